@@ -4,16 +4,24 @@
  */
 
 #include <reshade.hpp>
+#include "api_trace_recorder.hpp"
 #include <cassert>
+#include <string>
+#include <filesystem>
 #include <sstream>
 #include <shared_mutex>
 #include <unordered_set>
 
 using namespace reshade::api;
+using api_trace::make_array;
 
 namespace
 {
 	bool s_do_capture = false;
+	// Set via "BinaryTrace=1" in the "[API_TRACE]" section of the ReShade configuration, which writes compact binary records to a file instead of formatting every call as text (use "api_trace_decode" to convert them)
+	bool s_binary_trace = false;
+	uint32_t s_binary_trace_index = 0;
+	api_trace::recorder s_recorder;
 	std::shared_mutex s_mutex;
 	std::unordered_set<uint64_t> s_samplers;
 	std::unordered_set<uint64_t> s_resources;
@@ -337,6 +345,79 @@ namespace
 			return "unknown";
 		}
 	}
+
+	template <reshade::addon_event ev, typename... Args>
+	inline void record_event(const Args &... args)
+	{
+		s_recorder.record(static_cast<uint32_t>(ev), args...);
+	}
+
+	// Names of all events written to binary traces, which are stored in the trace file so that the decoder does not depend on the ReShade API
+	const std::pair<reshade::addon_event, const char *> s_binary_trace_event_names[] = {
+		{ reshade::addon_event::barrier, "barrier" },
+		{ reshade::addon_event::begin_render_pass, "begin_render_pass" },
+		{ reshade::addon_event::end_render_pass, "end_render_pass" },
+		{ reshade::addon_event::bind_render_targets_and_depth_stencil, "bind_render_targets_and_depth_stencil" },
+		{ reshade::addon_event::bind_pipeline, "bind_pipeline" },
+		{ reshade::addon_event::bind_pipeline_states, "bind_pipeline_states" },
+		{ reshade::addon_event::bind_viewports, "bind_viewports" },
+		{ reshade::addon_event::bind_scissor_rects, "bind_scissor_rects" },
+		{ reshade::addon_event::push_constants, "push_constants" },
+		{ reshade::addon_event::push_descriptors, "push_descriptors" },
+		{ reshade::addon_event::bind_descriptor_tables, "bind_descriptor_tables" },
+		{ reshade::addon_event::bind_index_buffer, "bind_index_buffer" },
+		{ reshade::addon_event::bind_vertex_buffers, "bind_vertex_buffers" },
+		{ reshade::addon_event::draw, "draw" },
+		{ reshade::addon_event::draw_indexed, "draw_indexed" },
+		{ reshade::addon_event::dispatch, "dispatch" },
+		{ reshade::addon_event::dispatch_mesh, "dispatch_mesh" },
+		{ reshade::addon_event::dispatch_rays, "dispatch_rays" },
+		{ reshade::addon_event::draw_or_dispatch_indirect, "draw_or_dispatch_indirect" },
+		{ reshade::addon_event::copy_resource, "copy_resource" },
+		{ reshade::addon_event::copy_buffer_region, "copy_buffer_region" },
+		{ reshade::addon_event::copy_buffer_to_texture, "copy_buffer_to_texture" },
+		{ reshade::addon_event::copy_texture_region, "copy_texture_region" },
+		{ reshade::addon_event::copy_texture_to_buffer, "copy_texture_to_buffer" },
+		{ reshade::addon_event::resolve_texture_region, "resolve_texture_region" },
+		{ reshade::addon_event::clear_depth_stencil_view, "clear_depth_stencil_view" },
+		{ reshade::addon_event::clear_render_target_view, "clear_render_target_view" },
+		{ reshade::addon_event::clear_unordered_access_view_uint, "clear_unordered_access_view_uint" },
+		{ reshade::addon_event::clear_unordered_access_view_float, "clear_unordered_access_view_float" },
+		{ reshade::addon_event::copy_acceleration_structure, "copy_acceleration_structure" },
+		{ reshade::addon_event::build_acceleration_structure, "build_acceleration_structure" },
+		{ reshade::addon_event::generate_mipmaps, "generate_mipmaps" },
+		{ reshade::addon_event::begin_query, "begin_query" },
+		{ reshade::addon_event::end_query, "end_query" },
+		{ reshade::addon_event::copy_query_heap_results, "copy_query_heap_results" },
+	};
+
+	bool begin_binary_trace()
+	{
+		std::vector<const char *> names;
+		for (const std::pair<reshade::addon_event, const char *> &name : s_binary_trace_event_names)
+		{
+			const uint32_t event = static_cast<uint32_t>(name.first);
+			if (event >= names.size())
+				names.resize(event + 1);
+			names[event] = name.second;
+		}
+
+		char base_path[260] = "";
+		size_t base_path_size = sizeof(base_path);
+		reshade::get_reshade_base_path(base_path, &base_path_size);
+
+		const std::filesystem::path path = std::filesystem::u8path(base_path) / ("api_trace_" + std::to_string(s_binary_trace_index++) + ".rstrace");
+
+		// This waits for the background thread of the previous trace, which was already stopped at the end of the captured frame, so has usually finished long ago
+		if (!s_recorder.open(path, names.data(), static_cast<uint32_t>(names.size())))
+		{
+			reshade::log_message(reshade::log_level::error, ("Failed to create binary trace file \"" + path.u8string() + "\"!").c_str());
+			return false;
+		}
+
+		reshade::log_message(reshade::log_level::info, ("Writing binary trace to \"" + path.u8string() + "\" ...").c_str());
+		return true;
+	}
 }
 
 static void on_init_swapchain(swapchain *swapchain)
@@ -436,6 +517,12 @@ static void on_barrier(command_list *, uint32_t num_resources, const resource *r
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::barrier>(make_array(resources, num_resources), make_array(old_states, num_resources), make_array(new_states, num_resources));
+		return;
+	}
+
 	for (uint32_t i = 0; i < num_resources; ++i)
 	{
 		std::stringstream s;
@@ -449,6 +536,16 @@ static void on_begin_render_pass(command_list *, uint32_t count, const render_pa
 	if (!s_do_capture)
 		return;
 
+	if (s_recorder.is_recording())
+	{
+		resource_view rtvs[8] = {};
+		for (uint32_t i = 0; i < count && i < 8; ++i)
+			rtvs[i] = rts[i].view;
+
+		record_event<reshade::addon_event::begin_render_pass>(make_array(rtvs, std::min(count, 8u)), ds != nullptr ? ds->view : resource_view { 0 });
+		return;
+	}
+
 	std::stringstream s;
 	s << "begin_render_pass(" << count << ", { ";
 	for (uint32_t i = 0; i < count; ++i)
@@ -462,6 +559,12 @@ static void on_end_render_pass(command_list *)
 	if (!s_do_capture)
 		return;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::end_render_pass>();
+		return;
+	}
+
 	std::stringstream s;
 	s << "end_render_pass()";
 
@@ -481,6 +584,12 @@ static void on_bind_render_targets_and_depth_stencil(command_list *, uint32_t co
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_render_targets_and_depth_stencil>(make_array(rtvs, count), dsv);
+		return;
+	}
+
 	std::stringstream s;
 	s << "bind_render_targets_and_depth_stencil(" << count << ", { ";
 	for (uint32_t i = 0; i < count; ++i)
@@ -502,6 +611,12 @@ static void on_bind_pipeline(command_list *, pipeline_stage type, pipeline pipel
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_pipeline>(type, pipeline);
+		return;
+	}
+
 	std::stringstream s;
 	s << "bind_pipeline(" << to_string(type) << ", " << (void *)pipeline.handle << ")";
 
@@ -512,6 +627,12 @@ static void on_bind_pipeline_states(command_list *, uint32_t count, const dynami
 	if (!s_do_capture)
 		return;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_pipeline_states>(make_array(states, count), make_array(values, count));
+		return;
+	}
+
 	for (uint32_t i = 0; i < count; ++i)
 	{
 		std::stringstream s;
@@ -524,6 +645,12 @@ static void on_bind_viewports(command_list *, uint32_t first, uint32_t count, co
 	if (!s_do_capture)
 		return;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_viewports>(first, count);
+		return;
+	}
+
 	std::stringstream s;
 	s << "bind_viewports(" << first << ", " << count << ", { ... })";
 
@@ -534,6 +661,12 @@ static void on_bind_scissor_rects(command_list *, uint32_t first, uint32_t count
 	if (!s_do_capture)
 		return;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_scissor_rects>(first, count);
+		return;
+	}
+
 	std::stringstream s;
 	s << "bind_scissor_rects(" << first << ", " << count << ", { ... })";
 
@@ -544,6 +677,12 @@ static void on_push_constants(command_list *, shader_stage stages, pipeline_layo
 	if (!s_do_capture)
 		return;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::push_constants>(stages, layout, param_index, first, make_array(static_cast<const uint32_t *>(values), count));
+		return;
+	}
+
 	std::stringstream s;
 	s << "push_constants(" << to_string(stages) << ", " << (void *)layout.handle << ", " << param_index << ", " << first << ", " << count << ", { ";
 	for (uint32_t i = 0; i < count; ++i)
@@ -586,6 +725,12 @@ static void on_push_descriptors(command_list *, shader_stage stages, pipeline_la
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::push_descriptors>(stages, layout, param_index, update.type, update.binding, update.count);
+		return;
+	}
+
 	std::stringstream s;
 	s << "push_descriptors(" << to_string(stages) << ", " << (void *)layout.handle << ", " << param_index << ", { " << to_string(update.type) << ", " << update.binding << ", " << update.count << " })";
 
@@ -596,6 +741,12 @@ static void on_bind_descriptor_tables(command_list *, shader_stage stages, pipel
 	if (!s_do_capture)
 		return;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_descriptor_tables>(stages, layout, first, make_array(tables, count));
+		return;
+	}
+
 	for (uint32_t i = 0; i < count; ++i)
 	{
 		std::stringstream s;
@@ -615,6 +766,12 @@ static void on_bind_index_buffer(command_list *, resource buffer, uint64_t offse
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_index_buffer>(buffer, offset, index_size);
+		return;
+	}
+
 	std::stringstream s;
 	s << "bind_index_buffer(" << (void *)buffer.handle << ", " << offset << ", " << index_size << ")";
 
@@ -633,6 +790,12 @@ static void on_bind_vertex_buffers(command_list *, uint32_t first, uint32_t coun
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::bind_vertex_buffers>(first, make_array(buffers, count), make_array(offsets, count), make_array(strides, count));
+		return;
+	}
+
 	for (uint32_t i = 0; i < count; ++i)
 	{
 		std::stringstream s;
@@ -646,6 +809,12 @@ static bool on_draw(command_list *, uint32_t vertices, uint32_t instances, uint3
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::draw>(vertices, instances, first_vertex, first_instance);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "draw(" << vertices << ", " << instances << ", " << first_vertex << ", " << first_instance << ")";
 
@@ -658,6 +827,12 @@ static bool on_draw_indexed(command_list *, uint32_t indices, uint32_t instances
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::draw_indexed>(indices, instances, first_index, vertex_offset, first_instance);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "draw_indexed(" << indices << ", " << instances << ", " << first_index << ", " << vertex_offset << ", " << first_instance << ")";
 
@@ -670,6 +845,12 @@ static bool on_dispatch(command_list *, uint32_t group_count_x, uint32_t group_c
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::dispatch>(group_count_x, group_count_y, group_count_z);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "dispatch(" << group_count_x << ", " << group_count_y << ", " << group_count_z << ")";
 
@@ -682,6 +863,12 @@ static bool on_dispatch_mesh(command_list *, uint32_t group_count_x, uint32_t gr
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::dispatch_mesh>(group_count_x, group_count_y, group_count_z);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "dispatch_mesh(" << group_count_x << ", " << group_count_y << ", " << group_count_z << ")";
 
@@ -694,6 +881,12 @@ static bool on_dispatch_rays(command_list *, resource raygen, uint64_t raygen_of
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::dispatch_rays>(raygen, raygen_offset, raygen_size, miss, miss_offset, miss_size, miss_stride, hit_group, hit_group_offset, hit_group_size, hit_group_stride, callable, callable_offset, callable_size, callable_stride, width, height, depth);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "dispatch_rays(" << (void *)raygen.handle << ", " << raygen_offset << ", " << raygen_size << ", " << (void *)miss.handle << ", " << miss_offset << ", " << miss_size << ", " << miss_stride << (void *)hit_group.handle << ", " << hit_group_offset << ", " << hit_group_size << ", " << hit_group_stride << ", " << (void *)callable.handle << ", " << callable_offset << ", " << callable_size << ", " << callable_stride << ", " << width << ", " << height << ", " << depth << ")";
 
@@ -706,6 +899,12 @@ static bool on_draw_or_dispatch_indirect(command_list *, indirect_command type,
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::draw_or_dispatch_indirect>(type, buffer, offset, draw_count, stride);
+		return false;
+	}
+
 	std::stringstream s;
 	switch (type)
 	{
@@ -747,6 +946,12 @@ static bool on_copy_resource(command_list *, resource src, resource dst)
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::copy_resource>(src, dst);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "copy_resource(" << (void *)src.handle << ", " << (void *)dst.handle << ")";
 
@@ -767,6 +972,12 @@ static bool on_copy_buffer_region(command_list *, resource src, uint64_t src_off
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::copy_buffer_region>(src, src_offset, dst, dst_offset, size);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "copy_buffer_region(" << (void *)src.handle << ", " << src_offset << ", " << (void *)dst.handle << ", " << dst_offset << ", " << size << ")";
 
@@ -787,6 +998,12 @@ static bool on_copy_buffer_to_texture(command_list *, resource src, uint64_t src
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::copy_buffer_to_texture>(src, src_offset, row_length, slice_height, dst, dst_subresource);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "copy_buffer_to_texture(" << (void *)src.handle << ", " << src_offset << ", " << row_length << ", " << slice_height << ", " << (void *)dst.handle << ", " << dst_subresource << ")";
 
@@ -807,6 +1024,12 @@ static bool on_copy_texture_region(command_list *, resource src, uint32_t src_su
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::copy_texture_region>(src, src_subresource, dst, dst_subresource, filter);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "copy_texture_region(" << (void *)src.handle << ", " << src_subresource << ", " << (void *)dst.handle << ", " << dst_subresource << ", " << (uint32_t)filter << ")";
 
@@ -827,6 +1050,12 @@ static bool on_copy_texture_to_buffer(command_list *, resource src, uint32_t src
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::copy_texture_to_buffer>(src, src_subresource, dst, dst_offset, row_length, slice_height);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "copy_texture_to_buffer(" << (void *)src.handle << ", " << src_subresource << ", " << (void *)dst.handle << ", " << dst_offset << ", " << row_length << ", " << slice_height << ")";
 
@@ -847,6 +1076,12 @@ static bool on_resolve_texture_region(command_list *, resource src, uint32_t src
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::resolve_texture_region>(src, src_subresource, dst, dst_subresource, dst_x, dst_y, dst_z, format);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "resolve_texture_region(" << (void *)src.handle << ", " << src_subresource << ", { ... }, " << (void *)dst.handle << ", " << dst_subresource << ", " << dst_x << ", " << dst_y << ", " << dst_z << ", " << (uint32_t)format << ")";
 
@@ -867,6 +1102,12 @@ static bool on_clear_depth_stencil_view(command_list *, resource_view dsv, const
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::clear_depth_stencil_view>(dsv, depth != nullptr ? *depth : 0.0f, stencil != nullptr ? static_cast<uint32_t>(*stencil) : 0u);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "clear_depth_stencil_view(" << (void *)dsv.handle << ", " << (depth != nullptr ? *depth : 0.0f) << ", " << (stencil != nullptr ? *stencil : 0) << ")";
 
@@ -886,6 +1127,12 @@ static bool on_clear_render_target_view(command_list *, resource_view rtv, const
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::clear_render_target_view>(rtv, make_array(color, 4));
+		return false;
+	}
+
 	std::stringstream s;
 	s << "clear_render_target_view(" << (void *)rtv.handle << ", { " << color[0] << ", " << color[1] << ", " << color[2] << ", " << color[3] << " })";
 
@@ -905,6 +1152,12 @@ static bool on_clear_unordered_access_view_uint(command_list *, resource_view ua
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::clear_unordered_access_view_uint>(uav, make_array(values, 4));
+		return false;
+	}
+
 	std::stringstream s;
 	s << "clear_unordered_access_view_uint(" << (void *)uav.handle << ", { " << values[0] << ", " << values[1] << ", " << values[2] << ", " << values[3] << " })";
 
@@ -924,6 +1177,12 @@ static bool on_clear_unordered_access_view_float(command_list *, resource_view u
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::clear_unordered_access_view_float>(uav, make_array(values, 4));
+		return false;
+	}
+
 	std::stringstream s;
 	s << "clear_unordered_access_view_float(" << (void *)uav.handle << ", { " << values[0] << ", " << values[1] << ", " << values[2] << ", " << values[3] << " })";
 
@@ -944,6 +1203,12 @@ static bool on_copy_acceleration_structure(command_list *, resource_view source,
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::copy_acceleration_structure>(source, dest, mode);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "copy_acceleration_structure(" << (void *)source.handle << ", " << (void *)dest.handle << ", " << to_string(mode) << ")";
 
@@ -963,6 +1228,12 @@ static bool on_build_acceleration_structure(command_list *, acceleration_structu
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::build_acceleration_structure>(type, flags, input_count, scratch, scratch_offset, source, dest, mode);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "build_acceleration_structure(" << to_string(type) << ", " << std::hex << static_cast<uint32_t>(flags) << std::dec << ", " << input_count << ", { ... }, " << (void *)scratch.handle << ", " << scratch_offset << ", " << (void *)source.handle << ", " << (void *)dest.handle << ", " << to_string(mode) << ")";
 
@@ -983,6 +1254,12 @@ static bool on_generate_mipmaps(command_list *, resource_view srv)
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::generate_mipmaps>(srv);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "generate_mipmaps(" << (void *)srv.handle << ")";
 
@@ -996,6 +1273,12 @@ static bool on_begin_query(command_list *cmd_list, query_heap heap, query_type t
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::begin_query>(heap, type, index);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "begin_query(" << (void *)heap.handle << ", " << to_string(type) << ", " << index << ")";
 
@@ -1008,6 +1291,12 @@ static bool on_end_query(command_list *cmd_list, query_heap heap, query_type typ
 	if (!s_do_capture)
 		return false;
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::end_query>(heap, type, index);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "end_query(" << (void *)heap.handle << ", " << to_string(type) << ", " << index << ")";
 
@@ -1027,6 +1316,12 @@ static bool on_copy_query_heap_results(command_list *cmd_list, query_heap heap,
 	}
 #endif
 
+	if (s_recorder.is_recording())
+	{
+		record_event<reshade::addon_event::copy_query_heap_results>(heap, type, first, count, dest, dest_offset, stride);
+		return false;
+	}
+
 	std::stringstream s;
 	s << "copy_query_heap_results(" << (void *)heap.handle << ", " << to_string(type) << ", " << first << ", " << count << (void *)dest.handle << ", " << dest_offset << ", " << stride << ")";
 
@@ -1039,7 +1334,16 @@ static void on_present(effect_runtime *runtime)
 {
 	if (s_do_capture)
 	{
-		reshade::log_message(reshade::log_level::info, "present()");
+		if (s_recorder.is_recording())
+		{
+			// Only hand the remaining records to the background thread, writing them to disk and closing the file happens there, so that the render thread does not have to wait for it
+			s_recorder.stop();
+		}
+		else
+		{
+			reshade::log_message(reshade::log_level::info, "present()");
+		}
+
 		reshade::log_message(reshade::log_level::info, "--- End Frame ---");
 		s_do_capture = false;
 	}
@@ -1048,6 +1352,11 @@ static void on_present(effect_runtime *runtime)
 		// The keyboard shortcut to trigger logging
 		if (runtime->is_key_pressed(VK_F10))
 		{
+			reshade::get_config_value(runtime, "API_TRACE", "BinaryTrace", s_binary_trace);
+
+			if (s_binary_trace && !begin_binary_trace())
+				return;
+
 			s_do_capture = true;
 			reshade::log_message(reshade::log_level::info, "--- Frame ---");
 		}
@@ -1057,67 +1366,67 @@ static void on_present(effect_runtime *runtime)
 extern "C" __declspec(dllexport) const char *NAME = "API Trace";
 extern "C" __declspec(dllexport) const char *DESCRIPTION = "Example add-on that logs the graphics API calls done by the application of the next frame after pressing a keyboard shortcut.";
 
-BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
+// Use 'AddonInit' and 'AddonUninit' instead of 'DllMain', since the background thread writing binary traces cannot be waited on while the loader lock is held
+extern "C" __declspec(dllexport) bool AddonInit(HMODULE addon_module, HMODULE reshade_module)
 {
-	switch (fdwReason)
-	{
-	case DLL_PROCESS_ATTACH:
-		if (!reshade::register_addon(hModule))
-			return FALSE;
-
-		reshade::register_event<reshade::addon_event::init_swapchain>(on_init_swapchain);
-		reshade::register_event<reshade::addon_event::destroy_swapchain>(on_destroy_swapchain);
-		reshade::register_event<reshade::addon_event::init_sampler>(on_init_sampler);
-		reshade::register_event<reshade::addon_event::destroy_sampler>(on_destroy_sampler);
-		reshade::register_event<reshade::addon_event::init_resource>(on_init_resource);
-		reshade::register_event<reshade::addon_event::destroy_resource>(on_destroy_resource);
-		reshade::register_event<reshade::addon_event::init_resource_view>(on_init_resource_view);
-		reshade::register_event<reshade::addon_event::destroy_resource_view>(on_destroy_resource_view);
-		reshade::register_event<reshade::addon_event::init_pipeline>(on_init_pipeline);
-		reshade::register_event<reshade::addon_event::destroy_pipeline>(on_destroy_pipeline);
-
-		reshade::register_event<reshade::addon_event::barrier>(on_barrier);
-		reshade::register_event<reshade::addon_event::begin_render_pass>(on_begin_render_pass);
-		reshade::register_event<reshade::addon_event::end_render_pass>(on_end_render_pass);
-		reshade::register_event<reshade::addon_event::bind_render_targets_and_depth_stencil>(on_bind_render_targets_and_depth_stencil);
-		reshade::register_event<reshade::addon_event::bind_pipeline>(on_bind_pipeline);
-		reshade::register_event<reshade::addon_event::bind_pipeline_states>(on_bind_pipeline_states);
-		reshade::register_event<reshade::addon_event::bind_viewports>(on_bind_viewports);
-		reshade::register_event<reshade::addon_event::bind_scissor_rects>(on_bind_scissor_rects);
-		reshade::register_event<reshade::addon_event::push_constants>(on_push_constants);
-		reshade::register_event<reshade::addon_event::push_descriptors>(on_push_descriptors);
-		reshade::register_event<reshade::addon_event::bind_descriptor_tables>(on_bind_descriptor_tables);
-		reshade::register_event<reshade::addon_event::bind_index_buffer>(on_bind_index_buffer);
-		reshade::register_event<reshade::addon_event::bind_vertex_buffers>(on_bind_vertex_buffers);
-		reshade::register_event<reshade::addon_event::draw>(on_draw);
-		reshade::register_event<reshade::addon_event::draw_indexed>(on_draw_indexed);
-		reshade::register_event<reshade::addon_event::dispatch>(on_dispatch);
-		reshade::register_event<reshade::addon_event::dispatch_mesh>(on_dispatch_mesh);
-		reshade::register_event<reshade::addon_event::dispatch_rays>(on_dispatch_rays);
-		reshade::register_event<reshade::addon_event::draw_or_dispatch_indirect>(on_draw_or_dispatch_indirect);
-		reshade::register_event<reshade::addon_event::copy_resource>(on_copy_resource);
-		reshade::register_event<reshade::addon_event::copy_buffer_region>(on_copy_buffer_region);
-		reshade::register_event<reshade::addon_event::copy_buffer_to_texture>(on_copy_buffer_to_texture);
-		reshade::register_event<reshade::addon_event::copy_texture_region>(on_copy_texture_region);
-		reshade::register_event<reshade::addon_event::copy_texture_to_buffer>(on_copy_texture_to_buffer);
-		reshade::register_event<reshade::addon_event::resolve_texture_region>(on_resolve_texture_region);
-		reshade::register_event<reshade::addon_event::clear_depth_stencil_view>(on_clear_depth_stencil_view);
-		reshade::register_event<reshade::addon_event::clear_render_target_view>(on_clear_render_target_view);
-		reshade::register_event<reshade::addon_event::clear_unordered_access_view_uint>(on_clear_unordered_access_view_uint);
-		reshade::register_event<reshade::addon_event::clear_unordered_access_view_float>(on_clear_unordered_access_view_float);
-		reshade::register_event<reshade::addon_event::copy_acceleration_structure>(on_copy_acceleration_structure);
-		reshade::register_event<reshade::addon_event::build_acceleration_structure>(on_build_acceleration_structure);
-		reshade::register_event<reshade::addon_event::generate_mipmaps>(on_generate_mipmaps);
-		reshade::register_event<reshade::addon_event::begin_query>(on_begin_query);
-		reshade::register_event<reshade::addon_event::end_query>(on_end_query);
-		reshade::register_event<reshade::addon_event::copy_query_heap_results>(on_copy_query_heap_results);
-
-		reshade::register_event<reshade::addon_event::reshade_present>(on_present);
-		break;
-	case DLL_PROCESS_DETACH:
-		reshade::unregister_addon(hModule);
-		break;
-	}
+	if (!reshade::register_addon(addon_module, reshade_module))
+		return false;
+
+	reshade::register_event<reshade::addon_event::init_swapchain>(on_init_swapchain);
+	reshade::register_event<reshade::addon_event::destroy_swapchain>(on_destroy_swapchain);
+	reshade::register_event<reshade::addon_event::init_sampler>(on_init_sampler);
+	reshade::register_event<reshade::addon_event::destroy_sampler>(on_destroy_sampler);
+	reshade::register_event<reshade::addon_event::init_resource>(on_init_resource);
+	reshade::register_event<reshade::addon_event::destroy_resource>(on_destroy_resource);
+	reshade::register_event<reshade::addon_event::init_resource_view>(on_init_resource_view);
+	reshade::register_event<reshade::addon_event::destroy_resource_view>(on_destroy_resource_view);
+	reshade::register_event<reshade::addon_event::init_pipeline>(on_init_pipeline);
+	reshade::register_event<reshade::addon_event::destroy_pipeline>(on_destroy_pipeline);
+
+	reshade::register_event<reshade::addon_event::barrier>(on_barrier);
+	reshade::register_event<reshade::addon_event::begin_render_pass>(on_begin_render_pass);
+	reshade::register_event<reshade::addon_event::end_render_pass>(on_end_render_pass);
+	reshade::register_event<reshade::addon_event::bind_render_targets_and_depth_stencil>(on_bind_render_targets_and_depth_stencil);
+	reshade::register_event<reshade::addon_event::bind_pipeline>(on_bind_pipeline);
+	reshade::register_event<reshade::addon_event::bind_pipeline_states>(on_bind_pipeline_states);
+	reshade::register_event<reshade::addon_event::bind_viewports>(on_bind_viewports);
+	reshade::register_event<reshade::addon_event::bind_scissor_rects>(on_bind_scissor_rects);
+	reshade::register_event<reshade::addon_event::push_constants>(on_push_constants);
+	reshade::register_event<reshade::addon_event::push_descriptors>(on_push_descriptors);
+	reshade::register_event<reshade::addon_event::bind_descriptor_tables>(on_bind_descriptor_tables);
+	reshade::register_event<reshade::addon_event::bind_index_buffer>(on_bind_index_buffer);
+	reshade::register_event<reshade::addon_event::bind_vertex_buffers>(on_bind_vertex_buffers);
+	reshade::register_event<reshade::addon_event::draw>(on_draw);
+	reshade::register_event<reshade::addon_event::draw_indexed>(on_draw_indexed);
+	reshade::register_event<reshade::addon_event::dispatch>(on_dispatch);
+	reshade::register_event<reshade::addon_event::dispatch_mesh>(on_dispatch_mesh);
+	reshade::register_event<reshade::addon_event::dispatch_rays>(on_dispatch_rays);
+	reshade::register_event<reshade::addon_event::draw_or_dispatch_indirect>(on_draw_or_dispatch_indirect);
+	reshade::register_event<reshade::addon_event::copy_resource>(on_copy_resource);
+	reshade::register_event<reshade::addon_event::copy_buffer_region>(on_copy_buffer_region);
+	reshade::register_event<reshade::addon_event::copy_buffer_to_texture>(on_copy_buffer_to_texture);
+	reshade::register_event<reshade::addon_event::copy_texture_region>(on_copy_texture_region);
+	reshade::register_event<reshade::addon_event::copy_texture_to_buffer>(on_copy_texture_to_buffer);
+	reshade::register_event<reshade::addon_event::resolve_texture_region>(on_resolve_texture_region);
+	reshade::register_event<reshade::addon_event::clear_depth_stencil_view>(on_clear_depth_stencil_view);
+	reshade::register_event<reshade::addon_event::clear_render_target_view>(on_clear_render_target_view);
+	reshade::register_event<reshade::addon_event::clear_unordered_access_view_uint>(on_clear_unordered_access_view_uint);
+	reshade::register_event<reshade::addon_event::clear_unordered_access_view_float>(on_clear_unordered_access_view_float);
+	reshade::register_event<reshade::addon_event::copy_acceleration_structure>(on_copy_acceleration_structure);
+	reshade::register_event<reshade::addon_event::build_acceleration_structure>(on_build_acceleration_structure);
+	reshade::register_event<reshade::addon_event::generate_mipmaps>(on_generate_mipmaps);
+	reshade::register_event<reshade::addon_event::begin_query>(on_begin_query);
+	reshade::register_event<reshade::addon_event::end_query>(on_end_query);
+	reshade::register_event<reshade::addon_event::copy_query_heap_results>(on_copy_query_heap_results);
+
+	reshade::register_event<reshade::addon_event::reshade_present>(on_present);
+
+	return true;
+}
+extern "C" __declspec(dllexport) void AddonUninit(HMODULE addon_module, HMODULE reshade_module)
+{
+	// Wait for a binary trace that is still being written to finish
+	s_recorder.close();
 
-	return TRUE;
+	reshade::unregister_addon(addon_module, reshade_module);
 }
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+// Command-line tool that converts binary traces written by the API trace add-on into text, JSON or per-event statistics.
+// It only depends on the C++ standard library, so it can be built on any platform, e.g. with "c++ -std=c++17 -O2 api_trace_decode.cpp -o api_trace_decode".
+
+#include "api_trace_recorder.hpp"
+#include <cinttypes>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+using namespace api_trace;
+
+namespace
+{
+	enum class output_mode
+	{
+		text,
+		json,
+		stats
+	};
+
+	struct event_stats
+	{
+		uint64_t count = 0;
+		uint64_t size = 0;
+	};
+
+	struct record_info
+	{
+		uint64_t sequence;
+		uint32_t thread_index;
+		uint16_t event;
+		const uint8_t *fields;
+		const uint8_t *fields_end;
+	};
+
+	template <typename T>
+	inline bool read(const uint8_t *&p, const uint8_t *end, T &value)
+	{
+		if (static_cast<size_t>(end - p) < sizeof(T))
+			return false;
+		std::memcpy(&value, p, sizeof(T));
+		p += sizeof(T);
+		return true;
+	}
+
+	void print_value(field_type type, const uint8_t *p, output_mode mode)
+	{
+		switch (type)
+		{
+		case field_type::uint32:
+		{
+			uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			std::printf("%" PRIu32, value);
+			break;
+		}
+		case field_type::int32:
+		{
+			int32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			std::printf("%" PRId32, value);
+			break;
+		}
+		case field_type::uint64:
+		{
+			uint64_t value;
+			std::memcpy(&value, p, sizeof(value));
+			std::printf("%" PRIu64, value);
+			break;
+		}
+		case field_type::float32:
+		{
+			float value;
+			std::memcpy(&value, p, sizeof(value));
+			std::printf("%g", value);
+			break;
+		}
+		case field_type::handle:
+		{
+			uint64_t value;
+			std::memcpy(&value, p, sizeof(value));
+			// JSON has no hexadecimal number literals, so write handles as strings there
+			std::printf(mode == output_mode::json ? "\"0x%016" PRIX64 "\"" : "0x%016" PRIX64, value);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	bool print_fields(const uint8_t *p, const uint8_t *end, output_mode mode)
+	{
+		for (bool first = true; p < end; first = false)
+		{
+			uint8_t type = 0;
+			if (!read(p, end, type))
+				return false;
+
+			if (!first)
+				std::printf(", ");
+
+			const field_type element_type = static_cast<field_type>(type & ~static_cast<uint8_t>(field_type::array));
+			const uint32_t element_size = field_type_size(element_type);
+			if (element_size == 0)
+				return false;
+
+			if (type & static_cast<uint8_t>(field_type::array))
+			{
+				uint32_t count = 0;
+				if (!read(p, end, count) || static_cast<size_t>(end - p) < static_cast<size_t>(count) * element_size)
+					return false;
+
+				std::printf(mode == output_mode::json ? "[" : "{ ");
+				for (uint32_t i = 0; i < count; ++i, p += element_size)
+				{
+					if (i != 0)
+						std::printf(", ");
+					print_value(element_type, p, mode);
+				}
+				std::printf(mode == output_mode::json ? "]" : " }");
+			}
+			else
+			{
+				if (static_cast<size_t>(end - p) < element_size)
+					return false;
+
+				print_value(element_type, p, mode);
+				p += element_size;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	output_mode mode = output_mode::text;
+	const char *path = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--text") == 0)
+			mode = output_mode::text;
+		else if (std::strcmp(argv[i], "--json") == 0)
+			mode = output_mode::json;
+		else if (std::strcmp(argv[i], "--stats") == 0)
+			mode = output_mode::stats;
+		else
+			path = argv[i];
+	}
+
+	if (path == nullptr)
+	{
+		std::fprintf(stderr, "usage: %s [--text | --json | --stats] <trace file>\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::fprintf(stderr, "error: failed to open '%s'\n", path);
+		return 1;
+	}
+
+	const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	const uint8_t *p = data.data();
+	const uint8_t *const end = data.data() + data.size();
+
+	char magic[sizeof(file_magic)] = {};
+	uint32_t version = 0;
+	uint32_t num_names = 0;
+	if (!read(p, end, magic) || std::memcmp(magic, file_magic, sizeof(file_magic)) != 0 || !read(p, end, version) || version != file_version || !read(p, end, num_names))
+	{
+		std::fprintf(stderr, "error: '%s' is not a supported trace file\n", path);
+		return 1;
+	}
+
+	std::unordered_map<uint16_t, std::string> names;
+	for (uint32_t i = 0; i < num_names; ++i)
+	{
+		uint16_t event = 0, length = 0;
+		if (!read(p, end, event) || !read(p, end, length) || static_cast<size_t>(end - p) < length)
+		{
+			std::fprintf(stderr, "error: name table is truncated\n");
+			return 1;
+		}
+
+		names[event].assign(reinterpret_cast<const char *>(p), length);
+		p += length;
+	}
+
+	const auto get_name = [&names](uint16_t event) {
+		if (const auto it = names.find(event); it != names.end())
+			return it->second;
+		return "event_" + std::to_string(event);
+	};
+
+	std::unordered_map<uint16_t, event_stats> stats;
+	std::vector<record_info> records;
+	uint32_t num_threads = 0;
+	uint64_t num_records = 0;
+	bool truncated = false;
+
+	while (p < end && !truncated)
+	{
+		chunk_header chunk;
+		if (!read(p, end, chunk) || chunk.magic != chunk_magic || static_cast<size_t>(end - p) < chunk.size)
+		{
+			truncated = true;
+			break;
+		}
+
+		num_threads = std::max(num_threads, chunk.thread_index + 1);
+
+		const uint8_t *const chunk_end = p + chunk.size;
+		while (p < chunk_end)
+		{
+			record_header record;
+			if (!read(p, chunk_end, record) || record.size < sizeof(record) || static_cast<size_t>(chunk_end - p) < record.size - sizeof(record))
+			{
+				truncated = true;
+				break;
+			}
+
+			const uint8_t *const record_end = p + (record.size - sizeof(record));
+
+			if (mode == output_mode::stats)
+			{
+				stats[record.event].count++;
+				stats[record.event].size += record.size;
+			}
+			else
+			{
+				records.push_back({ record.sequence, chunk.thread_index, record.event, p, record_end });
+			}
+
+			num_records++;
+			p = record_end;
+		}
+
+		p = chunk_end;
+	}
+
+	if (mode != output_mode::stats)
+	{
+		// Chunks are stored in the order they filled up, so sort records from all threads back into the order they were recorded in
+		std::stable_sort(records.begin(), records.end(),
+			[](const record_info &lhs, const record_info &rhs) { return lhs.sequence < rhs.sequence; });
+
+		if (mode == output_mode::json)
+			std::printf("[\n");
+
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			const record_info &record = records[i];
+
+			switch (mode)
+			{
+			case output_mode::text:
+				std::printf("%" PRIu64 " [%" PRIu32 "] %s(", record.sequence, record.thread_index, get_name(record.event).c_str());
+				truncated |= !print_fields(record.fields, record.fields_end, mode);
+				std::printf(")\n");
+				break;
+			case output_mode::json:
+				std::printf("%s{ \"sequence\": %" PRIu64 ", \"thread\": %" PRIu32 ", \"event\": \"%s\", \"args\": [", i != 0 ? ",\n" : "", record.sequence, record.thread_index, get_name(record.event).c_str());
+				truncated |= !print_fields(record.fields, record.fields_end, mode);
+				std::printf("] }");
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (mode == output_mode::json)
+			std::printf("\n]\n");
+	}
+
+	if (mode == output_mode::stats)
+	{
+		std::vector<std::pair<uint16_t, event_stats>> sorted_stats(stats.begin(), stats.end());
+		std::sort(sorted_stats.begin(), sorted_stats.end(),
+			[](const std::pair<uint16_t, event_stats> &lhs, const std::pair<uint16_t, event_stats> &rhs) { return lhs.second.count > rhs.second.count; });
+
+		std::printf("%-40s %12s %8s %14s\n", "event", "count", "%", "bytes");
+		for (const std::pair<uint16_t, event_stats> &entry : sorted_stats)
+			std::printf("%-40s %12" PRIu64 " %7.2f%% %14" PRIu64 "\n", get_name(entry.first).c_str(), entry.second.count, 100.0 * entry.second.count / num_records, entry.second.size);
+		std::printf("\n%" PRIu64 " records from %" PRIu32 " threads\n", num_records, num_threads);
+	}
+
+	if (truncated)
+	{
+		std::fprintf(stderr, "warning: trace file is truncated or corrupted, stopped after %" PRIu64 " records\n", num_records);
+		return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,448 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <filesystem>
+#include <type_traits>
+#include <condition_variable>
+
+// This header has no dependencies on the ReShade API or Windows, so that the offline decoder can share it.
+//
+// Layout of a binary trace file (all values little-endian and without padding):
+//   file header:  char magic[8] = "RSTRACE", uint32_t version, uint32_t num_names
+//   name table:   num_names x { uint16_t event, uint16_t length, char name[length] }
+//   chunks:       { uint32_t magic = 'CHNK', uint32_t thread_index, uint32_t sequence, uint32_t size, uint8_t records[size] }
+//   record:       uint16_t event, uint16_t size (including this header), uint64_t sequence, followed by fields
+//
+// Chunks of different threads are written in the order they fill up, so records are not sorted in the file. The sequence number of a record is taken from a counter shared by all threads when it is recorded, which gives the order in which events happened across threads.
+//   field:        uint8_t type, followed by the value, or for arrays (type with 'array' bit set) by uint32_t count and count values
+namespace api_trace
+{
+	constexpr char file_magic[8] = "RSTRACE";
+	constexpr uint32_t file_version = 2;
+	constexpr uint32_t chunk_magic = 0x4B4E4843; // 'CHNK'
+	constexpr uint32_t chunk_capacity = 64 * 1024;
+	// Arrays longer than this are truncated, so that a record always fits into a chunk
+	constexpr uint32_t max_array_count = 1024;
+
+	enum class field_type : uint8_t
+	{
+		uint32 = 1,
+		int32 = 2,
+		uint64 = 3,
+		float32 = 4,
+		handle = 5,
+		array = 0x80
+	};
+
+	constexpr uint32_t field_type_size(field_type type)
+	{
+		switch (static_cast<field_type>(static_cast<uint8_t>(type) & ~static_cast<uint8_t>(field_type::array)))
+		{
+		case field_type::uint32:
+		case field_type::int32:
+		case field_type::float32:
+			return 4;
+		case field_type::uint64:
+		case field_type::handle:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	#pragma pack(push, 1)
+	struct chunk_header
+	{
+		uint32_t magic;
+		uint32_t thread_index;
+		uint32_t sequence;
+		uint32_t size;
+	};
+	struct record_header
+	{
+		uint16_t event;
+		uint16_t size;
+		uint64_t sequence;
+	};
+	#pragma pack(pop)
+
+	/// <summary>
+	/// Wraps a pointer and element count, so that it is written as a single array field.
+	/// </summary>
+	template <typename T>
+	struct array
+	{
+		const T *data;
+		uint32_t count;
+	};
+	template <typename T>
+	inline array<T> make_array(const T *data, uint32_t count)
+	{
+		return { data, data != nullptr ? count : 0 };
+	}
+
+	namespace internal
+	{
+		template <typename T, typename = void>
+		struct is_handle : std::false_type {};
+		template <typename T>
+		struct is_handle<T, std::void_t<decltype(T::handle)>> : std::true_type {};
+
+		template <typename T>
+		constexpr field_type type_of()
+		{
+			if constexpr (is_handle<T>::value)
+				return field_type::handle;
+			else if constexpr (std::is_same_v<T, float>)
+				return field_type::float32;
+			else if constexpr (std::is_enum_v<T>)
+				return sizeof(T) <= 4 ? field_type::uint32 : field_type::uint64;
+			else if constexpr (std::is_integral_v<T> && sizeof(T) <= 4)
+				return std::is_signed_v<T> ? field_type::int32 : field_type::uint32;
+			else
+			{
+				static_assert(std::is_integral_v<T>, "unsupported trace field type");
+				return field_type::uint64;
+			}
+		}
+
+		template <typename T>
+		inline uint8_t *write_value(uint8_t *p, const T &value)
+		{
+			if constexpr (is_handle<T>::value)
+			{
+				const uint64_t handle = value.handle;
+				std::memcpy(p, &handle, 8);
+				return p + 8;
+			}
+			else if constexpr (std::is_same_v<T, float>)
+			{
+				std::memcpy(p, &value, 4);
+				return p + 4;
+			}
+			else if constexpr (field_type_size(type_of<T>()) == 4)
+			{
+				const uint32_t data = static_cast<uint32_t>(value);
+				std::memcpy(p, &data, 4);
+				return p + 4;
+			}
+			else
+			{
+				const uint64_t data = static_cast<uint64_t>(value);
+				std::memcpy(p, &data, 8);
+				return p + 8;
+			}
+		}
+
+		template <typename T>
+		inline uint32_t field_size(const T &)
+		{
+			return 1 + field_type_size(type_of<T>());
+		}
+		template <typename T>
+		inline uint32_t field_size(const array<T> &value)
+		{
+			return 1 + 4 + std::min(value.count, max_array_count) * field_type_size(type_of<T>());
+		}
+
+		template <typename T>
+		inline uint8_t *write_field(uint8_t *p, const T &value)
+		{
+			*p++ = static_cast<uint8_t>(type_of<T>());
+			return write_value(p, value);
+		}
+		template <typename T>
+		inline uint8_t *write_field(uint8_t *p, const array<T> &value)
+		{
+			*p++ = static_cast<uint8_t>(type_of<T>()) | static_cast<uint8_t>(field_type::array);
+			const uint32_t count = std::min(value.count, max_array_count);
+			std::memcpy(p, &count, 4);
+			p += 4;
+			for (uint32_t i = 0; i < count; ++i)
+				p = write_value(p, value.data[i]);
+			return p;
+		}
+	}
+
+	/// <summary>
+	/// Records events into per-thread chunks, which are handed to a background thread that writes them to a file once full.
+	/// Appending a record only touches memory owned by the calling thread, the shared queue is only locked once per chunk.
+	/// </summary>
+	class recorder
+	{
+		struct chunk
+		{
+			chunk_header header;
+			uint8_t data[chunk_capacity];
+		};
+
+		struct thread_buffer
+		{
+			// Only contended while the recorder is flushing or closing, so a simple spin lock is sufficient
+			std::atomic_flag lock = ATOMIC_FLAG_INIT;
+			uint32_t thread_index = 0;
+			uint32_t sequence = 0;
+			std::unique_ptr<chunk> current;
+		};
+
+	public:
+		recorder() = default;
+		~recorder()
+		{
+			close();
+		}
+
+		recorder(const recorder &) = delete;
+		recorder &operator=(const recorder &) = delete;
+
+		/// <summary>
+		/// Creates a trace file and starts recording.
+		/// </summary>
+		/// <param name="path">Path to the trace file to create.</param>
+		/// <param name="names">Names of the events that will be recorded, indexed by event identifier (empty entries are skipped).</param>
+		/// <param name="num_names">Number of entries in <paramref name="names"/>.</param>
+		bool open(const std::filesystem::path &path, const char *const *names, uint32_t num_names)
+		{
+			close();
+
+#ifdef _WIN32
+			if (_wfopen_s(&_file, path.c_str(), L"wb") != 0)
+				_file = nullptr;
+#else
+			_file = std::fopen(path.c_str(), "wb");
+#endif
+			if (_file == nullptr)
+				return false;
+
+			uint32_t num_valid_names = 0;
+			for (uint32_t i = 0; i < num_names; ++i)
+				if (names[i] != nullptr)
+					num_valid_names++;
+
+			std::fwrite(file_magic, sizeof(file_magic), 1, _file);
+			std::fwrite(&file_version, sizeof(file_version), 1, _file);
+			std::fwrite(&num_valid_names, sizeof(num_valid_names), 1, _file);
+
+			for (uint32_t i = 0; i < num_names; ++i)
+			{
+				if (names[i] == nullptr)
+					continue;
+
+				const uint16_t event = static_cast<uint16_t>(i);
+				const uint16_t length = static_cast<uint16_t>(std::strlen(names[i]));
+				std::fwrite(&event, sizeof(event), 1, _file);
+				std::fwrite(&length, sizeof(length), 1, _file);
+				std::fwrite(names[i], length, 1, _file);
+			}
+
+			_stop = false;
+			_writer_thread = std::thread(&recorder::write_chunks, this);
+
+			_next_sequence.store(0, std::memory_order_relaxed);
+			_recording.store(true, std::memory_order_release);
+			return true;
+		}
+		/// <summary>
+		/// Stops recording and hands all pending records to the background thread, which writes them and then closes the trace file.
+		/// This does not wait for the background thread, so it is safe to call on a render thread.
+		/// </summary>
+		void stop()
+		{
+			if (!_recording.exchange(false, std::memory_order_acq_rel))
+				return;
+
+			flush();
+
+			{ const std::unique_lock<std::mutex> lock(_queue_mutex);
+				_stop = true;
+			}
+			_queue_condition.notify_all();
+		}
+		/// <summary>
+		/// Stops recording and waits until all pending records were written and the trace file was closed.
+		/// This blocks until everything is written to disk, so should not be called on a render thread (see <see cref="stop"/> instead).
+		/// </summary>
+		void close()
+		{
+			stop();
+
+			if (_writer_thread.joinable())
+				_writer_thread.join();
+		}
+
+		bool is_recording() const { return _recording.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Hands the partially filled chunks of all threads to the writer thread.
+		/// </summary>
+		void flush()
+		{
+			const std::unique_lock<std::mutex> lock(_buffers_mutex);
+
+			for (const std::unique_ptr<thread_buffer> &buffer : _buffers)
+			{
+				while (buffer->lock.test_and_set(std::memory_order_acquire))
+					std::this_thread::yield();
+
+				if (buffer->current != nullptr && buffer->current->header.size != 0)
+					submit_chunk(std::move(buffer->current));
+
+				buffer->lock.clear(std::memory_order_release);
+			}
+		}
+
+		/// <summary>
+		/// Appends a record with the specified fields to the buffer of the calling thread.
+		/// Fields can be integers, enumerations, floats, ReShade API handles or arrays of those wrapped with <see cref="make_array"/>.
+		/// </summary>
+		template <typename... Args>
+		void record(uint32_t event, const Args &... args)
+		{
+			if (!_recording.load(std::memory_order_relaxed))
+				return;
+
+			const uint32_t size = sizeof(record_header) + (0 + ... + internal::field_size(args));
+			if (size > UINT16_MAX)
+				return;
+
+			thread_buffer &buffer = get_thread_buffer();
+
+			while (buffer.lock.test_and_set(std::memory_order_acquire))
+				std::this_thread::yield();
+
+			// Check again after taking the lock, so that no records are added after the final flush in 'close'
+			if (_recording.load(std::memory_order_relaxed))
+			{
+				if (buffer.current == nullptr || buffer.current->header.size + size > chunk_capacity)
+				{
+					if (buffer.current != nullptr)
+						submit_chunk(std::move(buffer.current));
+
+					buffer.current = acquire_chunk();
+					buffer.current->header.thread_index = buffer.thread_index;
+					buffer.current->header.sequence = buffer.sequence++;
+				}
+
+				uint8_t *p = buffer.current->data + buffer.current->header.size;
+
+				const record_header header = { static_cast<uint16_t>(event), static_cast<uint16_t>(size), _next_sequence.fetch_add(1, std::memory_order_relaxed) };
+				std::memcpy(p, &header, sizeof(header));
+				p += sizeof(header);
+				((p = internal::write_field(p, args)), ...);
+
+				buffer.current->header.size += size;
+			}
+
+			buffer.lock.clear(std::memory_order_release);
+		}
+
+	private:
+		static uint64_t next_id()
+		{
+			static std::atomic<uint64_t> s_next_id = 1;
+			return s_next_id.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		thread_buffer &get_thread_buffer()
+		{
+			// Identify recorders by a unique number rather than their address, which could be reused by a later instance
+			thread_local uint64_t t_recorder_id = 0;
+			thread_local thread_buffer *t_buffer = nullptr;
+
+			if (t_recorder_id != _id)
+			{
+				const std::unique_lock<std::mutex> lock(_buffers_mutex);
+
+				t_buffer = _buffers.emplace_back(std::make_unique<thread_buffer>()).get();
+				t_buffer->thread_index = static_cast<uint32_t>(_buffers.size() - 1);
+				t_recorder_id = _id;
+			}
+
+			return *t_buffer;
+		}
+
+		std::unique_ptr<chunk> acquire_chunk()
+		{
+			{ const std::unique_lock<std::mutex> lock(_queue_mutex);
+
+				if (!_free_chunks.empty())
+				{
+					std::unique_ptr<chunk> result = std::move(_free_chunks.back());
+					_free_chunks.pop_back();
+					result->header.size = 0;
+					return result;
+				}
+			}
+
+			std::unique_ptr<chunk> result = std::make_unique<chunk>();
+			result->header.magic = chunk_magic;
+			result->header.size = 0;
+			return result;
+		}
+		void submit_chunk(std::unique_ptr<chunk> &&chunk)
+		{
+			{ const std::unique_lock<std::mutex> lock(_queue_mutex);
+				_pending_chunks.push_back(std::move(chunk));
+			}
+			_queue_condition.notify_one();
+		}
+
+		void write_chunks()
+		{
+			std::unique_lock<std::mutex> lock(_queue_mutex);
+
+			while (true)
+			{
+				_queue_condition.wait(lock, [this]() { return _stop || !_pending_chunks.empty(); });
+
+				if (_pending_chunks.empty())
+					break; // Only stop once all pending chunks were written
+
+				std::unique_ptr<chunk> chunk = std::move(_pending_chunks.front());
+				_pending_chunks.pop_front();
+
+				lock.unlock();
+				std::fwrite(chunk.get(), sizeof(chunk_header) + chunk->header.size, 1, _file);
+				lock.lock();
+
+				_free_chunks.push_back(std::move(chunk));
+			}
+
+			lock.unlock();
+
+			// Nothing else accesses the file once recording stopped, so it can be closed here without waiting for 'close'
+			std::fclose(_file);
+			_file = nullptr;
+		}
+
+		const uint64_t _id = next_id();
+		std::FILE *_file = nullptr;
+		std::atomic<bool> _recording = false;
+		std::atomic<uint64_t> _next_sequence = 0;
+
+		// Buffers are never freed before the recorder is destroyed, since threads keep pointers to them
+		std::mutex _buffers_mutex;
+		std::vector<std::unique_ptr<thread_buffer>> _buffers;
+
+		std::mutex _queue_mutex;
+		std::condition_variable _queue_condition;
+		std::deque<std::unique_ptr<chunk>> _pending_chunks;
+		std::vector<std::unique_ptr<chunk>> _free_chunks;
+		std::thread _writer_thread;
+		bool _stop = false;
+	};
+}
@@ -4,6 +4,7 @@
  */
 
 #include <reshade.hpp>
+#include <reshade_xxhash64.hpp>
 #include "config.hpp"
 #include "crc32_hash.hpp"
 #include <fstream>
@@ -16,8 +17,6 @@ static void save_shader_code(device_api device_type, const shader_desc &desc)
 	if (desc.code_size == 0)
 		return;
 
-	uint32_t shader_hash = compute_crc32(static_cast<const uint8_t *>(desc.code), desc.code_size);
-
 	const wchar_t *extension = L".cso";
 	if (device_type == device_api::vulkan || (
 		device_type == device_api::opengl && desc.code_size > sizeof(uint32_t) && *static_cast<const uint32_t *>(desc.code) == 0x07230203 /* SPIR-V magic value */))
@@ -33,11 +32,26 @@ static void save_shader_code(device_api device_type, const shader_desc &desc)
 	dump_path  = dump_path.parent_path();
 	dump_path /= RESHADE_ADDON_SHADER_SAVE_DIR;
 
-	if (std::filesystem::exists(dump_path) == false)
-		std::filesystem::create_directory(dump_path);
+	// Only need to create the dump directory once, rather than checking for it for every shader
+	// Use the non-throwing overloads, since an exception escaping the initializer would propagate into the application's pipeline creation call
+	static const bool dump_path_created = [&dump_path]() {
+		std::error_code ec;
+		return std::filesystem::create_directory(dump_path, ec) || std::filesystem::is_directory(dump_path, ec);
+	}();
+	if (!dump_path_created)
+		return;
+
+#if RESHADE_ADDON_SHADER_HASH_XXHASH64
+	const uint64_t shader_hash = reshade::compute_xxhash64(static_cast<const uint8_t *>(desc.code), desc.code_size);
+
+	wchar_t hash_string[19];
+	swprintf_s(hash_string, L"0x%016llX", shader_hash);
+#else
+	const uint32_t shader_hash = compute_crc32(static_cast<const uint8_t *>(desc.code), desc.code_size);
 
 	wchar_t hash_string[11];
 	swprintf_s(hash_string, L"0x%08X", shader_hash);
+#endif
 
 	dump_path /= hash_string;
 	dump_path += extension;
@@ -4,8 +4,10 @@
  */
 
 #include <reshade.hpp>
+#include <reshade_xxhash64.hpp>
 #include "config.hpp"
 #include "crc32_hash.hpp"
+#include "directory_index.hpp"
 #include <fstream>
 #include <filesystem>
 
@@ -13,13 +15,24 @@ using namespace reshade::api;
 
 static thread_local std::vector<std::vector<uint8_t>> s_data_to_delete;
 
+static directory_index &get_replace_directory()
+{
+	// Index the directory once and only update it when its contents change, instead of querying the file system for every shader
+	static directory_index index([]() {
+		// Load shader binaries from a directory next to the executable
+		wchar_t file_prefix[MAX_PATH] = L"";
+		GetModuleFileNameW(nullptr, file_prefix, ARRAYSIZE(file_prefix));
+
+		return std::filesystem::path(file_prefix).parent_path() / RESHADE_ADDON_SHADER_LOAD_DIR;
+	}());
+	return index;
+}
+
 static bool load_shader_code(device_api device_type, shader_desc &desc, std::vector<std::vector<uint8_t>> &data_to_delete)
 {
 	if (desc.code_size == 0)
 		return false;
 
-	uint32_t shader_hash = compute_crc32(static_cast<const uint8_t *>(desc.code), desc.code_size);
-
 	const wchar_t *extension = L".cso";
 	if (device_type == device_api::vulkan || (
 		device_type == device_api::opengl && desc.code_size > sizeof(uint32_t) && *static_cast<const uint32_t *>(desc.code) == 0x07230203 /* SPIR-V magic */))
@@ -27,24 +40,28 @@ static bool load_shader_code(device_api device_type, shader_desc &desc, std::vec
 	else if (device_type == device_api::opengl)
 		extension = L".glsl"; // OpenGL otherwise uses plain text GLSL
 
-	// Prepend executable file name to image files
-	wchar_t file_prefix[MAX_PATH] = L"";
-	GetModuleFileNameW(nullptr, file_prefix, ARRAYSIZE(file_prefix));
+#if RESHADE_ADDON_SHADER_HASH_XXHASH64
+	const uint64_t shader_hash = reshade::compute_xxhash64(static_cast<const uint8_t *>(desc.code), desc.code_size);
 
-	std::filesystem::path replace_path = file_prefix;
-	replace_path  = replace_path.parent_path();
-	replace_path /= RESHADE_ADDON_SHADER_LOAD_DIR;
+	wchar_t hash_string[19];
+	swprintf_s(hash_string, L"0x%016llX", shader_hash);
+#else
+	const uint32_t shader_hash = compute_crc32(static_cast<const uint8_t *>(desc.code), desc.code_size);
 
 	wchar_t hash_string[11];
 	swprintf_s(hash_string, L"0x%08X", shader_hash);
+#endif
 
-	replace_path /= hash_string;
-	replace_path += extension;
+	std::filesystem::path replace_file_name = hash_string;
+	replace_file_name += extension;
 
 	// Check if a replacement file for this shader hash exists and if so, overwrite the shader code with its contents
-	if (!std::filesystem::exists(replace_path))
+	directory_index &replace_directory = get_replace_directory();
+	if (!replace_directory.contains(replace_file_name))
 		return false;
 
+	const std::filesystem::path replace_path = replace_directory.path() / replace_file_name;
+
 	std::ifstream file(replace_path, std::ios::binary);
 	file.seekg(0, std::ios::end);
 	std::vector<uint8_t> shader_code(static_cast<size_t>(file.tellg()));
@@ -5,11 +5,120 @@
 
 #include <reshade.hpp>
 #include "config.hpp"
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
 
 using namespace reshade::api;
 
 // See implementation in 'utils\save_texture_image.cpp'
-extern bool save_texture_image(const resource_desc &desc, const subresource_data &data);
+extern uint32_t compute_texture_hash(const resource_desc &desc, const subresource_data &data);
+extern bool mark_texture_hash_saved(uint32_t hash);
+extern bool save_texture_image(const resource_desc &desc, const subresource_data &data, uint32_t hash);
+
+// Converting and encoding textures is slow, so do it on a pool of background threads, to avoid stalling the application while it is uploading textures (e.g. during loading screens)
+struct texture_save_task
+{
+	resource_desc desc;
+	uint32_t hash;
+	uint32_t row_pitch;
+	uint32_t slice_pitch;
+	std::vector<uint8_t> data;
+};
+
+static std::mutex s_save_queue_mutex;
+static std::condition_variable s_save_queue_condition;
+static std::deque<texture_save_task> s_save_queue;
+// Size of texture data that is queued or currently being saved
+static size_t s_save_queue_size = 0;
+static size_t s_num_skipped_textures = 0;
+static bool s_save_threads_exit = false;
+static std::vector<std::thread> s_save_threads;
+
+static void save_texture_thread_main()
+{
+	while (true)
+	{
+		texture_save_task task;
+		{
+			std::unique_lock<std::mutex> lock(s_save_queue_mutex);
+			s_save_queue_condition.wait(lock, []() { return !s_save_queue.empty() || s_save_threads_exit; });
+
+			// Finish saving all queued textures before exiting
+			if (s_save_queue.empty())
+				break;
+
+			task = std::move(s_save_queue.front());
+			s_save_queue.pop_front();
+		}
+
+		subresource_data data;
+		data.data = task.data.data();
+		data.row_pitch = task.row_pitch;
+		data.slice_pitch = task.slice_pitch;
+
+		save_texture_image(task.desc, data, task.hash);
+
+		const std::unique_lock<std::mutex> lock(s_save_queue_mutex);
+		s_save_queue_size -= task.data.size();
+	}
+}
+
+static void queue_texture_image(const resource_desc &desc, const subresource_data &data)
+{
+	const size_t size = format_slice_pitch(desc.texture.format, data.row_pitch, desc.texture.height);
+	if (size == 0)
+		return;
+
+	// Hash the texture data before copying it, so that textures that were already saved can be filtered out without taking up space in the queue
+	const uint32_t hash = compute_texture_hash(desc, data);
+
+	{
+		const std::unique_lock<std::mutex> lock(s_save_queue_mutex);
+
+		if (s_save_threads_exit)
+			return;
+
+		// Skip textures instead of waiting for the background threads when there is already too much data queued up
+		if (s_save_queue_size + size > RESHADE_ADDON_TEXTURE_SAVE_MAX_QUEUE_SIZE)
+		{
+			if (s_num_skipped_textures++ == 0)
+				reshade::log_message(reshade::log_level::warning, "Skipped saving textures because the background save queue is full.");
+			return;
+		}
+
+		// Only remember the texture as saved once it is actually queued, so that it can still be saved on a later upload if it was skipped above
+		if (!mark_texture_hash_saved(hash))
+			return;
+
+		s_save_queue_size += size;
+
+		if (s_save_threads.empty())
+		{
+			const unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+			for (unsigned int i = 0; i < num_threads; ++i)
+				s_save_threads.emplace_back(&save_texture_thread_main);
+		}
+	}
+
+	// Copy data outside the lock, since the source memory is only valid for the duration of the event callback
+	texture_save_task task;
+	task.desc = desc;
+	task.hash = hash;
+	task.row_pitch = data.row_pitch;
+	task.slice_pitch = data.slice_pitch;
+	task.data.assign(static_cast<const uint8_t *>(data.data), static_cast<const uint8_t *>(data.data) + size);
+
+	{
+		const std::unique_lock<std::mutex> lock(s_save_queue_mutex);
+		s_save_queue.push_back(std::move(task));
+	}
+
+	s_save_queue_condition.notify_one();
+}
 
 // There are multiple different ways textures can be initialized, so try and intercept them all
 // - Via initial data provided during texture creation (e.g. for immutable textures, common in D3D11 and OpenGL): See 'on_init_texture' implementation below
@@ -48,7 +157,7 @@ static void on_init_texture(device *device, const resource_desc &desc, const sub
 	if (initial_data == nullptr || !filter_texture(device, desc, nullptr))
 		return;
 
-	save_texture_image(desc, *initial_data);
+	queue_texture_image(desc, *initial_data);
 }
 static bool on_update_texture(device *device, const subresource_data &data, resource dst, uint32_t dst_subresource, const subresource_box *dst_box)
 {
@@ -59,7 +168,7 @@ static bool on_update_texture(device *device, const subresource_data &data, reso
 	if (!filter_texture(device, dst_desc, dst_box))
 		return false;
 
-	save_texture_image(dst_desc, data);
+	queue_texture_image(dst_desc, data);
 
 	return false;
 }
@@ -90,7 +199,7 @@ static bool on_copy_buffer_to_texture(command_list *cmd_list, resource src, uint
 			mapped_data.row_pitch = (mapped_data.row_pitch + 255) & ~255;
 		mapped_data.slice_pitch = format_slice_pitch(dst_desc.texture.format, mapped_data.row_pitch, slice_height != 0 ? slice_height : dst_desc.texture.height);
 
-		save_texture_image(dst_desc, mapped_data);
+		queue_texture_image(dst_desc, mapped_data);
 
 		device->unmap_buffer_region(src);
 	}
@@ -125,29 +234,39 @@ static void on_unmap_texture(device *, resource resource, uint32_t subresource)
 
 	s_current_mapping.res = { 0 };
 
-	save_texture_image(s_current_mapping.desc, s_current_mapping.data);
+	queue_texture_image(s_current_mapping.desc, s_current_mapping.data);
 }
 
 extern "C" __declspec(dllexport) const char *NAME = "Texture Dump";
 extern "C" __declspec(dllexport) const char *DESCRIPTION = "Example add-on that dumps all textures used by the application to image files on disk (\"" RESHADE_ADDON_TEXTURE_SAVE_DIR "\" directory).";
 
-BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
+// Use 'AddonInit' and 'AddonUninit' instead of 'DllMain', since the background threads cannot be waited on while the loader lock is held
+extern "C" __declspec(dllexport) bool AddonInit(HMODULE addon_module, HMODULE reshade_module)
 {
-	switch (fdwReason)
+	if (!reshade::register_addon(addon_module, reshade_module))
+		return false;
+
+	reshade::register_event<reshade::addon_event::init_resource>(on_init_texture);
+	reshade::register_event<reshade::addon_event::update_texture_region>(on_update_texture);
+	reshade::register_event<reshade::addon_event::copy_buffer_to_texture>(on_copy_buffer_to_texture);
+	reshade::register_event<reshade::addon_event::map_texture_region>(on_map_texture);
+	reshade::register_event<reshade::addon_event::unmap_texture_region>(on_unmap_texture);
+
+	return true;
+}
+extern "C" __declspec(dllexport) void AddonUninit(HMODULE addon_module, HMODULE reshade_module)
+{
+	// Wait for all queued textures to be saved before unregistering, so that no background thread is still using the add-on when it is unloaded (events arriving in the meantime are ignored because of the exit flag)
 	{
-	case DLL_PROCESS_ATTACH:
-		if (!reshade::register_addon(hModule))
-			return FALSE;
-		reshade::register_event<reshade::addon_event::init_resource>(on_init_texture);
-		reshade::register_event<reshade::addon_event::update_texture_region>(on_update_texture);
-		reshade::register_event<reshade::addon_event::copy_buffer_to_texture>(on_copy_buffer_to_texture);
-		reshade::register_event<reshade::addon_event::map_texture_region>(on_map_texture);
-		reshade::register_event<reshade::addon_event::unmap_texture_region>(on_unmap_texture);
-		break;
-	case DLL_PROCESS_DETACH:
-		reshade::unregister_addon(hModule);
-		break;
+		const std::unique_lock<std::mutex> lock(s_save_queue_mutex);
+		s_save_threads_exit = true;
 	}
 
-	return TRUE;
+	s_save_queue_condition.notify_all();
+
+	for (std::thread &thread : s_save_threads)
+		thread.join();
+	s_save_threads.clear();
+
+	reshade::unregister_addon(addon_module, reshade_module);
 }
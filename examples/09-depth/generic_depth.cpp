@@ -5,6 +5,7 @@
 
 #include <imgui.h>
 #include <reshade.hpp>
+#include "generic_depth_stats.hpp"
 #include <cmath>
 #include <cstring>
 #include <algorithm>
@@ -23,34 +24,6 @@ static unsigned int s_preserve_depth_buffers = 0;
 // Enable or disable the aspect ratio check from 'check_aspect_ratio' in the detection heuristic
 static unsigned int s_use_aspect_ratio_heuristics = 1;
 
-enum class clear_op
-{
-	clear_depth_stencil_view,
-	fullscreen_draw,
-	unbind_depth_stencil_view,
-};
-
-struct draw_stats
-{
-	uint32_t vertices = 0;
-	uint32_t drawcalls = 0;
-	uint32_t drawcalls_indirect = 0;
-	viewport last_viewport = {};
-};
-struct clear_stats : public draw_stats
-{
-	clear_op clear_op = clear_op::clear_depth_stencil_view;
-	bool copied_during_frame = false;
-};
-
-struct depth_stencil_frame_stats
-{
-	draw_stats total_stats;
-	draw_stats current_stats; // Stats since last clear operation
-	std::vector<clear_stats> clears;
-	bool copied_during_frame = false;
-};
-
 struct resource_hash
 {
 	inline size_t operator()(resource value) const
@@ -65,20 +38,23 @@ struct __declspec(uuid("43319e83-387c-448e-881c-7e68fc2e52c4")) state_tracking
 	const bool is_queue;
 	viewport current_viewport = {};
 	resource current_depth_stencil = { 0 };
-	std::unordered_map<resource, depth_stencil_frame_stats, resource_hash> counters_per_used_depth_stencil;
+	depth_stencil_stats_list counters_per_used_depth_stencil;
+	// Index of the statistics of the current depth-stencil in the list above, so that draw calls do not have to search the list
+	size_t current_counters_index = depth_stencil_stats_list::npos;
 	bool first_draw_since_bind = true;
 	draw_stats best_copy_stats;
 
 	state_tracking(bool is_queue) : is_queue(is_queue)
 	{
-		// Reserve some space upfront to avoid rehashing during command recording
-		counters_per_used_depth_stencil.reserve(32);
+		// Reserve some space upfront to avoid reallocating during command recording
+		counters_per_used_depth_stencil.reserve(16);
 	}
 
 	void reset()
 	{
 		best_copy_stats = { 0, 0 };
 		counters_per_used_depth_stencil.clear();
+		current_counters_index = depth_stencil_stats_list::npos;
 		current_depth_stencil = { 0 };
 	}
 	void reset_on_present()
@@ -86,6 +62,26 @@ struct __declspec(uuid("43319e83-387c-448e-881c-7e68fc2e52c4")) state_tracking
 		assert(is_queue);
 		best_copy_stats = { 0, 0 };
 		counters_per_used_depth_stencil.clear();
+		current_counters_index = depth_stencil_stats_list::npos;
+	}
+
+	const depth_stencil_frame_stats *find_counters(resource depth_stencil) const
+	{
+		return counters_per_used_depth_stencil.find(depth_stencil);
+	}
+	depth_stencil_frame_stats &get_counters(resource depth_stencil)
+	{
+		return counters_per_used_depth_stencil[counters_per_used_depth_stencil.find_or_add(depth_stencil)];
+	}
+	depth_stencil_frame_stats &get_current_counters()
+	{
+		assert(current_depth_stencil != 0);
+
+		// Adding entries for other depth-stencils may have shifted the cached index, so verify it still refers to the current depth-stencil
+		if (current_counters_index >= counters_per_used_depth_stencil.size() || counters_per_used_depth_stencil.key(current_counters_index) != current_depth_stencil)
+			current_counters_index = counters_per_used_depth_stencil.find_or_add(current_depth_stencil);
+
+		return counters_per_used_depth_stencil[current_counters_index];
 	}
 
 	void merge(const state_tracking &source)
@@ -96,24 +92,8 @@ struct __declspec(uuid("43319e83-387c-448e-881c-7e68fc2e52c4")) state_tracking
 		if (source.best_copy_stats.vertices >= best_copy_stats.vertices)
 			best_copy_stats = source.best_copy_stats;
 
-		if (source.counters_per_used_depth_stencil.empty())
-			return;
-
-		counters_per_used_depth_stencil.reserve(source.counters_per_used_depth_stencil.size());
-		for (const auto &[depth_stencil_handle, source_counters] : source.counters_per_used_depth_stencil)
-		{
-			depth_stencil_frame_stats &counters = counters_per_used_depth_stencil[depth_stencil_handle];
-			counters.total_stats.vertices += source_counters.total_stats.vertices;
-			counters.total_stats.drawcalls += source_counters.total_stats.drawcalls;
-			counters.total_stats.drawcalls_indirect += source_counters.total_stats.drawcalls_indirect;
-			counters.current_stats.vertices += source_counters.current_stats.vertices;
-			counters.current_stats.drawcalls += source_counters.current_stats.drawcalls;
-			counters.current_stats.drawcalls_indirect += source_counters.current_stats.drawcalls_indirect;
-
-			counters.clears.insert(counters.clears.end(), source_counters.clears.begin(), source_counters.clears.end());
-
-			counters.copied_during_frame |= source_counters.copied_during_frame;
-		}
+		// Merge all statistics at once, rather than updating shared state on every draw call
+		counters_per_used_depth_stencil.merge(source.counters_per_used_depth_stencil);
 	}
 };
 
@@ -314,7 +294,7 @@ static void on_clear_depth_impl(command_list *cmd_list, state_tracking &state, r
 		lock.lock();
 
 	bool do_copy = true;
-	depth_stencil_frame_stats &counters = state.counters_per_used_depth_stencil[depth_stencil];
+	depth_stencil_frame_stats &counters = state.get_counters(depth_stencil);
 
 	// Ignore clears when there was no meaningful workload (e.g. at the start of a frame)
 	// Don't do this in Vulkan, to handle common case of DXVK flushing its immediate command buffer and thus resetting its stats during the frame
@@ -591,7 +571,7 @@ static bool on_draw(command_list *cmd_list, uint32_t vertices, uint32_t instance
 
 	state.first_draw_since_bind = false;
 
-	depth_stencil_frame_stats &counters = state.counters_per_used_depth_stencil[state.current_depth_stencil];
+	depth_stencil_frame_stats &counters = state.get_current_counters();
 	counters.total_stats.vertices += vertices * instances;
 	counters.total_stats.drawcalls += 1;
 	counters.current_stats.vertices += vertices * instances;
@@ -623,7 +603,7 @@ static bool on_draw_indirect(command_list *cmd_list, indirect_command type, reso
 	if (state.is_queue)
 		lock.lock();
 
-	depth_stencil_frame_stats &counters = state.counters_per_used_depth_stencil[state.current_depth_stencil];
+	depth_stencil_frame_stats &counters = state.get_current_counters();
 	counters.total_stats.drawcalls += draw_count;
 	counters.total_stats.drawcalls_indirect += draw_count;
 	counters.current_stats.drawcalls += draw_count;
@@ -757,7 +737,7 @@ static void on_present(command_queue *, swapchain *swapchain, const rect *, cons
 		return;
 
 	// Also skip update when there has been very little activity (special case for emulators like PCSX2 which may present more often than they render a frame)
-	if (queue_state.counters_per_used_depth_stencil.size() == 1 && queue_state.counters_per_used_depth_stencil.begin()->second.total_stats.drawcalls <= 8)
+	if (queue_state.counters_per_used_depth_stencil.size() == 1 && queue_state.counters_per_used_depth_stencil.front().second.total_stats.drawcalls <= 8)
 		return;
 
 	device_data.frame_index++;
@@ -767,7 +747,7 @@ static void on_present(command_queue *, swapchain *swapchain, const rect *, cons
 		depth_stencil_resource &info = it->second;
 		info.last_counters = depth_stencil_frame_stats {}; // Clear previous frame statistics
 
-		if (queue_state.counters_per_used_depth_stencil.find(it->first) == queue_state.counters_per_used_depth_stencil.end() && device_data.frame_index > (info.last_used_in_frame + 30))
+		if (queue_state.find_counters(it->first) == nullptr && device_data.frame_index > (info.last_used_in_frame + 30))
 		{
 			// Remove from list when not used for a couple of frames (e.g. because the resource was actually destroyed since)
 			it = device_data.depth_stencil_resources.erase(it);
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2021 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <reshade_api_pipeline.hpp>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+enum class clear_op
+{
+	clear_depth_stencil_view,
+	fullscreen_draw,
+	unbind_depth_stencil_view,
+};
+
+struct draw_stats
+{
+	uint32_t vertices = 0;
+	uint32_t drawcalls = 0;
+	uint32_t drawcalls_indirect = 0;
+	reshade::api::viewport last_viewport = {};
+};
+struct clear_stats : public draw_stats
+{
+	::clear_op clear_op = clear_op::clear_depth_stencil_view;
+	bool copied_during_frame = false;
+};
+
+struct depth_stencil_frame_stats
+{
+	draw_stats total_stats;
+	draw_stats current_stats; // Stats since last clear operation
+	std::vector<clear_stats> clears;
+	bool copied_during_frame = false;
+
+	void merge(const depth_stencil_frame_stats &source)
+	{
+		total_stats.vertices += source.total_stats.vertices;
+		total_stats.drawcalls += source.total_stats.drawcalls;
+		total_stats.drawcalls_indirect += source.total_stats.drawcalls_indirect;
+		current_stats.vertices += source.current_stats.vertices;
+		current_stats.drawcalls += source.current_stats.drawcalls;
+		current_stats.drawcalls_indirect += source.current_stats.drawcalls_indirect;
+
+		clears.insert(clears.end(), source.clears.begin(), source.clears.end());
+
+		copied_during_frame |= source.copied_during_frame;
+	}
+};
+
+/// <summary>
+/// Flat list of statistics per depth-stencil resource, kept sorted by resource handle.
+/// Only a handful of depth-stencils are used per command list, so this is cheaper than a hash map, while still allowing to search and merge lists without comparing every pair of entries.
+/// </summary>
+class depth_stencil_stats_list
+{
+public:
+	using value_type = std::pair<reshade::api::resource, depth_stencil_frame_stats>;
+
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+	bool empty() const { return _entries.empty(); }
+	size_t size() const { return _entries.size(); }
+
+	auto begin() const { return _entries.cbegin(); }
+	auto end() const { return _entries.cend(); }
+	const value_type &front() const { return _entries.front(); }
+
+	void clear() { _entries.clear(); }
+	void reserve(size_t capacity) { _entries.reserve(capacity); }
+
+	reshade::api::resource key(size_t index) const { return _entries[index].first; }
+	depth_stencil_frame_stats &operator[](size_t index) { return _entries[index].second; }
+
+	/// <summary>
+	/// Finds the statistics for the specified <paramref name="depth_stencil"/> resource.
+	/// </summary>
+	/// <returns>Pointer to the statistics, or <see langword="nullptr"/> if the resource is not in the list.</returns>
+	const depth_stencil_frame_stats *find(reshade::api::resource depth_stencil) const
+	{
+		const auto it = lower_bound(depth_stencil);
+		if (it == _entries.end() || it->first != depth_stencil)
+			return nullptr;
+		return &it->second;
+	}
+
+	/// <summary>
+	/// Gets the index of the statistics for the specified <paramref name="depth_stencil"/> resource, adding an empty entry if it is not in the list yet.
+	/// Adding an entry shifts the index of all entries with a larger resource handle.
+	/// </summary>
+	size_t find_or_add(reshade::api::resource depth_stencil)
+	{
+		auto it = lower_bound(depth_stencil);
+		if (it == _entries.end() || it->first != depth_stencil)
+			it = _entries.emplace(it, depth_stencil, depth_stencil_frame_stats {});
+		return static_cast<size_t>(it - _entries.begin());
+	}
+
+	/// <summary>
+	/// Adds all statistics from the <paramref name="source"/> list to this list, in a single pass over both sorted lists.
+	/// </summary>
+	void merge(const depth_stencil_stats_list &source)
+	{
+		const size_t num_existing_entries = _entries.size();
+
+		// Merge statistics of depth-stencils that are in both lists in place and append the others
+		size_t index = 0;
+		for (const value_type &source_entry : source._entries)
+		{
+			while (index < num_existing_entries && _entries[index].first.handle < source_entry.first.handle)
+				++index;
+
+			if (index < num_existing_entries && _entries[index].first == source_entry.first)
+				_entries[index].second.merge(source_entry.second);
+			else
+				_entries.push_back(source_entry);
+		}
+
+		// Appended entries are sorted already, so only need to merge the two sorted ranges
+		if (_entries.size() != num_existing_entries)
+			std::inplace_merge(_entries.begin(), _entries.begin() + num_existing_entries, _entries.end(),
+				[](const value_type &lhs, const value_type &rhs) { return lhs.first.handle < rhs.first.handle; });
+	}
+
+private:
+	std::vector<value_type>::iterator lower_bound(reshade::api::resource depth_stencil)
+	{
+		return std::lower_bound(_entries.begin(), _entries.end(), depth_stencil.handle,
+			[](const value_type &entry, uint64_t handle) { return entry.first.handle < handle; });
+	}
+	std::vector<value_type>::const_iterator lower_bound(reshade::api::resource depth_stencil) const
+	{
+		return std::lower_bound(_entries.cbegin(), _entries.cend(), depth_stencil.handle,
+			[](const value_type &entry, uint64_t handle) { return entry.first.handle < handle; });
+	}
+
+	std::vector<value_type> _entries;
+};
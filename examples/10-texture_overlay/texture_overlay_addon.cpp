@@ -209,9 +209,11 @@ static void on_bind_descriptor_tables(command_list *cmd_list, shader_stage stage
 	auto &descriptor_data = device->get_private_data<descriptor_tracking>();
 	assert((&descriptor_data) != nullptr);
 
+	std::vector<descriptor_range> ranges;
+
 	for (uint32_t i = 0; i < count; ++i)
 	{
-		const pipeline_layout_param param = descriptor_data.get_pipeline_layout_param(layout, first + i);
+		const pipeline_layout_param param = descriptor_data.get_pipeline_layout_param(layout, first + i, ranges);
 		assert(param.type == pipeline_layout_param_type::descriptor_table);
 
 		for (uint32_t k = 0; k < param.descriptor_table.count; ++k)
@@ -5,6 +5,7 @@
 
 #include <reshade.hpp>
 #include <chrono>
+#include <cstring>
 
 extern "C" {
 #include <libavutil/hwcontext.h>
@@ -18,7 +19,13 @@ struct __declspec(uuid("0d7525f9-c4e1-426e-bc99-15bbd5fd51f2")) video_capture
 	AVFormatContext *output_ctx = nullptr;
 	AVFrame *frame = nullptr;
 
-	reshade::api::resource host_resource;
+	// Frames are copied into one of multiple host resources in a round-robin fashion and only read back a few frames later, once the copy has finished on the GPU
+	reshade::api::resource host_resources[3] = {};
+	uint64_t host_resource_fence_values[3] = {};
+	std::chrono::system_clock::time_point host_resource_times[3];
+	size_t next_host_resource = 0;
+	reshade::api::fence copy_fence = {};
+	uint64_t copy_fence_value = 0;
 
 	std::chrono::system_clock::time_point last_time;
 	std::chrono::system_clock::time_point start_time;
@@ -27,6 +34,8 @@ struct __declspec(uuid("0d7525f9-c4e1-426e-bc99-15bbd5fd51f2")) video_capture
 	void destroy_codec_ctx();
 	bool init_format_ctx(const char *filename);
 	void destroy_format_ctx();
+	bool init_host_resources(reshade::api::device *device, reshade::api::resource_desc desc);
+	void destroy_host_resources(reshade::api::device *device);
 };
 
 bool video_capture::init_codec_ctx(const reshade::api::resource_desc &buffer_desc)
@@ -174,6 +183,44 @@ void video_capture::destroy_format_ctx()
 	}
 }
 
+bool video_capture::init_host_resources(reshade::api::device *device, reshade::api::resource_desc desc)
+{
+	desc.type = reshade::api::resource_type::texture_2d;
+	desc.heap = reshade::api::memory_heap::gpu_to_cpu;
+	desc.usage = reshade::api::resource_usage::copy_dest;
+	desc.flags = reshade::api::resource_flags::none;
+
+	for (reshade::api::resource &host_resource : host_resources)
+	{
+		if (!device->create_resource(desc, nullptr, reshade::api::resource_usage::copy_dest, &host_resource))
+		{
+			destroy_host_resources(device);
+			return false;
+		}
+	}
+
+	// Without fence support every frame is read back immediately after the copy, which stalls, but still works
+	if (!device->create_fence(0, reshade::api::fence_flags::none, &copy_fence))
+		copy_fence = { 0 };
+	copy_fence_value = 0;
+
+	return true;
+}
+void video_capture::destroy_host_resources(reshade::api::device *device)
+{
+	for (size_t i = 0; i < std::size(host_resources); ++i)
+	{
+		device->destroy_resource(host_resources[i]);
+		host_resources[i] = { 0 };
+		host_resource_fence_values[i] = 0;
+	}
+
+	next_host_resource = 0;
+
+	device->destroy_fence(copy_fence);
+	copy_fence = { 0 };
+}
+
 static void encode_frame(AVCodecContext *enc, AVFormatContext *s, AVFrame *frame, int stream_index = 0)
 {
 	if (int err = avcodec_send_frame(enc, frame); err < 0)
@@ -195,6 +242,58 @@ static void encode_frame(AVCodecContext *enc, AVFormatContext *s, AVFrame *frame
 	}
 }
 
+static void encode_host_resource(video_capture &data, reshade::api::device *device, size_t index)
+{
+	data.host_resource_fence_values[index] = 0;
+
+	if (av_frame_make_writable(data.frame) < 0)
+		return;
+
+	reshade::api::subresource_data host_data;
+	if (!device->map_texture_region(data.host_resources[index], 0, nullptr, reshade::api::map_access::read_only, &host_data))
+		return;
+
+	for (int y = 0; y < data.codec_ctx->height; ++y)
+	{
+		// Host and frame data are both 32 bits per pixel, with the codec pixel format chosen to match the channel order, so can copy whole rows at once
+		std::memcpy(
+			data.frame->data[0] + y * data.frame->linesize[0],
+			static_cast<const uint8_t *>(host_data.data) + y * host_data.row_pitch,
+			static_cast<size_t>(data.codec_ctx->width) * 4);
+	}
+
+	device->unmap_texture_region(data.host_resources[index], 0);
+
+	data.frame->pts = av_rescale_q(
+		std::chrono::duration_cast<std::chrono::milliseconds>(data.host_resource_times[index] - data.start_time).count(),
+		AVRational { std::milli::num, std::milli::den },
+		data.codec_ctx->time_base);
+
+	encode_frame(data.codec_ctx, data.output_ctx, data.frame);
+}
+static void encode_finished_frames(video_capture &data, reshade::api::device *device, bool wait)
+{
+	// Go from oldest to newest copy, since they complete in submission order
+	for (size_t i = 0; i < std::size(data.host_resources); ++i)
+	{
+		const size_t index = (data.next_host_resource + i) % std::size(data.host_resources);
+
+		const uint64_t fence_value = data.host_resource_fence_values[index];
+		if (fence_value == 0)
+			continue;
+
+		if (device->get_completed_fence_value(data.copy_fence) < fence_value)
+		{
+			if (!wait)
+				break;
+
+			device->wait(data.copy_fence, fence_value);
+		}
+
+		encode_host_resource(data, device, index);
+	}
+}
+
 static void on_init(reshade::api::effect_runtime *runtime)
 {
 	runtime->create_private_data<video_capture>();
@@ -203,12 +302,15 @@ static void on_destroy(reshade::api::effect_runtime *runtime)
 {
 	video_capture &data = runtime->get_private_data<video_capture>();
 
-	if (data.host_resource != 0)
-		runtime->get_device()->destroy_resource(data.host_resource);
-
 	// Flush the encoder
 	if (data.output_ctx != nullptr)
+	{
+		encode_finished_frames(data, runtime->get_device(), true);
+
 		encode_frame(data.codec_ctx, data.output_ctx, nullptr);
+	}
+
+	data.destroy_host_resources(runtime->get_device());
 
 	data.destroy_format_ctx(); data.destroy_codec_ctx();
 
@@ -229,10 +331,12 @@ static void on_reshade_finish_effects(reshade::api::effect_runtime *runtime, res
 		{
 			reshade::log_message(reshade::log_level::info, "Stopping video recording ...");
 
+			// Encode the frames that are still in flight before flushing the encoder
+			encode_finished_frames(data, device, true);
+
 			runtime->get_command_queue()->wait_idle();
 
-			device->destroy_resource(data.host_resource);
-			data.host_resource = { 0 };
+			data.destroy_host_resources(device);
 
 			// Flush the encoder
 			encode_frame(data.codec_ctx, data.output_ctx, nullptr);
@@ -248,12 +352,7 @@ static void on_reshade_finish_effects(reshade::api::effect_runtime *runtime, res
 			if (!data.init_format_ctx("video.mp4"))
 				return;
 
-			desc.type = reshade::api::resource_type::texture_2d;
-			desc.heap = reshade::api::memory_heap::gpu_to_cpu;
-			desc.usage = reshade::api::resource_usage::copy_dest;
-			desc.flags = reshade::api::resource_flags::none;
-
-			if (device->create_resource(desc, nullptr, reshade::api::resource_usage::copy_dest, &data.host_resource))
+			if (data.init_host_resources(device, desc))
 			{
 				reshade::log_message(reshade::log_level::info, "Starting video recording ...");
 
@@ -269,56 +368,49 @@ static void on_reshade_finish_effects(reshade::api::effect_runtime *runtime, res
 		}
 	}
 
-	if (data.codec_ctx == nullptr || data.output_ctx == nullptr || data.host_resource == 0)
+	if (data.codec_ctx == nullptr || data.output_ctx == nullptr || data.host_resources[0] == 0)
 		return;
 
+	// Encode any frames whose copy has finished executing on the GPU by now, without blocking
+	encode_finished_frames(data, device, false);
+
 	// Only encode a frame every few frames, depending on the set codec framerate
 	const auto time = std::chrono::system_clock::now();
 	if ((time - data.last_time) < (std::chrono::milliseconds(data.codec_ctx->time_base.num * std::milli::den) / data.codec_ctx->time_base.den))
 		return;
 	data.last_time = time;
 
-	// TODO: This is slow/incorrect, because blocking for the frame and copy to finish.
-	// Instead multiple resources should be created and copied into in a round-robin fashion, only the oldest of which is mapped below and copied into the video frame.
-	// See the OBS capture add-on example which does this.
+	// If all host resources are still in use, wait for the oldest copy to finish, so that its host resource can be reused
+	if (data.host_resource_fence_values[data.next_host_resource] != 0)
+	{
+		device->wait(data.copy_fence, data.host_resource_fence_values[data.next_host_resource]);
+		encode_host_resource(data, device, data.next_host_resource);
+	}
+
+	const size_t index = data.next_host_resource;
+	data.next_host_resource = (data.next_host_resource + 1) % std::size(data.host_resources);
+
 	reshade::api::command_list *const cmd_list = runtime->get_command_queue()->get_immediate_command_list();
 	cmd_list->barrier(rtv_resource, reshade::api::resource_usage::render_target, reshade::api::resource_usage::copy_source);
-	cmd_list->copy_texture_region(rtv_resource, 0, nullptr, data.host_resource, 0, nullptr);
+	cmd_list->copy_texture_region(rtv_resource, 0, nullptr, data.host_resources[index], 0, nullptr);
 	cmd_list->barrier(rtv_resource, reshade::api::resource_usage::copy_source, reshade::api::resource_usage::render_target);
 
-	runtime->get_command_queue()->flush_immediate_command_list();
-
-	// Wait for the above copy command to finish executing on the GPU
-	runtime->get_command_queue()->wait_idle();
-
-	if (av_frame_make_writable(data.frame) < 0)
-		return;
-
-	reshade::api::subresource_data host_data;
-	if (!device->map_texture_region(data.host_resource, 0, nullptr, reshade::api::map_access::read_only, &host_data))
-		return;
+	data.host_resource_times[index] = time;
 
-	for (int y = 0; y < data.codec_ctx->height; ++y)
+	// Signaling the fence also flushes the immediate command list
+	if (data.copy_fence != 0 && runtime->get_command_queue()->signal(data.copy_fence, data.copy_fence_value + 1))
 	{
-		for (int x = 0; x < data.codec_ctx->width; ++x)
-		{
-			const size_t host_data_index = y * host_data.row_pitch + x * 4;
-			const size_t frame_data_index = y * data.frame->linesize[0] + x * 4;
-
-			data.frame->data[0][frame_data_index + 0] = static_cast<const uint8_t *>(host_data.data)[host_data_index + 0];
-			data.frame->data[0][frame_data_index + 1] = static_cast<const uint8_t *>(host_data.data)[host_data_index + 1];
-			data.frame->data[0][frame_data_index + 2] = static_cast<const uint8_t *>(host_data.data)[host_data_index + 2];
-		}
+		data.host_resource_fence_values[index] = ++data.copy_fence_value;
 	}
+	else
+	{
+		runtime->get_command_queue()->flush_immediate_command_list();
 
-	device->unmap_texture_region(data.host_resource, 0);
+		// Wait for the above copy command to finish executing on the GPU
+		runtime->get_command_queue()->wait_idle();
 
-	data.frame->pts = av_rescale_q(
-		std::chrono::duration_cast<std::chrono::milliseconds>(time - data.start_time).count(),
-		AVRational { std::milli::num, std::milli::den },
-		data.codec_ctx->time_base);
-
-	encode_frame(data.codec_ctx, data.output_ctx, data.frame);
+		encode_host_resource(data, device, index);
+	}
 }
 
 extern "C" __declspec(dllexport) const char *NAME = "Video Capture";
@@ -9,12 +9,17 @@
 // The subdirectory to load shader binaries from
 #define RESHADE_ADDON_SHADER_LOAD_DIR ".\\shaderreplace"
 
+// Name shader binaries after their 64-bit xxHash instead of their CRC32, which is faster to compute and less likely to collide, but does not match file names from existing dumps
+#define RESHADE_ADDON_SHADER_HASH_XXHASH64 0
+
 // The subdirectory to save textures to
 #define RESHADE_ADDON_TEXTURE_SAVE_DIR ".\\texdump"
 #define RESHADE_ADDON_TEXTURE_SAVE_FORMAT ".png"
 #define RESHADE_ADDON_TEXTURE_SAVE_HASH_TEXMOD 1
 // Skip any textures that were already dumped this session, to reduce lag at the cost of increased memory usage
 #define RESHADE_ADDON_TEXTURE_SAVE_ENABLE_HASH_SET 1
+// Maximum amount of texture data (in bytes) that may be waiting to be saved in the background, any textures beyond that are skipped instead of stalling the application
+#define RESHADE_ADDON_TEXTURE_SAVE_MAX_QUEUE_SIZE (512 * 1024 * 1024)
 
 // The subdirectory to load textures from
 #define RESHADE_ADDON_TEXTURE_LOAD_DIR ".\\texreplace"
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+#pragma once
+
+#include <reshade_api_pipeline.hpp>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// Flat table of all the descriptors in a heap, split into fixed-size pages so that it can grow without moving existing descriptors.
+/// Looking up a descriptor only requires atomic loads, the lock is only taken to allocate new pages.
+/// </summary>
+class descriptor_heap_table
+{
+public:
+	static constexpr uint32_t page_size = 1024;
+
+	/// <summary>
+	/// A single descriptor in the table.
+	/// Applications may update a descriptor on one thread while another thread still looks it up (e.g. to query a stale descriptor of a table that is being recycled), so all fields are atomics that are accessed with relaxed ordering.
+	/// This makes such accesses well-defined at almost no cost, but a reader racing with an update may see the fields of the old and new descriptor mixed.
+	/// </summary>
+	struct slot
+	{
+		std::atomic<reshade::api::descriptor_type> type { reshade::api::descriptor_type::sampler };
+		std::atomic<uint64_t> sampler { 0 };
+		std::atomic<uint64_t> view { 0 };
+
+		reshade::api::descriptor_type load_type() const { return type.load(std::memory_order_relaxed); }
+		reshade::api::sampler load_sampler() const { return { sampler.load(std::memory_order_relaxed) }; }
+		reshade::api::resource_view load_view() const { return { view.load(std::memory_order_relaxed) }; }
+
+		void store(reshade::api::descriptor_type new_type, reshade::api::sampler new_sampler, reshade::api::resource_view new_view)
+		{
+			type.store(new_type, std::memory_order_relaxed);
+			sampler.store(new_sampler.handle, std::memory_order_relaxed);
+			view.store(new_view.handle, std::memory_order_relaxed);
+		}
+		void store_type(reshade::api::descriptor_type new_type)
+		{
+			type.store(new_type, std::memory_order_relaxed);
+		}
+		void copy_from(const slot &source)
+		{
+			store(source.load_type(), source.load_sampler(), source.load_view());
+		}
+		void clear()
+		{
+			store(reshade::api::descriptor_type::sampler, { 0 }, { 0 });
+		}
+	};
+
+	~descriptor_heap_table()
+	{
+		// The most recent directory contains pointers to all pages that were ever allocated
+		if (const page_directory *const directory = _directory.load(std::memory_order_relaxed); directory != nullptr)
+			for (uint32_t i = 0; i < directory->num_pages; ++i)
+				delete[] directory->pages[i].load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Gets a pointer to the specified descriptor, or <see langword="nullptr"/> if no storage was allocated for it yet.
+	/// The returned pointer is valid for the next "page_size - offset % page_size" descriptors.
+	/// </summary>
+	const slot *find(uint32_t offset) const
+	{
+		const uint32_t page_index = offset / page_size;
+
+		if (const page_directory *const directory = _directory.load(std::memory_order_acquire); directory != nullptr && page_index < directory->num_pages)
+			if (const slot *const page = directory->pages[page_index].load(std::memory_order_acquire); page != nullptr)
+				return page + (offset % page_size);
+
+		return nullptr;
+	}
+	/// <summary>
+	/// Gets a pointer to the specified descriptor, allocating storage for it if necessary.
+	/// The returned pointer is valid for the next "page_size - offset % page_size" descriptors.
+	/// </summary>
+	slot *get_or_create(uint32_t offset)
+	{
+		const uint32_t page_index = offset / page_size;
+
+		if (const page_directory *const directory = _directory.load(std::memory_order_acquire); directory != nullptr && page_index < directory->num_pages)
+			if (slot *const page = directory->pages[page_index].load(std::memory_order_acquire); page != nullptr)
+				return page + (offset % page_size);
+
+		const std::unique_lock<std::mutex> lock(_mutex);
+
+		page_directory *directory = _directory.load(std::memory_order_relaxed);
+		if (directory == nullptr || page_index >= directory->num_pages)
+		{
+			uint32_t num_pages = directory != nullptr ? directory->num_pages : 1;
+			while (num_pages <= page_index)
+				num_pages *= 2;
+
+			auto new_directory = std::make_unique<page_directory>();
+			new_directory->num_pages = num_pages;
+			new_directory->pages = std::make_unique<std::atomic<slot *>[]>(num_pages);
+			for (uint32_t i = 0; i < num_pages; ++i)
+				new_directory->pages[i].store(directory != nullptr && i < directory->num_pages ? directory->pages[i].load(std::memory_order_relaxed) : nullptr, std::memory_order_relaxed);
+
+			directory = new_directory.get();
+			_directories.push_back(std::move(new_directory));
+			_directory.store(directory, std::memory_order_release);
+		}
+
+		// Another thread may have allocated the page while waiting for the lock
+		slot *page = directory->pages[page_index].load(std::memory_order_relaxed);
+		if (page == nullptr)
+		{
+			page = new slot[page_size];
+			directory->pages[page_index].store(page, std::memory_order_release);
+		}
+
+		return page + (offset % page_size);
+	}
+
+private:
+	struct page_directory
+	{
+		uint32_t num_pages;
+		std::unique_ptr<std::atomic<slot *>[]> pages;
+	};
+
+	std::mutex _mutex;
+	std::atomic<page_directory *> _directory = nullptr;
+	// Previous directories are kept alive, since other threads may still be reading them (they only hold pointers to pages, so this is cheap)
+	std::vector<std::unique_ptr<page_directory>> _directories;
+};
@@ -5,48 +5,83 @@
 
 #include "reshade.hpp"
 #include "descriptor_tracking.hpp"
+#include <algorithm>
 
 using namespace reshade::api;
 
-sampler descriptor_tracking::get_sampler(descriptor_heap heap, uint32_t offset) const
+auto descriptor_tracking::find_heap(descriptor_heap heap) const -> const descriptor_heap_table *
 {
-	const descriptor_heap_data &heap_data = heaps.at(heap);
+	const std::shared_lock<std::shared_mutex> lock(heaps_mutex);
 
-	if (offset < heap_data.descriptors.size())
-	{
-		const std::pair<descriptor_type, sampler_with_resource_view> &descriptor = heap_data.descriptors[offset];
+	if (const auto it = heaps.find(heap.handle); it != heaps.end())
+		return it->second.get();
+	return nullptr;
+}
+auto descriptor_tracking::get_or_create_heap(descriptor_heap heap) -> descriptor_heap_table &
+{
+	{ const std::shared_lock<std::shared_mutex> lock(heaps_mutex);
 
-		if (descriptor.first == descriptor_type::sampler || descriptor.first == descriptor_type::sampler_with_resource_view)
-			return descriptor.second.sampler;
+		if (const auto it = heaps.find(heap.handle); it != heaps.end())
+			return *it->second;
+	}
+
+	const std::unique_lock<std::shared_mutex> lock(heaps_mutex);
+
+	std::unique_ptr<descriptor_heap_table> &heap_data = heaps[heap.handle];
+	if (heap_data == nullptr)
+		heap_data = std::make_unique<descriptor_heap_table>();
+	return *heap_data;
+}
+
+sampler descriptor_tracking::get_sampler(descriptor_heap heap, uint32_t offset) const
+{
+	if (const descriptor_heap_table *const heap_data = find_heap(heap))
+	{
+		if (const descriptor_heap_table::slot *const descriptor = heap_data->find(offset))
+		{
+			if (const descriptor_type type = descriptor->load_type();
+				type == descriptor_type::sampler || type == descriptor_type::sampler_with_resource_view)
+				return descriptor->load_sampler();
+		}
 	}
 
 	return { 0 };
 }
 resource_view descriptor_tracking::get_shader_resource_view(descriptor_heap heap, uint32_t offset) const
 {
-	const descriptor_heap_data &heap_data = heaps.at(heap);
-
-	if (offset < heap_data.descriptors.size())
+	if (const descriptor_heap_table *const heap_data = find_heap(heap))
 	{
-		const std::pair<descriptor_type, sampler_with_resource_view> &descriptor = heap_data.descriptors[offset];
-
-		if (descriptor.first == descriptor_type::shader_resource_view || descriptor.first == descriptor_type::sampler_with_resource_view)
-			return descriptor.second.view;
+		if (const descriptor_heap_table::slot *const descriptor = heap_data->find(offset))
+		{
+			if (const descriptor_type type = descriptor->load_type();
+				type == descriptor_type::shader_resource_view || type == descriptor_type::sampler_with_resource_view)
+				return descriptor->load_view();
+		}
 	}
 
 	return { 0 };
 }
 
-pipeline_layout_param descriptor_tracking::get_pipeline_layout_param(pipeline_layout layout, uint32_t param) const
+pipeline_layout_param descriptor_tracking::get_pipeline_layout_param(pipeline_layout layout, uint32_t param, std::vector<descriptor_range> &ranges) const
 {
-	const pipeline_layout_data &layout_data = layouts.at(layout);
+	const std::shared_lock<std::shared_mutex> lock(layouts_mutex);
+
+	const pipeline_layout_data &layout_data = layouts.at(layout.handle);
 
-	return layout_data.params[param];
+	pipeline_layout_param result = layout_data.params[param];
+	if (result.type == pipeline_layout_param_type::descriptor_table)
+	{
+		ranges.assign(layout_data.ranges[param].begin(), layout_data.ranges[param].end());
+		result.descriptor_table.ranges = ranges.data();
+	}
+
+	return result;
 }
 
 void descriptor_tracking::register_pipeline_layout(pipeline_layout layout, uint32_t count, const pipeline_layout_param *params)
 {
-	pipeline_layout_data &layout_data = layouts[layout];
+	// Build the layout data before inserting it, so that readers never see it partially initialized
+	pipeline_layout_data layout_data;
 	layout_data.params.assign(params, params + count);
 	layout_data.ranges.resize(count);
 
@@ -58,12 +93,17 @@ void descriptor_tracking::register_pipeline_layout(pipeline_layout layout, uint3
 			layout_data.params[i].descriptor_table.ranges = layout_data.ranges[i].data();
 		}
 	}
+
+	const std::unique_lock<std::shared_mutex> lock(layouts_mutex);
+
+	// Moving the vectors keeps the range pointers in the parameters valid
+	layouts[layout.handle] = std::move(layout_data);
 }
 void descriptor_tracking::unregister_pipeline_layout(pipeline_layout layout)
 {
-	pipeline_layout_data &layout_data = layouts[layout];
-	layout_data.params.clear();
-	layout_data.ranges.clear();
+	const std::unique_lock<std::shared_mutex> lock(layouts_mutex);
+
+	layouts.erase(layout.handle);
 }
 
 static void on_init_device(device *device)
@@ -102,15 +142,44 @@ bool descriptor_tracking::on_copy_descriptor_tables(device *device, uint32_t cou
 		descriptor_heap dst_heap;
 		device->get_descriptor_heap_offset(copy.dest_table, copy.dest_binding, copy.dest_array_offset, &dst_heap, &dst_offset);
 
-		descriptor_heap_data &src_pool_data = ctx.heaps[src_heap];
-		descriptor_heap_data &dst_pool_data = ctx.heaps[dst_heap];
+		const descriptor_heap_table *const src_heap_data = ctx.find_heap(src_heap);
+		descriptor_heap_table &dst_heap_data = ctx.get_or_create_heap(dst_heap);
 
-		if (dst_offset + copy.count > dst_pool_data.descriptors.size())
-			dst_pool_data.descriptors.grow_to_at_least(dst_offset + copy.count);
+		// Source and destination ranges may overlap within the same heap, in which case descriptors have to be copied back to front if the destination comes after the source (like with 'memmove')
+		const bool backwards = src_heap == dst_heap && dst_offset > src_offset;
 
-		for (uint32_t k = 0; k < copy.count; ++k)
+		// Copy runs of descriptors at once, split wherever either the source or destination crosses a page boundary
+		for (uint32_t k = 0, run; k < copy.count; k += run)
 		{
-			dst_pool_data.descriptors[dst_offset + k] = src_pool_data.descriptors[src_offset + k];
+			uint32_t first;
+			if (backwards)
+			{
+				const uint32_t end = copy.count - k;
+				run = std::min(end, std::min((src_offset + end - 1) % descriptor_heap_table::page_size + 1, (dst_offset + end - 1) % descriptor_heap_table::page_size + 1));
+				first = end - run;
+			}
+			else
+			{
+				first = k;
+				run = std::min(copy.count - k, std::min(descriptor_heap_table::page_size - (src_offset + k) % descriptor_heap_table::page_size, descriptor_heap_table::page_size - (dst_offset + k) % descriptor_heap_table::page_size));
+			}
+
+			descriptor_heap_table::slot *const dst_descriptors = dst_heap_data.get_or_create(dst_offset + first);
+
+			if (const descriptor_heap_table::slot *const src_descriptors = src_heap_data != nullptr ? src_heap_data->find(src_offset + first) : nullptr)
+			{
+				if (backwards)
+					for (uint32_t j = run; j-- > 0;)
+						dst_descriptors[j].copy_from(src_descriptors[j]);
+				else
+					for (uint32_t j = 0; j < run; ++j)
+						dst_descriptors[j].copy_from(src_descriptors[j]);
+			}
+			else
+			{
+				for (uint32_t j = 0; j < run; ++j)
+					dst_descriptors[j].clear();
+			}
 		}
 	}
 
@@ -129,28 +198,32 @@ bool descriptor_tracking::on_update_descriptor_tables(device *device, uint32_t c
 		descriptor_heap heap;
 		device->get_descriptor_heap_offset(update.table, update.binding, update.array_offset, &heap, &offset);
 
-		descriptor_heap_data &heap_data = ctx.heaps[heap];
+		descriptor_heap_table &heap_data = ctx.get_or_create_heap(heap);
 
-		if (offset + update.count > heap_data.descriptors.size())
-			heap_data.descriptors.grow_to_at_least(offset + update.count);
-
-		for (uint32_t k = 0; k < update.count; ++k)
+		for (uint32_t k = 0, run; k < update.count; k += run)
 		{
-			std::pair<descriptor_type, sampler_with_resource_view> &descriptor = heap_data.descriptors[offset + k];
+			run = std::min(update.count - k, descriptor_heap_table::page_size - (offset + k) % descriptor_heap_table::page_size);
 
-			descriptor.first = update.type;
+			descriptor_heap_table::slot *const descriptors = heap_data.get_or_create(offset + k);
 
 			switch (update.type)
 			{
 			case descriptor_type::sampler:
-				descriptor.second.sampler = static_cast<const sampler *>(update.descriptors)[k];
+				for (uint32_t j = 0; j < run; ++j)
+					descriptors[j].store(update.type, static_cast<const sampler *>(update.descriptors)[k + j], { 0 });
 				break;
 			case descriptor_type::sampler_with_resource_view:
-				descriptor.second = static_cast<const sampler_with_resource_view *>(update.descriptors)[k];
+				for (uint32_t j = 0; j < run; ++j)
+					descriptors[j].store(update.type, static_cast<const sampler_with_resource_view *>(update.descriptors)[k + j].sampler, static_cast<const sampler_with_resource_view *>(update.descriptors)[k + j].view);
 				break;
 			case descriptor_type::shader_resource_view:
 			case descriptor_type::unordered_access_view:
-				descriptor.second.view = static_cast<const resource_view *>(update.descriptors)[k];
+				for (uint32_t j = 0; j < run; ++j)
+					descriptors[j].store(update.type, { 0 }, static_cast<const resource_view *>(update.descriptors)[k + j]);
+				break;
+			default:
+				for (uint32_t j = 0; j < run; ++j)
+					descriptors[j].store_type(update.type);
 				break;
 			}
 		}
@@ -5,9 +5,11 @@
 
 #pragma once
 
+#include "descriptor_heap_table.hpp"
+#include <memory>
 #include <vector>
-#include <concurrent_vector.h>
-#include <concurrent_unordered_map.h>
+#include <shared_mutex>
+#include <unordered_map>
 
 /// <summary>
 /// An instance of this is automatically created for all devices and can be queried with <c>device->get_private_data&lt;descriptor_tracking&gt;()</c> (assuming descriptor tracking was registered via <see cref="descriptor_tracking::register_events"/>).
@@ -35,8 +37,9 @@ public:
 
 	/// <summary>
 	/// Gets the description that was used to create the specified pipeline layout parameter.
+	/// The pipeline layout may be destroyed concurrently, so the descriptor ranges of a descriptor table parameter are copied into <paramref name="ranges"/>, which the returned description points into.
 	/// </summary>
-	reshade::api::pipeline_layout_param get_pipeline_layout_param(reshade::api::pipeline_layout layout, uint32_t param) const;
+	reshade::api::pipeline_layout_param get_pipeline_layout_param(reshade::api::pipeline_layout layout, uint32_t param, std::vector<reshade::api::descriptor_range> &ranges) const;
 
 private:
 	void register_pipeline_layout(reshade::api::pipeline_layout layout, uint32_t count, const reshade::api::pipeline_layout_param *params);
@@ -48,31 +51,19 @@ private:
 	static bool on_copy_descriptor_tables(reshade::api::device *device, uint32_t count, const reshade::api::descriptor_table_copy *copies);
 	static bool on_update_descriptor_tables(reshade::api::device *device, uint32_t count, const reshade::api::descriptor_table_update *updates);
 
-	struct descriptor_heap_data
-	{
-		concurrency::concurrent_vector<std::pair<reshade::api::descriptor_type, reshade::api::sampler_with_resource_view>> descriptors;
-	};
-	struct descriptor_heap_hash : std::hash<uint64_t>
-	{
-		size_t operator()(reshade::api::descriptor_heap handle) const
-		{
-			return std::hash<uint64_t>::operator()(handle.handle);
-		}
-	};
-
 	struct pipeline_layout_data
 	{
 		std::vector<reshade::api::pipeline_layout_param> params;
 		std::vector<std::vector<reshade::api::descriptor_range>> ranges;
 	};
-	struct pipeline_layout_hash : std::hash<uint64_t>
-	{
-		size_t operator()(reshade::api::pipeline_layout handle) const
-		{
-			return std::hash<uint64_t>::operator()(handle.handle);
-		}
-	};
 
-	concurrency::concurrent_unordered_map<reshade::api::descriptor_heap, descriptor_heap_data, descriptor_heap_hash> heaps;
-	concurrency::concurrent_unordered_map<reshade::api::pipeline_layout, pipeline_layout_data, pipeline_layout_hash> layouts;
+	const descriptor_heap_table *find_heap(reshade::api::descriptor_heap heap) const;
+	descriptor_heap_table &get_or_create_heap(reshade::api::descriptor_heap heap);
+
+	// Heap data is never destroyed before the device is, so references to it stay valid after releasing the lock
+	mutable std::shared_mutex heaps_mutex;
+	std::unordered_map<uint64_t, std::unique_ptr<descriptor_heap_table>> heaps;
+	// Layout data is destroyed together with the pipeline layout, so readers have to copy what they need out of it before releasing the lock
+	mutable std::shared_mutex layouts_mutex;
+	std::unordered_map<uint64_t, pipeline_layout_data> layouts;
 };
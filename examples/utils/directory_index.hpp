@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <filesystem>
+#include <shared_mutex>
+#include <unordered_set>
+#include <Windows.h>
+
+/// <summary>
+/// Set of the names of all files in a directory, which is built on first use and rebuilt whenever the directory contents change.
+/// This makes checking whether a file exists a hash table lookup, instead of a file system query.
+/// </summary>
+class directory_index
+{
+public:
+	explicit directory_index(std::filesystem::path path) : _path(std::move(path)) {}
+	~directory_index()
+	{
+		if (const HANDLE change_notification = _change_notification.load(); change_notification != INVALID_HANDLE_VALUE)
+			FindCloseChangeNotification(change_notification);
+	}
+
+	directory_index(const directory_index &) = delete;
+	directory_index &operator=(const directory_index &) = delete;
+
+	const std::filesystem::path &path() const { return _path; }
+
+	/// <summary>
+	/// Checks whether a file with the specified name (case-insensitive) exists in the directory.
+	/// </summary>
+	bool contains(const std::filesystem::path &file_name)
+	{
+		update();
+
+		const std::shared_lock<std::shared_mutex> lock(_mutex);
+		return _file_names.find(normalize(file_name.native())) != _file_names.end();
+	}
+
+private:
+	static std::wstring normalize(std::wstring file_name)
+	{
+		for (wchar_t &c : file_name)
+			c = towlower(c);
+		return file_name;
+	}
+
+	void update()
+	{
+		if (_initialized.load(std::memory_order_acquire))
+		{
+			if (const HANDLE change_notification = _change_notification.load(std::memory_order_acquire); change_notification != INVALID_HANDLE_VALUE)
+			{
+				// Polling the change notification is much cheaper than querying the file system for every lookup
+				if (WaitForSingleObject(change_notification, 0) != WAIT_OBJECT_0)
+					return;
+			}
+			else
+			{
+				// Directory did not exist when the index was built, so check again from time to time whether it was created since
+				if (GetTickCount64() - _last_rebuild_time.load(std::memory_order_relaxed) < 1000)
+					return;
+			}
+		}
+
+		const std::unique_lock<std::shared_mutex> lock(_mutex);
+
+		if (const HANDLE change_notification = _change_notification.load(std::memory_order_relaxed); change_notification != INVALID_HANDLE_VALUE)
+		{
+			// Another thread may have rebuilt the index already
+			if (_initialized.load(std::memory_order_relaxed) && WaitForSingleObject(change_notification, 0) != WAIT_OBJECT_0)
+				return;
+
+			FindNextChangeNotification(change_notification);
+		}
+		else
+		{
+			_change_notification.store(FindFirstChangeNotificationW(_path.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE), std::memory_order_release);
+		}
+
+		_file_names.clear();
+
+		std::error_code ec;
+		for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(_path, std::filesystem::directory_options::skip_permission_denied, ec))
+			if (entry.is_regular_file(ec))
+				_file_names.insert(normalize(entry.path().filename().native()));
+
+		_last_rebuild_time.store(GetTickCount64(), std::memory_order_relaxed);
+		_initialized.store(true, std::memory_order_release);
+	}
+
+	const std::filesystem::path _path;
+	std::shared_mutex _mutex;
+	std::unordered_set<std::wstring> _file_names;
+	std::atomic<HANDLE> _change_notification = INVALID_HANDLE_VALUE;
+	std::atomic<bool> _initialized = false;
+	std::atomic<ULONGLONG> _last_rebuild_time = 0;
+};
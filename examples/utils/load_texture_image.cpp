@@ -8,12 +8,26 @@
 #include <reshade.hpp>
 #include "config.hpp"
 #include "crc32_hash.hpp"
+#include "directory_index.hpp"
 #include <vector>
 #include <filesystem>
 #include <stb_image.h>
 
 using namespace reshade::api;
 
+static directory_index &get_replace_directory()
+{
+	// Index the directory once and only update it when its contents change, instead of querying the file system for every texture
+	static directory_index index([]() {
+		// Prepend executable directory to image files
+		wchar_t file_prefix[MAX_PATH] = L"";
+		GetModuleFileNameW(nullptr, file_prefix, ARRAYSIZE(file_prefix));
+
+		return std::filesystem::path(file_prefix).parent_path() / RESHADE_ADDON_TEXTURE_LOAD_DIR;
+	}());
+	return index;
+}
+
 bool load_texture_image(const resource_desc &desc, subresource_data &data, std::vector<std::vector<uint8_t>> &data_to_delete)
 {
 #if RESHADE_ADDON_TEXTURE_LOAD_HASH_TEXMOD
@@ -31,24 +45,19 @@ bool load_texture_image(const resource_desc &desc, subresource_data &data, std::
 		format_slice_pitch(desc.texture.format, data.row_pitch, desc.texture.height));
 #endif
 
-	// Prepend executable directory to image files
-	wchar_t file_prefix[MAX_PATH] = L"";
-	GetModuleFileNameW(nullptr, file_prefix, ARRAYSIZE(file_prefix));
-
-	std::filesystem::path replace_path = file_prefix;
-	replace_path  = replace_path.parent_path();
-	replace_path /= RESHADE_ADDON_TEXTURE_LOAD_DIR;
-
 	wchar_t hash_string[11];
 	swprintf_s(hash_string, L"0x%08X", hash);
 
-	replace_path /= hash_string;
-	replace_path += RESHADE_ADDON_TEXTURE_LOAD_FORMAT;
+	std::filesystem::path replace_file_name = hash_string;
+	replace_file_name += RESHADE_ADDON_TEXTURE_LOAD_FORMAT;
 
 	// Check if a replacement file for this texture hash exists and if so, overwrite the texture data with its contents
-	if (!std::filesystem::exists(replace_path))
+	directory_index &replace_directory = get_replace_directory();
+	if (!replace_directory.contains(replace_file_name))
 		return false;
 
+	const std::filesystem::path replace_path = replace_directory.path() / replace_file_name;
+
 	int width = 0, height = 0, channels = 0;
 	stbi_uc *const rgba_pixel_data_p = stbi_load(replace_path.u8string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
 	if (rgba_pixel_data_p == nullptr)
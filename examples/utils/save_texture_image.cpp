@@ -9,11 +9,14 @@
 #include "config.hpp"
 #include "crc32_hash.hpp"
 #include <vector>
+#include <fstream>
 #include <filesystem>
+#include <fpng.h>
 #include <stb_image_write.h>
 
 #if RESHADE_ADDON_TEXTURE_SAVE_ENABLE_HASH_SET
 #include <set>
+#include <mutex>
 #endif
 
 using namespace reshade::api;
@@ -87,7 +90,7 @@ static void unpack_bc4_value(uint8_t alpha_0, uint8_t alpha_1, uint32_t alpha_in
 	}
 }
 
-bool save_texture_image(const resource_desc &desc, const subresource_data &data)
+uint32_t compute_texture_hash(const resource_desc &desc, const subresource_data &data)
 {
 #if RESHADE_ADDON_TEXTURE_SAVE_HASH_TEXMOD
 	// Behavior of the original TexMod (see https://github.com/codemasher/texmod/blob/master/uMod_DX9/uMod_TextureFunction.cpp#L41)
@@ -104,19 +107,25 @@ bool save_texture_image(const resource_desc &desc, const subresource_data &data)
 		format_slice_pitch(desc.texture.format, data.row_pitch, desc.texture.height));
 #endif
 
+	return hash;
+}
+
+bool mark_texture_hash_saved(uint32_t hash)
+{
 #if RESHADE_ADDON_TEXTURE_SAVE_ENABLE_HASH_SET
+	// May be called from multiple threads at once
+	static std::mutex hash_set_mutex;
 	static std::set<uint32_t> hash_set;
-	if (hash_set.find(hash) != hash_set.end())
-	{
-		reshade::log_message(reshade::log_level::error, "Skipped texture that was already dumped.");
-		return true;
-	}
-	else
-	{
-		hash_set.insert(hash);
-	}
+	const std::unique_lock<std::mutex> lock(hash_set_mutex);
+	return hash_set.insert(hash).second;
+#else
+	(void)hash;
+	return true;
 #endif
+}
 
+bool save_texture_image(const resource_desc &desc, const subresource_data &data, uint32_t hash)
+{
 	const uint32_t block_count_x = (desc.texture.width + 3) / 4;
 	const uint32_t block_count_y = (desc.texture.height + 3) / 4;
 
@@ -412,8 +421,9 @@ bool save_texture_image(const resource_desc &desc, const subresource_data &data)
 	dump_path  = dump_path.parent_path();
 	dump_path /= RESHADE_ADDON_TEXTURE_SAVE_DIR;
 
-	if (std::filesystem::exists(dump_path) == false)
-		std::filesystem::create_directory(dump_path);
+	// Use the non-throwing overload, since this may be called on a background thread
+	std::error_code ec;
+	std::filesystem::create_directory(dump_path, ec);
 
 	wchar_t hash_string[11];
 	swprintf_s(hash_string, L"0x%08X", hash);
@@ -424,7 +434,32 @@ bool save_texture_image(const resource_desc &desc, const subresource_data &data)
 	if (dump_path.extension() == L".bmp")
 		return stbi_write_bmp(dump_path.u8string().c_str(), desc.texture.width, desc.texture.height, 4, rgba_pixel_data.data()) != 0;
 	else if (dump_path.extension() == L".png")
-		return stbi_write_png(dump_path.u8string().c_str(), desc.texture.width, desc.texture.height, 4, rgba_pixel_data.data(), desc.texture.width * 4) != 0;
+	{
+		// fpng encodes several times faster than stb_image_write
+		static const bool fpng_initialized = (fpng::fpng_init(), true);
+		(void)fpng_initialized;
+
+		std::vector<uint8_t> encoded_data;
+		if (!fpng::fpng_encode_image_to_memory(rgba_pixel_data.data(), desc.texture.width, desc.texture.height, 4, encoded_data))
+			return false;
+
+		std::ofstream file(dump_path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char *>(encoded_data.data()), encoded_data.size());
+		return file.good();
+	}
 	else
 		return false;
 }
+
+bool save_texture_image(const resource_desc &desc, const subresource_data &data)
+{
+	const uint32_t hash = compute_texture_hash(desc, data);
+
+	if (!mark_texture_hash_saved(hash))
+	{
+		reshade::log_message(reshade::log_level::error, "Skipped texture that was already dumped.");
+		return true;
+	}
+
+	return save_texture_image(desc, data, hash);
+}
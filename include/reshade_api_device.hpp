@@ -619,6 +619,22 @@ namespace reshade { namespace api
 		/// <param name="out_handles">Pointer to the first element of an array (with elements of the size reported by <see cref="device_properties::shader_group_handle_size"/>) that is filled with the handles.</param>
 		/// <returns><see langword="true"/> if the shader group handles were successfully retrieved, <see langword="false"/> otherwise.</returns>
 		virtual bool get_pipeline_shader_group_handles(pipeline pipeline, uint32_t first, uint32_t count, void *out_handles) = 0;
+
+		/// <summary>
+		/// Gets the contents of the pipeline cache of this device, which holds the compiled shader code of pipelines created through <see cref="create_pipeline"/>.
+		/// This can be stored on disk and passed to <see cref="merge_pipeline_cache_data"/> again on a later run, to speed up pipeline creation.
+		/// </summary>
+		/// <param name="size">Pointer to a variable that is set to the size of the data in bytes. When <paramref name="data"/> is not <see langword="nullptr"/>, it has to be set to the size of that buffer beforehand.</param>
+		/// <param name="data">Optional pointer to a buffer that is filled with the data.</param>
+		/// <returns><see langword="true"/> if the data was retrieved, <see langword="false"/> if the device does not have a pipeline cache or the buffer was too small.</returns>
+		virtual bool get_pipeline_cache_data(size_t *size, void *data) = 0;
+		/// <summary>
+		/// Adds the pipelines in data previously retrieved via <see cref="get_pipeline_cache_data"/> to the pipeline cache of this device.
+		/// </summary>
+		/// <param name="size">Size of the data in bytes.</param>
+		/// <param name="data">Pointer to the data.</param>
+		/// <returns><see langword="true"/> if the data was added, <see langword="false"/> if the device does not have a pipeline cache or the data was created by a different device or driver.</returns>
+		virtual bool merge_pipeline_cache_data(size_t size, const void *data) = 0;
 	};
 
 	/// <summary>
@@ -500,7 +500,7 @@ namespace reshade { namespace api
 		/// <summary>
 		/// Format of the element data.
 		/// </summary>
-		format format = format::unknown;
+		api::format format = format::unknown;
 		/// <summary>
 		/// Index of the vertex buffer binding.
 		/// </summary>
@@ -590,7 +590,7 @@ namespace reshade { namespace api
 		/// Logical operation for each render target. Ignored if <see cref="logic_op_enable"/> is <see langword="false"/>.
 		/// </summary>
 		/// <seealso cref="device_caps::logic_op"/>
-		logic_op logic_op[8] = { logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop };
+		api::logic_op logic_op[8] = { logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop, logic_op::noop };
 		/// <summary>
 		/// A write mask specifying which color components are written to each render target. Bitwise combination of <c>0x1</c> for red, <c>0x2</c> for green, <c>0x4</c> for blue and <c>0x8</c> for alpha.
 		/// </summary>
@@ -606,11 +606,11 @@ namespace reshade { namespace api
 		/// Fill mode to use when rendering triangles.
 		/// </summary>
 		/// <seealso cref="device_caps::fill_mode_non_solid"/>
-		fill_mode fill_mode = fill_mode::solid;
+		api::fill_mode fill_mode = fill_mode::solid;
 		/// <summary>
 		/// Triangles facing the specified direction are not drawn.
 		/// </summary>
-		cull_mode cull_mode = cull_mode::back;
+		api::cull_mode cull_mode = cull_mode::back;
 		/// <summary>
 		/// Determines if a triangle is front or back-facing.
 		/// </summary>
@@ -1003,7 +1003,7 @@ namespace reshade { namespace api
 		/// <summary>
 		/// Sampler to sampler the shader resource view with.
 		/// </summary>
-		sampler sampler = { 0 };
+		api::sampler sampler = { 0 };
 		/// <summary>
 		/// Shader resource view.
 		/// </summary>
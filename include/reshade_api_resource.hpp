@@ -114,7 +114,7 @@ namespace reshade { namespace api
 		/// <summary>
 		/// Comparison function to use to compare sampled data against existing sampled data.
 		/// </summary>
-		compare_op compare_op = compare_op::never;
+		api::compare_op compare_op = compare_op::never;
 		/// <summary>
 		/// RGBA value to return for texture coordinates outside 0 to 1 range when addressing mode is <see cref="texture_address_mode::border"/>.
 		/// </summary>
@@ -237,9 +237,9 @@ namespace reshade { namespace api
 		constexpr resource_desc() : texture() {}
 		constexpr resource_desc(uint64_t size, memory_heap heap, resource_usage usage) :
 			type(resource_type::buffer), buffer({ size }), heap(heap), usage(usage) {}
-		constexpr resource_desc(uint32_t width, uint32_t height, uint16_t layers, uint16_t levels, format format, uint16_t samples, memory_heap heap, resource_usage usage, resource_flags flags = resource_flags::none) :
+		constexpr resource_desc(uint32_t width, uint32_t height, uint16_t layers, uint16_t levels, api::format format, uint16_t samples, memory_heap heap, resource_usage usage, resource_flags flags = resource_flags::none) :
 			type(resource_type::texture_2d), texture({ width, height, layers, levels, format, samples }), heap(heap), usage(usage), flags(flags) {}
-		constexpr resource_desc(resource_type type, uint32_t width, uint32_t height, uint16_t depth_or_layers, uint16_t levels, format format, uint16_t samples, memory_heap heap, resource_usage usage, resource_flags flags = resource_flags::none) :
+		constexpr resource_desc(resource_type type, uint32_t width, uint32_t height, uint16_t depth_or_layers, uint16_t levels, api::format format, uint16_t samples, memory_heap heap, resource_usage usage, resource_flags flags = resource_flags::none) :
 			type(type), texture({ width, height, depth_or_layers, levels, format, samples }), heap(heap), usage(usage), flags(flags) {}
 
 		/// <summary>
@@ -289,7 +289,7 @@ namespace reshade { namespace api
 				/// <summary>
 				/// Data format of each texel in the texture.
 				/// </summary>
-				format   format = format::unknown;
+				api::format format = format::unknown;
 				/// <summary>
 				/// The number of samples per texel. Set to a value higher than 1 for multisampling.
 				/// </summary>
@@ -344,15 +344,15 @@ namespace reshade { namespace api
 	struct [[nodiscard]] resource_view_desc
 	{
 		constexpr resource_view_desc() : texture() {}
-		constexpr resource_view_desc(format format, uint64_t offset, uint64_t size) :
+		constexpr resource_view_desc(api::format format, uint64_t offset, uint64_t size) :
 			type(resource_view_type::buffer), format(format), buffer({ offset, size }) {}
-		constexpr resource_view_desc(format format, uint32_t first_level, uint32_t levels, uint32_t first_layer, uint32_t layers) :
+		constexpr resource_view_desc(api::format format, uint32_t first_level, uint32_t levels, uint32_t first_layer, uint32_t layers) :
 			type(resource_view_type::texture_2d), format(format), texture({ first_level, levels, first_layer, layers }) {}
-		constexpr resource_view_desc(resource_view_type type, format format, uint64_t offset, uint64_t size) :
+		constexpr resource_view_desc(resource_view_type type, api::format format, uint64_t offset, uint64_t size) :
 			type(type), format(format), buffer({ offset, size }) {}
-		constexpr resource_view_desc(resource_view_type type, format format, uint32_t first_level, uint32_t levels, uint32_t first_layer, uint32_t layers) :
+		constexpr resource_view_desc(resource_view_type type, api::format format, uint32_t first_level, uint32_t levels, uint32_t first_layer, uint32_t layers) :
 			type(type), format(format), texture({ first_level, levels, first_layer, layers }) {}
-		constexpr explicit resource_view_desc(format format) : type(resource_view_type::texture_2d), format(format), texture({ 0, 1, 0, 1 }) {}
+		constexpr explicit resource_view_desc(api::format format) : type(resource_view_type::texture_2d), format(format), texture({ 0, 1, 0, 1 }) {}
 
 		/// <summary>
 		/// Resource type the view should interpret the resource data to.
@@ -361,7 +361,7 @@ namespace reshade { namespace api
 		/// <summary>
 		/// Format the view should reinterpret the resource data to (can be different than the format of the resource as long as they are compatible).
 		/// </summary>
-		format format = format::unknown;
+		api::format format = format::unknown;
 
 		union
 		{
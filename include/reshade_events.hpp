@@ -1662,11 +1662,79 @@ namespace reshade
 		/// </remarks>
 		reshade_overlay_technique,
 
+		/// <summary>
+		/// Called with all draw, descriptor table and push constant commands recorded into a command list since the last time this event was called for it, before:
+		/// <list type="bullet">
+		/// <item><description>the command list is submitted to a command queue (see <see cref="addon_event::execute_command_list"/>)</description></item>
+		/// <item><description>the command list is executed from another command list, or a D3D11 deferred context is finished into one (see <see cref="addon_event::execute_secondary_command_list"/>)</description></item>
+		/// <item><description>the immediate command list of a command queue is presented (see <see cref="addon_event::present"/>)</description></item>
+		/// <item><description>the number of recorded commands exceeds an internal limit</description></item>
+		/// </list>
+		/// Recorded commands are discarded when a command list is reset or destroyed.
+		/// <para>Callback function signature: <c>void (api::command_list *cmd_list, uint32_t count, const api::command_record *records)</c></para>
+		/// </summary>
+		/// <remarks>
+		/// This is an alternative to registering for the <see cref="addon_event::draw"/>, <see cref="addon_event::draw_indexed"/>, <see cref="addon_event::bind_descriptor_tables"/> and <see cref="addon_event::push_constants"/> events, which is much cheaper for applications issuing a large number of commands, but cannot be used to modify or skip them.
+		/// The record array and any data it points to is only valid for the duration of the callback.
+		/// </remarks>
+		command_stream = 93,
+
 #if RESHADE_ADDON
-		max = 93 // Last value used internally by ReShade to determine number of events in this enum
+		max = 94 // Last value used internally by ReShade to determine number of events in this enum
 #endif
 	};
 
+	namespace api
+	{
+		/// <summary>
+		/// A single command passed to the <see cref="addon_event::command_stream"/> event.
+		/// </summary>
+		struct command_record
+		{
+			/// <summary>
+			/// Event this command corresponds to, which determines the active member of the union below.
+			/// This is either <see cref="addon_event::draw"/>, <see cref="addon_event::draw_indexed"/>, <see cref="addon_event::bind_descriptor_tables"/> or <see cref="addon_event::push_constants"/>.
+			/// </summary>
+			addon_event type;
+
+			union
+			{
+				struct
+				{
+					uint32_t vertex_count;
+					uint32_t instance_count;
+					uint32_t first_vertex;
+					uint32_t first_instance;
+				} draw;
+				struct
+				{
+					uint32_t index_count;
+					uint32_t instance_count;
+					uint32_t first_index;
+					int32_t vertex_offset;
+					uint32_t first_instance;
+				} draw_indexed;
+				struct
+				{
+					shader_stage stages;
+					pipeline_layout layout;
+					uint32_t first;
+					uint32_t count;
+					const descriptor_table *tables;
+				} bind_descriptor_tables;
+				struct
+				{
+					shader_stage stages;
+					pipeline_layout layout;
+					uint32_t layout_param;
+					uint32_t first;
+					uint32_t count;
+					const void *values;
+				} push_constants;
+			};
+		};
+	}
+
 	template <addon_event ev>
 	struct addon_event_traits;
 
@@ -1802,4 +1870,6 @@ namespace reshade
 
 	RESHADE_DEFINE_ADDON_EVENT_TRAITS(addon_event::reshade_overlay_uniform_variable, bool, api::effect_runtime *runtime, api::effect_uniform_variable variable);
 	RESHADE_DEFINE_ADDON_EVENT_TRAITS(addon_event::reshade_overlay_technique, bool, api::effect_runtime *runtime, api::effect_technique technique);
+
+	RESHADE_DEFINE_ADDON_EVENT_TRAITS(addon_event::command_stream, void, api::command_list *cmd_list, uint32_t count, const api::command_record *records);
 }
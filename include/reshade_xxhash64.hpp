@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Implementation of the 64-bit xxHash algorithm (XXH64), written from the algorithm description at https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md (xxHash was designed by Yann Collet, this is not the reference implementation)
+// This is several times faster than CRC32 on large inputs and has a much lower chance of collisions, at the cost of producing different hash values
+// It is part of the add-on headers so that add-ons and ReShade itself produce the same hash values
+namespace reshade::xxhash64_internal
+{
+	constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+	constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+	constexpr uint64_t prime3 = 0x165667B19E3779F9ull;
+	constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+	constexpr uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+	inline uint64_t rotl(uint64_t value, int amount)
+	{
+		return (value << amount) | (value >> (64 - amount));
+	}
+	inline uint64_t read64(const uint8_t *data)
+	{
+		uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+	inline uint32_t read32(const uint8_t *data)
+	{
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	inline uint64_t round(uint64_t acc, uint64_t input)
+	{
+		acc += input * prime2;
+		acc = rotl(acc, 31);
+		return acc * prime1;
+	}
+	inline uint64_t merge_round(uint64_t acc, uint64_t value)
+	{
+		acc ^= round(0, value);
+		return acc * prime1 + prime4;
+	}
+}
+
+namespace reshade
+{
+	/// <summary>
+	/// Computes the 64-bit xxHash (XXH64) of the specified data.
+	/// </summary>
+	inline uint64_t compute_xxhash64(const uint8_t *data, size_t size, uint64_t seed = 0)
+	{
+		using namespace xxhash64_internal;
+
+		const uint8_t *const end = data + size;
+
+		uint64_t hash;
+		if (size >= 32)
+		{
+			uint64_t v1 = seed + prime1 + prime2;
+			uint64_t v2 = seed + prime2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - prime1;
+
+			// Process four independent lanes of 8 bytes each per iteration
+			for (const uint8_t *const limit = end - 32; data <= limit; data += 32)
+			{
+				v1 = round(v1, read64(data));
+				v2 = round(v2, read64(data + 8));
+				v3 = round(v3, read64(data + 16));
+				v4 = round(v4, read64(data + 24));
+			}
+
+			hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+			hash = merge_round(hash, v1);
+			hash = merge_round(hash, v2);
+			hash = merge_round(hash, v3);
+			hash = merge_round(hash, v4);
+		}
+		else
+		{
+			hash = seed + prime5;
+		}
+
+		hash += static_cast<uint64_t>(size);
+
+		for (; data + 8 <= end; data += 8)
+		{
+			hash ^= round(0, read64(data));
+			hash = rotl(hash, 27) * prime1 + prime4;
+		}
+		if (data + 4 <= end)
+		{
+			hash ^= static_cast<uint64_t>(read32(data)) * prime1;
+			hash = rotl(hash, 23) * prime2 + prime3;
+			data += 4;
+		}
+		for (; data < end; ++data)
+		{
+			hash ^= (*data) * prime5;
+			hash = rotl(hash, 11) * prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+}
@@ -14,6 +14,7 @@
 #define IDR_IMGUI_VS_SPIRV              110
 #define IDR_MIPMAP_CS                   111
 #define IDB_MAIN_ICON                   112
+#define IDR_RESAMPLE_PS                 113
 #define IDR_LICENSE_GL3W                701
 #define IDR_LICENSE_IMGUI               702
 #define IDR_LICENSE_MINHOOK             703
@@ -30,9 +31,9 @@
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
-#define _APS_NEXT_RESOURCE_VALUE        113
+#define _APS_NEXT_RESOURCE_VALUE        114
 #define _APS_NEXT_COMMAND_VALUE         40001
 #define _APS_NEXT_CONTROL_VALUE         1001
-#define _APS_NEXT_SYMED_VALUE           113
+#define _APS_NEXT_SYMED_VALUE           114
 #endif
 #endif
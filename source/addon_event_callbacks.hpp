@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "reader_tracker.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#if RESHADE_ADDON_EVENT_STATISTICS
+#include <chrono>
+#endif
+
+namespace reshade
+{
+	/// <summary>
+	/// Callbacks registered for a single add-on event.
+	/// </summary>
+	struct alignas(64) addon_event_callbacks
+	{
+		/// <summary>
+		/// Null-terminated array of callbacks, or <see langword="nullptr"/> if no callbacks are registered.
+		/// The array is immutable once published and is replaced as a whole on registration changes, so that it can be iterated without any locking.
+		/// </summary>
+		std::atomic<void *const *> list = nullptr;
+		/// <summary>
+		/// Number of callbacks in the current array.
+		/// </summary>
+		std::atomic<uint32_t> count = 0;
+		/// <summary>
+		/// Tracks threads that are currently iterating the callback array of this event, so that replaced arrays can be destroyed once no thread uses them anymore.
+		/// This is tracked per event, so that frequently invoked events do not hold back destruction of the arrays of all other events.
+		/// </summary>
+		reader_tracker readers;
+#if RESHADE_ADDON_EVENT_STATISTICS
+		/// <summary>
+		/// Number of times this event was invoked with at least one callback registered.
+		/// </summary>
+		std::atomic<uint64_t> num_invocations = 0;
+		/// <summary>
+		/// Accumulated time spent in callbacks for this event, in nanoseconds.
+		/// </summary>
+		std::atomic<uint64_t> total_duration = 0;
+#endif
+
+		/// <summary>
+		/// Calls <paramref name="call"/> with every registered callback, until it returns <see langword="true"/>.
+		/// </summary>
+		/// <returns><see langword="true"/> if any call returned <see langword="true"/>, <see langword="false"/> otherwise.</returns>
+		template <typename F>
+		bool invoke(F &&call)
+		{
+			if (list.load(std::memory_order_relaxed) == nullptr)
+				return false;
+
+			// Keep the callback array alive while iterating it, since registration changes may replace it concurrently
+			const reader_tracker::scope reader(readers);
+			void *const *const event_list = list.load();
+			if (event_list == nullptr)
+				return false;
+#if RESHADE_ADDON_EVENT_STATISTICS
+			const timer timer(*this);
+#endif
+			bool handled = false;
+			for (void *const *cb = event_list; *cb != nullptr && !handled; ++cb)
+				handled = call(*cb);
+			return handled;
+		}
+
+		/// <summary>
+		/// Publishes a new callback array with the specified <paramref name="callback"/> added or removed.
+		/// Calls to this and <see cref="reclaim"/> have to be serialized by the caller.
+		/// </summary>
+		void update(void *callback, bool add)
+		{
+			std::vector<void *> new_callbacks;
+			new_callbacks.reserve(count.load(std::memory_order_relaxed) + 1);
+			if (void *const *const current_list = list.load(std::memory_order_relaxed))
+				for (void *const *cb = current_list; *cb != nullptr; ++cb)
+					new_callbacks.push_back(*cb);
+
+			if (add)
+				new_callbacks.push_back(callback);
+			else
+				new_callbacks.erase(std::remove(new_callbacks.begin(), new_callbacks.end(), callback), new_callbacks.end());
+
+			std::unique_ptr<void *[]> new_list;
+			if (!new_callbacks.empty())
+			{
+				new_list.reset(new void *[new_callbacks.size() + 1]);
+				std::copy(new_callbacks.begin(), new_callbacks.end(), new_list.get());
+				new_list[new_callbacks.size()] = nullptr;
+			}
+
+			// Publish the new array as a whole (sequentially consistent, see 'reader_tracker'), so that concurrent invocations either see the previous or the new list of callbacks
+			count.store(static_cast<uint32_t>(new_callbacks.size()), std::memory_order_relaxed);
+			list.store(new_list.get());
+
+			if (_storage != nullptr)
+				_retired.push_back(std::move(_storage));
+			_storage = std::move(new_list);
+
+			reclaim();
+		}
+		/// <summary>
+		/// Destroys callback arrays that were replaced, once no invocation of this event can still be iterating them.
+		/// </summary>
+		/// <param name="force">Set to <see langword="true"/> to destroy them regardless, when it is known that this event is no longer invoked.</param>
+		void reclaim(bool force = false)
+		{
+			// Invocations that started after the new array was published see it, so once no invocation is in progress, none can still be iterating a replaced one
+			// Registration changes from inside a callback always find the invoking thread itself still reading, in which case reclamation is retried later
+			if (!_retired.empty() && (force || !readers.has_readers()))
+				_retired.clear();
+		}
+
+		/// <summary>
+		/// Gets the number of replaced callback arrays that were not destroyed yet.
+		/// </summary>
+		size_t num_retired() const { return _retired.size(); }
+
+#if RESHADE_ADDON_EVENT_STATISTICS
+		/// <summary>
+		/// Records the time spent in callbacks for an event when it goes out of scope.
+		/// </summary>
+		struct timer
+		{
+			explicit timer(addon_event_callbacks &callbacks) :
+				callbacks(callbacks), start(std::chrono::high_resolution_clock::now()) {}
+			~timer()
+			{
+				callbacks.num_invocations.fetch_add(1, std::memory_order_relaxed);
+				callbacks.total_duration.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count(), std::memory_order_relaxed);
+			}
+
+			addon_event_callbacks &callbacks;
+			const std::chrono::high_resolution_clock::time_point start;
+		};
+#endif
+
+	private:
+		// Owns the current callback array
+		std::unique_ptr<void *[]> _storage;
+		// Callback arrays that were replaced may still be iterated by other threads, so they are only destroyed once no thread is invoking this event anymore
+		std::vector<std::unique_ptr<void *[]>> _retired;
+	};
+}
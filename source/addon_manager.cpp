@@ -9,6 +9,11 @@
 #include "addon_manager.hpp"
 #include "dll_log.hpp"
 #include "ini_file.hpp"
+#include <mutex>
+#include <memory>
+#include <cstring>
+#include <shared_mutex>
+#include <unordered_map>
 
 extern void register_addon_depth();
 extern void unregister_addon_depth();
@@ -17,7 +22,7 @@ extern HMODULE g_module_handle;
 
 extern std::filesystem::path get_module_path(HMODULE module);
 
-#if RESHADE_VERBOSE_LOG
+#if RESHADE_VERBOSE_LOG || RESHADE_ADDON_EVENT_STATISTICS
 static const char *addon_event_to_string(reshade::addon_event ev)
 {
 #define CASE(name) case reshade::addon_event::name: return #name
@@ -113,6 +118,7 @@ static const char *addon_event_to_string(reshade::addon_event ev)
 		CASE(reshade_set_current_preset_path);
 		CASE(reshade_reorder_techniques);
 		CASE(reshade_open_overlay);
+		CASE(command_stream);
 	}
 #undef  CASE
 	return "unknown";
@@ -123,9 +129,36 @@ static const char *addon_event_to_string(reshade::addon_event ev)
 bool reshade::addon_enabled = true;
 #endif
 bool reshade::addon_all_loaded = true;
-std::vector<void *> reshade::addon_event_list[static_cast<uint32_t>(reshade::addon_event::max)];
+reshade::addon_event_callbacks reshade::addon_event_list[static_cast<uint32_t>(reshade::addon_event::max)];
 std::vector<reshade::addon_info> reshade::addon_loaded_info;
 static unsigned long s_reference_count = 0;
+static std::mutex s_event_list_mutex;
+#if RESHADE_ADDON >= 2
+struct command_stream
+{
+	std::vector<reshade::api::command_record> records;
+	// Array data referenced by records, stored in 64-bit units to keep descriptor table handles aligned
+	std::vector<uint64_t> payload;
+};
+
+// Deliver recorded commands early when a command list is not submitted for a long time (e.g. deferred contexts), so that memory usage stays bounded
+static constexpr size_t s_max_command_stream_records = 16384;
+static std::shared_mutex s_command_streams_mutex;
+static std::unordered_map<reshade::api::command_list *, std::unique_ptr<command_stream>> s_command_streams;
+// Incremented whenever a command stream is destroyed, to invalidate the per-thread lookup caches
+static std::atomic<uint32_t> s_command_streams_generation = 0;
+#endif
+
+static void update_event_list(reshade::addon_event ev, void *callback, bool add)
+{
+	const std::unique_lock<std::mutex> lock(s_event_list_mutex);
+
+	reshade::addon_event_list[static_cast<uint32_t>(ev)].update(callback, add);
+
+	// Registration changes from inside a callback always find the invoking thread itself still reading that event, so retry reclamation of all other events here too
+	for (reshade::addon_event_callbacks &callbacks : reshade::addon_event_list)
+		callbacks.reclaim();
+}
 
 void reshade::load_addons()
 {
@@ -269,6 +302,15 @@ void reshade::unload_addons()
 	if (InterlockedDecrement(&s_reference_count) != 0)
 		return;
 
+#if RESHADE_ADDON_EVENT_STATISTICS
+	for (uint32_t ev = 0; ev < static_cast<uint32_t>(addon_event::max); ++ev)
+	{
+		const addon_event_callbacks &callbacks = addon_event_list[ev];
+		if (const uint64_t num_invocations = callbacks.num_invocations.load(std::memory_order_relaxed))
+			LOG(INFO) << "Event " << addon_event_to_string(static_cast<addon_event>(ev)) << " was invoked " << num_invocations << " times with an average duration of " << (callbacks.total_duration.load(std::memory_order_relaxed) / num_invocations) << " ns.";
+	}
+#endif
+
 #if RESHADE_ADDON == 1
 	// There are no add-ons to unload ...
 #else
@@ -303,8 +345,20 @@ void reshade::unload_addons()
 
 #ifndef NDEBUG
 	// All events should have been unregistered at this point
-	for (const std::vector<void *> &event_info : addon_event_list)
-		assert(event_info.empty());
+	for (const addon_event_callbacks &callbacks : addon_event_list)
+		assert(callbacks.list.load() == nullptr);
+#endif
+
+	{ const std::unique_lock<std::mutex> lock(s_event_list_mutex);
+		for (addon_event_callbacks &callbacks : addon_event_list)
+			callbacks.reclaim(true);
+	}
+
+#if RESHADE_ADDON >= 2
+	{ const std::unique_lock<std::shared_mutex> lock(s_command_streams_mutex);
+		s_command_streams.clear();
+		s_command_streams_generation.fetch_add(1, std::memory_order_release);
+	}
 #endif
 
 	addon_loaded_info.clear();
@@ -465,6 +519,144 @@ void ReShadeUnregisterAddon(HMODULE module)
 	reshade::addon_loaded_info.erase(reshade::addon_loaded_info.begin() + (info - reshade::addon_loaded_info.data()));
 }
 
+#if RESHADE_ADDON >= 2
+static command_stream &get_command_stream(reshade::api::command_list *cmd_list)
+{
+	// Command lists are usually recorded on a single thread at a time with many commands in a row, so cache the last lookup
+	thread_local reshade::api::command_list *cached_cmd_list = nullptr;
+	thread_local command_stream *cached_stream = nullptr;
+	thread_local uint32_t cached_generation = 0;
+
+	const uint32_t generation = s_command_streams_generation.load(std::memory_order_acquire);
+	if (cmd_list == cached_cmd_list && generation == cached_generation)
+		return *cached_stream;
+
+	command_stream *stream = nullptr;
+	{ const std::shared_lock<std::shared_mutex> lock(s_command_streams_mutex);
+		if (const auto it = s_command_streams.find(cmd_list); it != s_command_streams.end())
+			stream = it->second.get();
+	}
+	if (stream == nullptr)
+	{
+		const std::unique_lock<std::shared_mutex> lock(s_command_streams_mutex);
+		std::unique_ptr<command_stream> &new_stream = s_command_streams[cmd_list];
+		if (new_stream == nullptr)
+			new_stream = std::make_unique<command_stream>();
+		stream = new_stream.get();
+	}
+
+	cached_cmd_list = cmd_list;
+	cached_stream = stream;
+	cached_generation = generation;
+
+	return *stream;
+}
+
+static uintptr_t append_payload(command_stream &stream, const void *data, size_t size)
+{
+	const uintptr_t offset = stream.payload.size();
+	stream.payload.resize(offset + (size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	if (size != 0)
+		std::memcpy(stream.payload.data() + offset, data, size);
+	return offset;
+}
+
+void reshade::record_draw(api::command_list *cmd_list, uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
+{
+	command_stream &stream = get_command_stream(cmd_list);
+
+	api::command_record &record = stream.records.emplace_back();
+	record.type = addon_event::draw;
+	record.draw = { vertex_count, instance_count, first_vertex, first_instance };
+
+	if (stream.records.size() >= s_max_command_stream_records)
+		flush_command_stream(cmd_list);
+}
+void reshade::record_draw_indexed(api::command_list *cmd_list, uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
+{
+	command_stream &stream = get_command_stream(cmd_list);
+
+	api::command_record &record = stream.records.emplace_back();
+	record.type = addon_event::draw_indexed;
+	record.draw_indexed = { index_count, instance_count, first_index, vertex_offset, first_instance };
+
+	if (stream.records.size() >= s_max_command_stream_records)
+		flush_command_stream(cmd_list);
+}
+void reshade::record_bind_descriptor_tables(api::command_list *cmd_list, api::shader_stage stages, api::pipeline_layout layout, uint32_t first, uint32_t count, const api::descriptor_table *tables)
+{
+	command_stream &stream = get_command_stream(cmd_list);
+
+	// Store offset into the payload array in place of the pointer until the records are delivered, since the payload array may be reallocated until then
+	const uintptr_t offset = append_payload(stream, tables, count * sizeof(api::descriptor_table));
+
+	api::command_record &record = stream.records.emplace_back();
+	record.type = addon_event::bind_descriptor_tables;
+	record.bind_descriptor_tables = { stages, layout, first, count, reinterpret_cast<const api::descriptor_table *>(offset) };
+
+	if (stream.records.size() >= s_max_command_stream_records)
+		flush_command_stream(cmd_list);
+}
+void reshade::record_push_constants(api::command_list *cmd_list, api::shader_stage stages, api::pipeline_layout layout, uint32_t layout_param, uint32_t first, uint32_t count, const void *values)
+{
+	command_stream &stream = get_command_stream(cmd_list);
+
+	const uintptr_t offset = append_payload(stream, values, count * sizeof(uint32_t));
+
+	api::command_record &record = stream.records.emplace_back();
+	record.type = addon_event::push_constants;
+	record.push_constants = { stages, layout, layout_param, first, count, reinterpret_cast<const void *>(offset) };
+
+	if (stream.records.size() >= s_max_command_stream_records)
+		flush_command_stream(cmd_list);
+}
+
+void reshade::flush_command_stream(api::command_list *cmd_list)
+{
+	command_stream &stream = get_command_stream(cmd_list);
+	if (stream.records.empty())
+		return;
+
+	// Resolve payload offsets to pointers now that the payload array no longer changes
+	for (api::command_record &record : stream.records)
+	{
+		switch (record.type)
+		{
+		case addon_event::bind_descriptor_tables:
+			record.bind_descriptor_tables.tables = reinterpret_cast<const api::descriptor_table *>(stream.payload.data() + reinterpret_cast<uintptr_t>(record.bind_descriptor_tables.tables));
+			break;
+		case addon_event::push_constants:
+			record.push_constants.values = stream.payload.data() + reinterpret_cast<uintptr_t>(record.push_constants.values);
+			break;
+		default:
+			break;
+		}
+	}
+
+	addon_event_list[static_cast<uint32_t>(addon_event::command_stream)].invoke([&](void *cb) {
+		reinterpret_cast<addon_event_traits<addon_event::command_stream>::decl>(cb)(cmd_list, static_cast<uint32_t>(stream.records.size()), stream.records.data());
+		return false;
+	});
+
+	stream.records.clear();
+	stream.payload.clear();
+}
+void reshade::discard_command_stream(api::command_list *cmd_list, bool destroy)
+{
+	if (destroy)
+	{
+		const std::unique_lock<std::shared_mutex> lock(s_command_streams_mutex);
+		if (s_command_streams.erase(cmd_list) != 0)
+			s_command_streams_generation.fetch_add(1, std::memory_order_release);
+		return;
+	}
+
+	command_stream &stream = get_command_stream(cmd_list);
+	stream.records.clear();
+	stream.payload.clear();
+}
+#endif
+
 void ReShadeRegisterEvent(reshade::addon_event ev, void *callback)
 {
 	if (ev >= reshade::addon_event::max)
@@ -479,15 +671,14 @@ void ReShadeRegisterEvent(reshade::addon_event ev, void *callback)
 
 #if RESHADE_ADDON == 1
 	// Block all application events when building without add-on loading support
-	if (info->handle != g_module_handle && (ev > reshade::addon_event::destroy_effect_runtime && ev < reshade::addon_event::present))
+	if (info->handle != g_module_handle && ((ev > reshade::addon_event::destroy_effect_runtime && ev < reshade::addon_event::present) || ev == reshade::addon_event::command_stream))
 	{
 		LOG(ERROR) << "Failed to register an event because only limited add-on functionality is available!";
 		return;
 	}
 #endif
 
-	std::vector<void *> &event_list = reshade::addon_event_list[static_cast<uint32_t>(ev)];
-	event_list.push_back(callback);
+	update_event_list(ev, callback, true);
 
 	info->event_callbacks.emplace_back(static_cast<uint32_t>(ev), callback);
 
@@ -505,12 +696,11 @@ void ReShadeUnregisterEvent(reshade::addon_event ev, void *callback)
 		return; // Do not log an error here, since this may be called if an add-on failed to load
 
 #if RESHADE_ADDON == 1
-	if (info->handle != g_module_handle && (ev > reshade::addon_event::destroy_effect_runtime && ev < reshade::addon_event::present))
+	if (info->handle != g_module_handle && ((ev > reshade::addon_event::destroy_effect_runtime && ev < reshade::addon_event::present) || ev == reshade::addon_event::command_stream))
 		return;
 #endif
 
-	std::vector<void *> &event_list = reshade::addon_event_list[static_cast<uint32_t>(ev)];
-	event_list.erase(std::remove(event_list.begin(), event_list.end(), callback), event_list.end());
+	update_event_list(ev, callback, false);
 
 	info->event_callbacks.erase(std::remove(info->event_callbacks.begin(), info->event_callbacks.end(), std::make_pair(static_cast<uint32_t>(ev), callback)), info->event_callbacks.end());
 
@@ -7,6 +7,7 @@
 
 #include "addon.hpp"
 #include "reshade_events.hpp"
+#include "addon_event_callbacks.hpp"
 
 #if RESHADE_ADDON
 
@@ -21,9 +22,9 @@ namespace reshade
 	extern bool addon_all_loaded;
 
 	/// <summary>
-	/// List of add-on event callbacks.
+	/// List of add-on event callbacks, indexed by event.
 	/// </summary>
-	extern std::vector<void *> addon_event_list[];
+	extern addon_event_callbacks addon_event_list[];
 
 	/// <summary>
 	/// List of currently loaded add-ons.
@@ -50,13 +51,83 @@ namespace reshade
 	/// </summary>
 	addon_info *find_addon(void *address);
 
+#if RESHADE_ADDON >= 2
+	/// <summary>
+	/// Checks whether the specified <typeparamref name="ev"/>ent is recorded or flushes recorded commands for the <see cref="addon_event::command_stream"/> event.
+	/// </summary>
+	template <addon_event ev>
+	constexpr bool is_command_stream_event =
+		ev == addon_event::draw ||
+		ev == addon_event::draw_indexed ||
+		ev == addon_event::bind_descriptor_tables ||
+		ev == addon_event::push_constants ||
+		ev == addon_event::reset_command_list ||
+		ev == addon_event::execute_command_list ||
+		ev == addon_event::execute_secondary_command_list ||
+		ev == addon_event::present ||
+		ev == addon_event::destroy_command_list;
+
+	void record_draw(api::command_list *cmd_list, uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance);
+	void record_draw_indexed(api::command_list *cmd_list, uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
+	void record_bind_descriptor_tables(api::command_list *cmd_list, api::shader_stage stages, api::pipeline_layout layout, uint32_t first, uint32_t count, const api::descriptor_table *tables);
+	void record_push_constants(api::command_list *cmd_list, api::shader_stage stages, api::pipeline_layout layout, uint32_t layout_param, uint32_t first, uint32_t count, const void *values);
+
+	/// <summary>
+	/// Invokes the <see cref="addon_event::command_stream"/> event with all commands recorded for the specified command list and then clears them.
+	/// </summary>
+	void flush_command_stream(api::command_list *cmd_list);
+	/// <summary>
+	/// Clears all commands recorded for the specified command list, optionally releasing the associated memory.
+	/// </summary>
+	void discard_command_stream(api::command_list *cmd_list, bool destroy);
+
+	/// <summary>
+	/// Records the arguments of the specified <typeparamref name="ev"/>ent for the <see cref="addon_event::command_stream"/> event, or flushes or discards recorded commands.
+	/// </summary>
+	template <addon_event ev, typename... Args>
+	__forceinline void invoke_command_stream_event(const Args &... args)
+	{
+		if constexpr (ev == addon_event::draw)
+			record_draw(args...);
+		else if constexpr (ev == addon_event::draw_indexed)
+			record_draw_indexed(args...);
+		else if constexpr (ev == addon_event::bind_descriptor_tables)
+			record_bind_descriptor_tables(args...);
+		else if constexpr (ev == addon_event::push_constants)
+			record_push_constants(args...);
+		else if constexpr (ev == addon_event::execute_command_list)
+			[](api::command_queue *, api::command_list *cmd_list) {
+				flush_command_stream(cmd_list);
+			}(args...);
+		else if constexpr (ev == addon_event::execute_secondary_command_list)
+			// Secondary command lists and D3D11 deferred contexts are never submitted to a queue directly, so flush them when they are executed from (or finished into) another command list
+			[](api::command_list *, api::command_list *secondary_cmd_list) {
+				flush_command_stream(secondary_cmd_list);
+			}(args...);
+		else if constexpr (ev == addon_event::present)
+			// Commands on the immediate command list are never submitted explicitly, so flush them when presenting
+			[](api::command_queue *queue, api::swapchain *, const api::rect *, const api::rect *, uint32_t, const api::rect *) {
+				if (api::command_list *const immediate_command_list = queue != nullptr ? queue->get_immediate_command_list() : nullptr)
+					flush_command_stream(immediate_command_list);
+			}(args...);
+		else
+			discard_command_stream(args..., ev == addon_event::destroy_command_list);
+	}
+#endif
+
 	/// <summary>
 	/// Checks whether any callbacks were registered for the specified <paramref name="ev"/>ent.
 	/// </summary>
 	template <addon_event ev>
 	__forceinline bool has_addon_event()
 	{
-		return !addon_event_list[static_cast<uint32_t>(ev)].empty();
+#if RESHADE_ADDON >= 2
+		// Commands have to be recorded for the command stream event even if there are no callbacks for the individual events
+		if constexpr (is_command_stream_event<ev>)
+			if (addon_event_list[static_cast<uint32_t>(addon_event::command_stream)].list.load(std::memory_order_relaxed) != nullptr)
+				return true;
+#endif
+		return addon_event_list[static_cast<uint32_t>(ev)].list.load(std::memory_order_relaxed) != nullptr;
 	}
 
 	/// <summary>
@@ -127,9 +198,15 @@ namespace reshade
 		if (!addon_enabled)
 			return;
 #endif
-		std::vector<void *> &event_list = addon_event_list[static_cast<uint32_t>(ev)];
-		for (size_t cb = 0, count = event_list.size(); cb < count; ++cb) // Generates better code than ranged-based for loop
-			reinterpret_cast<typename addon_event_traits<ev>::decl>(event_list[cb])(std::forward<Args>(args)...);
+#if RESHADE_ADDON >= 2
+		if constexpr (is_command_stream_event<ev>)
+			if (addon_event_list[static_cast<uint32_t>(addon_event::command_stream)].list.load(std::memory_order_relaxed) != nullptr)
+				invoke_command_stream_event<ev>(args...);
+#endif
+		addon_event_list[static_cast<uint32_t>(ev)].invoke([&](void *cb) {
+			reinterpret_cast<typename addon_event_traits<ev>::decl>(cb)(std::forward<Args>(args)...);
+			return false;
+		});
 	}
 	/// <summary>
 	/// Invokes registered callbacks for the specified <typeparamref name="ev"/>ent until a callback reports back as having handled this event by returning <see langword="true"/>.
@@ -141,11 +218,16 @@ namespace reshade
 		if (!addon_enabled)
 			return false;
 #endif
-		std::vector<void *> &event_list = addon_event_list[static_cast<uint32_t>(ev)];
-		for (size_t cb = 0, count = event_list.size(); cb < count; ++cb)
-			if (reinterpret_cast<typename addon_event_traits<ev>::decl>(event_list[cb])(std::forward<Args>(args)...))
-				return true;
-		return false;
+		const bool handled = addon_event_list[static_cast<uint32_t>(ev)].invoke([&](void *cb) {
+			return reinterpret_cast<typename addon_event_traits<ev>::decl>(cb)(std::forward<Args>(args)...);
+		});
+#if RESHADE_ADDON >= 2
+		// Record commands only after the callbacks ran and none of them skipped it, so that the command stream only contains commands that are actually executed
+		if constexpr (is_command_stream_event<ev>)
+			if (!handled && addon_event_list[static_cast<uint32_t>(addon_event::command_stream)].list.load(std::memory_order_relaxed) != nullptr)
+				invoke_command_stream_event<ev>(args...);
+#endif
+		return handled;
 	}
 }
 
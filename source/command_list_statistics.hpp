@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "reshade_api_device.hpp"
+
+namespace reshade
+{
+	/// <summary>
+	/// Number of commands recorded into a command list, grouped by kind.
+	/// </summary>
+	struct command_statistics
+	{
+		uint32_t barriers = 0;
+		uint32_t render_passes = 0;
+		uint32_t pipeline_binds = 0;
+		uint32_t descriptor_table_binds = 0;
+		uint32_t push_constants = 0;
+		uint32_t draws_and_dispatches = 0;
+		uint32_t copies = 0;
+		uint32_t clears = 0;
+		uint32_t mipmap_generations = 0;
+	};
+
+	/// <summary>
+	/// Command list that forwards all commands to another command list and counts them on the way.
+	/// This keeps statistics out of the code recording the commands and only costs anything while it is actually used.
+	/// </summary>
+	class command_list_statistics : public api::command_list
+	{
+	public:
+		command_list_statistics(api::command_list *cmd_list, command_statistics &stats) :
+			_cmd_list(cmd_list), _stats(stats) {}
+
+		uint64_t get_native() const final { return _cmd_list->get_native(); }
+		void get_private_data(const uint8_t guid[16], uint64_t *data) const final { _cmd_list->get_private_data(guid, data); }
+		void set_private_data(const uint8_t guid[16], const uint64_t data) final { _cmd_list->set_private_data(guid, data); }
+
+		api::device *get_device() final { return _cmd_list->get_device(); }
+
+		void barrier(uint32_t count, const api::resource *resources, const api::resource_usage *old_states, const api::resource_usage *new_states) final
+		{
+			_stats.barriers += count;
+			_cmd_list->barrier(count, resources, old_states, new_states);
+		}
+
+		void begin_render_pass(uint32_t count, const api::render_pass_render_target_desc *rts, const api::render_pass_depth_stencil_desc *ds) final
+		{
+			_stats.render_passes++;
+			_cmd_list->begin_render_pass(count, rts, ds);
+		}
+		void end_render_pass() final { _cmd_list->end_render_pass(); }
+		void bind_render_targets_and_depth_stencil(uint32_t count, const api::resource_view *rtvs, api::resource_view dsv) final { _cmd_list->bind_render_targets_and_depth_stencil(count, rtvs, dsv); }
+
+		void bind_pipeline(api::pipeline_stage stages, api::pipeline pipeline) final
+		{
+			_stats.pipeline_binds++;
+			_cmd_list->bind_pipeline(stages, pipeline);
+		}
+		void bind_pipeline_states(uint32_t count, const api::dynamic_state *states, const uint32_t *values) final { _cmd_list->bind_pipeline_states(count, states, values); }
+		void bind_viewports(uint32_t first, uint32_t count, const api::viewport *viewports) final { _cmd_list->bind_viewports(first, count, viewports); }
+		void bind_scissor_rects(uint32_t first, uint32_t count, const api::rect *rects) final { _cmd_list->bind_scissor_rects(first, count, rects); }
+
+		void push_constants(api::shader_stage stages, api::pipeline_layout layout, uint32_t layout_param, uint32_t first, uint32_t count, const void *values) final
+		{
+			_stats.push_constants++;
+			_cmd_list->push_constants(stages, layout, layout_param, first, count, values);
+		}
+		void push_descriptors(api::shader_stage stages, api::pipeline_layout layout, uint32_t layout_param, const api::descriptor_table_update &update) final
+		{
+			_stats.descriptor_table_binds++;
+			_cmd_list->push_descriptors(stages, layout, layout_param, update);
+		}
+		void bind_descriptor_tables(api::shader_stage stages, api::pipeline_layout layout, uint32_t first, uint32_t count, const api::descriptor_table *tables) final
+		{
+			_stats.descriptor_table_binds += count;
+			_cmd_list->bind_descriptor_tables(stages, layout, first, count, tables);
+		}
+
+		void bind_index_buffer(api::resource buffer, uint64_t offset, uint32_t index_size) final { _cmd_list->bind_index_buffer(buffer, offset, index_size); }
+		void bind_vertex_buffers(uint32_t first, uint32_t count, const api::resource *buffers, const uint64_t *offsets, const uint32_t *strides) final { _cmd_list->bind_vertex_buffers(first, count, buffers, offsets, strides); }
+		void bind_stream_output_buffers(uint32_t first, uint32_t count, const api::resource *buffers, const uint64_t *offsets, const uint64_t *max_sizes, const api::resource *counter_buffers, const uint64_t *counter_offsets) final { _cmd_list->bind_stream_output_buffers(first, count, buffers, offsets, max_sizes, counter_buffers, counter_offsets); }
+
+		void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) final
+		{
+			_stats.draws_and_dispatches++;
+			_cmd_list->draw(vertex_count, instance_count, first_vertex, first_instance);
+		}
+		void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) final
+		{
+			_stats.draws_and_dispatches++;
+			_cmd_list->draw_indexed(index_count, instance_count, first_index, vertex_offset, first_instance);
+		}
+		void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) final
+		{
+			_stats.draws_and_dispatches++;
+			_cmd_list->dispatch(group_count_x, group_count_y, group_count_z);
+		}
+		void dispatch_mesh(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) final
+		{
+			_stats.draws_and_dispatches++;
+			_cmd_list->dispatch_mesh(group_count_x, group_count_y, group_count_z);
+		}
+		void dispatch_rays(api::resource raygen, uint64_t raygen_offset, uint64_t raygen_size, api::resource miss, uint64_t miss_offset, uint64_t miss_size, uint64_t miss_stride, api::resource hit_group, uint64_t hit_group_offset, uint64_t hit_group_size, uint64_t hit_group_stride, api::resource callable, uint64_t callable_offset, uint64_t callable_size, uint64_t callable_stride, uint32_t width, uint32_t height, uint32_t depth) final
+		{
+			_stats.draws_and_dispatches++;
+			_cmd_list->dispatch_rays(raygen, raygen_offset, raygen_size, miss, miss_offset, miss_size, miss_stride, hit_group, hit_group_offset, hit_group_size, hit_group_stride, callable, callable_offset, callable_size, callable_stride, width, height, depth);
+		}
+		void draw_or_dispatch_indirect(api::indirect_command type, api::resource buffer, uint64_t offset, uint32_t draw_count, uint32_t stride) final
+		{
+			_stats.draws_and_dispatches += draw_count;
+			_cmd_list->draw_or_dispatch_indirect(type, buffer, offset, draw_count, stride);
+		}
+
+		void copy_resource(api::resource source, api::resource dest) final
+		{
+			_stats.copies++;
+			_cmd_list->copy_resource(source, dest);
+		}
+		void copy_buffer_region(api::resource source, uint64_t source_offset, api::resource dest, uint64_t dest_offset, uint64_t size) final
+		{
+			_stats.copies++;
+			_cmd_list->copy_buffer_region(source, source_offset, dest, dest_offset, size);
+		}
+		void copy_buffer_to_texture(api::resource source, uint64_t source_offset, uint32_t row_length, uint32_t slice_height, api::resource dest, uint32_t dest_subresource, const api::subresource_box *dest_box) final
+		{
+			_stats.copies++;
+			_cmd_list->copy_buffer_to_texture(source, source_offset, row_length, slice_height, dest, dest_subresource, dest_box);
+		}
+		void copy_texture_region(api::resource source, uint32_t source_subresource, const api::subresource_box *source_box, api::resource dest, uint32_t dest_subresource, const api::subresource_box *dest_box, api::filter_mode filter) final
+		{
+			_stats.copies++;
+			_cmd_list->copy_texture_region(source, source_subresource, source_box, dest, dest_subresource, dest_box, filter);
+		}
+		void copy_texture_to_buffer(api::resource source, uint32_t source_subresource, const api::subresource_box *source_box, api::resource dest, uint64_t dest_offset, uint32_t row_length, uint32_t slice_height) final
+		{
+			_stats.copies++;
+			_cmd_list->copy_texture_to_buffer(source, source_subresource, source_box, dest, dest_offset, row_length, slice_height);
+		}
+		void resolve_texture_region(api::resource source, uint32_t source_subresource, const api::subresource_box *source_box, api::resource dest, uint32_t dest_subresource, int32_t dest_x, int32_t dest_y, int32_t dest_z, api::format format) final
+		{
+			_stats.copies++;
+			_cmd_list->resolve_texture_region(source, source_subresource, source_box, dest, dest_subresource, dest_x, dest_y, dest_z, format);
+		}
+
+		void clear_depth_stencil_view(api::resource_view dsv, const float *depth, const uint8_t *stencil, uint32_t rect_count, const api::rect *rects) final
+		{
+			_stats.clears++;
+			_cmd_list->clear_depth_stencil_view(dsv, depth, stencil, rect_count, rects);
+		}
+		void clear_render_target_view(api::resource_view rtv, const float color[4], uint32_t rect_count, const api::rect *rects) final
+		{
+			_stats.clears++;
+			_cmd_list->clear_render_target_view(rtv, color, rect_count, rects);
+		}
+		void clear_unordered_access_view_uint(api::resource_view uav, const uint32_t values[4], uint32_t rect_count, const api::rect *rects) final
+		{
+			_stats.clears++;
+			_cmd_list->clear_unordered_access_view_uint(uav, values, rect_count, rects);
+		}
+		void clear_unordered_access_view_float(api::resource_view uav, const float values[4], uint32_t rect_count, const api::rect *rects) final
+		{
+			_stats.clears++;
+			_cmd_list->clear_unordered_access_view_float(uav, values, rect_count, rects);
+		}
+
+		void generate_mipmaps(api::resource_view srv) final
+		{
+			_stats.mipmap_generations++;
+			_cmd_list->generate_mipmaps(srv);
+		}
+
+		void begin_query(api::query_heap heap, api::query_type type, uint32_t index) final { _cmd_list->begin_query(heap, type, index); }
+		void end_query(api::query_heap heap, api::query_type type, uint32_t index) final { _cmd_list->end_query(heap, type, index); }
+		void copy_query_heap_results(api::query_heap heap, api::query_type type, uint32_t first, uint32_t count, api::resource dest, uint64_t dest_offset, uint32_t stride) final { _cmd_list->copy_query_heap_results(heap, type, first, count, dest, dest_offset, stride); }
+
+		void copy_acceleration_structure(api::resource_view source, api::resource_view dest, api::acceleration_structure_copy_mode mode) final { _cmd_list->copy_acceleration_structure(source, dest, mode); }
+		void build_acceleration_structure(api::acceleration_structure_type type, api::acceleration_structure_build_flags flags, uint32_t input_count, const api::acceleration_structure_build_input *inputs, api::resource scratch, uint64_t scratch_offset, api::resource_view source, api::resource_view dest, api::acceleration_structure_build_mode mode) final { _cmd_list->build_acceleration_structure(type, flags, input_count, inputs, scratch, scratch_offset, source, dest, mode); }
+
+		void begin_debug_event(const char *label, const float color[4]) final { _cmd_list->begin_debug_event(label, color); }
+		void end_debug_event() final { _cmd_list->end_debug_event(); }
+		void insert_debug_marker(const char *label, const float color[4]) final { _cmd_list->insert_debug_marker(label, color); }
+
+	private:
+		api::command_list *const _cmd_list;
+		command_statistics &_stats;
+	};
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "cube_lut.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+
+static inline uint16_t float_to_half(float value)
+{
+	uint32_t f;
+	std::memcpy(&f, &value, sizeof(f));
+
+	const uint32_t sign = (f >> 16) & 0x8000;
+	f &= 0x7FFFFFFF;
+
+	if (f >= 0x47800000) // Overflow, infinity or NaN
+		return static_cast<uint16_t>(sign | (f > 0x7F800000 ? 0x7E00 : 0x7C00));
+
+	if (f < 0x38800000) // Denormal or zero
+	{
+		if (f < 0x33000000)
+			return static_cast<uint16_t>(sign);
+
+		const uint32_t shift = 126 - (f >> 23);
+		const uint32_t mantissa = (f & 0x7FFFFF) | 0x800000;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+
+		uint32_t h = mantissa >> shift;
+		// Round to nearest even
+		if (remainder > halfway || (remainder == halfway && (h & 1) != 0))
+			h++;
+		return static_cast<uint16_t>(sign | h);
+	}
+
+	// Rebias exponent from 127 to 15
+	uint32_t h = (f - 0x38000000) >> 13;
+	// Round to nearest even (a carry into the exponent correctly rounds up to the next power of two or infinity)
+	if ((f & 0x1FFF) > 0x1000 || ((f & 0x1FFF) == 0x1000 && (h & 1) != 0))
+		h++;
+	return static_cast<uint16_t>(sign | h);
+}
+
+static inline const char *skip_cube_whitespace(const char *p, const char *end)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+		++p;
+	return p;
+}
+static inline const char *parse_cube_float(const char *p, const char *end, float &value)
+{
+	p = skip_cube_whitespace(p, end);
+	if (p < end && *p == '+')
+		++p;
+
+	// Parse without locale or allocation overhead (unlike 'std::strtod'), falling back to zero on malformed input
+	const std::from_chars_result result = std::from_chars(p, end, value);
+	if (result.ec != std::errc())
+	{
+		value = 0.0f;
+		return p;
+	}
+	return result.ptr;
+}
+
+void *reshade::utils::load_cube_lut(const char *data, size_t data_size, reshadefx::texture_format format, int &width, int &height, int &depth)
+{
+	size_t num_components = 0;
+	bool half_precision = false;
+	switch (format)
+	{
+	case reshadefx::texture_format::r32f:
+		num_components = 1;
+		break;
+	case reshadefx::texture_format::rg32f:
+		num_components = 2;
+		break;
+	case reshadefx::texture_format::rgba32f:
+		num_components = 4;
+		break;
+	case reshadefx::texture_format::rgba16f:
+		num_components = 4;
+		half_precision = true;
+		break;
+	default:
+		return nullptr;
+	}
+
+	float domain_min[3] = { 0.0f, 0.0f, 0.0f };
+	float domain_scale[3] = { 1.0f, 1.0f, 1.0f };
+
+	void *pixels = nullptr;
+	size_t num_entries = 0;
+	size_t index = 0;
+
+	const char *const end = data + data_size;
+
+	for (const char *line = data, *line_end; line < end && (pixels == nullptr || index < num_entries); line = line_end + 1)
+	{
+		line_end = static_cast<const char *>(std::memchr(line, '\n', end - line));
+		if (line_end == nullptr)
+			line_end = end;
+
+		const char *p = skip_cube_whitespace(line, line_end);
+		if (p == line_end || *p == '#')
+			continue; // Skip empty lines and lines with comments
+
+		const std::string_view keyword(p, line_end - p);
+
+		if (std::isalpha(static_cast<unsigned char>(*p)))
+		{
+			if (keyword.rfind("DOMAIN_MIN", 0) == 0 || keyword.rfind("DOMAIN_MAX", 0) == 0)
+			{
+				const bool is_max = keyword[8] == 'A';
+
+				float domain_max[3];
+				for (int c = 0; c < 3; ++c)
+					domain_max[c] = domain_scale[c] + domain_min[c];
+
+				p += 10;
+				for (int c = 0; c < 3; ++c)
+					p = parse_cube_float(p, line_end, is_max ? domain_max[c] : domain_min[c]);
+
+				for (int c = 0; c < 3; ++c)
+					domain_scale[c] = domain_max[c] - domain_min[c];
+				continue;
+			}
+
+			const bool is_1d = keyword.rfind("LUT_1D_SIZE", 0) == 0;
+			if (is_1d || keyword.rfind("LUT_3D_SIZE", 0) == 0)
+			{
+				if (pixels != nullptr)
+					break;
+
+				p = skip_cube_whitespace(p + 11, line_end);
+
+				int size = 0;
+				std::from_chars(p, line_end, size);
+				if (size < 2 || size > (is_1d ? 65536 : 256))
+					return nullptr;
+
+				width = size;
+				height = depth = is_1d ? 1 : size;
+
+				num_entries = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth);
+				// Use zero-initialized memory, so that truncated files do not result in undefined texture contents
+				pixels = std::calloc(num_entries * num_components, half_precision ? sizeof(uint16_t) : sizeof(float));
+				if (pixels == nullptr)
+					return nullptr;
+				continue;
+			}
+
+			continue; // Skip optional title and any other unknown keywords
+		}
+
+		if (pixels == nullptr)
+			return nullptr; // Table data needs to be preceded by a size declaration
+
+		float value[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		for (int c = 0; c < 3; ++c)
+		{
+			p = parse_cube_float(p, line_end, value[c]);
+			value[c] = value[c] * domain_scale[c] + domain_min[c];
+		}
+
+		if (half_precision)
+			for (size_t c = 0; c < num_components; ++c)
+				static_cast<uint16_t *>(pixels)[index * num_components + c] = float_to_half(value[c]);
+		else
+			for (size_t c = 0; c < num_components; ++c)
+				static_cast<float *>(pixels)[index * num_components + c] = value[c];
+
+		index++;
+	}
+
+	return pixels;
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "effect_module.hpp"
+
+namespace reshade::utils
+{
+	/// <summary>
+	/// Parses an Adobe Cube LUT file that was read into memory and writes the table directly in the layout of the specified texture format.
+	/// </summary>
+	/// <param name="data">Pointer to the text of the Cube LUT file.</param>
+	/// <param name="data_size">Size of the text in bytes.</param>
+	/// <param name="format">Texture format to write the table in (one of r32f, rg32f, rgba32f or rgba16f).</param>
+	/// <param name="width">Receives the width of the table.</param>
+	/// <param name="height">Receives the height of the table (one for 1D tables).</param>
+	/// <param name="depth">Receives the depth of the table (one for 1D tables).</param>
+	/// <returns>Pointer to the table data allocated with <c>std::calloc</c>, or <see langword="nullptr"/> if parsing failed.</returns>
+	void *load_cube_lut(const char *data, size_t data_size, reshadefx::texture_format format, int &width, int &height, int &depth);
+}
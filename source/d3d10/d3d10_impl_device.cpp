@@ -1258,3 +1258,13 @@ bool reshade::d3d10::device_impl::get_pipeline_shader_group_handles(api::pipelin
 {
 	return false;
 }
+
+bool reshade::d3d10::device_impl::get_pipeline_cache_data(size_t *, void *)
+{
+	// Drivers compile shaders when they are created, so there is no pipeline cache to persist
+	return false;
+}
+bool reshade::d3d10::device_impl::merge_pipeline_cache_data(size_t, const void *)
+{
+	return false;
+}
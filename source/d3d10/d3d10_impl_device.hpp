@@ -89,6 +89,9 @@ namespace reshade::d3d10
 
 		bool get_pipeline_shader_group_handles(api::pipeline pipeline, uint32_t first, uint32_t count, void *groups) final;
 
+		bool get_pipeline_cache_data(size_t *size, void *data) final;
+		bool merge_pipeline_cache_data(size_t size, const void *data) final;
+
 		uint64_t get_timestamp_frequency() const final;
 
 		api::device *get_device() final { return this; }
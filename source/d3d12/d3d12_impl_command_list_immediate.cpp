@@ -7,6 +7,7 @@
 #include "d3d12_impl_command_list_immediate.hpp"
 #include "d3d12_impl_type_convert.hpp"
 #include "dll_log.hpp" // Include late to get HRESULT log overloads
+#include <algorithm>
 
 reshade::d3d12::command_list_immediate_impl::command_list_immediate_impl(device_impl *device, ID3D12CommandQueue *queue) :
 	command_list_impl(device, nullptr),
@@ -55,8 +56,16 @@ void reshade::d3d12::command_list_immediate_impl::end_query(api::query_heap heap
 	{
 		_orig->ResolveQueryData(heap_object, convert_query_type(type), index, 1, extra_data.readback_resource, index * sizeof(uint64_t));
 
-		extra_data.fences[index].second++;
-		_current_query_fences.push_back(extra_data.fences[index]);
+		const UINT64 fence_value = ++extra_data.fence_values[extra_data.size];
+		extra_data.fence_values[index] = fence_value;
+
+		// Only the last value has to be signaled for each fence, since fence values of a heap only ever increase
+		if (const auto it = std::find_if(_current_query_fences.begin(), _current_query_fences.end(),
+				[fence = extra_data.fence](const std::pair<ID3D12Fence *, UINT64> &item) { return item.first == fence; });
+			it != _current_query_fences.end())
+			it->second = fence_value;
+		else
+			_current_query_fences.emplace_back(extra_data.fence, fence_value);
 	}
 }
 
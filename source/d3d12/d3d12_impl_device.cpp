@@ -1629,7 +1629,7 @@ void reshade::d3d12::device_impl::update_descriptor_tables(uint32_t count, const
 bool reshade::d3d12::device_impl::create_query_heap(api::query_type type, uint32_t size, api::query_heap *out_handle)
 {
 	com_ptr<ID3D12Resource> readback_resource;
-	std::vector<com_ptr<ID3D12Fence>> fences(size);
+	com_ptr<ID3D12Fence> fence;
 
 	D3D12_RESOURCE_DESC readback_desc = {};
 	readback_desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
@@ -1647,13 +1647,11 @@ bool reshade::d3d12::device_impl::create_query_heap(api::query_type type, uint32
 		return false;
 	}
 
-	for (uint32_t i = 0; i < size; i++)
+	// Share a single fence between all queries, rather than creating one per query, since heaps may hold many queries
+	if (FAILED(_orig->CreateFence(0ull, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence))))
 	{
-		if (FAILED(_orig->CreateFence(0ull, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fences[i]))))
-		{
-			*out_handle = { 0 };
-			return false;
-		}
+		*out_handle = { 0 };
+		return false;
 	}
 
 	D3D12_QUERY_HEAP_DESC internal_desc = {};
@@ -1666,10 +1664,10 @@ bool reshade::d3d12::device_impl::create_query_heap(api::query_type type, uint32
 		query_heap_extra_data extra_data;
 		extra_data.size = size;
 		extra_data.readback_resource = readback_resource.release();
-		extra_data.fences = new std::pair<ID3D12Fence *, UINT64>[size];
-		for (uint32_t i = 0; i < extra_data.size; ++i)
-			// Start with fence value above the initial value, so that 'get_query_heap_results' will return false for the first frame as well
-			extra_data.fences[i] = std::make_pair(fences[i].release(), 1ull);
+		extra_data.fence = fence.release();
+		extra_data.fence_values = new UINT64[size + 1];
+		// Start with fence value above the initial value, so that 'get_query_heap_results' will return false for the first frame as well
+		std::fill_n(extra_data.fence_values, size + 1, 1ull);
 
 		object->SetPrivateData(extra_data_guid, sizeof(extra_data), &extra_data);
 
@@ -1695,9 +1693,8 @@ void reshade::d3d12::device_impl::destroy_query_heap(api::query_heap handle)
 	{
 		extra_data.readback_resource->Release();
 
-		for (uint32_t i = 0; i < extra_data.size; ++i)
-			extra_data.fences[i].first->Release();
-		delete[] extra_data.fences;
+		extra_data.fence->Release();
+		delete[] extra_data.fence_values;
 	}
 
 	heap_object->Release();
@@ -1714,12 +1711,12 @@ bool reshade::d3d12::device_impl::get_query_heap_results(api::query_heap heap, u
 	UINT extra_data_size = sizeof(extra_data);
 	if (SUCCEEDED(heap_object->GetPrivateData(extra_data_guid, &extra_data_size, &extra_data)))
 	{
+		const UINT64 completed_value = extra_data.fence->GetCompletedValue();
+
 		for (size_t i = 0; i < count; ++i)
 		{
-			const std::pair<ID3D12Fence *, UINT64> &fence = extra_data.fences[i + first];
-
 			// Verify that the query has finished executing on the GPU
-			if (fence.first->GetCompletedValue() < fence.second)
+			if (completed_value < extra_data.fence_values[i + first])
 				return false;
 		}
 
@@ -1901,6 +1898,16 @@ bool reshade::d3d12::device_impl::get_pipeline_shader_group_handles(api::pipelin
 	return false;
 }
 
+bool reshade::d3d12::device_impl::get_pipeline_cache_data(size_t *, void *)
+{
+	// A 'ID3D12PipelineLibrary' can only look up pipelines by a name and the exact description they were stored with, and drivers keep a disk cache of compiled shaders already, so there is no generic pipeline cache to persist
+	return false;
+}
+bool reshade::d3d12::device_impl::merge_pipeline_cache_data(size_t, const void *)
+{
+	return false;
+}
+
 void reshade::d3d12::device_impl::register_resource(ID3D12Resource *resource, bool acceleration_structure)
 {
 	assert(resource != nullptr);
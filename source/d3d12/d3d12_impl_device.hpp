@@ -96,6 +96,9 @@ namespace reshade::d3d12
 
 		bool get_pipeline_shader_group_handles(api::pipeline pipeline, uint32_t first, uint32_t count, void *groups) final;
 
+		bool get_pipeline_cache_data(size_t *size, void *data) final;
+		bool merge_pipeline_cache_data(size_t size, const void *data) final;
+
 		command_list_immediate_impl *get_first_immediate_command_list();
 
 #if RESHADE_ADDON >= 2
@@ -31,7 +31,10 @@ namespace reshade::d3d12
 	{
 		UINT size;
 		ID3D12Resource *readback_resource;
-		std::pair<ID3D12Fence *, UINT64> *fences;
+		// Single fence that is signaled after every submission that resolved queries of this heap
+		ID3D12Fence *fence;
+		// Fence value each query waits for, followed by the last value that was handed out (so 'size + 1' entries)
+		UINT64 *fence_values;
 	};
 
 	extern const GUID extra_data_guid;
@@ -2023,6 +2023,16 @@ bool reshade::d3d9::device_impl::get_pipeline_shader_group_handles(api::pipeline
 	return false;
 }
 
+bool reshade::d3d9::device_impl::get_pipeline_cache_data(size_t *, void *)
+{
+	// Drivers compile shaders when they are created, so there is no pipeline cache to persist
+	return false;
+}
+bool reshade::d3d9::device_impl::merge_pipeline_cache_data(size_t, const void *)
+{
+	return false;
+}
+
 HRESULT reshade::d3d9::device_impl::create_surface_replacement(const D3DSURFACE_DESC &desc, IDirect3DSurface9 **out_surface, HANDLE *out_shared_handle)
 {
 	// Cannot create multisampled textures
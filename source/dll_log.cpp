@@ -4,28 +4,381 @@
  */
 
 #include "dll_log.hpp"
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <cstdio>
+#include <condition_variable>
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <ctime>
+#include <pthread.h>
+#endif
+
+#pragma region Platform Abstraction
+
+#ifdef _WIN32
+typedef HANDLE log_file_handle;
+static const log_file_handle invalid_log_file_handle = INVALID_HANDLE_VALUE;
+#else
+typedef std::FILE *log_file_handle;
+static const log_file_handle invalid_log_file_handle = nullptr;
+#endif
+
+struct local_time
+{
+	unsigned int year, month, day, hour, minute, second, milliseconds;
+};
+
+static local_time get_local_time()
+{
+#ifdef _WIN32
+	SYSTEMTIME time;
+	GetLocalTime(&time);
+
+	return { time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, time.wMilliseconds };
+#else
+	timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	tm time;
+	localtime_r(&now.tv_sec, &time);
+
+	return { static_cast<unsigned int>(time.tm_year + 1900), static_cast<unsigned int>(time.tm_mon + 1), static_cast<unsigned int>(time.tm_mday), static_cast<unsigned int>(time.tm_hour), static_cast<unsigned int>(time.tm_min), static_cast<unsigned int>(time.tm_sec), static_cast<unsigned int>(now.tv_nsec / 1000000) };
+#endif
+}
+
+static unsigned long get_current_thread_id()
+{
+#ifdef _WIN32
+	return GetCurrentThreadId();
+#else
+	return static_cast<unsigned long>(pthread_self());
+#endif
+}
+
+static log_file_handle open_file(const std::filesystem::path &path, std::error_code &ec)
+{
+#ifdef _WIN32
+	// Open the log file for writing (and flush on each write) and clear previous contents
+	const HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_WRITE_THROUGH, NULL);
+
+	if (handle != INVALID_HANDLE_VALUE)
+		// Last error may be ERROR_ALREADY_EXISTS if an existing file was overwritten, which can be ignored
+		ec.clear();
+	else
+		ec.assign(GetLastError(), std::system_category());
+
+	return handle;
+#else
+	std::FILE *const file = std::fopen(path.c_str(), "wb");
+
+	if (file != nullptr)
+		ec.clear();
+	else
+		ec.assign(errno, std::system_category());
+
+	return file;
+#endif
+}
+
+static void close_file(log_file_handle handle)
+{
+#ifdef _WIN32
+	CloseHandle(handle);
+#else
+	std::fclose(handle);
+#endif
+}
+
+static void write_file(log_file_handle handle, const std::string &data)
+{
+#ifdef _WIN32
+	DWORD written = 0;
+	WriteFile(handle, data.data(), static_cast<DWORD>(data.size()), &written, nullptr);
+	assert(written == data.size());
+#else
+	std::fwrite(data.data(), 1, data.size(), handle);
+	std::fflush(handle);
+#endif
+}
+
+static void write_debug_output(const std::string &line)
+{
+#ifdef _WIN32
+	OutputDebugStringA(line.c_str());
+#else
+	std::fputs(line.c_str(), stderr);
+#endif
+}
+
+static void writer_thread_main();
+
+static bool start_writer_thread()
+{
+#ifdef _WIN32
+	// Keep a reference to this module while the thread is running, so that it cannot be unloaded underneath it (released again by 'FreeLibraryAndExitThread' below)
+	HMODULE module = nullptr;
+	if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, reinterpret_cast<LPCWSTR>(&start_writer_thread), &module))
+		return false;
+
+	const HANDLE thread = CreateThread(nullptr, 0, [](LPVOID module) -> DWORD {
+		writer_thread_main();
+		FreeLibraryAndExitThread(static_cast<HMODULE>(module), 0);
+	}, module, 0, nullptr);
+	if (thread == nullptr)
+	{
+		FreeLibrary(module);
+		return false;
+	}
+
+	CloseHandle(thread);
+	return true;
+#else
+	try
+	{
+		std::thread(writer_thread_main).detach();
+		return true;
+	}
+	catch (const std::system_error &)
+	{
+		return false;
+	}
+#endif
+}
+
+#pragma endregion
 
 struct scoped_file_handle
 {
 	~scoped_file_handle()
 	{
-		if (handle != INVALID_HANDLE_VALUE)
-			CloseHandle(handle);
+		if (handle != invalid_log_file_handle)
+			close_file(handle);
 	}
 
-	operator HANDLE() const { return handle; }
+	operator log_file_handle() const { return handle; }
 
-	void operator=(HANDLE new_handle)
+	void operator=(log_file_handle new_handle)
 	{
 		handle = new_handle;
 	}
 
 private:
-	HANDLE handle = INVALID_HANDLE_VALUE;
+	log_file_handle handle = invalid_log_file_handle;
 };
 
+// Protects the file handle and the consumer side of the message queue
+static std::timed_mutex s_file_mutex;
+// Set when the file lock could not be acquired during shutdown, since it is held by a thread that was terminated during process exit
+static std::atomic<bool> s_file_mutex_abandoned;
 static scoped_file_handle s_file_handle;
+static std::atomic<bool> s_file_open;
+
+// Bounded multi-producer queue of formatted lines (see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue)
+// The 'turn' of each record is stored relative to its index, so that the zero-initialized state is valid before any static constructors ran
+struct log_record
+{
+	std::atomic<size_t> turn;
+	std::string *line;
+};
+
+static constexpr size_t s_queue_size = 4096;
+static log_record s_queue[s_queue_size];
+static std::atomic<size_t> s_queue_write_pos;
+static std::atomic<size_t> s_queue_read_pos;
+static std::atomic<size_t> s_dropped_messages;
+
+// Timed, so that 'shutdown' can give up on it when it is held by a thread that was terminated during process exit
+static std::timed_mutex s_writer_wakeup_mutex;
+static std::condition_variable_any s_writer_wakeup_cv;
+static std::atomic<bool> s_writer_running;
+static std::atomic<bool> s_writer_sleeping;
+static std::atomic<bool> s_synchronous;
+
+static bool try_push_line(std::string *line)
+{
+	size_t pos = s_queue_write_pos.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		log_record &record = s_queue[pos % s_queue_size];
+		const size_t expected_turn = pos - pos % s_queue_size;
+		const size_t turn = record.turn.load(std::memory_order_acquire);
+
+		if (turn == expected_turn)
+		{
+			if (s_queue_write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				record.line = line;
+				record.turn.store(expected_turn + 1);
+				return true;
+			}
+		}
+		else if (static_cast<ptrdiff_t>(turn - expected_turn) < 0)
+		{
+			return false; // Queue is full, since this record was not read yet since the last time around
+		}
+		else
+		{
+			pos = s_queue_write_pos.load(std::memory_order_relaxed);
+		}
+	}
+}
+static bool is_queue_empty()
+{
+	const size_t pos = s_queue_read_pos.load(std::memory_order_relaxed);
+
+	return s_queue[pos % s_queue_size].turn.load() != (pos - pos % s_queue_size) + 1;
+}
+static std::string *pop_line()
+{
+	const size_t pos = s_queue_read_pos.load(std::memory_order_relaxed);
+
+	log_record &record = s_queue[pos % s_queue_size];
+	const size_t expected_turn = pos - pos % s_queue_size;
+	if (record.turn.load(std::memory_order_acquire) != expected_turn + 1)
+		return nullptr;
+
+	std::string *const line = record.line;
+	record.turn.store(expected_turn + s_queue_size, std::memory_order_release);
+	s_queue_read_pos.store(pos + 1, std::memory_order_relaxed);
+	return line;
+}
+
+static void write_queued_lines_locked()
+{
+	std::string batch;
+
+	while (std::string *const line = pop_line())
+	{
+		batch += *line;
+		delete line;
+
+		// Avoid accumulating too much data before writing
+		if (batch.size() >= 64 * 1024)
+		{
+			if (s_file_handle != invalid_log_file_handle)
+				write_file(s_file_handle, batch);
+			batch.clear();
+		}
+	}
+
+	if (!batch.empty() && s_file_handle != invalid_log_file_handle)
+		write_file(s_file_handle, batch);
+}
+static void write_queued_lines(bool wait = true)
+{
+	std::unique_lock<std::timed_mutex> lock(s_file_mutex, std::defer_lock);
+
+	if (wait)
+	{
+		lock.lock();
+	}
+	else
+	{
+		// The writer thread may have been terminated while holding the lock during process exit, so only wait for a bounded amount of time for it to finish its current batch and give up for good if it does not
+		if (s_file_mutex_abandoned.load() || !lock.try_lock_for(std::chrono::seconds(1)))
+		{
+			s_file_mutex_abandoned.store(true);
+			return;
+		}
+	}
+
+	write_queued_lines_locked();
+	lock.unlock();
+
+	if (const size_t dropped_messages = s_dropped_messages.exchange(0))
+		LOG(WARN) << "Dropped " << dropped_messages << " log messages because the log queue was full.";
+}
+
+static void wake_writer_thread()
+{
+	if (s_writer_sleeping.load())
+	{
+		const std::lock_guard<std::timed_mutex> lock(s_writer_wakeup_mutex);
+		s_writer_wakeup_cv.notify_all();
+	}
+}
+
+static void writer_thread_main()
+{
+	while (true)
+	{
+		write_queued_lines();
+
+		std::unique_lock<std::timed_mutex> lock(s_writer_wakeup_mutex);
+
+		if (s_synchronous.load())
+		{
+			// Let 'shutdown' know that everything queued before it was written
+			s_writer_running.store(false);
+			s_writer_wakeup_cv.notify_all();
+			break;
+		}
+
+		s_writer_sleeping.store(true);
+		if (is_queue_empty())
+			s_writer_wakeup_cv.wait_for(lock, std::chrono::seconds(1));
+		s_writer_sleeping.store(false);
+
+		if (is_queue_empty() && !s_synchronous.load())
+		{
+			// Stop the thread when there was nothing to write for a while, so that it does not keep the module loaded forever
+			s_writer_running.store(false);
+
+			// A message may have been queued right before the running flag was reset, in which case either continue here or let the thread started by that producer handle it
+			if (is_queue_empty() || s_writer_running.exchange(true))
+				break;
+		}
+	}
+}
+
+static void queue_line(std::string &&line, reshade::log::level level)
+{
+	std::string *const line_ptr = new std::string(std::move(line));
+
+	while (!try_push_line(line_ptr))
+	{
+		// Drop informational messages when the writer cannot keep up, but never drop warnings and errors
+		if (level == reshade::log::level::info || level == reshade::log::level::debug)
+		{
+			delete line_ptr;
+			s_dropped_messages++;
+			return;
+		}
+
+		// Apply backpressure by helping to write the queue
+		write_queued_lines();
+	}
+
+	if (s_synchronous.load())
+	{
+		write_queued_lines(false);
+		return;
+	}
+
+	// Write warnings and errors (and everything queued before them) right away, so that they are not lost if the process crashes shortly after
+	if (level == reshade::log::level::error || level == reshade::log::level::warning)
+	{
+		write_queued_lines();
+		return;
+	}
+
+	if (!s_writer_running.load(std::memory_order_relaxed) && !s_writer_running.exchange(true))
+	{
+		if (!start_writer_thread())
+		{
+			s_writer_running.store(false);
+			write_queued_lines();
+		}
+		return;
+	}
+
+	wake_writer_thread();
+}
 
 reshade::log::message::message(level level)
 {
@@ -36,69 +389,79 @@ reshade::log::message::message(level level)
 	if (static_cast<size_t>(level) > std::size(level_names))
 		level = level::debug;
 
-	SYSTEMTIME time;
-	GetLocalTime(&time);
+	_level = level;
+
+	const local_time time = get_local_time();
 
 	// Set default line stream settings
 	_line_stream.setf(std::ios::left);
 	_line_stream.setf(std::ios::showbase);
 
-	// Start a new line
-	_line_stream << std::right << std::setfill('0')
+	// Start a new line (formatting the prefix directly is a lot cheaper than going through the stream with 'setw' and 'setfill')
+	char prefix[64];
+	int prefix_length = 0;
 #if RESHADE_VERBOSE_LOG
-		<< std::setw(4) << time.wYear << '-'
-		<< std::setw(2) << time.wMonth << '-'
-		<< std::setw(2) << time.wDay << 'T'
+	prefix_length += snprintf(prefix, sizeof(prefix), "%04u-%02u-%02uT", time.year, time.month, time.day);
 #endif
-		<< std::setw(2) << time.wHour << ':'
-		<< std::setw(2) << time.wMinute << ':'
-		<< std::setw(2) << time.wSecond << ':'
-		<< std::setw(3) << time.wMilliseconds << ' '
-		<< '[' << std::setw(5) << GetCurrentThreadId() << ']' << std::setfill(' ') << " | "
-		<< level_names[static_cast<size_t>(level) - 1] << " | " << std::left;
+	snprintf(prefix + prefix_length, sizeof(prefix) - prefix_length, "%02u:%02u:%02u:%03u [%5lu] | %s | ",
+		time.hour, time.minute, time.second, time.milliseconds, get_current_thread_id(), level_names[static_cast<size_t>(level) - 1]);
+	_line_stream << prefix;
 }
 reshade::log::message::~message()
 {
-	std::string line_string = _line_stream.str();
-	line_string += '\n'; // Terminate line with line feed
+	const std::string message_string = _line_stream.str();
 
-	// Replace all LF with CRLF
-	for (size_t offset = 0; (offset = line_string.find('\n', offset)) != std::string::npos; offset += 2)
-		line_string.replace(offset, 1, "\r\n", 2);
-
-	// Write line to the log file
-	if (s_file_handle != INVALID_HANDLE_VALUE)
+	// Replace all LF with CRLF and terminate line with CRLF
+	std::string line_string;
+	line_string.reserve(message_string.size() + 16);
+	for (const char c : message_string)
 	{
-		DWORD written = 0;
-		WriteFile(s_file_handle, line_string.data(), static_cast<DWORD>(line_string.size()), &written, nullptr);
-		assert(written == line_string.size());
+		if (c == '\n')
+			line_string += '\r';
+		line_string += c;
 	}
+	line_string += "\r\n";
 
 #ifndef NDEBUG
 	// Write line to the debug output
-	OutputDebugStringA(line_string.c_str());
+	write_debug_output(line_string);
 #endif
+
+	// Write line to the log file
+	if (s_file_open.load(std::memory_order_relaxed))
+		queue_line(std::move(line_string), _level);
 }
 
 bool reshade::log::open_log_file(const std::filesystem::path &path, std::error_code &ec)
 {
-	// Close the previous file first
-	// Do this here, instead of in 'scoped_file_handle::operator=', so that the old handle is closed before the new handle is created
-	if (s_file_handle != INVALID_HANDLE_VALUE)
-		CloseHandle(s_file_handle);
-
-	// Open the log file for writing (and flush on each write) and clear previous contents
-	s_file_handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_WRITE_THROUGH, NULL);
+	const std::lock_guard<std::timed_mutex> lock(s_file_mutex);
 
-	if (s_file_handle != INVALID_HANDLE_VALUE)
+	// Close the previous file first, after writing any messages that were still queued for it
+	// Do this here, instead of in 'scoped_file_handle::operator=', so that the old handle is closed before the new handle is created
+	if (s_file_handle != invalid_log_file_handle)
 	{
-		// Last error may be ERROR_ALREADY_EXISTS if an existing file was overwritten, which can be ignored
-		ec.clear();
-		return true;
+		write_queued_lines_locked();
+		close_file(s_file_handle);
 	}
-	else
+
+	s_file_handle = open_file(path, ec);
+	s_file_open.store(s_file_handle != invalid_log_file_handle);
+
+	return s_file_handle != invalid_log_file_handle;
+}
+
+void reshade::log::shutdown()
+{
+	s_synchronous.store(true);
+
+	// Wake up the writer thread if it is still running and wait for it to finish writing and exit
+	// This is bounded, since the writer thread may have been terminated during process exit already, in which case it never signals and may even still hold one of the locks
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	if (std::unique_lock<std::timed_mutex> lock(s_writer_wakeup_mutex, std::defer_lock); lock.try_lock_until(deadline))
 	{
-		ec.assign(GetLastError(), std::system_category());
-		return false;
+		s_writer_wakeup_cv.notify_all();
+		s_writer_wakeup_cv.wait_until(lock, deadline, []() { return !s_writer_running.load(); });
 	}
+
+	write_queued_lines(false);
 }
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cassert>
+#include <cwchar>
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
@@ -39,7 +40,15 @@ namespace reshade::log
 	bool open_log_file(const std::filesystem::path &path, std::error_code &ec);
 
 	/// <summary>
-	/// Constructs a single log message including current time and level and writes it to the open log file.
+	/// Writes all queued log messages to the log file and switches to writing any further messages synchronously.
+	/// This has to be called before the module is unloaded, since no new background writer thread can be started after that point.
+	/// </summary>
+	void shutdown();
+
+	/// <summary>
+	/// Constructs a single log message including current time and level and queues it for writing to the open log file.
+	/// Queued messages are written in batches by a background thread, so that logging does not stall the calling thread on disk access.
+	/// Warnings and errors are written synchronously instead, together with any messages queued before them.
 	/// </summary>
 	struct message
 	{
@@ -53,100 +62,107 @@ namespace reshade::log
 			return *this;
 		}
 
-#if defined(_REFIID_DEFINED) && defined(_COMBASEAPI_H_)
-		template <>
-		message &operator<<(REFIID riid)
+		inline message &operator<<(const char *message)
 		{
-			OLECHAR riid_string[40];
-			if (StringFromGUID2(riid, riid_string, ARRAYSIZE(riid_string)))
-				operator<<(riid_string);
+			assert(message != nullptr);
+			_line_stream << message;
 			return *this;
 		}
-#endif
 
-#if defined(_HRESULT_DEFINED)
-		template <>
-		message &operator<<(const HRESULT &hresult) // Note: HRESULT is just an alias for long, so this falsely catches all long values too
+		inline message &operator<<(const wchar_t *message)
 		{
-			switch (hresult)
-			{
-			case E_NOTIMPL:
-				return *this << "E_NOTIMPL";
-			case E_OUTOFMEMORY:
-				return *this << "E_OUTOFMEMORY";
-			case E_INVALIDARG:
-				return *this << "E_INVALIDARG";
-			case E_NOINTERFACE:
-				return *this << "E_NOINTERFACE";
-			case E_FAIL:
-				return *this << "E_FAIL";
-			case 0x8876017C:
-				return *this << "D3DERR_OUTOFVIDEOMEMORY";
-			case 0x88760868:
-				return *this << "D3DERR_DEVICELOST";
-			case 0x8876086A:
-				return *this << "D3DERR_NOTAVAILABLE";
-			case 0x8876086C:
-				return *this << "D3DERR_INVALIDCALL";
-			case 0x88760870:
-				return *this << "D3DERR_DEVICEREMOVED";
-			case 0x88760874:
-				return *this << "D3DERR_DEVICEHUNG";
-			case DXGI_ERROR_INVALID_CALL:
-				return *this << "DXGI_ERROR_INVALID_CALL";
-			case DXGI_ERROR_UNSUPPORTED:
-				return *this << "DXGI_ERROR_UNSUPPORTED";
-			case DXGI_ERROR_DEVICE_REMOVED:
-				return *this << "DXGI_ERROR_DEVICE_REMOVED";
-			case DXGI_ERROR_DEVICE_HUNG:
-				return *this << "DXGI_ERROR_DEVICE_HUNG";
-			case DXGI_ERROR_DEVICE_RESET:
-				return *this << "DXGI_ERROR_DEVICE_RESET";
-			case DXGI_ERROR_DRIVER_INTERNAL_ERROR:
-				return *this << "DXGI_ERROR_DRIVER_INTERNAL_ERROR";
-			default:
-				return *this << std::hex << static_cast<unsigned long>(hresult) << std::dec;
-			}
+			assert(message != nullptr);
+			return operator<<(wide_to_utf8(message, message + std::wcslen(message)));
 		}
-#endif
 
-		template <>
-		message &operator<<(const std::wstring &message)
+	private:
+		/// <summary>
+		/// Converts a wide string to UTF-8, which is UTF-16 on Windows and UTF-32 on most other platforms.
+		/// </summary>
+		static std::string wide_to_utf8(const wchar_t *begin, const wchar_t *end)
 		{
-			static_assert(sizeof(std::wstring::value_type) == sizeof(uint16_t), "expected 'std::wstring' to use UTF-16 encoding");
+			static_assert(sizeof(wchar_t) == sizeof(uint16_t) || sizeof(wchar_t) == sizeof(uint32_t), "expected 'wchar_t' to use UTF-16 or UTF-32 encoding");
 
 			std::string utf8_message;
-			utf8_message.reserve(message.size());
-			utf8::unchecked::utf16to8(message.begin(), message.end(), std::back_inserter(utf8_message));
-
-			return operator<<(utf8_message);
+			utf8_message.reserve(end - begin);
+			if constexpr (sizeof(wchar_t) == sizeof(uint16_t))
+				utf8::unchecked::utf16to8(begin, end, std::back_inserter(utf8_message));
+			else
+				utf8::unchecked::utf32to8(begin, end, std::back_inserter(utf8_message));
+			return utf8_message;
 		}
 
-		template <>
-		message &operator<<(const std::filesystem::path &path)
-		{
-			return operator<<('"' + path.u8string() + '"');
-		}
+		level _level;
+		std::ostringstream _line_stream;
+	};
 
-		inline message &operator<<(const char *message)
-		{
-			assert(message != nullptr);
-			_line_stream << message;
-			return *this;
-		}
+	// Explicit specializations have to be declared at namespace scope (MSVC accepts them inside the class, but other compilers do not)
+#if defined(_REFIID_DEFINED) && defined(_COMBASEAPI_H_)
+	template <>
+	inline message &message::operator<<(REFIID riid)
+	{
+		OLECHAR riid_string[40];
+		if (StringFromGUID2(riid, riid_string, ARRAYSIZE(riid_string)))
+			operator<<(riid_string);
+		return *this;
+	}
+#endif
 
-		inline message &operator<<(const wchar_t *message)
+#if defined(_HRESULT_DEFINED)
+	template <>
+	inline message &message::operator<<(const HRESULT &hresult) // Note: HRESULT is just an alias for long, so this falsely catches all long values too
+	{
+		switch (hresult)
 		{
-			static_assert(sizeof(wchar_t) == sizeof(uint16_t), "expected 'wchar_t' to use UTF-16 encoding");
-
-			assert(message != nullptr);
-			std::string utf8_message;
-			utf8::unchecked::utf16to8(message, message + wcslen(message), std::back_inserter(utf8_message));
-
-			return operator<<(utf8_message);
+		case E_NOTIMPL:
+			return *this << "E_NOTIMPL";
+		case E_OUTOFMEMORY:
+			return *this << "E_OUTOFMEMORY";
+		case E_INVALIDARG:
+			return *this << "E_INVALIDARG";
+		case E_NOINTERFACE:
+			return *this << "E_NOINTERFACE";
+		case E_FAIL:
+			return *this << "E_FAIL";
+		case 0x8876017C:
+			return *this << "D3DERR_OUTOFVIDEOMEMORY";
+		case 0x88760868:
+			return *this << "D3DERR_DEVICELOST";
+		case 0x8876086A:
+			return *this << "D3DERR_NOTAVAILABLE";
+		case 0x8876086C:
+			return *this << "D3DERR_INVALIDCALL";
+		case 0x88760870:
+			return *this << "D3DERR_DEVICEREMOVED";
+		case 0x88760874:
+			return *this << "D3DERR_DEVICEHUNG";
+		case DXGI_ERROR_INVALID_CALL:
+			return *this << "DXGI_ERROR_INVALID_CALL";
+		case DXGI_ERROR_UNSUPPORTED:
+			return *this << "DXGI_ERROR_UNSUPPORTED";
+		case DXGI_ERROR_DEVICE_REMOVED:
+			return *this << "DXGI_ERROR_DEVICE_REMOVED";
+		case DXGI_ERROR_DEVICE_HUNG:
+			return *this << "DXGI_ERROR_DEVICE_HUNG";
+		case DXGI_ERROR_DEVICE_RESET:
+			return *this << "DXGI_ERROR_DEVICE_RESET";
+		case DXGI_ERROR_DRIVER_INTERNAL_ERROR:
+			return *this << "DXGI_ERROR_DRIVER_INTERNAL_ERROR";
+		default:
+			return *this << std::hex << static_cast<unsigned long>(hresult) << std::dec;
 		}
+	}
+#endif
 
-	private:
-		std::ostringstream _line_stream;
-	};
+	template <>
+	inline message &message::operator<<(const std::wstring &message)
+	{
+		return operator<<(wide_to_utf8(message.data(), message.data() + message.size()));
+	}
+
+	template <>
+	inline message &message::operator<<(const std::filesystem::path &path)
+	{
+		return operator<<('"' + path.u8string() + '"');
+	}
 }
@@ -340,6 +340,9 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
 		}
 		case DLL_PROCESS_DETACH:
 		{
+			// Write remaining log messages and any that follow synchronously, since the background writer thread is gone at this point
+			reshade::log::shutdown();
+
 			LOG(INFO) << "Exiting ...";
 
 #if RESHADE_ADDON
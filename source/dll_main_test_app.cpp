@@ -775,6 +775,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow
 
 	reshade::hooks::uninstall();
 
+	reshade::log::shutdown();
+
 	return static_cast<int>(msg.wParam);
 }
 
@@ -239,6 +239,7 @@ namespace reshadefx
 	{
 		std::string name;
 		reshadefx::type type = {};
+		std::string unique_name;
 		uint32_t size = 0;
 		uint32_t offset = 0;
 		std::vector<annotation> annotations;
@@ -290,6 +291,7 @@ namespace reshadefx
 		std::string vs_entry_point;
 		std::string ps_entry_point;
 		std::string cs_entry_point;
+		std::string enable_uniform_name;
 		uint8_t generate_mipmaps = true;
 		uint8_t clear_render_targets = false;
 		uint8_t srgb_write_enable = false;
@@ -84,5 +84,7 @@ namespace reshadefx
 		std::vector<uint32_t> _loop_break_target_stack;
 		std::vector<uint32_t> _loop_continue_target_stack;
 		reshadefx::function_info *_current_function = nullptr;
+		// Names of uniform variables including their namespace scope, so that pass states can reference them unambiguously
+		std::unordered_map<uint32_t, std::string> _uniform_unique_names;
 	};
 }
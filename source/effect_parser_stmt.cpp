@@ -1577,6 +1577,10 @@ bool reshadefx::parser::parse_variable(type type, std::string name, bool global)
 		uniform_info.name = name;
 		uniform_info.type = type;
 
+		// Add namespace scope to avoid name clashes
+		uniform_info.unique_name = 'V' + current_scope().name + name;
+		std::replace(uniform_info.unique_name.begin(), uniform_info.unique_name.end(), ':', '_');
+
 		uniform_info.annotations = std::move(sampler_info.annotations);
 
 		uniform_info.initializer_value = std::move(initializer.constant);
@@ -1584,6 +1588,8 @@ bool reshadefx::parser::parse_variable(type type, std::string name, bool global)
 
 		symbol = { symbol_type::variable, 0, type };
 		symbol.id = _codegen->define_uniform(variable_location, uniform_info);
+
+		_uniform_unique_names[symbol.id] = uniform_info.unique_name;
 	}
 	// All other variables are separate entities
 	else
@@ -1665,9 +1671,10 @@ bool reshadefx::parser::parse_technique_pass(pass_info &info)
 
 		const bool is_shader_state = state_name.size() > 6 && state_name.compare(state_name.size() - 6, 6, "Shader") == 0; // VertexShader, PixelShader, ComputeShader, ...
 		const bool is_texture_state = state_name.compare(0, 12, "RenderTarget") == 0 && (state_name.size() == 12 || (state_name[12] >= '0' && state_name[12] < '8'));
+		const bool is_uniform_state = state_name == "EnableIf";
 
-		// Shader and render target assignment looks up values in the symbol table, so handle those separately from the other states
-		if (is_shader_state || is_texture_state)
+		// Shader, render target and uniform assignment looks up values in the symbol table, so handle those separately from the other states
+		if (is_shader_state || is_texture_state || is_uniform_state)
 		{
 			std::string identifier;
 			scoped_symbol symbol;
@@ -1741,6 +1748,18 @@ bool reshadefx::parser::parse_technique_pass(pass_info &info)
 						}
 					}
 				}
+				else if (is_uniform_state)
+				{
+					if (!symbol.id)
+						parse_success = false,
+						error(state_location, 3004, "undeclared identifier '" + identifier + "', expected uniform variable name");
+					else if (symbol.op != symbol_type::variable || !symbol.type.has(type::q_uniform) || !symbol.type.is_scalar() || symbol.type.is_array())
+						parse_success = false,
+						error(state_location, 3020, "type mismatch, expected scalar uniform variable name");
+					else
+						// Uniform variables with the same name may be declared in different namespaces, so reference them by their unique name (see 'parse_variable')
+						info.enable_uniform_name = _uniform_unique_names.at(symbol.id);
+				}
 				else
 				{
 					assert(is_texture_state);
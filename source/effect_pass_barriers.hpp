@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "reshade_api_object_impl.hpp"
+#include <algorithm>
+
+namespace reshade
+{
+	/// <summary>
+	/// Resource transitions around a pass of a technique.
+	/// These are compiled once for the whole sequence of passes of a technique (see <see cref="compile"/>), so that rendering only has to replay them.
+	/// </summary>
+	struct effect_pass_barriers
+	{
+		// Resources this pass writes to, which are in shader resource state outside of it
+		std::vector<api::resource> modified_resources;
+		// State the modified resources are in while this pass writes to them
+		api::resource_usage modified_usage = api::resource_usage::render_target;
+		std::vector<api::resource_view> generate_mipmap_views;
+		bool samples_back_buffer = false;
+		bool writes_back_buffer = false;
+
+		// Transitions to issue before this pass, which include the deferred transitions of the previous pass (the first 'num_previous_pass_barriers' entries)
+		std::vector<api::resource> barrier_resources;
+		std::vector<api::resource_usage> barrier_states_old;
+		std::vector<api::resource_usage> barrier_states_new;
+		uint32_t num_previous_pass_barriers = 0;
+		// Whether the transitions back to shader resource state after this pass are merged into the ones before the next pass
+		bool defer_end_barriers = false;
+		// Whether the back buffer has to be copied before this pass, which is only the case if it samples the back buffer and it was modified since the last copy
+		bool copy_back_buffer = false;
+
+		/// <summary>
+		/// Compiles the transitions of a sequence of passes.
+		/// The back buffer is only copied before passes that sample it and only if it was modified since the last copy.
+		/// The transitions back to shader resource state after a pass are merged into the batch issued before the next pass where possible.
+		/// </summary>
+		/// <typeparam name="T">Type of the passes, which has to derive from this one.</typeparam>
+		template <typename T>
+		static void compile(std::vector<T> &passes)
+		{
+			const size_t num_passes = passes.size();
+
+			// Application or other techniques may have modified the back buffer before the first pass
+			bool back_buffer_modified = true;
+
+			for (size_t pass_index = 0; pass_index < num_passes; ++pass_index)
+			{
+				effect_pass_barriers &pass = passes[pass_index];
+
+				pass.barrier_resources.clear();
+				pass.barrier_states_old.clear();
+				pass.barrier_states_new.clear();
+				pass.num_previous_pass_barriers = 0;
+				pass.defer_end_barriers = false;
+				pass.copy_back_buffer = false;
+
+				if (back_buffer_modified && pass.samples_back_buffer)
+				{
+					pass.copy_back_buffer = true;
+					back_buffer_modified = false;
+				}
+
+				if (pass.writes_back_buffer)
+					back_buffer_modified = true;
+
+				if (pass_index != 0 && passes[pass_index - 1].defer_end_barriers)
+				{
+					const effect_pass_barriers &prev_pass = passes[pass_index - 1];
+
+					pass.barrier_resources = prev_pass.modified_resources;
+					pass.barrier_states_old.assign(prev_pass.modified_resources.size(), prev_pass.modified_usage);
+					pass.barrier_states_new.assign(prev_pass.modified_resources.size(), api::resource_usage::shader_resource);
+					pass.num_previous_pass_barriers = static_cast<uint32_t>(prev_pass.modified_resources.size());
+				}
+
+				pass.barrier_resources.insert(pass.barrier_resources.end(), pass.modified_resources.begin(), pass.modified_resources.end());
+				pass.barrier_states_old.resize(pass.barrier_resources.size(), api::resource_usage::shader_resource);
+				pass.barrier_states_new.resize(pass.barrier_resources.size(), pass.modified_usage);
+
+				// Transitions of this pass can be merged into the ones of the next pass, unless mipmap generation requires them to happen right after this pass, or the next pass modifies the same resources again (which must not appear twice in a single batch)
+				if (pass_index + 1 < num_passes && pass.generate_mipmap_views.empty())
+				{
+					const std::vector<api::resource> &next_modified_resources = passes[pass_index + 1].modified_resources;
+
+					pass.defer_end_barriers = std::none_of(pass.modified_resources.begin(), pass.modified_resources.end(),
+						[&next_modified_resources](const api::resource resource) {
+							return std::find(next_modified_resources.begin(), next_modified_resources.end(), resource) != next_modified_resources.end();
+						});
+				}
+			}
+		}
+
+		/// <summary>
+		/// Issues the transitions before this pass as a single batch, together with the copy of the back buffer into <paramref name="color_tex"/> if <paramref name="copy_back_buffer_now"/> is set.
+		/// </summary>
+		void record_begin_barriers(api::command_list *cmd_list, bool copy_back_buffer_now, api::resource back_buffer, api::resource color_tex) const
+		{
+			const uint32_t num_begin_barriers = static_cast<uint32_t>(barrier_resources.size());
+
+			if (copy_back_buffer_now)
+			{
+				// Save back buffer of previous pass, merging the transitions for the copy into the batch
+				const uint32_t num_previous_barriers = num_previous_pass_barriers;
+
+				temp_mem<api::resource> resources(num_begin_barriers + 2);
+				temp_mem<api::resource_usage> state_old(num_begin_barriers + 2), state_new(num_begin_barriers + 2);
+				std::copy_n(barrier_resources.data(), num_previous_barriers, resources.p);
+				std::copy_n(barrier_states_old.data(), num_previous_barriers, state_old.p);
+				std::copy_n(barrier_states_new.data(), num_previous_barriers, state_new.p);
+				std::copy_n(barrier_resources.data() + num_previous_barriers, num_begin_barriers - num_previous_barriers, resources.p + num_previous_barriers + 2);
+				std::copy_n(barrier_states_old.data() + num_previous_barriers, num_begin_barriers - num_previous_barriers, state_old.p + num_previous_barriers + 2);
+				std::copy_n(barrier_states_new.data() + num_previous_barriers, num_begin_barriers - num_previous_barriers, state_new.p + num_previous_barriers + 2);
+
+				resources[num_previous_barriers + 0] = back_buffer;
+				resources[num_previous_barriers + 1] = color_tex;
+				state_old[num_previous_barriers + 0] = api::resource_usage::render_target;
+				state_old[num_previous_barriers + 1] = api::resource_usage::shader_resource;
+				state_new[num_previous_barriers + 0] = api::resource_usage::copy_source;
+				state_new[num_previous_barriers + 1] = api::resource_usage::copy_dest;
+
+				cmd_list->barrier(num_previous_barriers + 2, resources.p, state_old.p, state_new.p);
+				cmd_list->copy_texture_region(back_buffer, 0, nullptr, color_tex, 0, nullptr);
+
+				std::swap(state_old[num_previous_barriers + 0], state_new[num_previous_barriers + 0]);
+				std::swap(state_old[num_previous_barriers + 1], state_new[num_previous_barriers + 1]);
+
+				cmd_list->barrier(num_begin_barriers - num_previous_barriers + 2, resources.p + num_previous_barriers, state_old.p + num_previous_barriers, state_new.p + num_previous_barriers);
+			}
+			else if (num_begin_barriers != 0)
+			{
+				cmd_list->barrier(num_begin_barriers, barrier_resources.data(), barrier_states_old.data(), barrier_states_new.data());
+			}
+		}
+
+		/// <summary>
+		/// Issues the transitions back to shader resource state after this pass, unless they were merged into the transitions before the next pass.
+		/// </summary>
+		void record_end_barriers(api::command_list *cmd_list) const
+		{
+			const uint32_t num_barriers = static_cast<uint32_t>(modified_resources.size());
+
+			if (!defer_end_barriers && num_barriers != 0)
+			{
+				temp_mem<api::resource_usage> state_old(num_barriers), state_new(num_barriers);
+				std::fill_n(state_old.p, num_barriers, modified_usage);
+				std::fill_n(state_new.p, num_barriers, api::resource_usage::shader_resource);
+				cmd_list->barrier(num_barriers, modified_resources.data(), state_old.p, state_new.p);
+			}
+		}
+	};
+}
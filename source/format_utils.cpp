@@ -0,0 +1,591 @@
+/*
+ * Copyright (C) 2023 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "format_utils.hpp"
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX // Keep 'std::min' and 'std::max' usable below
+	#endif
+	#include <Windows.h>
+#endif
+
+// Can be defined to zero beforehand to force the scalar reference implementations (used by the tests to compare the two)
+#ifndef RESHADE_FORMAT_UTILS_SSE2
+	#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+		#define RESHADE_FORMAT_UTILS_SSE2 1
+	#else
+		#define RESHADE_FORMAT_UTILS_SSE2 0
+	#endif
+#endif
+#if RESHADE_FORMAT_UTILS_SSE2
+	#include <emmintrin.h>
+#endif
+
+using namespace reshade;
+
+// Converts 'width' pixels of a single row starting at 'x', so that kernels can hand the remainder of a row to the scalar reference implementation
+typedef void (*row_conversion_func)(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width);
+
+// Only split work across threads for images that are large enough for it to be worth the synchronization overhead (roughly 1080p and up), smaller images are converted serially on the calling thread
+static constexpr size_t min_pixels_for_parallel_conversion = 1920 * 540;
+// Worker threads exit again after being idle for this long, so that they do not linger around when no conversions are happening (e.g. after taking a screenshot)
+static constexpr std::chrono::seconds conversion_worker_idle_timeout(10);
+
+namespace
+{
+	struct row_conversion_job
+	{
+		row_conversion_func func;
+		uint32_t width, height;
+		const uint8_t *src; size_t src_row_pitch;
+		uint8_t *dst; size_t dst_row_pitch;
+		uint32_t rows_per_split, num_splits;
+		std::atomic<uint32_t> next_split { 0 };
+		// Number of worker threads currently working on this job (protected by the pool mutex)
+		uint32_t num_workers = 0;
+
+		void run()
+		{
+			for (uint32_t i; (i = next_split.fetch_add(1)) < num_splits;)
+				for (uint32_t y = i * rows_per_split, y_end = std::min(y + rows_per_split, height); y < y_end; ++y)
+					func(src + y * src_row_pitch, dst + y * dst_row_pitch, 0, width);
+		}
+	};
+
+	/// <summary>
+	/// Pool of worker threads that are kept alive across conversions, so that converting consecutive frames (e.g. when taking screenshots in quick succession) does not create new threads every time.
+	/// </summary>
+	class row_conversion_pool
+	{
+	public:
+		static row_conversion_pool &instance()
+		{
+			// Intentionally leaked, so that idle worker threads never wait on a destroyed condition variable during process shutdown
+			static row_conversion_pool *const pool = new row_conversion_pool();
+			return *pool;
+		}
+
+		void run(row_conversion_job &job)
+		{
+			{
+				const std::unique_lock<std::mutex> lock(_mutex);
+				_jobs.push_back(&job);
+
+				// Failing to start additional workers is not fatal, since the calling thread simply ends up converting more of the rows itself
+				while (_num_workers < job.num_splits - 1 && start_worker())
+					_num_workers++;
+			}
+			_job_added.notify_all();
+
+			// Convert rows on the calling thread too while the workers are busy
+			job.run();
+
+			std::unique_lock<std::mutex> lock(_mutex);
+			// Ensure no more workers can pick up the job, then wait for the ones still working on it to finish
+			remove_job(&job);
+			_job_finished.wait(lock, [&job]() { return job.num_workers == 0; });
+		}
+
+	private:
+		bool start_worker()
+		{
+#ifdef _WIN32
+			// Keep a reference to this module while the thread is running, so that it cannot be unloaded underneath it (released again by 'FreeLibraryAndExitThread' below)
+			HMODULE module = nullptr;
+			if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, reinterpret_cast<LPCWSTR>(&instance), &module))
+				return false;
+
+			const HANDLE thread = CreateThread(nullptr, 0, [](LPVOID module) -> DWORD {
+				instance().worker_main();
+				FreeLibraryAndExitThread(static_cast<HMODULE>(module), 0);
+			}, module, 0, nullptr);
+			if (thread == nullptr)
+			{
+				FreeLibrary(module);
+				return false;
+			}
+
+			CloseHandle(thread);
+			return true;
+#else
+			try
+			{
+				std::thread([this]() { worker_main(); }).detach();
+				return true;
+			}
+			catch (const std::system_error &)
+			{
+				return false;
+			}
+#endif
+		}
+
+		void worker_main()
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+
+			while (_job_added.wait_for(lock, conversion_worker_idle_timeout, [this]() { return !_jobs.empty(); }))
+			{
+				row_conversion_job *const job = _jobs.front();
+				job->num_workers++;
+
+				lock.unlock();
+				job->run();
+				lock.lock();
+
+				// All rows of the job have been handed out at this point, so make room for the next one
+				remove_job(job);
+
+				if (--job->num_workers == 0)
+					_job_finished.notify_all();
+			}
+
+			_num_workers--;
+		}
+
+		void remove_job(row_conversion_job *job)
+		{
+			if (const auto it = std::find(_jobs.begin(), _jobs.end(), job); it != _jobs.end())
+				_jobs.erase(it);
+		}
+
+		std::mutex _mutex;
+		std::condition_variable _job_added, _job_finished;
+		std::vector<row_conversion_job *> _jobs;
+		uint32_t _num_workers = 0;
+	};
+}
+
+static void convert_rows(row_conversion_func func, uint32_t width, uint32_t height, const uint8_t *src, size_t src_row_pitch, uint8_t *dst, size_t dst_row_pitch)
+{
+	uint32_t num_splits = 1;
+	if (static_cast<size_t>(width) * static_cast<size_t>(height) >= min_pixels_for_parallel_conversion)
+		num_splits = std::min(std::max(std::thread::hardware_concurrency(), 1u), std::min(height / 64, 8u));
+
+	if (num_splits <= 1)
+	{
+		for (uint32_t y = 0; y < height; ++y)
+			func(src + y * src_row_pitch, dst + y * dst_row_pitch, 0, width);
+		return;
+	}
+
+	row_conversion_job job;
+	job.func = func;
+	job.width = width;
+	job.height = height;
+	job.src = src;
+	job.src_row_pitch = src_row_pitch;
+	job.dst = dst;
+	job.dst_row_pitch = dst_row_pitch;
+	job.rows_per_split = (height + num_splits - 1) / num_splits;
+	job.num_splits = num_splits;
+
+	row_conversion_pool::instance().run(job);
+}
+
+static inline uint32_t load_u32(const uint8_t *src)
+{
+	uint32_t value;
+	std::memcpy(&value, src, sizeof(value));
+	return value;
+}
+static inline void store_u32(uint8_t *dst, uint32_t value)
+{
+	std::memcpy(dst, &value, sizeof(value));
+}
+
+static inline float half_to_float(uint16_t h)
+{
+	// Shift exponent and mantissa into place and rebias via a multiplication, which handles denormals as well
+	uint32_t bits = static_cast<uint32_t>(h & 0x7FFF) << 13;
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	value *= 5.192296858534828e+33f; // 2^112
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	// Infinity and NaN keep their maximum exponent
+	if ((h & 0x7FFF) >= 0x7C00)
+		bits |= 0x7F800000;
+	bits |= static_cast<uint32_t>(h & 0x8000) << 16;
+
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static inline uint8_t tone_map_color_component(float c)
+{
+	// Reinhard tone mapping followed by an approximate gamma of 2, mapping scRGB values to 8-bit
+	c = c > 0.0f ? c : 0.0f; // Also maps NaN to zero
+	c = c < 65504.0f ? c : 65504.0f;
+	c = std::sqrt(c / (1.0f + c));
+	return static_cast<uint8_t>(static_cast<int32_t>(c * 255.0f + 0.5f));
+}
+static inline uint8_t clamp_alpha_component(float c)
+{
+	c = c > 0.0f ? c : 0.0f;
+	c = c < 1.0f ? c : 1.0f;
+	return static_cast<uint8_t>(static_cast<int32_t>(c * 255.0f + 0.5f));
+}
+
+static inline uint32_t r10g10b10a2_to_rgba8(uint32_t rgba)
+{
+	// Divide by 4 to get 10-bit range (0-1023) into 8-bit range (0-255) and multiply 2-bit alpha by 85 to get it into 8-bit range
+	return
+		(((rgba >>  2) & 0xFF)      ) |
+		(((rgba >> 12) & 0xFF) <<  8) |
+		(((rgba >> 22) & 0xFF) << 16) |
+		(((rgba >> 30) * 85  ) << 24);
+}
+static inline uint32_t swap_red_blue(uint32_t rgba)
+{
+	return (rgba & 0xFF00FF00) | ((rgba >> 16) & 0xFF) | ((rgba & 0xFF) << 16);
+}
+
+// Scalar reference implementations, which are also used to handle the remainder of a row not covered by the vectorized kernels
+
+static void convert_r8_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+		store_u32(dst + x * 4, src[x] | 0xFF000000);
+}
+static void convert_r8g8_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+		store_u32(dst + x * 4, src[x * 2 + 0] | (src[x * 2 + 1] << 8) | 0xFF000000);
+}
+static void convert_r8g8b8a8_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	std::memcpy(dst + x * 4, src + x * 4, (width - x) * 4);
+}
+static void convert_r8g8b8x8_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+		store_u32(dst + x * 4, load_u32(src + x * 4) | 0xFF000000);
+}
+static void convert_b8g8r8a8_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+		store_u32(dst + x * 4, swap_red_blue(load_u32(src + x * 4)));
+}
+static void convert_b8g8r8x8_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+		store_u32(dst + x * 4, swap_red_blue(load_u32(src + x * 4)) | 0xFF000000);
+}
+static void convert_r10g10b10a2_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+		store_u32(dst + x * 4, r10g10b10a2_to_rgba8(load_u32(src + x * 4)));
+}
+static void convert_b10g10r10a2_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+		store_u32(dst + x * 4, swap_red_blue(r10g10b10a2_to_rgba8(load_u32(src + x * 4))));
+}
+static void convert_r16g16b16a16_float_to_rgba8_scalar(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x < width; ++x)
+	{
+		uint16_t rgba[4];
+		std::memcpy(rgba, src + x * 8, sizeof(rgba));
+
+		dst[x * 4 + 0] = tone_map_color_component(half_to_float(rgba[0]));
+		dst[x * 4 + 1] = tone_map_color_component(half_to_float(rgba[1]));
+		dst[x * 4 + 2] = tone_map_color_component(half_to_float(rgba[2]));
+		dst[x * 4 + 3] = clamp_alpha_component(half_to_float(rgba[3]));
+	}
+}
+
+#if RESHADE_FORMAT_UTILS_SSE2
+
+static void convert_r8_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+	for (; x + 16 <= width; x += 16)
+	{
+		const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+		const __m128i r16_lo = _mm_unpacklo_epi8(r, zero);
+		const __m128i r16_hi = _mm_unpackhi_epi8(r, zero);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 +  0), _mm_or_si128(_mm_unpacklo_epi16(r16_lo, zero), alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 16), _mm_or_si128(_mm_unpackhi_epi16(r16_lo, zero), alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 32), _mm_or_si128(_mm_unpacklo_epi16(r16_hi, zero), alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 48), _mm_or_si128(_mm_unpackhi_epi16(r16_hi, zero), alpha));
+	}
+
+	convert_r8_to_rgba8_scalar(src, dst, x, width);
+}
+static void convert_r8g8_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+	for (; x + 8 <= width; x += 8)
+	{
+		const __m128i rg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 2));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 +  0), _mm_or_si128(_mm_unpacklo_epi16(rg, zero), alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 16), _mm_or_si128(_mm_unpackhi_epi16(rg, zero), alpha));
+	}
+
+	convert_r8g8_to_rgba8_scalar(src, dst, x, width);
+}
+static void convert_r8g8b8x8_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+	for (; x + 4 <= width; x += 4)
+	{
+		const __m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_or_si128(rgba, alpha));
+	}
+
+	convert_r8g8b8x8_to_rgba8_scalar(src, dst, x, width);
+}
+
+static inline __m128i swap_red_blue_sse2(__m128i bgra)
+{
+	const __m128i mask_ga = _mm_set1_epi32(0xFF00FF00);
+	const __m128i mask_low = _mm_set1_epi32(0x000000FF);
+
+	return _mm_or_si128(
+		_mm_and_si128(bgra, mask_ga),
+		_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(bgra, 16), mask_low),
+			_mm_slli_epi32(_mm_and_si128(bgra, mask_low), 16)));
+}
+
+static void convert_b8g8r8a8_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x + 4 <= width; x += 4)
+	{
+		const __m128i bgra = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), swap_red_blue_sse2(bgra));
+	}
+
+	convert_b8g8r8a8_to_rgba8_scalar(src, dst, x, width);
+}
+static void convert_b8g8r8x8_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+	for (; x + 4 <= width; x += 4)
+	{
+		const __m128i bgra = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_or_si128(swap_red_blue_sse2(bgra), alpha));
+	}
+
+	convert_b8g8r8x8_to_rgba8_scalar(src, dst, x, width);
+}
+
+static inline __m128i r10g10b10a2_to_rgba8_sse2(__m128i rgba)
+{
+	const __m128i mask_low = _mm_set1_epi32(0x000000FF);
+
+	const __m128i r = _mm_and_si128(_mm_srli_epi32(rgba,  2), mask_low);
+	const __m128i g = _mm_and_si128(_mm_srli_epi32(rgba, 12), mask_low);
+	const __m128i b = _mm_and_si128(_mm_srli_epi32(rgba, 22), mask_low);
+	__m128i a = _mm_srli_epi32(rgba, 30);
+	// Multiplication of a 2-bit value by 85 (0b01010101) is the same as replicating it four times
+	a = _mm_or_si128(a, _mm_slli_epi32(a, 2));
+	a = _mm_or_si128(a, _mm_slli_epi32(a, 4));
+
+	return _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+}
+
+static void convert_r10g10b10a2_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x + 4 <= width; x += 4)
+	{
+		const __m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), r10g10b10a2_to_rgba8_sse2(rgba));
+	}
+
+	convert_r10g10b10a2_to_rgba8_scalar(src, dst, x, width);
+}
+static void convert_b10g10r10a2_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	for (; x + 4 <= width; x += 4)
+	{
+		const __m128i bgra = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), swap_red_blue_sse2(r10g10b10a2_to_rgba8_sse2(bgra)));
+	}
+
+	convert_b10g10r10a2_to_rgba8_scalar(src, dst, x, width);
+}
+
+static inline __m128 half_to_float_sse2(__m128i h)
+{
+	// Same approach as the scalar 'half_to_float', with 'h' containing one zero-extended half value per 32-bit lane
+	const __m128i em = _mm_and_si128(h, _mm_set1_epi32(0x7FFF));
+	const __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+	const __m128i inf_nan = _mm_and_si128(_mm_cmpgt_epi32(em, _mm_set1_epi32(0x7BFF)), _mm_set1_epi32(0x7F800000));
+
+	const __m128 value = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(em, 13)), _mm_castsi128_ps(_mm_set1_epi32(0x77800000))); // 2^112
+	return _mm_or_ps(value, _mm_castsi128_ps(_mm_or_si128(inf_nan, sign)));
+}
+static inline __m128i tone_map_rgba_sse2(__m128 rgba)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	// Select tone mapped values for the color components and clamped values for the alpha component
+	const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+	// Operand order matters here, so that NaN is mapped to zero like in the scalar implementation
+	__m128 color = _mm_min_ps(_mm_max_ps(rgba, zero), _mm_set1_ps(65504.0f));
+	color = _mm_sqrt_ps(_mm_div_ps(color, _mm_add_ps(one, color)));
+	const __m128 alpha = _mm_min_ps(_mm_max_ps(rgba, zero), one);
+
+	const __m128 result = _mm_or_ps(_mm_andnot_ps(alpha_mask, color), _mm_and_ps(alpha_mask, alpha));
+	return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(result, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+}
+
+static void convert_r16g16b16a16_float_to_rgba8_sse2(const uint8_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; x + 4 <= width; x += 4)
+	{
+		const __m128i h01 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 8 +  0));
+		const __m128i h23 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 8 + 16));
+
+		const __m128i p0 = tone_map_rgba_sse2(half_to_float_sse2(_mm_unpacklo_epi16(h01, zero)));
+		const __m128i p1 = tone_map_rgba_sse2(half_to_float_sse2(_mm_unpackhi_epi16(h01, zero)));
+		const __m128i p2 = tone_map_rgba_sse2(half_to_float_sse2(_mm_unpacklo_epi16(h23, zero)));
+		const __m128i p3 = tone_map_rgba_sse2(half_to_float_sse2(_mm_unpackhi_epi16(h23, zero)));
+
+		// All values are in 0-255 range at this point, so saturation does not change them
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+	}
+
+	convert_r16g16b16a16_float_to_rgba8_scalar(src, dst, x, width);
+}
+
+#endif
+
+#if RESHADE_FORMAT_UTILS_SSE2
+	#define ROW_CONVERSION_FUNC(name) name##_sse2
+#else
+	#define ROW_CONVERSION_FUNC(name) name##_scalar
+#endif
+
+static row_conversion_func find_rgba8_conversion(api::format format)
+{
+	switch (format)
+	{
+	case api::format::r8_unorm:
+		return ROW_CONVERSION_FUNC(convert_r8_to_rgba8);
+	case api::format::r8g8_unorm:
+		return ROW_CONVERSION_FUNC(convert_r8g8_to_rgba8);
+	case api::format::r8g8b8a8_unorm:
+		return convert_r8g8b8a8_to_rgba8_scalar; // Plain copy
+	case api::format::r8g8b8x8_unorm:
+		return ROW_CONVERSION_FUNC(convert_r8g8b8x8_to_rgba8);
+	case api::format::b8g8r8a8_unorm:
+		return ROW_CONVERSION_FUNC(convert_b8g8r8a8_to_rgba8);
+	case api::format::b8g8r8x8_unorm:
+		return ROW_CONVERSION_FUNC(convert_b8g8r8x8_to_rgba8);
+	case api::format::r10g10b10a2_unorm:
+		return ROW_CONVERSION_FUNC(convert_r10g10b10a2_to_rgba8);
+	case api::format::b10g10r10a2_unorm:
+		return ROW_CONVERSION_FUNC(convert_b10g10r10a2_to_rgba8);
+	case api::format::r16g16b16a16_float:
+		return ROW_CONVERSION_FUNC(convert_r16g16b16a16_float_to_rgba8);
+	default:
+		return nullptr;
+	}
+}
+
+#undef ROW_CONVERSION_FUNC
+
+bool reshade::utils::is_rgba8_conversion_supported(api::format format)
+{
+	return find_rgba8_conversion(format) != nullptr;
+}
+bool reshade::utils::convert_pixels_to_rgba8(api::format format, uint32_t width, uint32_t height, const void *src, size_t src_row_pitch, uint8_t *dst, size_t dst_row_pitch)
+{
+	const row_conversion_func func = find_rgba8_conversion(format);
+	if (func == nullptr)
+		return false;
+
+	convert_rows(func, width, height, static_cast<const uint8_t *>(src), src_row_pitch, dst, dst_row_pitch);
+	return true;
+}
+
+void reshade::utils::collapse_rgba_components(void *pixels, size_t num_pixels, uint32_t num_components, uint32_t component_size)
+{
+	if (num_components >= 4)
+		return;
+
+	size_t i = 0;
+	uint8_t *const data = static_cast<uint8_t *>(pixels);
+	const size_t pixel_size = static_cast<size_t>(num_components) * component_size;
+
+	// Blocks are read entirely before their (smaller) result is written, and the result never reaches past the start of the next block, so this works in-place
+#if RESHADE_FORMAT_UTILS_SSE2
+	if (component_size == 1 && num_components == 1)
+	{
+		const __m128i mask = _mm_set1_epi32(0xFF);
+
+		for (; i + 16 <= num_pixels; i += 16)
+		{
+			const __m128i p0 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 4 +  0)), mask);
+			const __m128i p1 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 4 + 16)), mask);
+			const __m128i p2 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 4 + 32)), mask);
+			const __m128i p3 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 4 + 48)), mask);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+		}
+	}
+	else if (component_size == 1 && num_components == 2)
+	{
+		for (; i + 8 <= num_pixels; i += 8)
+		{
+			// Sign-extend the lower 16 bits, so that the signed saturation in the pack instruction leaves them untouched
+			const __m128i p0 = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 4 +  0)), 16), 16);
+			const __m128i p1 = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 4 + 16)), 16), 16);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(data + i * 2), _mm_packs_epi32(p0, p1));
+		}
+	}
+	else if (component_size == 4 && num_components == 1)
+	{
+		for (; i + 4 <= num_pixels; i += 4)
+		{
+			const __m128 p0 = _mm_loadu_ps(reinterpret_cast<const float *>(data + i * 16 +  0));
+			const __m128 p1 = _mm_loadu_ps(reinterpret_cast<const float *>(data + i * 16 + 16));
+			const __m128 p2 = _mm_loadu_ps(reinterpret_cast<const float *>(data + i * 16 + 32));
+			const __m128 p3 = _mm_loadu_ps(reinterpret_cast<const float *>(data + i * 16 + 48));
+
+			_mm_storeu_ps(reinterpret_cast<float *>(data + i * 4), _mm_movelh_ps(_mm_unpacklo_ps(p0, p1), _mm_unpacklo_ps(p2, p3)));
+		}
+	}
+	else if (component_size == 4 && num_components == 2)
+	{
+		for (; i + 2 <= num_pixels; i += 2)
+		{
+			const __m128 p0 = _mm_loadu_ps(reinterpret_cast<const float *>(data + i * 16 +  0));
+			const __m128 p1 = _mm_loadu_ps(reinterpret_cast<const float *>(data + i * 16 + 16));
+
+			_mm_storeu_ps(reinterpret_cast<float *>(data + i * 8), _mm_movelh_ps(p0, p1));
+		}
+	}
+#endif
+
+	for (; i < num_pixels; ++i)
+		std::memmove(data + i * pixel_size, data + i * 4 * component_size, pixel_size);
+}
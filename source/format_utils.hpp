@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2023 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "reshade_api_format.hpp"
+#include <cstddef>
+
+namespace reshade::utils
+{
+	/// <summary>
+	/// Checks whether pixel data in the specified format can be converted to 8-bit RGBA via <see cref="convert_pixels_to_rgba8"/>.
+	/// </summary>
+	bool is_rgba8_conversion_supported(api::format format);
+	/// <summary>
+	/// Converts pixel data in the specified format to 8-bit RGBA.
+	/// Formats without alpha channel get an opaque alpha, BGR formats are swizzled and high dynamic range floating-point formats are tone mapped.
+	/// Large images are converted in parallel, split by rows.
+	/// </summary>
+	/// <param name="format">Format of the source pixel data.</param>
+	/// <param name="width">Width of the image in pixels.</param>
+	/// <param name="height">Height of the image in pixels.</param>
+	/// <param name="src">Pointer to the source pixel data.</param>
+	/// <param name="src_row_pitch">Size of a row of the source pixel data in bytes, including any padding.</param>
+	/// <param name="dst">Pointer to the destination buffer, which has to be large enough to hold <paramref name="height"/> rows of <paramref name="dst_row_pitch"/> bytes.</param>
+	/// <param name="dst_row_pitch">Size of a row in the destination buffer in bytes.</param>
+	bool convert_pixels_to_rgba8(api::format format, uint32_t width, uint32_t height, const void *src, size_t src_row_pitch, uint8_t *dst, size_t dst_row_pitch);
+
+	/// <summary>
+	/// Reduces tightly packed RGBA pixel data in-place to the specified number of components per pixel (by dropping trailing components).
+	/// </summary>
+	/// <param name="pixels">Pointer to the pixel data.</param>
+	/// <param name="num_pixels">Number of pixels in the data.</param>
+	/// <param name="num_components">Number of components to keep per pixel (1, 2 or 4).</param>
+	/// <param name="component_size">Size of a single component in bytes (1 for 8-bit integer data or 4 for 32-bit floating-point data).</param>
+	void collapse_rgba_components(void *pixels, size_t num_pixels, uint32_t num_components, uint32_t component_size);
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2014 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+#include "hook_index.hpp"
+#include <algorithm>
+
+static inline size_t hash_address(reshade::hook::address address)
+{
+	// Mix all bits of the address, since neighboring virtual function table entries only differ in the low bits and function addresses are often aligned
+	uint64_t h = reinterpret_cast<uintptr_t>(address);
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDull;
+	h ^= h >> 33;
+	return static_cast<size_t>(h);
+}
+
+static void insert_into_index(std::vector<uint32_t> &table, const std::vector<reshade::hook> &hooks, uint32_t hook_index, reshade::hook::address reshade::hook::*key)
+{
+	const size_t mask = table.size() - 1;
+	const reshade::hook::address address = hooks[hook_index].*key;
+
+	for (size_t slot = hash_address(address) & mask; true; slot = (slot + 1) & mask)
+	{
+		if (table[slot] == 0)
+		{
+			table[slot] = hook_index + 1;
+			break;
+		}
+
+		// Only keep the first hook for a given address, to match the order of the hook list
+		if (hooks[table[slot] - 1].*key == address)
+			break;
+	}
+}
+static const reshade::hook *find_in_index(const std::vector<uint32_t> &table, const std::vector<reshade::hook> &hooks, reshade::hook::address address, reshade::hook::address reshade::hook::*key)
+{
+	const size_t mask = table.size() - 1;
+
+	for (size_t slot = hash_address(address) & mask; table[slot] != 0; slot = (slot + 1) & mask)
+	{
+		const reshade::hook &hook = hooks[table[slot] - 1];
+		if (hook.*key == address)
+			return &hook;
+	}
+
+	return nullptr;
+}
+
+reshade::hook_index::hook_index(std::vector<hook> hooks) :
+	_hooks(std::move(hooks))
+{
+	// Keep load factor at or below 50%, so that probe sequences stay short
+	size_t table_size = 16;
+	while (table_size < _hooks.size() * 2)
+		table_size *= 2;
+
+	_by_target.resize(table_size);
+	_by_replacement.resize(table_size);
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(_hooks.size()); ++i)
+	{
+		insert_into_index(_by_target, _hooks, i, &hook::target);
+		insert_into_index(_by_replacement, _hooks, i, &hook::replacement);
+	}
+}
+
+const reshade::hook *reshade::hook_index::find(hook::address target, hook::address replacement) const
+{
+	// If a target address is provided, find the matching hook with it, since it is unique for most hooks
+	if (target != nullptr)
+	{
+		const hook *const hook = find_in_index(_by_target, _hooks, target, &hook::target);
+		if (hook == nullptr || replacement == nullptr || hook->replacement == replacement)
+			return hook;
+
+		// Multiple hooks were installed for the same target, so fall back to searching the whole list for the one with the matching replacement function
+		const auto it = std::find_if(_hooks.cbegin(), _hooks.cend(),
+			[target, replacement](const reshade::hook &hook) {
+				return hook.replacement == replacement && hook.target == target;
+			});
+		return it != _hooks.cend() ? &(*it) : nullptr;
+	}
+
+	// Otherwise search with the replacement function address (since the target address may not be known inside a replacement function)
+	return find_in_index(_by_replacement, _hooks, replacement, &hook::replacement);
+}
+
+const reshade::hook_index *reshade::published_hook_index::publish(std::unique_ptr<const hook_index> index)
+{
+	const hook_index *const result = index.get();
+
+	if (_current_owner != nullptr)
+		_retired.push_back(std::move(_current_owner));
+	_current_owner = std::move(index);
+	_current.store(result);
+
+	// Any reader that started after the store above sees the new snapshot, so once there are no readers at all, none can still be accessing a superseded one
+	// Readers may keep threads busy with lookups for a long time, in which case reclamation is simply retried on the next publish
+	if (!_retired.empty() && !_readers.has_readers())
+		_retired.clear();
+
+	return result;
+}
+
+void reshade::published_hook_index::reset()
+{
+	_current.store(nullptr);
+	_current_owner.reset();
+	_retired.clear();
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2014 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+#pragma once
+
+#include "hook.hpp"
+#include "reader_tracker.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace reshade
+{
+	/// <summary>
+	/// Immutable snapshot of a list of hooks with open addressing tables for lookup by target and by replacement address.
+	/// </summary>
+	class hook_index
+	{
+	public:
+		explicit hook_index(std::vector<hook> hooks);
+
+		/// <summary>
+		/// Returns the number of hooks in this snapshot.
+		/// </summary>
+		size_t size() const { return _hooks.size(); }
+
+		/// <summary>
+		/// Finds the first hook with the specified target and/or replacement address.
+		/// </summary>
+		/// <param name="target">Original target address of the hooked function (optional).</param>
+		/// <param name="replacement">Address of the hook function (optional if a target address is provided).</param>
+		/// <returns>Pointer to the hook in this snapshot, or <see langword="nullptr"/> if there is no such hook.</returns>
+		const hook *find(hook::address target, hook::address replacement) const;
+
+	private:
+		std::vector<hook> _hooks;
+		// Each slot contains the index into '_hooks' plus one, or zero for an empty slot
+		std::vector<uint32_t> _by_target;
+		std::vector<uint32_t> _by_replacement;
+	};
+
+	/// <summary>
+	/// Publishes <see cref="hook_index"/> snapshots, so that lookups do not need any locking.
+	/// Superseded snapshots are destroyed once no reader can still be accessing them.
+	/// </summary>
+	class published_hook_index
+	{
+	public:
+		/// <summary>
+		/// Keeps the snapshot that was current when it was constructed alive while it exists.
+		/// </summary>
+		class read_guard
+		{
+		public:
+			explicit read_guard(const published_hook_index &owner) :
+				_scope(owner._readers), _index(owner._current.load()) {}
+
+			read_guard(const read_guard &) = delete;
+			read_guard &operator=(const read_guard &) = delete;
+
+			const hook_index *get() const { return _index; }
+
+		private:
+			const reader_tracker::scope _scope;
+			const hook_index *const _index;
+		};
+
+		published_hook_index() = default;
+		~published_hook_index() { reset(); }
+
+		/// <summary>
+		/// Begins a lookup in the current snapshot.
+		/// </summary>
+		read_guard read() const { return read_guard(*this); }
+
+		/// <summary>
+		/// Replaces the current snapshot and destroys superseded snapshots that are no longer in use.
+		/// Calls to this have to be serialized by the caller.
+		/// </summary>
+		const hook_index *publish(std::unique_ptr<const hook_index> index);
+		/// <summary>
+		/// Destroys all snapshots.
+		/// Calls to this have to be serialized by the caller and may not happen while any other thread is reading.
+		/// </summary>
+		void reset();
+
+		/// <summary>
+		/// Returns the number of superseded snapshots that are still waiting for readers to finish before they can be destroyed.
+		/// </summary>
+		size_t num_retired() const { return _retired.size(); }
+
+	private:
+		mutable reader_tracker _readers;
+		std::atomic<const hook_index *> _current = nullptr;
+		std::unique_ptr<const hook_index> _current_owner;
+		std::vector<std::unique_ptr<const hook_index>> _retired;
+	};
+}
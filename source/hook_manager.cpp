@@ -5,9 +5,12 @@
 
 #include "dll_log.hpp"
 #include "hook_manager.hpp"
+#include "hook_index.hpp"
 #include <cstring>
 #include <algorithm>
 #include <vector>
+#include <memory>
+#include <atomic>
 #include <shared_mutex>
 #include <Windows.h>
 
@@ -38,6 +41,9 @@ extern std::filesystem::path g_reshade_dll_path;
 static std::filesystem::path s_export_hook_path;
 static std::shared_mutex s_hooks_mutex;
 static std::vector<named_hook> s_hooks;
+static std::atomic<size_t> s_num_hooks = 0;
+// A new index is built and published as a whole whenever hooks are installed, so that lookups do not need any locking
+static reshade::published_hook_index s_hook_index;
 static std::shared_mutex s_delayed_hook_paths_mutex;
 static std::vector<std::filesystem::path> s_delayed_hook_paths;
 static PVOID s_dll_notification_cookie = nullptr;
@@ -76,7 +82,13 @@ static std::vector<module_export> enumerate_module_exports(HMODULE handle)
 	return exports;
 }
 
-static bool install_internal(const char *name, reshade::hook &hook, hook_method method)
+static void update_hook_index()
+{
+	// Has to be called with the hook list mutex held exclusively, which serializes publishing
+	s_hook_index.publish(std::make_unique<reshade::hook_index>(std::vector<reshade::hook>(s_hooks.cbegin(), s_hooks.cend())));
+}
+
+static bool install_internal(const char *name, reshade::hook &hook, hook_method method, bool update_index = true)
 {
 	// It does not make sense to install a hook which points to itself, so avoid that
 	if (hook.target == hook.replacement)
@@ -124,6 +136,11 @@ static bool install_internal(const char *name, reshade::hook &hook, hook_method
 	// Protect access to hook list with a mutex
 	{ const std::unique_lock<std::shared_mutex> lock(s_hooks_mutex);
 		s_hooks.push_back({ hook, name, method });
+		s_num_hooks.store(s_hooks.size(), std::memory_order_release);
+
+		// Rebuild the index right away, so that lookups never have to, unless a whole batch of hooks is being installed (in which case it is rebuilt once afterwards)
+		if (update_index)
+			update_hook_index();
 	}
 
 #if RESHADE_VERBOSE_LOG
@@ -211,10 +228,16 @@ static bool install_internal(HMODULE target_module, HMODULE replacement_module,
 		hook.trampoline = hook.target;
 		hook.replacement = std::get<2>(match);
 
-		if (install_internal(std::get<0>(match), hook, method))
+		if (install_internal(std::get<0>(match), hook, method, false))
 			num_installed_hooks++;
 	}
 
+	if (num_installed_hooks != 0)
+	{
+		const std::unique_lock<std::shared_mutex> lock(s_hooks_mutex);
+		update_hook_index();
+	}
+
 	// Status is successful if at least one match was found and hooked
 	return num_installed_hooks != 0;
 }
@@ -275,7 +298,7 @@ static bool uninstall_internal(const char *name, reshade::hook &hook, hook_metho
 	return true;
 }
 
-static reshade::hook find_internal(reshade::hook::address target, reshade::hook::address replacement)
+static reshade::hook find_internal_uncached(reshade::hook::address target, reshade::hook::address replacement)
 {
 	assert(target != nullptr || replacement != nullptr);
 
@@ -296,6 +319,28 @@ static reshade::hook find_internal(reshade::hook::address target, reshade::hook:
 
 	return it != s_hooks.cend() ? static_cast<const reshade::hook &>(*it) : reshade::hook {};
 }
+static reshade::hook find_internal(reshade::hook::address target, reshade::hook::address replacement)
+{
+	assert(target != nullptr || replacement != nullptr);
+
+	// Look up the hook in the current index without any locking first
+	{
+		const reshade::published_hook_index::read_guard guard = s_hook_index.read();
+
+		if (const reshade::hook_index *const index = guard.get())
+		{
+			if (const reshade::hook *const hook = index->find(target, replacement))
+				return *hook;
+
+			// Hook does not exist if the index is up to date
+			if (index->size() == s_num_hooks.load(std::memory_order_acquire))
+				return reshade::hook {};
+		}
+	}
+
+	// Otherwise a batch of hooks is still being installed and the index was not rebuilt yet, so fall back to searching the list
+	return find_internal_uncached(target, replacement);
+}
 
 #ifndef RESHADE_TEST_APPLICATION
 
@@ -447,6 +492,9 @@ void reshade::hooks::uninstall()
 		uninstall_internal(hook_info.name, hook_info, hook_info.method);
 
 	s_hooks.clear();
+	s_num_hooks.store(0);
+
+	s_hook_index.reset();
 
 #ifndef RESHADE_TEST_APPLICATION
 	if (s_dll_notification_cookie && s_dll_notification_cookie != reinterpret_cast<PVOID>(-1))
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace reshade
+{
+	/// <summary>
+	/// Index into a list of named items, to avoid linear searches when looking them up by name.
+	/// Names do not have to be unique, lookups return the same item a linear search through the list would.
+	/// </summary>
+	class name_index
+	{
+	public:
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		bool empty() const { return _indices.empty(); }
+
+		void clear() { _indices.clear(); }
+
+		/// <summary>
+		/// Adds the item at the specified <paramref name="index"/> in the list under the specified <paramref name="name"/>.
+		/// The same item may be added under multiple names.
+		/// </summary>
+		void add(const std::string &name, size_t index)
+		{
+			_indices.emplace(name, index);
+		}
+
+		/// <summary>
+		/// Finds the item with the lowest index in the list that was added under the specified <paramref name="name"/>.
+		/// </summary>
+		/// <returns>Index of the item, or <see cref="npos"/> if there is none.</returns>
+		size_t find(const std::string &name) const
+		{
+			return find(name, [](size_t) { return true; });
+		}
+		/// <summary>
+		/// Finds the item with the lowest index in the list that was added under the specified <paramref name="name"/> and satisfies the specified <paramref name="predicate"/>.
+		/// </summary>
+		/// <returns>Index of the item, or <see cref="npos"/> if there is none.</returns>
+		template <typename F>
+		size_t find(const std::string &name, F predicate) const
+		{
+			// Order of items with the same name is unspecified, so need to go through all of them
+			size_t result = npos;
+			const auto range = _indices.equal_range(name);
+			for (auto it = range.first; it != range.second; ++it)
+				if (it->second < result && predicate(it->second))
+					result = it->second;
+			return result;
+		}
+
+	private:
+		std::unordered_multimap<std::string, size_t> _indices;
+	};
+}
@@ -2458,3 +2458,13 @@ bool reshade::opengl::device_impl::get_pipeline_shader_group_handles(api::pipeli
 {
 	return false;
 }
+
+bool reshade::opengl::device_impl::get_pipeline_cache_data(size_t *, void *)
+{
+	// Drivers manage their own shader cache for OpenGL programs
+	return false;
+}
+bool reshade::opengl::device_impl::merge_pipeline_cache_data(size_t, const void *)
+{
+	return false;
+}
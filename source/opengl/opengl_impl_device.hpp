@@ -90,6 +90,9 @@ namespace reshade::opengl
 
 		bool get_pipeline_shader_group_handles(api::pipeline pipeline, uint32_t first, uint32_t count, void *groups) final;
 
+		bool get_pipeline_cache_data(size_t *size, void *data) final;
+		bool merge_pipeline_cache_data(size_t size, const void *data) final;
+
 	protected:
 		// Cached context information for quick access
 		int  _pixel_format;
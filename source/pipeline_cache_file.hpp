@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "reshade_xxhash64.hpp"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+namespace reshade
+{
+	/// <summary>
+	/// File that persists the pipeline cache of a device between runs of an application.
+	/// Every application gets its own file (since pipelines are rarely shared between applications), which is dropped once it grows beyond a size limit.
+	/// </summary>
+	class pipeline_cache_file
+	{
+	public:
+		pipeline_cache_file(const std::filesystem::path &cache_path, const std::filesystem::path &executable_path, uint32_t renderer_id, uint32_t vendor_id, uint32_t device_id, size_t max_size) :
+			_max_size(max_size)
+		{
+			// Include a hash of the full executable path, so that different applications with the same executable name do not share a file
+			const std::string executable_path_string = executable_path.u8string();
+			const uint64_t executable_path_hash = compute_xxhash64(reinterpret_cast<const uint8_t *>(executable_path_string.data()), executable_path_string.size());
+
+			char id[64];
+			std::snprintf(id, std::size(id), "-%08x-%x-%04x-%04x.pso", static_cast<uint32_t>(executable_path_hash), renderer_id, vendor_id, device_id);
+
+			_path = cache_path / std::filesystem::u8path("reshade-" + executable_path.stem().u8string() + id);
+		}
+
+		const std::filesystem::path &path() const { return _path; }
+
+		/// <summary>
+		/// Reads the pipeline cache data from the file.
+		/// </summary>
+		/// <returns><see langword="true"/> if the file exists and is within the size limit, <see langword="false"/> otherwise.</returns>
+		bool load(std::vector<uint8_t> &data) const
+		{
+			std::error_code ec;
+			const uintmax_t file_size = std::filesystem::file_size(_path, ec);
+			if (ec || file_size == 0 || file_size > _max_size)
+				return false;
+
+			std::ifstream file(_path, std::ios::binary);
+			if (!file)
+				return false;
+
+			data.resize(static_cast<size_t>(file_size));
+			return !!file.read(reinterpret_cast<char *>(data.data()), data.size());
+		}
+
+		/// <summary>
+		/// Replaces the contents of the file with the specified pipeline cache data, or deletes it if the data exceeds the size limit (so that the cache starts from scratch again).
+		/// </summary>
+		/// <returns><see langword="true"/> if the file was written, <see langword="false"/> otherwise.</returns>
+		bool save(const void *data, size_t size) const
+		{
+			std::error_code ec;
+
+			if (size == 0 || size > _max_size)
+			{
+				std::filesystem::remove(_path, ec);
+				return false;
+			}
+
+			// Write to a uniquely named temporary file first and then replace the existing one, so that a crash or another process saving at the same time cannot leave a truncated cache behind
+			std::filesystem::path temp_path = _path;
+			temp_path += '.' + unique_suffix() + ".tmp";
+
+			if (std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+				!file || !file.write(static_cast<const char *>(data), size) || (file.close(), file.fail()))
+			{
+				std::filesystem::remove(temp_path, ec);
+				return false;
+			}
+
+			std::filesystem::rename(temp_path, _path, ec);
+			if (ec)
+			{
+				std::filesystem::remove(temp_path, ec);
+				return false;
+			}
+
+			return true;
+		}
+
+	private:
+		static std::string unique_suffix()
+		{
+			thread_local std::mt19937_64 rng(std::random_device {}() ^ std::hash<std::thread::id>()(std::this_thread::get_id()) ^ std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
+			char suffix[17];
+			std::snprintf(suffix, std::size(suffix), "%016llx", static_cast<unsigned long long>(rng()));
+			return suffix;
+		}
+
+		std::filesystem::path _path;
+		size_t _max_size;
+	};
+}
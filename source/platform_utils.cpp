@@ -131,3 +131,32 @@ void reshade::utils::set_window_transparency(void *window, bool enabled)
 	blur_behind.fEnable = enabled;
 	DwmEnableBlurBehindWindow(GetAncestor(static_cast<HWND>(window), GA_ROOT), &blur_behind);
 }
+
+std::shared_ptr<const uint8_t> reshade::utils::map_file_read_only(const std::filesystem::path &path, size_t &size)
+{
+	const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER file_size = {};
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	// The view keeps the file mapping alive, so can close the handles again right away
+	const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return nullptr;
+
+	const auto view = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+	if (view == nullptr)
+		return nullptr;
+
+	size = static_cast<size_t>(file_size.QuadPart);
+
+	return std::shared_ptr<const uint8_t>(view, [](const uint8_t *view) { UnmapViewOfFile(view); });
+}
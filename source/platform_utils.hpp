@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <memory>
 #include <filesystem>
 
 namespace reshade::utils
@@ -29,4 +30,10 @@ namespace reshade::utils
 	/// Alpha values in the swap chain are only respected when the window is transparent.
 	/// </summary>
 	void set_window_transparency(void *window, bool enabled);
+
+	/// <summary>
+	/// Maps the specified file into memory for reading.
+	/// The mapping is released again when the last reference to the returned pointer is destroyed.
+	/// </summary>
+	std::shared_ptr<const uint8_t> map_file_read_only(const std::filesystem::path &path, size_t &size);
 }
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause OR MIT
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace reshade
+{
+	/// <summary>
+	/// Tracks threads that read data published through an atomic pointer, so that superseded data can be destroyed once no reader can still be accessing it.
+	/// Readers announce themselves on one of several counters, picked per thread and padded to a cache line each, so that concurrent readers do not contend on the same counter.
+	/// </summary>
+	class reader_tracker
+	{
+		static constexpr size_t num_counters = 16;
+
+	public:
+		/// <summary>
+		/// Marks the calling thread as reader for as long as this exists.
+		/// The published pointer has to be loaded after constructing this (with a sequentially consistent load).
+		/// </summary>
+		class scope
+		{
+		public:
+			explicit scope(reader_tracker &tracker) :
+				_counter(tracker._counters[current_slot() % num_counters].value)
+			{
+				// Sequentially consistent, so that a writer checking for readers after publishing either sees this reader or this reader sees the published data
+				_counter.fetch_add(1);
+			}
+			~scope()
+			{
+				_counter.fetch_sub(1, std::memory_order_release);
+			}
+
+			scope(const scope &) = delete;
+			scope &operator=(const scope &) = delete;
+
+		private:
+			std::atomic<size_t> &_counter;
+		};
+
+		/// <summary>
+		/// Checks whether any thread is currently reading.
+		/// When this returns <see langword="false"/> after new data was published (with a sequentially consistent store), no thread can still be accessing data that was superseded by it.
+		/// </summary>
+		bool has_readers() const
+		{
+			for (const counter &counter : _counters)
+				if (counter.value.load() != 0)
+					return true;
+			return false;
+		}
+
+	private:
+		struct alignas(64) counter
+		{
+			std::atomic<size_t> value = 0;
+		};
+
+		static size_t current_slot()
+		{
+			// Assign each thread a fixed counter the first time it reads, spreading threads evenly across all counters
+			static std::atomic<size_t> s_next_slot = 0;
+			thread_local size_t t_slot = 0; // Zero means not yet assigned
+			if (t_slot == 0)
+				t_slot = s_next_slot.fetch_add(1, std::memory_order_relaxed) + 1;
+			return t_slot;
+		}
+
+		counter _counters[num_counters];
+	};
+}
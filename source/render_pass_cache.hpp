@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <algorithm>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace reshade
+{
+	/// <summary>
+	/// Thread-safe cache of objects created for a combination of attachments (e.g. render passes and framebuffers for APIs without dynamic rendering), keyed by a hash of their description.
+	/// Lookups only take a shared lock, so that concurrent recording threads do not block each other.
+	/// Every entry keeps track of its attachment views, so that it can be evicted when any of them is destroyed.
+	/// </summary>
+	template <typename view_type, typename value_type, uint32_t max_attachments>
+	class render_pass_cache
+	{
+	public:
+		/// <summary>
+		/// Looks up the entry with the specified <paramref name="hash"/>.
+		/// </summary>
+		/// <returns><see langword="true"/> if an entry was found and stored in <paramref name="value"/>, <see langword="false"/> otherwise.</returns>
+		bool find(size_t hash, value_type &value) const
+		{
+			const std::shared_lock<std::shared_mutex> lock(_mutex);
+
+			if (const auto it = _entries.find(hash);
+				it != _entries.end())
+			{
+				value = it->second.value;
+				return true;
+			}
+
+			return false;
+		}
+
+		/// <summary>
+		/// Adds a new entry with the specified <paramref name="hash"/>, that references the specified attachment <paramref name="views"/>.
+		/// Objects should be created without holding any lock before calling this, so another thread may have added the same entry in the meantime.
+		/// </summary>
+		/// <returns><see langword="true"/> if the entry was added, or <see langword="false"/> if there already was one, in which case <paramref name="value"/> is replaced with the existing entry and the caller has to destroy the objects it created.</returns>
+		bool insert(size_t hash, value_type &value, const view_type *views, uint32_t num_views)
+		{
+			assert(num_views <= max_attachments);
+
+			entry new_entry;
+			new_entry.value = value;
+			new_entry.num_views = num_views;
+			std::copy_n(views, num_views, new_entry.views);
+
+			const std::unique_lock<std::shared_mutex> lock(_mutex);
+
+			if (const auto insert = _entries.emplace(hash, new_entry);
+				!insert.second)
+			{
+				value = insert.first->second.value;
+				return false;
+			}
+
+			for (uint32_t i = 0; i < num_views; ++i)
+				_entries_by_view.emplace(views[i], hash);
+
+			return true;
+		}
+
+		/// <summary>
+		/// Removes all entries that reference the specified attachment <paramref name="view"/>, calling <paramref name="destroy"/> with each of them.
+		/// </summary>
+		template <typename F>
+		void erase_with_view(view_type view, F &&destroy)
+		{
+			// Most views are never used as attachments, so check without blocking concurrent lookups first
+			{	const std::shared_lock<std::shared_mutex> lock(_mutex);
+
+				if (_entries_by_view.find(view) == _entries_by_view.end())
+					return;
+			}
+
+			const std::unique_lock<std::shared_mutex> lock(_mutex);
+
+			for (auto view_it = _entries_by_view.find(view); view_it != _entries_by_view.end(); view_it = _entries_by_view.find(view))
+			{
+				const size_t hash = view_it->second;
+
+				const auto it = _entries.find(hash);
+				assert(it != _entries.end());
+
+				// Remove references to this entry from all its attachments, not just the view being destroyed
+				for (uint32_t i = 0; i < it->second.num_views; ++i)
+				{
+					for (auto range = _entries_by_view.equal_range(it->second.views[i]); range.first != range.second;)
+					{
+						if (range.first->second == hash)
+							range.first = _entries_by_view.erase(range.first);
+						else
+							++range.first;
+					}
+				}
+
+				destroy(it->second.value);
+
+				_entries.erase(it);
+			}
+		}
+
+		/// <summary>
+		/// Removes all entries, calling <paramref name="destroy"/> with each of them.
+		/// </summary>
+		template <typename F>
+		void clear(F &&destroy)
+		{
+			const std::unique_lock<std::shared_mutex> lock(_mutex);
+
+			for (const auto &entry : _entries)
+				destroy(entry.second.value);
+
+			_entries.clear();
+			_entries_by_view.clear();
+		}
+
+		size_t size() const
+		{
+			const std::shared_lock<std::shared_mutex> lock(_mutex);
+			return _entries.size();
+		}
+
+	private:
+		struct entry
+		{
+			value_type value;
+			uint32_t num_views;
+			view_type views[max_attachments];
+		};
+
+		mutable std::shared_mutex _mutex;
+		std::unordered_map<size_t, entry> _entries;
+		std::unordered_multimap<view_type, size_t> _entries_by_view;
+	};
+}
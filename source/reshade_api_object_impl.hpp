@@ -8,6 +8,7 @@
 #include "reshade_api_device.hpp"
 #include <vector>
 #include <cassert>
+#include <cstring>
 
 namespace reshade::api
 {
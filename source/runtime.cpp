@@ -17,7 +17,10 @@
 #include "input_gamepad.hpp"
 #include "com_ptr.hpp"
 #include "platform_utils.hpp"
+#include "format_utils.hpp"
+#include "cube_lut.hpp"
 #include "reshade_api_object_impl.hpp"
+#include "reshade_xxhash64.hpp"
 #include <set>
 #include <thread>
 #include <cctype>
@@ -30,6 +33,7 @@
 #include <stb_image_dds.h>
 #include <stb_image_write.h>
 #include <stb_image_resize2.h>
+#include <d3d11.h>
 #include <d3dcompiler.h>
 
 bool resolve_path(std::filesystem::path &path, std::error_code &ec)
@@ -452,6 +456,44 @@ bool reshade::runtime::on_init()
 
 	if (!update_effect_color_and_stencil_tex(_width, _height, _back_buffer_format, _effect_stencil_format))
 		goto exit_failure;
+
+	// Scaled effects are resampled with a blit where possible, otherwise create a pipeline that draws a full-screen triangle sampling the source with linear filtering
+	if (!_device->check_capability(api::device_caps::blit) && (
+			_device->get_api() == api::device_api::d3d10 ||
+			_device->get_api() == api::device_api::d3d11 ||
+			_device->get_api() == api::device_api::d3d12))
+	{
+		api::sampler_desc sampler_desc = {};
+		sampler_desc.filter = api::filter_mode::min_mag_mip_linear;
+		sampler_desc.address_u = api::texture_address_mode::clamp;
+		sampler_desc.address_v = api::texture_address_mode::clamp;
+		sampler_desc.address_w = api::texture_address_mode::clamp;
+
+		api::pipeline_layout_param layout_params[2];
+		layout_params[0] = api::descriptor_range { 0, 0, 0, 1, api::shader_stage::all, 1, api::descriptor_type::sampler };
+		layout_params[1] = api::descriptor_range { 0, 0, 0, 1, api::shader_stage::all, 1, api::descriptor_type::shader_resource_view };
+
+		const resources::data_resource vs = resources::load_data_resource(IDR_FULLSCREEN_VS);
+		const resources::data_resource ps = resources::load_data_resource(IDR_RESAMPLE_PS);
+
+		api::shader_desc vs_desc = { vs.data, vs.data_size };
+		api::shader_desc ps_desc = { ps.data, ps.data_size };
+
+		const api::format render_target_format = api::format_to_default_typed(_effect_color_format, 0);
+
+		std::vector<api::pipeline_subobject> subobjects;
+		subobjects.push_back({ api::pipeline_subobject_type::vertex_shader, 1, &vs_desc });
+		subobjects.push_back({ api::pipeline_subobject_type::pixel_shader, 1, &ps_desc });
+		subobjects.push_back({ api::pipeline_subobject_type::render_target_formats, 1, &render_target_format });
+
+		if (!_device->create_pipeline_layout(2, layout_params, &_effect_resample_pipeline_layout) ||
+			!_device->create_pipeline(_effect_resample_pipeline_layout, static_cast<uint32_t>(subobjects.size()), subobjects.data(), &_effect_resample_pipeline) ||
+			!_device->create_sampler(sampler_desc, &_effect_resample_sampler_state))
+		{
+			LOG(ERROR) << "Failed to create effect resample pipeline!";
+			goto exit_failure;
+		}
+	}
 #endif
 
 	// Create render targets for the back buffer resources
@@ -499,6 +541,11 @@ bool reshade::runtime::on_init()
 	if (window != nullptr)
 		utils::set_window_transparency(window, false);
 
+#if RESHADE_FX
+	// Seed the pipeline cache of the device before any effects are loaded, so that their pipelines can be taken from it
+	load_pipeline_cache();
+#endif
+
 	// Reset frame count to zero so effects are loaded in 'update_effects'
 	_frame_count = 0;
 
@@ -534,6 +581,13 @@ exit_failure:
 	_effect_stencil_tex = {};
 	_device->destroy_resource_view(_effect_stencil_dsv);
 	_effect_stencil_dsv = {};
+
+	_device->destroy_pipeline(_effect_resample_pipeline);
+	_effect_resample_pipeline = {};
+	_device->destroy_pipeline_layout(_effect_resample_pipeline_layout);
+	_effect_resample_pipeline_layout = {};
+	_device->destroy_sampler(_effect_resample_sampler_state);
+	_effect_resample_sampler_state = {};
 #endif
 
 	_device->destroy_pipeline(_copy_pipeline);
@@ -572,10 +626,17 @@ void reshade::runtime::on_reset()
 	else
 		return; // Nothing to do if the runtime was already destroyed or not successfully initialized in the first place
 
+	// Finish any screenshots still in flight before the worker threads are joined below
+	destroy_texture_readbacks();
+
 #if RESHADE_FX
 	// Already performs a wait for idle, so no need to do it again before destroying resources below
 	destroy_effects();
 
+	_pipeline_thread_pool.stop();
+
+	save_pipeline_cache();
+
 	_device->destroy_resource(_empty_tex);
 	_empty_tex = {};
 	_device->destroy_resource_view(_empty_srv);
@@ -592,6 +653,13 @@ void reshade::runtime::on_reset()
 	_effect_stencil_tex = {};
 	_device->destroy_resource_view(_effect_stencil_dsv);
 	_effect_stencil_dsv = {};
+
+	_device->destroy_pipeline(_effect_resample_pipeline);
+	_effect_resample_pipeline = {};
+	_device->destroy_pipeline_layout(_effect_resample_pipeline_layout);
+	_effect_resample_pipeline_layout = {};
+	_device->destroy_sampler(_effect_resample_sampler_state);
+	_effect_resample_sampler_state = {};
 #else
 	for (std::thread &thread : _worker_threads)
 		if (thread.joinable())
@@ -671,6 +739,9 @@ void reshade::runtime::on_present(api::command_queue *present_queue)
 	_block_effect_reload_this_frame = false;
 #endif
 
+	// Hand off screenshots captured in previous frames whose copy has finished on the GPU by now
+	finish_texture_readbacks();
+
 	api::command_list *const cmd_list = _graphics_queue->get_immediate_command_list();
 
 	capture_state(cmd_list, _app_state);
@@ -721,6 +792,10 @@ void reshade::runtime::on_present(api::command_queue *present_queue)
 
 	_frame_count++;
 	const auto current_time = std::chrono::high_resolution_clock::now();
+#if RESHADE_GUI && RESHADE_FX
+	_last_effect_command_stats = _effect_command_stats;
+	_effect_command_stats = {};
+#endif
 	_last_frame_duration = current_time - _last_present_time; _last_present_time = current_time;
 
 #ifdef NDEBUG
@@ -941,6 +1016,9 @@ void reshade::runtime::load_config()
 	config_get("GENERAL", "NoEffectCache", _no_effect_cache);
 	config_get("GENERAL", "NoReloadOnInit", _no_reload_on_init);
 
+	config_get("GENERAL", "EffectCreationBudget", _effect_creation_budget);
+	_effect_creation_budget = std::max(_effect_creation_budget, 1.0f);
+	config_get("GENERAL", "EffectFrameBudget", _effect_frame_budget);
 	config_get("GENERAL", "EffectSearchPaths", _effect_search_paths);
 	config_get("GENERAL", "PerformanceMode", _performance_mode);
 	config_get("GENERAL", "PreprocessorDefinitions", _global_preprocessor_definitions);
@@ -1023,6 +1101,8 @@ void reshade::runtime::save_config() const
 	config.set("GENERAL", "NoEffectCache", _no_effect_cache);
 	config.set("GENERAL", "NoReloadOnInit", _no_reload_on_init);
 
+	config.set("GENERAL", "EffectCreationBudget", _effect_creation_budget);
+	config.set("GENERAL", "EffectFrameBudget", _effect_frame_budget);
 	config.set("GENERAL", "EffectSearchPaths", _effect_search_paths);
 	config.set("GENERAL", "PerformanceMode", _performance_mode);
 	config.set("GENERAL", "PreprocessorDefinitions", _global_preprocessor_definitions);
@@ -1442,6 +1522,16 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 
 	const std::string effect_name = source_file.filename().u8string();
 
+	// Scale the buffer dimensions reported to expensive effects when they exceed the frame budget (see 'update_effect_resolution_scales')
+	unsigned int resolution_scale = 100;
+	if (const auto scale_it = _effect_resolution_scales.find(effect_name);
+		scale_it != _effect_resolution_scales.end())
+		resolution_scale = scale_it->second;
+	const uint32_t buffer_width = std::max(1u, _effect_width * resolution_scale / 100);
+	const uint32_t buffer_height = std::max(1u, _effect_height * resolution_scale / 100);
+
+	attributes += "resolution_scale=" + std::to_string(resolution_scale) + ';';
+
 	std::vector<std::pair<std::string, std::string>> preprocessor_definitions = _global_preprocessor_definitions;
 	// Insert preset preprocessor definitions before global ones, so that if there are duplicates, the preset ones are used (since 'add_macro_definition' succeeds only for the first occurance)
 	if (const auto preset_it = _preset_preprocessor_definitions.find({});
@@ -1522,6 +1612,10 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 		effect.source_hash = source_hash;
 	}
 
+	effect.resolution_scale = resolution_scale;
+	effect.width = buffer_width;
+	effect.height = buffer_height;
+
 	if (_effect_load_skipping && !force_load)
 	{
 		if (std::vector<std::string> techniques;
@@ -1557,8 +1651,8 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 		pp.add_macro_definition("__RENDERER__", std::to_string(_renderer_id));
 		pp.add_macro_definition("__APPLICATION__", std::to_string( // Truncate hash to 32-bit, since lexer currently only supports 32-bit numbers anyway
 			std::hash<std::string>()(g_target_executable_path.stem().u8string()) & 0xFFFFFFFF));
-		pp.add_macro_definition("BUFFER_WIDTH", std::to_string(_effect_width));
-		pp.add_macro_definition("BUFFER_HEIGHT", std::to_string(_effect_height));
+		pp.add_macro_definition("BUFFER_WIDTH", std::to_string(buffer_width));
+		pp.add_macro_definition("BUFFER_HEIGHT", std::to_string(buffer_height));
 		pp.add_macro_definition("BUFFER_RCP_WIDTH", "(1.0 / BUFFER_WIDTH)");
 		pp.add_macro_definition("BUFFER_RCP_HEIGHT", "(1.0 / BUFFER_HEIGHT)");
 		pp.add_macro_definition("BUFFER_COLOR_SPACE", std::to_string(static_cast<uint32_t>(_back_buffer_color_space)));
@@ -1704,6 +1798,7 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 		if (effect.compiled)
 		{
 			effect.uniforms.clear();
+			effect.uniform_lookup.clear();
 
 			// Create space for all variables (aligned to 16 bytes)
 			effect.uniform_data_storage.resize((effect.module.total_uniform_size + 15) & ~15);
@@ -1751,6 +1846,7 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 				// Copy initial data into uniform storage area
 				reset_uniform_value(variable);
 
+				effect.uniform_lookup.add(variable.name, effect.uniforms.size());
 				effect.uniforms.push_back(std::move(variable));
 			}
 
@@ -1840,8 +1936,8 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 
 				if (_renderer_id == 0x9000)
 				{
-					// Create SEMANTIC_PIXEL_SIZE constants
-					hlsl += "#define COLOR_PIXEL_SIZE 1.0 / " + std::to_string(_effect_width) + ", 1.0 / " + std::to_string(_effect_height) + '\n';
+					// Create SEMANTIC_PIXEL_SIZE constants (the color texture of a scaled effect has the scaled dimensions, see 'create_effect')
+					hlsl += "#define COLOR_PIXEL_SIZE 1.0 / " + std::to_string(buffer_width) + ", 1.0 / " + std::to_string(buffer_height) + '\n';
 
 					uint32_t semantic_index = 0;
 					for (const reshadefx::texture_info &tex : effect.module.textures)
@@ -2138,11 +2234,8 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 			}
 
 			// Try to share textures with the same name across effects
-			if (const auto existing_texture = std::find_if(_textures.begin(), _textures.end(),
-					[&new_texture](const texture &item) {
-						return item.unique_name == new_texture.unique_name;
-					});
-				existing_texture != _textures.end())
+			if (texture *const existing_texture = find_texture(new_texture.unique_name);
+				existing_texture != nullptr)
 			{
 				// Cannot share texture if this is a normal one, but the existing one is a reference and vice versa
 				if (new_texture.semantic != existing_texture->semantic)
@@ -2233,6 +2326,10 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 			// This is the first effect using this texture
 			new_texture.shared.push_back(effect_index);
 
+			_texture_lookup.add(new_texture.unique_name, _textures.size());
+			if (new_texture.name != new_texture.unique_name)
+				_texture_lookup.add(new_texture.name, _textures.size());
+
 			_textures.push_back(std::move(new_texture));
 		}
 
@@ -2246,6 +2343,8 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 			if (new_technique.annotation_as_int("enabled"))
 				enable_technique(new_technique);
 
+			_technique_lookup.add(new_technique.name, _techniques.size());
+
 			_techniques.push_back(std::move(new_technique));
 			_technique_sorting.push_back(_techniques.size() - 1);
 		}
@@ -2286,8 +2385,20 @@ bool reshade::runtime::create_effect(size_t effect_index)
 	// Create textures now, since they are referenced when building samplers below
 	for (texture &tex : _textures)
 	{
-		if (tex.resource != 0 || std::find(tex.shared.cbegin(), tex.shared.cend(), effect_index) == tex.shared.cend())
+		if (std::find(tex.shared.cbegin(), tex.shared.cend(), effect_index) == tex.shared.cend())
+			continue;
+
+		if (tex.resource != 0)
+		{
+			// A transient render target may have been aliased with textures of other effects based on the effect that created it alone, which no longer holds once this effect shares it by name too (e.g. after reloading only this effect)
+			// The existing descriptors of the other effects cannot be redirected to a new resource, so recreate all effects instead, which then see every effect sharing the texture before creating it
+			if (tex.transient && tex.shared.size() > 1)
+			{
+				LOG(INFO) << "Recreating all effects because transient render target " << tex.unique_name << " is now shared with " << effect.source_file << '.';
+				_should_reload_effect = _effects.size();
+			}
 			continue;
+		}
 
 		if (!create_texture(tex))
 		{
@@ -2296,6 +2407,43 @@ bool reshade::runtime::create_effect(size_t effect_index)
 		}
 	}
 
+	// Scaled effects were compiled with dimensions no other effect agrees on, so restore full resolution when that can no longer work (e.g. because an effect that was loaded afterwards shares a texture with it by name)
+	// This has to recreate all effects, since a shared texture may already have been created with the scaled dimensions
+	for (size_t i = 0; i < _effects.size(); ++i)
+	{
+		if (_effects[i].compiled && _effects[i].resolution_scale != 100 && !is_effect_resolution_scalable(i))
+		{
+			LOG(INFO) << "Restoring full resolution of effect " << _effects[i].source_file << ", since it can no longer be scaled.";
+
+			_effect_resolution_scales.erase(_effects[i].source_file.filename().u8string());
+			_should_reload_effect = _effects.size();
+		}
+	}
+
+	// Create stand-ins for the back buffer and the effect color texture at the scaled dimensions, so that the technique of a scaled effect renders at the same resolution its 'BUFFER_WIDTH' and 'BUFFER_HEIGHT' report
+	if (effect.resolution_scale != 100)
+	{
+		if (!_device->create_resource(
+				api::resource_desc(effect.width, effect.height, 1, 1, _effect_color_format, 1, api::memory_heap::gpu_only, api::resource_usage::render_target | api::resource_usage::shader_resource | api::resource_usage::copy_source | api::resource_usage::copy_dest),
+				nullptr, api::resource_usage::render_target, &effect.scaled_back_buffer) ||
+			!_device->create_resource_view(effect.scaled_back_buffer, api::resource_usage::render_target, api::resource_view_desc(api::format_to_default_typed(_effect_color_format, 0)), &effect.scaled_back_buffer_rtv[0]) ||
+			!_device->create_resource_view(effect.scaled_back_buffer, api::resource_usage::render_target, api::resource_view_desc(api::format_to_default_typed(_effect_color_format, 1)), &effect.scaled_back_buffer_rtv[1]) ||
+			!_device->create_resource_view(effect.scaled_back_buffer, api::resource_usage::shader_resource, api::resource_view_desc(api::format_to_default_typed(_effect_color_format, 0)), &effect.scaled_back_buffer_srv) ||
+			!_device->create_resource(
+				api::resource_desc(effect.width, effect.height, 1, 1, _effect_color_format, 1, api::memory_heap::gpu_only, api::resource_usage::shader_resource | api::resource_usage::copy_dest),
+				nullptr, api::resource_usage::shader_resource, &effect.scaled_color_tex) ||
+			!_device->create_resource_view(effect.scaled_color_tex, api::resource_usage::shader_resource, api::resource_view_desc(api::format_to_default_typed(_effect_color_format, 0)), &effect.scaled_color_srv[0]) ||
+			!_device->create_resource_view(effect.scaled_color_tex, api::resource_usage::shader_resource, api::resource_view_desc(api::format_to_default_typed(_effect_color_format, 1)), &effect.scaled_color_srv[1]))
+		{
+			effect.errors += "Failed to create scaled back buffer.";
+			LOG(ERROR) << "Failed to create scaled back buffer for effect file " << effect.source_file << " (width = " << effect.width << ", height = " << effect.height << ")!";
+			return false;
+		}
+
+		_device->set_resource_name(effect.scaled_back_buffer, "ReShade scaled back buffer");
+		_device->set_resource_name(effect.scaled_color_tex, "ReShade scaled back buffer copy");
+	}
+
 	// Build specialization constants
 	std::vector<uint32_t> spec_data;
 	std::vector<uint32_t> spec_constants;
@@ -2306,8 +2454,12 @@ bool reshade::runtime::create_effect(size_t effect_index)
 		spec_constants.push_back(id);
 	}
 
-	// Create optional query heap for time measurements
-	if (!_device->create_query_heap(api::query_type::timestamp, static_cast<uint32_t>(effect.module.techniques.size() * 2 * 4), &effect.query_heap))
+	// Create optional query heap for time measurements, with a timestamp before the first pass and after the last (or every, if per-pass timings are enabled) pass for each slot of the query ring of every technique
+	uint32_t num_queries = 0;
+	for (const reshadefx::technique_info &info : effect.module.techniques)
+		num_queries += static_cast<uint32_t>((_gather_pass_timings ? info.passes.size() : 1) + 1) * technique::max_query_ring_depth;
+
+	if (!_device->create_query_heap(api::query_type::timestamp, num_queries, &effect.query_heap))
 		LOG(ERROR) << "Failed to create query heap for effect file " << effect.source_file << '!';
 
 	const bool sampler_with_resource_view = _device->check_capability(api::device_caps::sampler_with_resource_view);
@@ -2493,8 +2645,8 @@ bool reshade::runtime::create_effect(size_t effect_index)
 	}
 
 	// Initialize techniques and passes
-	size_t total_pass_index = 0;
-	size_t technique_index_in_effect = 0;
+	uint32_t query_base_index = 0;
+	std::vector<std::pair<technique *, size_t>> passes;
 
 	for (technique &tech : _techniques)
 	{
@@ -2503,284 +2655,339 @@ bool reshade::runtime::create_effect(size_t effect_index)
 
 		tech.passes_data.resize(tech.passes.size());
 
-		// Offset index so that a query exists for each command frame and two subsequent ones are used for before/after stamps
-		tech.query_base_index = static_cast<uint32_t>(technique_index_in_effect++ * 2 * 4);
+		// Offset index so that every technique has its own range of queries in the query heap of the effect
+		tech.query_per_pass = _gather_pass_timings && tech.passes.size() > 1;
+		tech.query_base_index = query_base_index;
+		query_base_index += static_cast<uint32_t>((_gather_pass_timings ? tech.passes.size() : 1) + 1) * technique::max_query_ring_depth;
 
-		for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index, ++total_pass_index)
-		{
-			reshadefx::pass_info &pass_info = tech.passes[pass_index];
-			technique::pass_data &pass_data = tech.passes_data[pass_index];
+		// Queries from a previous query heap are no longer valid
+		tech.query_ring_depth = 2;
+		std::fill_n(tech.query_slot_frame, technique::max_query_ring_depth, 0);
+		tech.query_slot_cpu_durations.assign((tech.query_per_pass ? tech.passes.size() : 1) * technique::max_query_ring_depth, 0);
 
-			std::vector<api::pipeline_subobject> subobjects;
+		for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
+			passes.emplace_back(&tech, pass_index);
+	}
+
+	std::mutex errors_mutex;
+
+	// This only accesses state specific to the pass, so can be called for different passes concurrently
+	const auto create_pass_pipeline = [&](technique &tech, size_t pass_index) -> bool {
+		reshadefx::pass_info &pass_info = tech.passes[pass_index];
+		technique::pass_data &pass_data = tech.passes_data[pass_index];
+
+		std::vector<api::pipeline_subobject> subobjects;
 
-			if (!pass_info.cs_entry_point.empty())
+		if (!pass_info.cs_entry_point.empty())
+		{
+			api::shader_desc cs_desc = {};
+			const std::string &cs = effect.assembly.at(pass_info.cs_entry_point);
+			cs_desc.code = cs.data();
+			cs_desc.code_size = cs.size();
+			if (_renderer_id & 0x20000)
 			{
-				api::shader_desc cs_desc = {};
-				const std::string &cs = effect.assembly.at(pass_info.cs_entry_point);
-				cs_desc.code = cs.data();
-				cs_desc.code_size = cs.size();
-				if (_renderer_id & 0x20000)
-				{
-					cs_desc.entry_point = pass_info.cs_entry_point.c_str();
-					cs_desc.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
-					cs_desc.spec_constant_ids = spec_constants.data();
-					cs_desc.spec_constant_values = spec_data.data();
-				}
+				cs_desc.entry_point = pass_info.cs_entry_point.c_str();
+				cs_desc.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
+				cs_desc.spec_constant_ids = spec_constants.data();
+				cs_desc.spec_constant_values = spec_data.data();
+			}
 
-				subobjects.push_back({ api::pipeline_subobject_type::compute_shader, 1, &cs_desc });
+			subobjects.push_back({ api::pipeline_subobject_type::compute_shader, 1, &cs_desc });
 
-				if (!_device->create_pipeline(effect.layout, static_cast<uint32_t>(subobjects.size()), subobjects.data(), &pass_data.pipeline))
-				{
-					effect.errors += "error: internal compiler error";
+			if (!_device->create_pipeline(effect.layout, static_cast<uint32_t>(subobjects.size()), subobjects.data(), &pass_data.pipeline))
+			{
+				const std::unique_lock<std::mutex> lock(errors_mutex);
 
-					LOG(ERROR) << "Failed to create compute pipeline for pass " << pass_index << " in technique '" << tech.name << "' in " << effect.source_file << '!';
-					return false;
-				}
+				effect.errors += "error: internal compiler error";
+
+				LOG(ERROR) << "Failed to create compute pipeline for pass " << pass_index << " in technique '" << tech.name << "' in " << effect.source_file << '!';
+				return false;
 			}
-			else
+		}
+		else
+		{
+			api::shader_desc vs_desc = {};
+			const std::string &vs = effect.assembly.at(pass_info.vs_entry_point);
+			vs_desc.code = vs.data();
+			vs_desc.code_size = vs.size();
+			if (_renderer_id & 0x20000)
 			{
-				api::shader_desc vs_desc = {};
-				const std::string &vs = effect.assembly.at(pass_info.vs_entry_point);
-				vs_desc.code = vs.data();
-				vs_desc.code_size = vs.size();
-				if (_renderer_id & 0x20000)
-				{
-					vs_desc.entry_point = pass_info.vs_entry_point.c_str();
-					vs_desc.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
-					vs_desc.spec_constant_ids = spec_constants.data();
-					vs_desc.spec_constant_values = spec_data.data();
-				}
+				vs_desc.entry_point = pass_info.vs_entry_point.c_str();
+				vs_desc.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
+				vs_desc.spec_constant_ids = spec_constants.data();
+				vs_desc.spec_constant_values = spec_data.data();
+			}
 
-				subobjects.push_back({ api::pipeline_subobject_type::vertex_shader, 1, &vs_desc });
+			subobjects.push_back({ api::pipeline_subobject_type::vertex_shader, 1, &vs_desc });
 
-				api::shader_desc ps_desc = {};
-				const std::string &ps = effect.assembly.at(pass_info.ps_entry_point);
-				ps_desc.code = ps.data();
-				ps_desc.code_size = ps.size();
-				if (_renderer_id & 0x20000)
-				{
-					ps_desc.entry_point = pass_info.ps_entry_point.c_str();
-					ps_desc.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
-					ps_desc.spec_constant_ids = spec_constants.data();
-					ps_desc.spec_constant_values = spec_data.data();
-				}
+			api::shader_desc ps_desc = {};
+			const std::string &ps = effect.assembly.at(pass_info.ps_entry_point);
+			ps_desc.code = ps.data();
+			ps_desc.code_size = ps.size();
+			if (_renderer_id & 0x20000)
+			{
+				ps_desc.entry_point = pass_info.ps_entry_point.c_str();
+				ps_desc.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
+				ps_desc.spec_constant_ids = spec_constants.data();
+				ps_desc.spec_constant_values = spec_data.data();
+			}
 
-				subobjects.push_back({ api::pipeline_subobject_type::pixel_shader, 1, &ps_desc });
+			subobjects.push_back({ api::pipeline_subobject_type::pixel_shader, 1, &ps_desc });
 
-				assert(pass_info.srgb_write_enable < 2);
+			assert(pass_info.srgb_write_enable < 2);
 
-				api::format render_target_formats[8] = {};
+			api::format render_target_formats[8] = {};
 
-				if (pass_info.render_target_names[0].empty())
-				{
-					pass_info.viewport_width = _effect_width;
-					pass_info.viewport_height = _effect_height;
+			if (pass_info.render_target_names[0].empty())
+			{
+				// Scaled effects render to the scaled back buffer instead (see 'render_technique')
+				pass_info.viewport_width = effect.width;
+				pass_info.viewport_height = effect.height;
 
-					render_target_formats[0] = api::format_to_default_typed(_effect_color_format, pass_info.srgb_write_enable);
+				render_target_formats[0] = api::format_to_default_typed(_effect_color_format, pass_info.srgb_write_enable);
 
-					subobjects.push_back({ api::pipeline_subobject_type::render_target_formats, 1, &render_target_formats[0] });
-				}
-				else
+				subobjects.push_back({ api::pipeline_subobject_type::render_target_formats, 1, &render_target_formats[0] });
+			}
+			else
+			{
+				int render_target_count = 0;
+				for (; render_target_count < 8 && !pass_info.render_target_names[render_target_count].empty(); ++render_target_count)
 				{
-					int render_target_count = 0;
-					for (; render_target_count < 8 && !pass_info.render_target_names[render_target_count].empty(); ++render_target_count)
-					{
-						const auto render_target_texture = std::find_if(_textures.cbegin(), _textures.cend(),
-							[&unique_name = pass_info.render_target_names[render_target_count]](const texture &item) {
-								return item.unique_name == unique_name && (item.resource != 0 || !item.semantic.empty());
-							});
-						assert(render_target_texture != _textures.cend());
-						assert(render_target_texture->semantic.empty() && render_target_texture->rtv[pass_info.srgb_write_enable] != 0);
-
-						if (std::find(pass_data.modified_resources.cbegin(), pass_data.modified_resources.cend(), render_target_texture->resource) == pass_data.modified_resources.cend())
-						{
-							pass_data.modified_resources.push_back(render_target_texture->resource);
+					const texture *const render_target_texture = find_texture(pass_info.render_target_names[render_target_count]);
+					assert(render_target_texture != nullptr && (render_target_texture->resource != 0 || !render_target_texture->semantic.empty()));
+					assert(render_target_texture->semantic.empty() && render_target_texture->rtv[pass_info.srgb_write_enable] != 0);
 
-							if (pass_info.generate_mipmaps && render_target_texture->levels > 1)
-								pass_data.generate_mipmap_views.push_back(render_target_texture->srv[pass_info.srgb_write_enable]);
-						}
+					if (std::find(pass_data.modified_resources.cbegin(), pass_data.modified_resources.cend(), render_target_texture->resource) == pass_data.modified_resources.cend())
+					{
+						pass_data.modified_resources.push_back(render_target_texture->resource);
 
-						const api::resource_desc res_desc = _device->get_resource_desc(render_target_texture->resource);
+						if (pass_info.generate_mipmaps && render_target_texture->levels > 1)
+							pass_data.generate_mipmap_views.push_back(render_target_texture->srv[pass_info.srgb_write_enable]);
+					}
 
-						render_target_formats[render_target_count] = api::format_to_default_typed(res_desc.texture.format, pass_info.srgb_write_enable);
+					const api::resource_desc res_desc = _device->get_resource_desc(render_target_texture->resource);
 
-						pass_data.render_target_views[render_target_count] = render_target_texture->rtv[pass_info.srgb_write_enable];
-					}
+					render_target_formats[render_target_count] = api::format_to_default_typed(res_desc.texture.format, pass_info.srgb_write_enable);
 
-					subobjects.push_back({ api::pipeline_subobject_type::render_target_formats, static_cast<uint32_t>(render_target_count), render_target_formats });
+					pass_data.render_target_views[render_target_count] = render_target_texture->rtv[pass_info.srgb_write_enable];
 				}
 
-				// Only need to attach stencil if stencil is actually used in this pass
-				if (pass_info.stencil_enable &&
-					pass_info.viewport_width == _effect_width &&
-					pass_info.viewport_height == _effect_height)
-				{
-					subobjects.push_back({ api::pipeline_subobject_type::depth_stencil_format, 1, &_effect_stencil_format });
-				}
+				subobjects.push_back({ api::pipeline_subobject_type::render_target_formats, static_cast<uint32_t>(render_target_count), render_target_formats });
+			}
 
-				subobjects.push_back({ api::pipeline_subobject_type::max_vertex_count, 1, &pass_info.num_vertices });
-				api::primitive_topology topology = static_cast<api::primitive_topology>(pass_info.topology);
-				subobjects.push_back({ api::pipeline_subobject_type::primitive_topology, 1, &topology });
+			// Only need to attach stencil if stencil is actually used in this pass
+			if (pass_info.stencil_enable &&
+				pass_info.viewport_width == _effect_width &&
+				pass_info.viewport_height == _effect_height)
+			{
+				subobjects.push_back({ api::pipeline_subobject_type::depth_stencil_format, 1, &_effect_stencil_format });
+			}
 
-				const auto convert_blend_op = [](reshadefx::pass_blend_op value) {
-					switch (value)
-					{
-					default:
-					case reshadefx::pass_blend_op::add: return api::blend_op::add;
-					case reshadefx::pass_blend_op::subtract: return api::blend_op::subtract;
-					case reshadefx::pass_blend_op::reverse_subtract: return api::blend_op::reverse_subtract;
-					case reshadefx::pass_blend_op::min: return api::blend_op::min;
-					case reshadefx::pass_blend_op::max: return api::blend_op::max;
-					}
-				};
-				const auto convert_blend_factor = [](reshadefx::pass_blend_factor value) {
-					switch (value) {
-					case reshadefx::pass_blend_factor::zero: return api::blend_factor::zero;
-					default:
-					case reshadefx::pass_blend_factor::one: return api::blend_factor::one;
-					case reshadefx::pass_blend_factor::source_color: return api::blend_factor::source_color;
-					case reshadefx::pass_blend_factor::one_minus_source_color: return api::blend_factor::one_minus_source_color;
-					case reshadefx::pass_blend_factor::dest_color: return api::blend_factor::dest_color;
-					case reshadefx::pass_blend_factor::one_minus_dest_color: return api::blend_factor::one_minus_dest_color;
-					case reshadefx::pass_blend_factor::source_alpha: return api::blend_factor::source_alpha;
-					case reshadefx::pass_blend_factor::one_minus_source_alpha: return api::blend_factor::one_minus_source_alpha;
-					case reshadefx::pass_blend_factor::dest_alpha: return api::blend_factor::dest_alpha;
-					case reshadefx::pass_blend_factor::one_minus_dest_alpha: return api::blend_factor::one_minus_dest_alpha;
-					}
-				};
+			subobjects.push_back({ api::pipeline_subobject_type::max_vertex_count, 1, &pass_info.num_vertices });
+			api::primitive_topology topology = static_cast<api::primitive_topology>(pass_info.topology);
+			subobjects.push_back({ api::pipeline_subobject_type::primitive_topology, 1, &topology });
 
-				// Technically should check for 'api::device_caps::independent_blend' support, but render target write masks are supported in D3D9, when rest is not, so just always set ...
-				api::blend_desc blend_state = {};
-				for (int i = 0; i < 8; ++i)
+			const auto convert_blend_op = [](reshadefx::pass_blend_op value) {
+				switch (value)
 				{
-					blend_state.blend_enable[i] = pass_info.blend_enable[i];
-					blend_state.source_color_blend_factor[i] = convert_blend_factor(pass_info.src_blend[i]);
-					blend_state.dest_color_blend_factor[i] = convert_blend_factor(pass_info.dest_blend[i]);
-					blend_state.color_blend_op[i] = convert_blend_op(pass_info.blend_op[i]);
-					blend_state.source_alpha_blend_factor[i] = convert_blend_factor(pass_info.src_blend_alpha[i]);
-					blend_state.dest_alpha_blend_factor[i] = convert_blend_factor(pass_info.dest_blend_alpha[i]);
-					blend_state.alpha_blend_op[i] = convert_blend_op(pass_info.blend_op_alpha[i]);
-					blend_state.render_target_write_mask[i] = pass_info.color_write_mask[i];
+				default:
+				case reshadefx::pass_blend_op::add: return api::blend_op::add;
+				case reshadefx::pass_blend_op::subtract: return api::blend_op::subtract;
+				case reshadefx::pass_blend_op::reverse_subtract: return api::blend_op::reverse_subtract;
+				case reshadefx::pass_blend_op::min: return api::blend_op::min;
+				case reshadefx::pass_blend_op::max: return api::blend_op::max;
+				}
+			};
+			const auto convert_blend_factor = [](reshadefx::pass_blend_factor value) {
+				switch (value) {
+				case reshadefx::pass_blend_factor::zero: return api::blend_factor::zero;
+				default:
+				case reshadefx::pass_blend_factor::one: return api::blend_factor::one;
+				case reshadefx::pass_blend_factor::source_color: return api::blend_factor::source_color;
+				case reshadefx::pass_blend_factor::one_minus_source_color: return api::blend_factor::one_minus_source_color;
+				case reshadefx::pass_blend_factor::dest_color: return api::blend_factor::dest_color;
+				case reshadefx::pass_blend_factor::one_minus_dest_color: return api::blend_factor::one_minus_dest_color;
+				case reshadefx::pass_blend_factor::source_alpha: return api::blend_factor::source_alpha;
+				case reshadefx::pass_blend_factor::one_minus_source_alpha: return api::blend_factor::one_minus_source_alpha;
+				case reshadefx::pass_blend_factor::dest_alpha: return api::blend_factor::dest_alpha;
+				case reshadefx::pass_blend_factor::one_minus_dest_alpha: return api::blend_factor::one_minus_dest_alpha;
 				}
+			};
 
-				subobjects.push_back({ api::pipeline_subobject_type::blend_state, 1, &blend_state });
+			// Technically should check for 'api::device_caps::independent_blend' support, but render target write masks are supported in D3D9, when rest is not, so just always set ...
+			api::blend_desc blend_state = {};
+			for (int i = 0; i < 8; ++i)
+			{
+				blend_state.blend_enable[i] = pass_info.blend_enable[i];
+				blend_state.source_color_blend_factor[i] = convert_blend_factor(pass_info.src_blend[i]);
+				blend_state.dest_color_blend_factor[i] = convert_blend_factor(pass_info.dest_blend[i]);
+				blend_state.color_blend_op[i] = convert_blend_op(pass_info.blend_op[i]);
+				blend_state.source_alpha_blend_factor[i] = convert_blend_factor(pass_info.src_blend_alpha[i]);
+				blend_state.dest_alpha_blend_factor[i] = convert_blend_factor(pass_info.dest_blend_alpha[i]);
+				blend_state.alpha_blend_op[i] = convert_blend_op(pass_info.blend_op_alpha[i]);
+				blend_state.render_target_write_mask[i] = pass_info.color_write_mask[i];
+			}
 
-				api::rasterizer_desc rasterizer_state = {};
-				rasterizer_state.cull_mode = api::cull_mode::none;
+			subobjects.push_back({ api::pipeline_subobject_type::blend_state, 1, &blend_state });
 
-				subobjects.push_back({ api::pipeline_subobject_type::rasterizer_state, 1, &rasterizer_state });
+			api::rasterizer_desc rasterizer_state = {};
+			rasterizer_state.cull_mode = api::cull_mode::none;
 
-				const auto convert_stencil_op = [](reshadefx::pass_stencil_op value) {
-					switch (value) {
-					case reshadefx::pass_stencil_op::zero: return api::stencil_op::zero;
-					default:
-					case reshadefx::pass_stencil_op::keep: return api::stencil_op::keep;
-					case reshadefx::pass_stencil_op::replace: return api::stencil_op::replace;
-					case reshadefx::pass_stencil_op::increment_saturate: return api::stencil_op::increment_saturate;
-					case reshadefx::pass_stencil_op::decrement_saturate: return api::stencil_op::decrement_saturate;
-					case reshadefx::pass_stencil_op::invert: return api::stencil_op::invert;
-					case reshadefx::pass_stencil_op::increment: return api::stencil_op::increment;
-					case reshadefx::pass_stencil_op::decrement: return api::stencil_op::decrement;
-					}
-				};
-				const auto convert_stencil_func = [](reshadefx::pass_stencil_func value) {
-					switch (value)
-					{
-					case reshadefx::pass_stencil_func::never: return api::compare_op::never;
-					case reshadefx::pass_stencil_func::less: return api::compare_op::less;
-					case reshadefx::pass_stencil_func::equal: return api::compare_op::equal;
-					case reshadefx::pass_stencil_func::less_equal: return api::compare_op::less_equal;
-					case reshadefx::pass_stencil_func::greater: return api::compare_op::greater;
-					case reshadefx::pass_stencil_func::not_equal: return api::compare_op::not_equal;
-					case reshadefx::pass_stencil_func::greater_equal: return api::compare_op::greater_equal;
-					default:
-					case reshadefx::pass_stencil_func::always: return api::compare_op::always;
-					}
-				};
+			subobjects.push_back({ api::pipeline_subobject_type::rasterizer_state, 1, &rasterizer_state });
 
-				api::depth_stencil_desc depth_stencil_state = {};
-				depth_stencil_state.depth_enable = false;
-				depth_stencil_state.depth_write_mask = false;
-				depth_stencil_state.depth_func = api::compare_op::always;
-				depth_stencil_state.stencil_enable = pass_info.stencil_enable;
-				depth_stencil_state.front_stencil_read_mask = pass_info.stencil_read_mask;
-				depth_stencil_state.front_stencil_write_mask = pass_info.stencil_write_mask;
-				depth_stencil_state.front_stencil_func = depth_stencil_state.back_stencil_func;
-				depth_stencil_state.front_stencil_fail_op = depth_stencil_state.back_stencil_fail_op;
-				depth_stencil_state.front_stencil_depth_fail_op = depth_stencil_state.back_stencil_depth_fail_op;
-				depth_stencil_state.front_stencil_pass_op = depth_stencil_state.back_stencil_pass_op;
-				depth_stencil_state.back_stencil_read_mask = pass_info.stencil_read_mask;
-				depth_stencil_state.back_stencil_write_mask = pass_info.stencil_write_mask;
-				depth_stencil_state.back_stencil_func = convert_stencil_func(pass_info.stencil_comparison_func);
-				depth_stencil_state.back_stencil_fail_op = convert_stencil_op(pass_info.stencil_op_fail);
-				depth_stencil_state.back_stencil_depth_fail_op = convert_stencil_op(pass_info.stencil_op_depth_fail);
-				depth_stencil_state.back_stencil_pass_op = convert_stencil_op(pass_info.stencil_op_pass);
-
-				subobjects.push_back({ api::pipeline_subobject_type::depth_stencil_state, 1, &depth_stencil_state });
-
-				if (!_device->create_pipeline(effect.layout, static_cast<uint32_t>(subobjects.size()), subobjects.data(), &pass_data.pipeline))
+			const auto convert_stencil_op = [](reshadefx::pass_stencil_op value) {
+				switch (value) {
+				case reshadefx::pass_stencil_op::zero: return api::stencil_op::zero;
+				default:
+				case reshadefx::pass_stencil_op::keep: return api::stencil_op::keep;
+				case reshadefx::pass_stencil_op::replace: return api::stencil_op::replace;
+				case reshadefx::pass_stencil_op::increment_saturate: return api::stencil_op::increment_saturate;
+				case reshadefx::pass_stencil_op::decrement_saturate: return api::stencil_op::decrement_saturate;
+				case reshadefx::pass_stencil_op::invert: return api::stencil_op::invert;
+				case reshadefx::pass_stencil_op::increment: return api::stencil_op::increment;
+				case reshadefx::pass_stencil_op::decrement: return api::stencil_op::decrement;
+				}
+			};
+			const auto convert_stencil_func = [](reshadefx::pass_stencil_func value) {
+				switch (value)
 				{
-					effect.errors += "error: internal compiler error";
-
-					LOG(ERROR) << "Failed to create graphics pipeline for pass " << pass_index << " in technique '" << tech.name << "' in " << effect.source_file << '!';
-					return false;
+				case reshadefx::pass_stencil_func::never: return api::compare_op::never;
+				case reshadefx::pass_stencil_func::less: return api::compare_op::less;
+				case reshadefx::pass_stencil_func::equal: return api::compare_op::equal;
+				case reshadefx::pass_stencil_func::less_equal: return api::compare_op::less_equal;
+				case reshadefx::pass_stencil_func::greater: return api::compare_op::greater;
+				case reshadefx::pass_stencil_func::not_equal: return api::compare_op::not_equal;
+				case reshadefx::pass_stencil_func::greater_equal: return api::compare_op::greater_equal;
+				default:
+				case reshadefx::pass_stencil_func::always: return api::compare_op::always;
 				}
-			}
+			};
 
-			if (effect.module.num_sampler_bindings != 0 ||
-				effect.module.num_texture_bindings != 0)
+			api::depth_stencil_desc depth_stencil_state = {};
+			depth_stencil_state.depth_enable = false;
+			depth_stencil_state.depth_write_mask = false;
+			depth_stencil_state.depth_func = api::compare_op::always;
+			depth_stencil_state.stencil_enable = pass_info.stencil_enable;
+			depth_stencil_state.front_stencil_read_mask = pass_info.stencil_read_mask;
+			depth_stencil_state.front_stencil_write_mask = pass_info.stencil_write_mask;
+			depth_stencil_state.front_stencil_func = depth_stencil_state.back_stencil_func;
+			depth_stencil_state.front_stencil_fail_op = depth_stencil_state.back_stencil_fail_op;
+			depth_stencil_state.front_stencil_depth_fail_op = depth_stencil_state.back_stencil_depth_fail_op;
+			depth_stencil_state.front_stencil_pass_op = depth_stencil_state.back_stencil_pass_op;
+			depth_stencil_state.back_stencil_read_mask = pass_info.stencil_read_mask;
+			depth_stencil_state.back_stencil_write_mask = pass_info.stencil_write_mask;
+			depth_stencil_state.back_stencil_func = convert_stencil_func(pass_info.stencil_comparison_func);
+			depth_stencil_state.back_stencil_fail_op = convert_stencil_op(pass_info.stencil_op_fail);
+			depth_stencil_state.back_stencil_depth_fail_op = convert_stencil_op(pass_info.stencil_op_depth_fail);
+			depth_stencil_state.back_stencil_pass_op = convert_stencil_op(pass_info.stencil_op_pass);
+
+			subobjects.push_back({ api::pipeline_subobject_type::depth_stencil_state, 1, &depth_stencil_state });
+
+			if (!_device->create_pipeline(effect.layout, static_cast<uint32_t>(subobjects.size()), subobjects.data(), &pass_data.pipeline))
 			{
-				pass_data.texture_table = texture_tables[total_pass_index];
+				const std::unique_lock<std::mutex> lock(errors_mutex);
 
-				for (const reshadefx::sampler_info &info : pass_info.samplers)
-				{
-					const auto sampler_texture = std::find_if(_textures.cbegin(), _textures.cend(),
-						[&unique_name = info.texture_name](const texture &item) {
-							return item.unique_name == unique_name && (item.resource != 0 || !item.semantic.empty());
-						});
-					assert(sampler_texture != _textures.cend());
+				effect.errors += "error: internal compiler error";
+
+				LOG(ERROR) << "Failed to create graphics pipeline for pass " << pass_index << " in technique '" << tech.name << "' in " << effect.source_file << '!';
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	// Creating pipelines is the most expensive part of effect creation (since drivers compile shaders at this point), so spread it across the worker threads of the pipeline pool where the device is free-threaded
+	if (passes.size() > 1 && is_device_free_threaded())
+	{
+		// The current thread takes part as well, so create one thread less
+		_pipeline_thread_pool.start(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+		std::atomic<bool> pipelines_created = true;
 
-					api::resource_view &srv = sampler_descriptors[sampler_with_resource_view ? info.binding : effect.module.num_sampler_bindings + info.texture_binding].view;
+		_pipeline_thread_pool.parallel_for(passes.size(), [&](size_t i) {
+			if (pipelines_created.load(std::memory_order_relaxed) && !create_pass_pipeline(*passes[i].first, passes[i].second))
+				pipelines_created.store(false, std::memory_order_relaxed);
+		});
+
+		if (!pipelines_created.load(std::memory_order_relaxed))
+			return false;
+	}
+	else
+	{
+		for (const std::pair<technique *, size_t> &pass : passes)
+			if (!create_pass_pipeline(*pass.first, pass.second))
+				return false;
+	}
 
-					api::descriptor_table_update &write = descriptor_writes.emplace_back();
-					write.table = pass_data.texture_table;
-					write.count = 1;
+	// Set up descriptors after all pipelines were created, since this accesses state shared between passes
+	for (size_t total_pass_index = 0; total_pass_index < passes.size(); ++total_pass_index)
+	{
+		technique &tech = *passes[total_pass_index].first;
+		reshadefx::pass_info &pass_info = tech.passes[passes[total_pass_index].second];
+		technique::pass_data &pass_data = tech.passes_data[passes[total_pass_index].second];
+
+		if (effect.module.num_sampler_bindings != 0 ||
+			effect.module.num_texture_bindings != 0)
+		{
+			pass_data.texture_table = texture_tables[total_pass_index];
+
+			for (const reshadefx::sampler_info &info : pass_info.samplers)
+			{
+				const texture *const sampler_texture = find_texture(info.texture_name);
+				assert(sampler_texture != nullptr && (sampler_texture->resource != 0 || !sampler_texture->semantic.empty()));
+
+				api::resource_view &srv = sampler_descriptors[sampler_with_resource_view ? info.binding : effect.module.num_sampler_bindings + info.texture_binding].view;
+
+				api::descriptor_table_update &write = descriptor_writes.emplace_back();
+				write.table = pass_data.texture_table;
+				write.count = 1;
 
-					if (sampler_with_resource_view)
+				if (sampler_with_resource_view)
+				{
+					write.binding = info.binding;
+					write.type = api::descriptor_type::sampler_with_resource_view;
+					write.descriptors = &sampler_descriptors[info.binding];
+
+					api::sampler_desc desc;
+					desc.filter = static_cast<api::filter_mode>(info.filter);
+					desc.address_u = static_cast<api::texture_address_mode>(info.address_u);
+					desc.address_v = static_cast<api::texture_address_mode>(info.address_v);
+					desc.address_w = static_cast<api::texture_address_mode>(info.address_w);
+					desc.mip_lod_bias = info.lod_bias;
+					desc.max_anisotropy = 1;
+					desc.compare_op = api::compare_op::always;
+					desc.border_color[0] = 0.0f;
+					desc.border_color[1] = 0.0f;
+					desc.border_color[2] = 0.0f;
+					desc.border_color[3] = 0.0f;
+					desc.min_lod = info.min_lod;
+					desc.max_lod = info.max_lod;
+
+					if (!create_effect_sampler_state(desc, sampler_descriptors[info.binding].sampler))
 					{
-						write.binding = info.binding;
-						write.type = api::descriptor_type::sampler_with_resource_view;
-						write.descriptors = &sampler_descriptors[info.binding];
-
-						api::sampler_desc desc;
-						desc.filter = static_cast<api::filter_mode>(info.filter);
-						desc.address_u = static_cast<api::texture_address_mode>(info.address_u);
-						desc.address_v = static_cast<api::texture_address_mode>(info.address_v);
-						desc.address_w = static_cast<api::texture_address_mode>(info.address_w);
-						desc.mip_lod_bias = info.lod_bias;
-						desc.max_anisotropy = 1;
-						desc.compare_op = api::compare_op::always;
-						desc.border_color[0] = 0.0f;
-						desc.border_color[1] = 0.0f;
-						desc.border_color[2] = 0.0f;
-						desc.border_color[3] = 0.0f;
-						desc.min_lod = info.min_lod;
-						desc.max_lod = info.max_lod;
-
-						if (!create_effect_sampler_state(desc, sampler_descriptors[info.binding].sampler))
-						{
-							LOG(ERROR) << "Failed to create sampler object '" << info.unique_name << "' in " << effect.source_file << '!';
-							return false;
-						}
+						LOG(ERROR) << "Failed to create sampler object '" << info.unique_name << "' in " << effect.source_file << '!';
+						return false;
 					}
-					else
+				}
+				else
+				{
+					write.binding = info.texture_binding;
+					write.type = api::descriptor_type::shader_resource_view;
+					write.descriptors = &srv;
+				}
+
+				if (!sampler_texture->semantic.empty())
+				{
+					if (sampler_texture->semantic == "COLOR")
+						pass_data.samples_back_buffer = true;
+
+					if (sampler_texture->semantic == "COLOR" && effect.scaled_color_tex != 0)
 					{
-						write.binding = info.texture_binding;
-						write.type = api::descriptor_type::shader_resource_view;
-						write.descriptors = &srv;
+						// Scaled effects sample their own copy of the scaled back buffer, which is never replaced, so does not need to be tracked
+						srv = effect.scaled_color_srv[info.srgb];
 					}
-
-					if (!sampler_texture->semantic.empty())
+					else
 					{
 						if (const auto it = _texture_semantic_bindings.find(sampler_texture->semantic); it != _texture_semantic_bindings.end())
 							srv = info.srgb ? it->second.second : it->second.first;
@@ -2796,45 +3003,42 @@ bool reshade::runtime::create_effect(size_t effect_index)
 							!!info.srgb
 						});
 					}
-					else
-					{
-						assert(info.srgb < 2);
-
-						srv = sampler_texture->srv[info.srgb];
-					}
+				}
+				else
+				{
+					assert(info.srgb < 2);
 
-					assert(srv != 0);
+					srv = sampler_texture->srv[info.srgb];
 				}
+
+				assert(srv != 0);
 			}
+		}
 
-			if (effect.module.num_storage_bindings != 0)
+		if (effect.module.num_storage_bindings != 0)
+		{
+			pass_data.storage_table = storage_tables[total_pass_index];
+
+			for (const reshadefx::storage_info &info : pass_info.storages)
 			{
-				pass_data.storage_table = storage_tables[total_pass_index];
+				const texture *const storage_texture = find_texture(info.texture_name);
+				assert(storage_texture != nullptr && (storage_texture->resource != 0 || !storage_texture->semantic.empty()));
+				assert(storage_texture->semantic.empty() && storage_texture->uav[info.level] != 0);
 
-				for (const reshadefx::storage_info &info : pass_info.storages)
+				if (std::find(pass_data.modified_resources.cbegin(), pass_data.modified_resources.cend(), storage_texture->resource) == pass_data.modified_resources.cend())
 				{
-					const auto storage_texture = std::find_if(_textures.cbegin(), _textures.cend(),
-						[&unique_name = info.texture_name](const texture &item) {
-							return item.unique_name == unique_name && (item.resource != 0 || !item.semantic.empty());
-						});
-					assert(storage_texture != _textures.cend());
-					assert(storage_texture->semantic.empty() && storage_texture->uav[info.level] != 0);
-
-					if (std::find(pass_data.modified_resources.cbegin(), pass_data.modified_resources.cend(), storage_texture->resource) == pass_data.modified_resources.cend())
-					{
-						pass_data.modified_resources.push_back(storage_texture->resource);
-
-						if (pass_info.generate_mipmaps && storage_texture->levels > 1)
-							pass_data.generate_mipmap_views.push_back(storage_texture->srv[0]);
-					}
+					pass_data.modified_resources.push_back(storage_texture->resource);
 
-					api::descriptor_table_update &write = descriptor_writes.emplace_back();
-					write.table = pass_data.storage_table;
-					write.binding = info.binding;
-					write.type = api::descriptor_type::unordered_access_view;
-					write.count = 1;
-					write.descriptors = &storage_texture->uav[info.level];
+					if (pass_info.generate_mipmaps && storage_texture->levels > 1)
+						pass_data.generate_mipmap_views.push_back(storage_texture->srv[0]);
 				}
+
+				api::descriptor_table_update &write = descriptor_writes.emplace_back();
+				write.table = pass_data.storage_table;
+				write.binding = info.binding;
+				write.type = api::descriptor_type::unordered_access_view;
+				write.count = 1;
+				write.descriptors = &storage_texture->uav[info.level];
 			}
 		}
 	}
@@ -2842,6 +3046,60 @@ bool reshade::runtime::create_effect(size_t effect_index)
 	if (!descriptor_writes.empty())
 		_device->update_descriptor_tables(static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data());
 
+	for (size_t total_pass_index = 0; total_pass_index < passes.size(); ++total_pass_index)
+	{
+		technique &tech = *passes[total_pass_index].first;
+		const size_t pass_index = passes[total_pass_index].second;
+		const reshadefx::pass_info &pass_info = tech.passes[pass_index];
+		technique::pass_data &pass_data = tech.passes_data[pass_index];
+
+		// Compute shaders do not write to the back buffer
+		pass_data.modified_usage = pass_info.cs_entry_point.empty() ? api::resource_usage::render_target : api::resource_usage::unordered_access;
+		pass_data.writes_back_buffer = pass_info.cs_entry_point.empty() && pass_info.render_target_names[0].empty();
+
+		if (_renderer_id == 0x9000 && pass_info.cs_entry_point.empty())
+		{
+			// Registers of SEMANTIC_PIXEL_SIZE constants are allocated downwards from c254 (see 'load_effect'), so together with '__TEXEL_SIZE__' they form a contiguous block that can be set with a single call
+			const size_t num_semantics = std::count_if(effect.module.textures.cbegin(), effect.module.textures.cend(),
+				[](const reshadefx::texture_info &tex) { return !tex.semantic.empty() && tex.semantic != "COLOR"; });
+
+			pass_data.d3d9_constants.assign((num_semantics + 1) * 4, 0.0f);
+			for (size_t semantic_index = 0; semantic_index < num_semantics; ++semantic_index)
+			{
+				// Semantic textures are expected to cover the screen, so give them the same pixel size as the (possibly scaled) back buffer of this effect
+				pass_data.d3d9_constants[semantic_index * 4 + 0] = 1.0f / effect.width;
+				pass_data.d3d9_constants[semantic_index * 4 + 1] = 1.0f / effect.height;
+			}
+
+			// Set __TEXEL_SIZE__ constant (see effect_codegen_hlsl.cpp)
+			pass_data.d3d9_constants[num_semantics * 4 + 0] = -1.0f / pass_info.viewport_width;
+			pass_data.d3d9_constants[num_semantics * 4 + 1] =  1.0f / pass_info.viewport_height;
+		}
+
+		if (!pass_info.enable_uniform_name.empty())
+		{
+			// Uniform names are not unique across namespaces, so cannot use the name lookup here
+			if (const auto uniform_it = std::find_if(effect.uniforms.cbegin(), effect.uniforms.cend(),
+					[&pass_info](const uniform &variable) { return variable.unique_name == pass_info.enable_uniform_name; });
+				uniform_it != effect.uniforms.cend())
+			{
+				pass_data.enable_uniform_index = static_cast<size_t>(std::distance(effect.uniforms.cbegin(), uniform_it));
+			}
+			else if (const auto spec_it = std::find_if(effect.module.spec_constants.cbegin(), effect.module.spec_constants.cend(),
+					[&pass_info](const reshadefx::uniform_info &constant) { return constant.unique_name == pass_info.enable_uniform_name; });
+				spec_it != effect.module.spec_constants.cend())
+			{
+				// Value of specialization constants cannot change without recompiling the effect, so can evaluate the condition just once
+				pass_data.always_skipped = spec_it->type.is_floating_point() ? spec_it->initializer_value.as_float[0] == 0.0f : spec_it->initializer_value.as_uint[0] == 0;
+			}
+		}
+	}
+
+	// Compile the sequence of passes of each technique once, so that rendering only has to replay it (see 'render_technique')
+	for (const std::pair<technique *, size_t> &pass : passes)
+		if (pass.second == 0)
+			effect_pass_barriers::compile(pass.first->passes_data);
+
 	// Clear effect assembly now that it was consumed
 	effect.assembly.clear();
 
@@ -2871,10 +3129,27 @@ bool reshade::runtime::create_effect_sampler_state(const api::sampler_desc &desc
 		return false;
 	}
 }
+bool reshade::runtime::is_device_free_threaded() const
+{
+	switch (_device->get_api())
+	{
+	case api::device_api::d3d11:
+		// Applications may opt out of thread-safety of the D3D11 device, in which case resources must not be created concurrently
+		return (reinterpret_cast<ID3D11Device *>(_device->get_native())->GetCreationFlags() & D3D11_CREATE_DEVICE_SINGLETHREADED) == 0;
+	case api::device_api::d3d12:
+	case api::device_api::vulkan:
+		return true;
+	default:
+		return false;
+	}
+}
 void reshade::runtime::destroy_effect(size_t effect_index)
 {
 	assert(effect_index < _effects.size());
 
+	// Textures of this effect may still be loading, so stop that before destroying them
+	abort_texture_loading();
+
 	// Make sure no effect resources are currently in use
 	_graphics_queue->wait_idle();
 
@@ -2910,6 +3185,21 @@ void reshade::runtime::destroy_effect(size_t effect_index)
 		_device->destroy_query_heap(effect.query_heap);
 		effect.query_heap = {};
 
+		_device->destroy_resource(effect.scaled_back_buffer);
+		effect.scaled_back_buffer = {};
+		_device->destroy_resource_view(effect.scaled_back_buffer_rtv[0]);
+		effect.scaled_back_buffer_rtv[0] = {};
+		_device->destroy_resource_view(effect.scaled_back_buffer_rtv[1]);
+		effect.scaled_back_buffer_rtv[1] = {};
+		_device->destroy_resource_view(effect.scaled_back_buffer_srv);
+		effect.scaled_back_buffer_srv = {};
+		_device->destroy_resource(effect.scaled_color_tex);
+		effect.scaled_color_tex = {};
+		_device->destroy_resource_view(effect.scaled_color_srv[0]);
+		effect.scaled_color_srv[0] = {};
+		_device->destroy_resource_view(effect.scaled_color_srv[1]);
+		effect.scaled_color_srv[1] = {};
+
 		effect.texture_semantic_to_binding.clear();
 	}
 
@@ -2954,188 +3244,536 @@ void reshade::runtime::destroy_effect(size_t effect_index)
 		}
 	}
 
+	// Indices of the remaining textures and techniques have changed
+	update_name_lookups();
+
 	// Do not clear effect here, since it is common to be reused immediately
 }
 
-void reshade::runtime::load_textures()
+static bool get_texture_format_info(reshadefx::texture_format format, uint32_t &pixel_size, stbir_datatype &data_type, stbir_pixel_layout &pixel_layout)
 {
-	for (texture &tex : _textures)
+	switch (format)
 	{
-		if (tex.resource == 0 || !tex.semantic.empty())
-			continue; // Ignore textures that are not created yet and those that are handled in the runtime implementation
-
-		std::filesystem::path source_path = std::filesystem::u8path(tex.annotation_as_string("source"));
-		// Ignore textures that have no image file attached to them (e.g. plain render targets)
-		if (source_path.empty())
-			continue;
-
-		// Search for image file using the provided search paths unless the path provided is already absolute
-		if (!find_file(_texture_search_paths, source_path))
-		{
-			LOG(ERROR) << "Source " << source_path << " for texture '" << tex.unique_name << "' was not found in any of the texture search paths!";
-			_last_reload_successful = false;
-			continue;
-		}
-
-		std::error_code ec;
-		const uintmax_t file_size = std::filesystem::file_size(source_path, ec);
-
-		void *pixels = nullptr;
-		int width = 0, height = 1, depth = 1, channels = 0;
-		const bool is_floating_point_format = (tex.format == reshadefx::texture_format::r32f || tex.format == reshadefx::texture_format::rg32f || tex.format == reshadefx::texture_format::rgba32f);
-
-		if (auto file = std::ifstream(source_path, std::ios::binary))
-		{
-			if (source_path.extension() == L".cube")
-			{
-				if (!is_floating_point_format)
-				{
-					LOG(ERROR) << "Source " << source_path << " for texture '" << tex.unique_name << "' is a Cube LUT file, which can only be loaded into textures with a floating-point format!";
-					_last_reload_successful = false;
-					continue;
-				}
-
-				float domain_min[3] = { 0.0f, 0.0f, 0.0f };
-				float domain_max[3] = { 1.0f, 1.0f, 1.0f };
-
-				// Read header information
-				std::string line;
-				while (std::getline(file, line))
-				{
-					if (line.empty() || line[0] == '#')
-						continue; // Skip lines with comments
-
-					char *p = line.data();
+	case reshadefx::texture_format::r8:
+		pixel_size = 1 * 1;
+		data_type = STBIR_TYPE_UINT8;
+		pixel_layout = STBIR_1CHANNEL;
+		return true;
+	case reshadefx::texture_format::r32f:
+		pixel_size = 4 * 1;
+		data_type = STBIR_TYPE_FLOAT;
+		pixel_layout = STBIR_1CHANNEL;
+		return true;
+	case reshadefx::texture_format::rg8:
+		pixel_size = 1 * 2;
+		data_type = STBIR_TYPE_UINT8;
+		pixel_layout = STBIR_2CHANNEL;
+		return true;
+	case reshadefx::texture_format::rg16:
+		pixel_size = 2 * 2;
+		data_type = STBIR_TYPE_UINT16;
+		pixel_layout = STBIR_2CHANNEL;
+		return true;
+	case reshadefx::texture_format::rg16f:
+		pixel_size = 2 * 2;
+		data_type = STBIR_TYPE_HALF_FLOAT;
+		pixel_layout = STBIR_2CHANNEL;
+		return true;
+	case reshadefx::texture_format::rg32f:
+		pixel_size = 4 * 2;
+		data_type = STBIR_TYPE_FLOAT;
+		pixel_layout = STBIR_2CHANNEL;
+		return true;
+	case reshadefx::texture_format::rgba8:
+	case reshadefx::texture_format::rgb10a2:
+		pixel_size = 1 * 4;
+		data_type = STBIR_TYPE_UINT8;
+		pixel_layout = STBIR_RGBA;
+		return true;
+	case reshadefx::texture_format::rgba16:
+		pixel_size = 2 * 4;
+		data_type = STBIR_TYPE_UINT16;
+		pixel_layout = STBIR_RGBA;
+		return true;
+	case reshadefx::texture_format::rgba16f:
+		pixel_size = 2 * 4;
+		data_type = STBIR_TYPE_HALF_FLOAT;
+		pixel_layout = STBIR_RGBA;
+		return true;
+	case reshadefx::texture_format::rgba32f:
+		pixel_size = 4 * 4;
+		data_type = STBIR_TYPE_FLOAT;
+		pixel_layout = STBIR_RGBA;
+		return true;
+	default:
+		return false;
+	}
+}
 
-					if (line.rfind("TITLE", 0) == 0)
-						continue; // Skip optional line with title
+// Limit the amount of decoded image data that may wait for upload, so that worker threads do not allocate an unbounded amount of memory while the render thread is catching up
+static constexpr size_t max_pending_texture_upload_size = 256 * 1024 * 1024;
+// Limit the amount of image data that is uploaded per frame, to avoid hitches while many large textures are streaming in
+static constexpr size_t max_texture_upload_size_per_frame = 32 * 1024 * 1024;
 
-					if (line.rfind("DOMAIN_MIN", 0) == 0)
-					{
-						p += 10;
-						domain_min[0] = static_cast<float>(std::strtod(p, &p));
-						domain_min[1] = static_cast<float>(std::strtod(p, &p));
-						domain_min[2] = static_cast<float>(std::strtod(p, &p));
-						continue;
-					}
-					if (line.rfind("DOMAIN_MAX", 0) == 0)
-					{
-						p += 10;
-						domain_max[0] = static_cast<float>(std::strtod(p, &p));
-						domain_max[1] = static_cast<float>(std::strtod(p, &p));
-						domain_max[2] = static_cast<float>(std::strtod(p, &p));
-						continue;
-					}
+struct texture_cache_header
+{
+	uint32_t magic;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t depth;
+	uint32_t reserved;
+	uint64_t data_size;
+};
+
+static constexpr uint32_t texture_cache_magic = 0x31435852; // "RXC1"
+// Limit the total size of decoded image data kept in the cache directory, least recently used files are removed beyond that
+static constexpr uintmax_t max_texture_cache_size = 1024 * 1024 * 1024;
+
+static bool load_texture_cache(const std::filesystem::path &cache_file, reshadefx::texture_format format, uint32_t width, uint32_t height, uint32_t depth, std::shared_ptr<const uint8_t> &data, size_t &data_size)
+{
+	// Mark file as recently used, so that it is the last to be evicted (see 'evict_texture_cache')
+	std::error_code ec;
+	std::filesystem::last_write_time(cache_file, std::filesystem::file_time_type::clock::now(), ec);
 
-					if (line.rfind("LUT_1D_SIZE", 0) == 0)
-					{
-						if (pixels != nullptr)
-							break;
-						width = std::strtol(p + 11, nullptr, 10);
-						pixels = std::malloc(static_cast<size_t>(width) * 4 * sizeof(float));
-						continue;
-					}
-					if (line.rfind("LUT_3D_SIZE", 0) == 0)
-					{
-						if (pixels != nullptr)
-							break;
-						width = height = depth = std::strtol(p + 11, nullptr, 10);
-						pixels = std::malloc(static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * 4 * sizeof(float));
-						continue;
-					}
+	size_t file_size = 0;
+	const std::shared_ptr<const uint8_t> mapped_file = reshade::utils::map_file_read_only(cache_file, file_size);
+	if (mapped_file == nullptr || file_size < sizeof(texture_cache_header))
+		return false;
 
-					// Line has no known keyword, so assume this is where the table data starts and roll back a line to continue reading that below
-					file.seekg(-static_cast<std::streampos>(line.size() + 1), std::ios::cur);
-					break;
-				}
+	const auto header = reinterpret_cast<const texture_cache_header *>(mapped_file.get());
+	if (header->magic != texture_cache_magic ||
+		header->format != static_cast<uint32_t>(format) ||
+		header->width != width || header->height != height || header->depth != depth ||
+		header->data_size != (file_size - sizeof(texture_cache_header)))
+		return false;
 
-				// Read table data
-				if (pixels != nullptr)
-				{
-					size_t index = 0;
-					while (std::getline(file, line) && (index + 4) <= (static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * 4))
-					{
-						if (line.empty() || line[0] == '#')
-							continue; // Skip lines with comments
+	// Touch every page of the mapping here on the worker thread, so that the page faults reading the file do not happen during upload on the render thread instead
+	volatile uint8_t page_sum = 0;
+	for (size_t offset = 0; offset < file_size; offset += 4096)
+		page_sum += mapped_file.get()[offset];
 
-						char *p = line.data();
+	// Reference the pixel data in the mapped file directly, so it can be uploaded without another copy
+	data = std::shared_ptr<const uint8_t>(mapped_file, mapped_file.get() + sizeof(texture_cache_header));
+	data_size = static_cast<size_t>(header->data_size);
+	return true;
+}
+static void evict_texture_cache(const std::filesystem::path &cache_path)
+{
+	std::vector<std::pair<std::filesystem::file_time_type, std::pair<std::filesystem::path, uintmax_t>>> cache_files;
+	uintmax_t total_size = 0;
 
-						static_cast<float *>(pixels)[index++] = static_cast<float>(std::strtod(p, &p)) * (domain_max[0] - domain_min[0]) + domain_min[0];
-						static_cast<float *>(pixels)[index++] = static_cast<float>(std::strtod(p, &p)) * (domain_max[1] - domain_min[1]) + domain_min[1];
-						static_cast<float *>(pixels)[index++] = static_cast<float>(std::strtod(p, &p)) * (domain_max[2] - domain_min[2]) + domain_min[2];
-						static_cast<float *>(pixels)[index++] = 1.0f;
-					}
-				}
-			}
-			else
+	std::error_code ec;
+	for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(cache_path, std::filesystem::directory_options::skip_permission_denied, ec))
+	{
+		const std::filesystem::path filename = entry.path().filename();
+		if (filename.native().compare(0, 8, L"reshade-") != 0 || entry.path().extension() != L".tex")
+			continue;
+
+		const uintmax_t file_size = entry.file_size(ec);
+		if (ec)
+			continue;
+		const std::filesystem::file_time_type last_write_time = entry.last_write_time(ec);
+		if (ec)
+			continue;
+
+		cache_files.push_back({ last_write_time, { entry.path(), file_size } });
+		total_size += file_size;
+	}
+
+	if (total_size <= max_texture_cache_size)
+		return;
+
+	// Remove least recently used files first
+	std::sort(cache_files.begin(), cache_files.end(),
+		[](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+	for (const auto &cache_file : cache_files)
+	{
+		if (total_size <= max_texture_cache_size)
+			break;
+
+		// This fails for files that are currently mapped, which is fine, since those are in use
+		if (std::filesystem::remove(cache_file.second.first, ec))
+			total_size -= cache_file.second.second;
+	}
+}
+static bool save_texture_cache(const std::filesystem::path &cache_file, const std::string &unique_name, reshadefx::texture_format format, uint32_t width, uint32_t height, uint32_t depth, const std::vector<uint8_t> &data)
+{
+	texture_cache_header header = {};
+	header.magic = texture_cache_magic;
+	header.format = static_cast<uint32_t>(format);
+	header.width = width;
+	header.height = height;
+	header.depth = depth;
+	header.data_size = data.size();
+
+	// Write to a temporary file first and rename that afterwards, in case multiple textures reference the same image and are written to the cache concurrently
+	std::filesystem::path temp_file = cache_file;
+	temp_file += '.' + std::to_string(compute_xxhash64(reinterpret_cast<const uint8_t *>(unique_name.data()), unique_name.size()));
+
+	if (auto file = std::ofstream(temp_file, std::ios::binary | std::ios::trunc))
+	{
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char *>(data.data()), data.size());
+		file.close();
+
+		if (!file.fail())
+		{
+			std::error_code ec;
+			std::filesystem::rename(temp_file, cache_file, ec);
+			if (!ec)
+				return true;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::remove(temp_file, ec);
+	return false;
+}
+
+static bool load_texture_data(const std::vector<std::filesystem::path> &search_paths, const std::filesystem::path &cache_path, const std::string &unique_name, std::filesystem::path source_path, reshadefx::texture_format format, uint32_t target_width, uint32_t target_height, uint32_t target_depth, std::shared_ptr<const uint8_t> &data, size_t &data_size)
+{
+	// Search for image file using the provided search paths unless the path provided is already absolute
+	if (!find_file(search_paths, source_path))
+	{
+		LOG(ERROR) << "Source " << source_path << " for texture '" << unique_name << "' was not found in any of the texture search paths!";
+		return false;
+	}
+
+	std::error_code ec;
+	const uintmax_t file_size = std::filesystem::file_size(source_path, ec);
+
+	void *pixels = nullptr;
+	int width = 0, height = 1, depth = 1, channels = 0;
+	std::filesystem::path cache_file;
+	const bool is_cube_lut = source_path.extension() == L".cube";
+	const bool is_floating_point_format = (format == reshadefx::texture_format::r32f || format == reshadefx::texture_format::rg32f || format == reshadefx::texture_format::rgba32f);
+
+	if (auto file = std::ifstream(source_path, std::ios::binary))
+	{
+		// Read texture data into memory in one go since that is faster than reading chunk by chunk
+		std::vector<stbi_uc> file_data(static_cast<size_t>(file_size));
+		file.read(reinterpret_cast<char *>(file_data.data()), file_data.size());
+		file.close();
+
+		if (is_cube_lut)
+		{
+			if (!is_floating_point_format && format != reshadefx::texture_format::rgba16f)
 			{
-				// Read texture data into memory in one go since that is faster than reading chunk by chunk
-				std::vector<stbi_uc> file_data(static_cast<size_t>(file_size));
-				file.read(reinterpret_cast<char *>(file_data.data()), file_data.size());
-				file.close();
-
-				if (is_floating_point_format)
-					pixels = stbi_loadf_from_memory(file_data.data(), static_cast<int>(file_data.size()), &width, &height, &channels, STBI_rgb_alpha);
-				else if (stbi_dds_test_memory(file_data.data(), static_cast<int>(file_data.size())))
-					pixels = stbi_dds_load_from_memory(file_data.data(), static_cast<int>(file_data.size()), &width, &height, &depth, &channels, STBI_rgb_alpha);
-				else
-					pixels = stbi_load_from_memory(file_data.data(), static_cast<int>(file_data.size()), &width, &height, &channels, STBI_rgb_alpha);
+				LOG(ERROR) << "Source " << source_path << " for texture '" << unique_name << "' is a Cube LUT file, which can only be loaded into textures with a floating-point format!";
+				return false;
 			}
-		}
 
-		if (ec || pixels == nullptr)
+			pixels = utils::load_cube_lut(reinterpret_cast<const char *>(file_data.data()), file_data.size(), format, width, height, depth);
+		}
+		else
 		{
-			LOG(ERROR) << "Failed to load " << source_path << " for texture '" << tex.unique_name << "' with error code " << ec.value() << '!';
-			_last_reload_successful = false;
-			continue;
+			// Check if decoded image data for this file content and texture description was already written to the cache before, in which case can skip decoding entirely
+			if (!cache_path.empty())
+			{
+				// Use a hash with a fixed definition, so that the file names stay the same across builds and compilers
+				const uint64_t content_hash = compute_xxhash64(file_data.data(), file_data.size());
+
+				cache_file = cache_path / std::filesystem::u8path(
+					"reshade-" + source_path.stem().u8string() + '-' + std::to_string(content_hash) + '-' +
+					std::to_string(static_cast<uint32_t>(format)) + '-' + std::to_string(target_width) + 'x' + std::to_string(target_height) + 'x' + std::to_string(target_depth) + ".tex");
+
+				if (load_texture_cache(cache_file, format, target_width, target_height, target_depth, data, data_size))
+					return true;
+			}
+
+			if (is_floating_point_format)
+				pixels = stbi_loadf_from_memory(file_data.data(), static_cast<int>(file_data.size()), &width, &height, &channels, STBI_rgb_alpha);
+			else if (stbi_dds_test_memory(file_data.data(), static_cast<int>(file_data.size())))
+				pixels = stbi_dds_load_from_memory(file_data.data(), static_cast<int>(file_data.size()), &width, &height, &depth, &channels, STBI_rgb_alpha);
+			else
+				pixels = stbi_load_from_memory(file_data.data(), static_cast<int>(file_data.size()), &width, &height, &channels, STBI_rgb_alpha);
 		}
+	}
 
-		// Collapse data to the correct number of components per pixel based on the texture format
-		switch (tex.format)
+	if (ec || pixels == nullptr)
+	{
+		LOG(ERROR) << "Failed to load " << source_path << " for texture '" << unique_name << "' with error code " << ec.value() << '!';
+		return false;
+	}
+
+	// Collapse data to the correct number of components per pixel based on the texture format (Cube LUT data is already written in the texture format layout)
+	if (!is_cube_lut)
+	{
+		const size_t num_pixels = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth);
+
+		switch (format)
 		{
 		case reshadefx::texture_format::r8:
-			for (size_t i = 4, k = 1; i < static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * 4; i += 4, k += 1)
-				static_cast<stbi_uc *>(pixels)[k] = static_cast<stbi_uc *>(pixels)[i];
+			utils::collapse_rgba_components(pixels, num_pixels, 1, sizeof(stbi_uc));
 			break;
 		case reshadefx::texture_format::r32f:
-			for (size_t i = 4, k = 1; i < static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * 4; i += 4, k += 1)
-				static_cast<float *>(pixels)[k] = static_cast<float *>(pixels)[i];
+			utils::collapse_rgba_components(pixels, num_pixels, 1, sizeof(float));
 			break;
 		case reshadefx::texture_format::rg8:
-			for (size_t i = 4, k = 2; i < static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * 4; i += 4, k += 2)
-				static_cast<stbi_uc *>(pixels)[k + 0] = static_cast<stbi_uc *>(pixels)[i + 0],
-				static_cast<stbi_uc *>(pixels)[k + 1] = static_cast<stbi_uc *>(pixels)[i + 1];
+			utils::collapse_rgba_components(pixels, num_pixels, 2, sizeof(stbi_uc));
 			break;
 		case reshadefx::texture_format::rg32f:
-			for (size_t i = 4, k = 2; i < static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * 4; i += 4, k += 2)
-				static_cast<float *>(pixels)[k + 0] = static_cast<float *>(pixels)[i + 0],
-				static_cast<float *>(pixels)[k + 1] = static_cast<float *>(pixels)[i + 1];
+			utils::collapse_rgba_components(pixels, num_pixels, 2, sizeof(float));
 			break;
 		case reshadefx::texture_format::rgba8:
 		case reshadefx::texture_format::rgba32f:
 			break;
 		default:
-			LOG(ERROR) << "Texture upload is not supported for format " << static_cast<int>(tex.format) << " of texture '" << tex.unique_name << "'!";
-			_last_reload_successful = false;
+			LOG(ERROR) << "Texture upload is not supported for format " << static_cast<int>(format) << " of texture '" << unique_name << "'!";
 			stbi_image_free(pixels);
+			return false;
+		}
+	}
+
+	if (static_cast<uint32_t>(depth) != target_depth || (target_depth != 1 && (static_cast<uint32_t>(width) != target_width || static_cast<uint32_t>(height) != target_height)))
+	{
+		LOG(ERROR) << "Resizing image data is not supported for 3D textures like '" << unique_name << "'.";
+		stbi_image_free(pixels);
+		return false;
+	}
+
+	uint32_t pixel_size;
+	stbir_datatype data_type;
+	stbir_pixel_layout pixel_layout;
+	get_texture_format_info(format, pixel_size, data_type, pixel_layout);
+
+	std::vector<uint8_t> resized_data(static_cast<size_t>(target_width) * static_cast<size_t>(target_height) * static_cast<size_t>(target_depth) * static_cast<size_t>(pixel_size));
+
+	// Resize image data to the texture dimensions here already, so that this work does not have to happen on the render thread
+	if (static_cast<uint32_t>(width) != target_width || static_cast<uint32_t>(height) != target_height)
+	{
+		LOG(INFO) << "Resizing image data for texture '" << unique_name << "' from " << width << "x" << height << " to " << target_width << "x" << target_height << '.';
+
+		stbir_resize(pixels, width, height, 0, resized_data.data(), target_width, target_height, 0, pixel_layout, data_type, STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT);
+	}
+	else
+	{
+		std::memcpy(resized_data.data(), pixels, resized_data.size());
+	}
+
+	stbi_image_free(pixels);
+
+	if (!cache_file.empty() && !save_texture_cache(cache_file, unique_name, format, target_width, target_height, target_depth, resized_data))
+		LOG(WARN) << "Failed to write decoded image data for texture '" << unique_name << "' to cache file " << cache_file << '.';
+
+	const auto buffer = std::make_shared<std::vector<uint8_t>>(std::move(resized_data));
+	data = std::shared_ptr<const uint8_t>(buffer, buffer->data());
+	data_size = buffer->size();
+
+	return true;
+}
+
+void reshade::runtime::load_textures()
+{
+	// Abort any texture loading that may still be in progress from a previous call
+	abort_texture_loading();
+
+	struct texture_load_info
+	{
+		std::string unique_name;
+		std::filesystem::path source_path;
+		reshadefx::texture_format format;
+		uint32_t width, height, depth;
+	};
+
+	std::vector<texture_load_info> textures_to_load;
+
+	for (texture &tex : _textures)
+	{
+		if (tex.resource == 0 || !tex.semantic.empty())
+			continue; // Ignore textures that are not created yet and those that are handled in the runtime implementation
+
+		std::filesystem::path source_path = std::filesystem::u8path(tex.annotation_as_string("source"));
+		// Ignore textures that have no image file attached to them (e.g. plain render targets)
+		if (source_path.empty())
 			continue;
+
+		textures_to_load.push_back({ tex.unique_name, std::move(source_path), tex.format, tex.width, tex.height, tex.depth });
+	}
+
+	const auto state = std::make_shared<texture_load_state>();
+	state->remaining = textures_to_load.size();
+	_texture_load = state;
+
+	if (textures_to_load.empty())
+		return;
+
+	// Decoded image data is stored in the effect cache directory, so that the next reload can skip decoding
+	const std::filesystem::path cache_path = _no_effect_cache ? std::filesystem::path() : g_reshade_base_path / _effect_cache_path;
+
+	// Decode images in parallel on worker threads, the render thread then only has to upload the results (see 'upload_textures')
+	const size_t num_splits = std::min<size_t>(textures_to_load.size(), std::max<size_t>(std::thread::hardware_concurrency(), 2u) - 1);
+
+	// Worker threads are detached, since they only access the shared state and exit by themselves once done or aborted (see 'abort_texture_loading')
+	for (size_t n = 0; n < num_splits; ++n)
+		std::thread([state, textures_to_load, search_paths = _texture_search_paths, cache_path, num_splits, n]() {
+			// Keep the cache directory within its size limit, which involves enumerating it, so do it on a worker thread too
+			if (n == 0 && !cache_path.empty())
+				evict_texture_cache(cache_path);
+
+			for (size_t i = 0; i < textures_to_load.size() && !state->aborted; ++i)
+			{
+				if (i * num_splits / textures_to_load.size() != n)
+					continue;
+
+				const texture_load_info &info = textures_to_load[i];
+
+				texture_data data;
+				data.unique_name = info.unique_name;
+				data.width = info.width;
+				data.height = info.height;
+				data.depth = info.depth;
+
+				if (load_texture_data(search_paths, cache_path, info.unique_name, info.source_path, info.format, info.width, info.height, info.depth, data.pixels, data.pixels_size))
+				{
+					std::unique_lock<std::mutex> lock(state->upload_mutex);
+					// Wait for the render thread to upload some of the pending data before adding more (unless nothing is pending, in which case a single large image is still allowed through)
+					state->upload_cv.wait(lock, [&state]() { return state->aborted || state->upload_queue.empty() || state->upload_queue_size < max_pending_texture_upload_size; });
+					if (state->aborted)
+						return;
+
+					state->upload_queue_size += data.pixels_size;
+					state->upload_queue.push_back(std::move(data));
+				}
+				else
+				{
+					state->failed = true;
+				}
+
+				// Decrement only after the data was added to the queue, so that 'upload_textures' cannot observe an empty queue with no remaining textures before this one was uploaded
+				state->remaining--;
+			}
+		}).detach();
+}
+bool reshade::runtime::upload_textures()
+{
+	if (_texture_load == nullptr)
+		return false;
+
+	texture_load_state &state = *_texture_load;
+
+	size_t uploaded_size = 0;
+
+	while (true)
+	{
+		texture_data data;
+		{
+			const std::unique_lock<std::mutex> lock(state.upload_mutex);
+
+			if (state.upload_queue.empty())
+			{
+				if (state.remaining != 0)
+					return false; // Some textures are still being decoded, continue next frame
+				break;
+			}
+
+			// Stay within the per-frame upload budget, but always upload at least one image per frame so that loading makes progress
+			if (uploaded_size != 0 && uploaded_size + state.upload_queue.front().pixels_size > max_texture_upload_size_per_frame)
+				return false;
+
+			data = std::move(state.upload_queue.front());
+			state.upload_queue.pop_front();
+			state.upload_queue_size -= data.pixels_size;
 		}
 
-		update_texture(tex, width, height, depth, pixels);
+		// Wake up any worker thread that is waiting for space in the queue
+		state.upload_cv.notify_all();
 
-		stbi_image_free(pixels);
+		uploaded_size += data.pixels_size;
+
+		if (texture *const tex = find_texture(data.unique_name);
+			tex != nullptr && tex->resource != 0)
+		{
+			update_texture(*tex, data.width, data.height, data.depth, data.pixels.get());
+
+			tex->loaded = true;
+		}
+	}
+
+	if (state.failed)
+		_last_reload_successful = false;
 
-		tex.loaded = true;
+	// All textures were loaded and the worker threads exit by themselves
+	_texture_load.reset();
+
+	return true;
+}
+void reshade::runtime::abort_texture_loading()
+{
+	if (_texture_load == nullptr)
+		return;
+
+	{
+		const std::unique_lock<std::mutex> lock(_texture_load->upload_mutex);
+		_texture_load->aborted = true;
 	}
 
-	_textures_loaded = true;
+	// Wake up any worker thread that is waiting for space in the queue, but do not wait for them to exit, since they may be in the middle of decoding a large image
+	_texture_load->upload_cv.notify_all();
+
+	// Worker threads keep the state alive until they exit, any data they decoded in the meantime is discarded with it
+	_texture_load.reset();
 }
+static bool is_transient_render_target(const reshade::texture &tex, const reshadefx::module &module)
+{
+	if (!tex.render_target || tex.storage_access || tex.shared.size() != 1 || tex.annotation_as_int("pooled") || !tex.annotation_as_string("source").empty())
+		return false;
+
+	for (const reshadefx::technique_info &technique_info : module.techniques)
+	{
+		// Find the first pass in this technique that accesses the texture, which has to overwrite it before anything reads it
+		for (const reshadefx::pass_info &pass_info : technique_info.passes)
+		{
+			const bool is_sampled = std::any_of(pass_info.samplers.cbegin(), pass_info.samplers.cend(),
+				[&tex](const reshadefx::sampler_info &info) { return info.texture_name == tex.unique_name; });
+			const bool is_written = std::find(std::begin(pass_info.render_target_names), std::end(pass_info.render_target_names), tex.unique_name) != std::end(pass_info.render_target_names);
+
+			if (is_sampled)
+				return false;
+			if (is_written)
+			{
+				// Passes that may be skipped cannot be relied upon to overwrite the texture
+				if (!pass_info.clear_render_targets || !pass_info.enable_uniform_name.empty())
+					return false;
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
 bool reshade::runtime::create_texture(texture &tex)
 {
 	// Do not create resource if it is a special reference, those are set in 'render_technique' and 'update_texture_bindings'
 	if (!tex.semantic.empty())
 		return true;
 
+	tex.transient = is_transient_render_target(tex, _effects[tex.effect_index].module);
+
+	if (tex.transient)
+	{
+		// Techniques render one after another, so transient render targets of different effects are never live at the same time and can share a resource
+		for (const texture &other_tex : _textures)
+		{
+			if (&other_tex == &tex || !other_tex.transient || other_tex.resource == 0 || !other_tex.matches_description(tex))
+				continue;
+
+			if (std::any_of(_textures.cbegin(), _textures.cend(),
+					[&tex, resource = other_tex.resource](const texture &item) { return item.resource == resource && item.effect_index == tex.effect_index; }))
+				continue;
+
+			tex.resource = other_tex.resource;
+			std::copy_n(other_tex.srv, 2, tex.srv);
+			std::copy_n(other_tex.rtv, 2, tex.rtv);
+
+			_transient_texture_references[tex.resource.handle]++;
+			return true;
+		}
+	}
+
 	api::resource_type type = api::resource_type::unknown;
 	api::resource_view_type view_type = api::resource_view_type::unknown;
 
@@ -3244,6 +3882,9 @@ bool reshade::runtime::create_texture(texture &tex)
 
 	_device->set_resource_name(tex.resource, tex.unique_name.c_str());
 
+	if (tex.transient)
+		_transient_texture_references[tex.resource.handle] = 1;
+
 	// Always create shader resource views
 	{
 		if (!_device->create_resource_view(tex.resource, api::resource_usage::shader_resource, api::resource_view_desc(view_type, view_format, 0, tex.levels, 0, UINT32_MAX), &tex.srv[0]))
@@ -3297,6 +3938,31 @@ bool reshade::runtime::create_texture(texture &tex)
 
 	return true;
 }
+reshade::texture *reshade::runtime::find_texture(const std::string &unique_name)
+{
+	// Lookup also contains textures by their name, so need to compare the unique name of all candidates
+	const size_t texture_index = _texture_lookup.find(unique_name,
+		[this, &unique_name](size_t index) { return _textures[index].unique_name == unique_name; });
+
+	return texture_index != name_index::npos ? &_textures[texture_index] : nullptr;
+}
+void reshade::runtime::update_name_lookups()
+{
+	_texture_lookup.clear();
+	for (size_t texture_index = 0; texture_index < _textures.size(); ++texture_index)
+	{
+		const texture &tex = _textures[texture_index];
+
+		_texture_lookup.add(tex.unique_name, texture_index);
+		if (tex.name != tex.unique_name)
+			_texture_lookup.add(tex.name, texture_index);
+	}
+
+	_technique_lookup.clear();
+	for (size_t technique_index = 0; technique_index < _techniques.size(); ++technique_index)
+		_technique_lookup.add(_techniques[technique_index].name, technique_index);
+}
+
 void reshade::runtime::destroy_texture(texture &tex)
 {
 #if RESHADE_GUI
@@ -3304,6 +3970,23 @@ void reshade::runtime::destroy_texture(texture &tex)
 		_preview_texture.handle = 0;
 #endif
 
+	// Only destroy the resource of a transient render target once no other texture aliases it anymore
+	if (tex.transient && tex.resource != 0)
+	{
+		if (const auto it = _transient_texture_references.find(tex.resource.handle);
+			it != _transient_texture_references.end() && --it->second != 0)
+		{
+			tex.resource = {};
+			tex.srv[0] = tex.srv[1] = {};
+			tex.rtv[0] = tex.rtv[1] = {};
+			return;
+		}
+		else if (it != _transient_texture_references.end())
+		{
+			_transient_texture_references.erase(it);
+		}
+	}
+
 	_device->destroy_resource(tex.resource);
 	tex.resource = {};
 
@@ -3375,6 +4058,11 @@ void reshade::runtime::disable_technique(technique &tech)
 	tech.time_left = 0;
 	tech.average_cpu_duration.clear();
 	tech.average_gpu_duration.clear();
+	for (technique::pass_data &pass_data : tech.passes_data)
+	{
+		pass_data.average_cpu_duration.clear();
+		pass_data.average_gpu_duration.clear();
+	}
 
 	if (status_changed) // Decrease rendering reference count
 		_effects[tech.effect_index].rendering--;
@@ -3506,6 +4194,8 @@ void reshade::runtime::reload_effects(bool force_load_all)
 }
 void reshade::runtime::destroy_effects()
 {
+	abort_texture_loading();
+
 	// Make sure no threads are still accessing effect data
 	for (std::thread &thread : _worker_threads)
 		if (thread.joinable())
@@ -3538,8 +4228,8 @@ void reshade::runtime::destroy_effects()
 	}
 
 	// Textures and techniques should have been cleaned up by the calls to 'destroy_effect' above
-	assert(_textures.empty());
-	assert(_techniques.empty() && _technique_sorting.empty());
+	assert(_textures.empty() && _texture_lookup.empty());
+	assert(_techniques.empty() && _technique_sorting.empty() && _technique_lookup.empty());
 
 	_textures_loaded = false;
 	_should_reload_effect = std::numeric_limits<size_t>::max();
@@ -3581,6 +4271,50 @@ bool reshade::runtime::save_effect_cache(const std::string &id, const std::strin
 	file.write(data.data(), data.size());
 	return !file.fail();
 }
+reshade::pipeline_cache_file reshade::runtime::get_pipeline_cache_file() const
+{
+	// Limit size of the cache, since drivers only ever add to it, which would otherwise let it grow without bounds as effects are changed over time
+	constexpr size_t max_pipeline_cache_size = 256 * 1024 * 1024;
+
+	return pipeline_cache_file(g_reshade_base_path / _effect_cache_path, g_target_executable_path, _renderer_id, _vendor_id, _device_id, max_pipeline_cache_size);
+}
+void reshade::runtime::load_pipeline_cache()
+{
+	if (_no_effect_cache)
+		return;
+
+	const pipeline_cache_file file = get_pipeline_cache_file();
+
+	if (std::vector<uint8_t> data; file.load(data))
+	{
+		if (_device->merge_pipeline_cache_data(data.size(), data.data()))
+			_pipeline_cache_size = data.size();
+		else
+			LOG(INFO) << "Ignoring pipeline cache " << file.path() << ", since it was created by a different device or driver.";
+	}
+}
+void reshade::runtime::save_pipeline_cache()
+{
+	if (_no_effect_cache)
+		return;
+
+	// Skip writing the cache again if nothing was added to it
+	size_t size = 0;
+	if (!_device->get_pipeline_cache_data(&size, nullptr) || size == _pipeline_cache_size)
+		return;
+
+	std::vector<uint8_t> data(size);
+	if (!_device->get_pipeline_cache_data(&size, data.data()))
+		return;
+
+	const pipeline_cache_file file = get_pipeline_cache_file();
+
+	if (file.save(data.data(), size))
+		_pipeline_cache_size = size;
+	else
+		LOG(WARN) << "Failed to save pipeline cache of " << size << " bytes to " << file.path() << '!';
+}
+
 void reshade::runtime::clear_effect_cache()
 {
 	std::error_code ec;
@@ -3593,7 +4327,7 @@ void reshade::runtime::clear_effect_cache()
 
 		const std::filesystem::path filename = entry.path().filename();
 		const std::filesystem::path extension = entry.path().extension();
-		if (filename.native().compare(0, 8, L"reshade-") != 0 || (extension != L".i" && extension != L".cso" && extension != L".asm"))
+		if (filename.native().compare(0, 8, L"reshade-") != 0 || (extension != L".i" && extension != L".cso" && extension != L".asm" && extension != L".tex" && extension != L".pso"))
 			continue;
 
 		std::filesystem::remove(entry, ec);
@@ -3641,7 +4375,8 @@ bool reshade::runtime::update_effect_color_and_stencil_tex(uint32_t width, uint3
 
 #if RESHADE_ADDON
 	// Reload effects to update 'BUFFER_WIDTH', 'BUFFER_HEIGHT' and 'BUFFER_COLOR_BIT_DEPTH' definitions (unless this is the 'update_effect_color_and_stencil_tex' call in 'on_init')
-	const bool force_reload = _is_initialized && (width != _effect_width || height != _effect_height || format_color_bit_depth(color_format_typeless) != format_color_bit_depth(_effect_color_format));
+	// Scaled effects also have to recreate their stand-ins for the back buffer whenever the format changes
+	const bool force_reload = _is_initialized && (width != _effect_width || height != _effect_height || format_color_bit_depth(color_format_typeless) != format_color_bit_depth(_effect_color_format) || (color_format_typeless != _effect_color_format && !_effect_resolution_scales.empty()));
 #endif
 
 	_effect_width = width;
@@ -3718,6 +4453,9 @@ void reshade::runtime::update_effects()
 		_should_reload_effect = std::numeric_limits<size_t>::max();
 	}
 
+	if (_effect_frame_budget > 0.0f && _effects_enabled && !is_loading())
+		update_effect_resolution_scales();
+
 	if (_reload_remaining_effects == 0)
 	{
 		// Clear the thread list now that they all have finished
@@ -3763,7 +4501,9 @@ void reshade::runtime::update_effects()
 	if (_reload_remaining_effects != std::numeric_limits<size_t>::max())
 		return;
 
-	if (!_reload_create_queue.empty())
+	// Create as many effects as fit into the time budget for this frame (but always at least one), so that loading many effects does not take as many frames, without stalling a single frame for too long
+	// The budget is only checked after creating an effect, so that loading makes progress even with a budget that is shorter than creating any single effect
+	for (const std::chrono::high_resolution_clock::time_point time_create_started = std::chrono::high_resolution_clock::now(); !_reload_create_queue.empty();)
 	{
 		// Pop an effect from the queue
 		const size_t effect_index = _reload_create_queue.back();
@@ -3784,36 +4524,200 @@ void reshade::runtime::update_effects()
 			_last_reload_successful = false;
 		}
 
-		// An effect has changed, need to reload textures
-		_textures_loaded = false;
+		// An effect has changed, need to reload textures
+		_textures_loaded = false;
+		abort_texture_loading();
+
+#if RESHADE_GUI
+		const effect &effect = _effects[effect_index];
+
+		// Update assembly in all code editors after a reload
+		for (editor_instance &instance : _editors)
+		{
+			if (!instance.generated || instance.entry_point_name.empty() || instance.file_path != effect.source_file)
+				continue;
+
+			assert(instance.effect_index == effect_index);
+
+			if (effect.assembly_text.find(instance.entry_point_name) != effect.assembly_text.end())
+				open_code_editor(instance);
+		}
+#endif
+
+		if ((std::chrono::high_resolution_clock::now() - time_create_started) >= std::chrono::duration<float, std::milli>(_effect_creation_budget))
+			break;
+	}
+
+	if (!_textures_loaded && _reload_create_queue.empty())
+	{
+		// Now that all effects were created, start loading all textures in the background
+		if (_texture_load == nullptr)
+			load_textures();
+
+		// Upload textures that finished loading so far, until all of them are done
+		if (upload_textures())
+		{
+			_textures_loaded = true;
+
+#if RESHADE_ADDON
+			invoke_addon_event<addon_event::reshade_reloaded_effects>(this);
+#endif
+		}
+	}
+}
+void reshade::runtime::update_effect_resolution_scales()
+{
+	const auto current_time = std::chrono::high_resolution_clock::now();
+
+	// Give the GPU time averages a few seconds to settle after a change before deciding again, to avoid oscillating between resolutions
+	if (current_time - _last_effect_resolution_scale_change < std::chrono::seconds(5) ||
+		current_time - _last_reload_time < std::chrono::seconds(5) ||
+		_should_reload_effect != std::numeric_limits<size_t>::max())
+		return;
+
+	std::vector<uint64_t> effect_durations(_effects.size());
+	uint64_t total_duration = 0;
+	for (const technique &tech : _techniques)
+	{
+		if (!tech.enabled)
+			continue;
+
+		effect_durations[tech.effect_index] += tech.average_gpu_duration;
+		total_duration += tech.average_gpu_duration;
+	}
+
+	if (total_duration == 0)
+		return;
+
+	const uint64_t budget = static_cast<uint64_t>(_effect_frame_budget * 1000000.0);
+
+	constexpr unsigned int min_resolution_scale = 50;
+	constexpr unsigned int resolution_scale_step = 25;
+
+	size_t effect_index = std::numeric_limits<size_t>::max();
+	unsigned int new_resolution_scale = 100;
+
+	if (total_duration > budget + budget / 10)
+	{
+		// Over budget, so reduce the resolution of the most expensive effect that can still be scaled down (which only consist of a single technique, see 'is_effect_resolution_scalable')
+		for (size_t i = 0; i < _effects.size(); ++i)
+		{
+			if (!_effects[i].compiled || effect_durations[i] == 0 || !is_effect_resolution_scalable(i))
+				continue;
+
+			const auto scale_it = _effect_resolution_scales.find(_effects[i].source_file.filename().u8string());
+			const unsigned int resolution_scale = scale_it != _effect_resolution_scales.end() ? scale_it->second : 100;
+			if (resolution_scale <= min_resolution_scale)
+				continue;
+
+			if (effect_index == std::numeric_limits<size_t>::max() || effect_durations[i] > effect_durations[effect_index])
+			{
+				effect_index = i;
+				new_resolution_scale = std::max(min_resolution_scale, resolution_scale - resolution_scale_step);
+			}
+		}
+	}
+	else if (total_duration < budget - budget * 3 / 10)
+	{
+		// Well under budget, so restore the resolution of a scaled effect, as long as the estimated cost at the higher resolution still fits
+		for (size_t i = 0; i < _effects.size() && effect_index == std::numeric_limits<size_t>::max(); ++i)
+		{
+			const auto scale_it = _effect_resolution_scales.find(_effects[i].source_file.filename().u8string());
+			if (!_effects[i].compiled || scale_it == _effect_resolution_scales.end())
+				continue;
+
+			const unsigned int resolution_scale = scale_it->second;
+			const unsigned int next_resolution_scale = std::min(100u, resolution_scale + resolution_scale_step);
+
+			// Cost scales roughly with the number of pixels processed
+			const uint64_t estimated_duration = effect_durations[i] * next_resolution_scale * next_resolution_scale / (resolution_scale * resolution_scale);
+			if (total_duration - effect_durations[i] + estimated_duration < budget - budget / 10)
+			{
+				effect_index = i;
+				new_resolution_scale = next_resolution_scale;
+			}
+		}
+	}
+
+	if (effect_index == std::numeric_limits<size_t>::max())
+		return;
+
+	const std::string effect_name = _effects[effect_index].source_file.filename().u8string();
+
+	if (new_resolution_scale >= 100)
+		_effect_resolution_scales.erase(effect_name);
+	else
+		_effect_resolution_scales[effect_name] = new_resolution_scale;
+
+	LOG(INFO) << "Changing resolution scale of technique " << _effects[effect_index].module.techniques[0].name << " in " << effect_name << " to " << new_resolution_scale << "% to stay within frame budget of " << _effect_frame_budget << " ms.";
+
+	_should_reload_effect = effect_index;
+	_last_effect_resolution_scale_change = current_time;
+}
+bool reshade::runtime::is_effect_resolution_scalable(size_t effect_index) const
+{
+	const effect &effect = _effects[effect_index];
+
+	// Preprocessor definitions like 'BUFFER_WIDTH' apply to the entire effect file, so only effects consisting of a single technique can be scaled without affecting others
+	if (effect.module.techniques.size() != 1)
+		return false;
+
+	// The effect stencil buffer always has the full dimensions
+	for (const reshadefx::pass_info &pass_info : effect.module.techniques[0].passes)
+		if (pass_info.stencil_enable)
+			return false;
+
+	// Textures shared by name with other effects have to agree on dimensions across all of them
+	for (const texture &tex : _textures)
+		if (tex.semantic.empty() && tex.shared.size() > 1 && std::find(tex.shared.begin(), tex.shared.end(), effect_index) != tex.shared.end())
+			return false;
+
+	return true;
+}
+void reshade::runtime::resample_effect_texture(api::command_list *cmd_list, api::resource source, api::resource_view source_srv, api::resource_usage source_state, api::resource dest, api::resource_view dest_rtv, uint32_t dest_width, uint32_t dest_height)
+{
+	assert(source_state == api::resource_usage::render_target || source_state == api::resource_usage::shader_resource);
+
+	// Destination is expected to be in the render target state, like the back buffer while rendering effects
+	if (_effect_resample_pipeline == 0)
+	{
+		const api::resource resources[2] = { source, dest };
+		const api::resource_usage state_old[2] = { source_state, api::resource_usage::render_target };
+		const api::resource_usage state_new[2] = { api::resource_usage::copy_source, api::resource_usage::copy_dest };
+
+		cmd_list->barrier(2, resources, state_old, state_new);
+		cmd_list->copy_texture_region(source, 0, nullptr, dest, 0, nullptr, api::filter_mode::min_mag_mip_linear);
+		cmd_list->barrier(2, resources, state_new, state_old);
+		return;
+	}
+
+	// Devices that cannot scale while copying draw a fullscreen triangle instead (see 'on_init')
+	if (source_state != api::resource_usage::shader_resource)
+		cmd_list->barrier(source, source_state, api::resource_usage::shader_resource);
+
+	cmd_list->bind_pipeline(api::pipeline_stage::all_graphics, _effect_resample_pipeline);
 
-#if RESHADE_GUI
-		const effect &effect = _effects[effect_index];
+	cmd_list->push_descriptors(api::shader_stage::pixel, _effect_resample_pipeline_layout, 0, api::descriptor_table_update { {}, 0, 0, 1, api::descriptor_type::sampler, &_effect_resample_sampler_state });
+	cmd_list->push_descriptors(api::shader_stage::pixel, _effect_resample_pipeline_layout, 1, api::descriptor_table_update { {}, 0, 0, 1, api::descriptor_type::shader_resource_view, &source_srv });
 
-		// Update assembly in all code editors after a reload
-		for (editor_instance &instance : _editors)
-		{
-			if (!instance.generated || instance.entry_point_name.empty() || instance.file_path != effect.source_file)
-				continue;
+	api::render_pass_render_target_desc render_target = {};
+	render_target.view = dest_rtv;
 
-			assert(instance.effect_index == effect_index);
+	cmd_list->begin_render_pass(1, &render_target, nullptr);
 
-			if (effect.assembly_text.find(instance.entry_point_name) != effect.assembly_text.end())
-				open_code_editor(instance);
-		}
-#endif
-	}
+	const api::viewport viewport = { 0.0f, 0.0f, static_cast<float>(dest_width), static_cast<float>(dest_height), 0.0f, 1.0f };
+	cmd_list->bind_viewports(0, 1, &viewport);
+	const api::rect scissor_rect = { 0, 0, static_cast<int32_t>(dest_width), static_cast<int32_t>(dest_height) };
+	cmd_list->bind_scissor_rects(0, 1, &scissor_rect);
 
-	if (!_textures_loaded && _reload_create_queue.empty())
-	{
-		// Now that all effects were created, load all textures
-		load_textures();
+	cmd_list->draw(3, 1, 0, 0);
 
-#if RESHADE_ADDON
-		invoke_addon_event<addon_event::reshade_reloaded_effects>(this);
-#endif
-	}
+	cmd_list->end_render_pass();
+
+	if (source_state != api::resource_usage::shader_resource)
+		cmd_list->barrier(source, api::resource_usage::shader_resource, source_state);
 }
+
 void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource_view rtv, api::resource_view rtv_srgb)
 {
 	// Do not render effects twice in a frame
@@ -3972,7 +4876,8 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 					if (_input == nullptr)
 						break;
 
-					set_uniform_value(variable, _input->mouse_position_x(), _input->mouse_position_y());
+					// Report the position in the dimensions of the effect, which are smaller than those of the back buffer for scaled effects
+					set_uniform_value(variable, _input->mouse_position_x() * effect.width / _effect_width, _input->mouse_position_y() * effect.height / _effect_height);
 					break;
 				}
 				case special_uniform::mouse_delta:
@@ -3980,7 +4885,7 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 					if (_input == nullptr)
 						break;
 
-					set_uniform_value(variable, _input->mouse_movement_delta_x(), _input->mouse_movement_delta_y());
+					set_uniform_value(variable, _input->mouse_movement_delta_x() * static_cast<int>(effect.resolution_scale) / 100, _input->mouse_movement_delta_y() * static_cast<int>(effect.resolution_scale) / 100);
 					break;
 				}
 				case special_uniform::mouse_button:
@@ -4128,24 +5033,112 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 {
 	const effect &effect = _effects[tech.effect_index];
 
+#if RESHADE_ADDON
+	// Add-ons always see the command list the technique is rendered with, never the statistics wrapper below, so that its identity does not depend on whether the overlay is open
+	api::command_list *const addon_cmd_list = cmd_list;
+#endif
+
 #if RESHADE_GUI
-	if (_gather_gpu_statistics && _timestamp_frequency != 0 && effect.query_heap != 0)
+	// Number of timestamp intervals measured per frame, either one per pass or one for the entire technique
+	const size_t num_timings_per_slot = tech.query_per_pass ? tech.passes.size() : 1;
+	const uint32_t num_queries_per_slot = static_cast<uint32_t>(num_timings_per_slot + 1);
+	uint32_t query_slot = technique::max_query_ring_depth;
+
+	if ((_gather_gpu_statistics || _timing_export_file.is_open() || _effect_frame_budget > 0.0f) && _timestamp_frequency != 0 && effect.query_heap != 0)
 	{
-		// Evaluate queries from oldest frame in queue
-		if (uint64_t timestamps[2];
-			_device->get_query_heap_results(effect.query_heap, tech.query_base_index + (_frame_count % 4) * 2, 2, timestamps, sizeof(uint64_t)))
-			tech.average_gpu_duration.append((timestamps[1] - timestamps[0]) * 1000000000ull / _timestamp_frequency);
+		const auto find_oldest_query_slot = [&tech]() {
+			uint32_t oldest_slot = technique::max_query_ring_depth;
+			for (uint32_t slot = 0; slot < technique::max_query_ring_depth; ++slot)
+				if (tech.query_slot_frame[slot] != 0 && (oldest_slot == technique::max_query_ring_depth || tech.query_slot_frame[slot] < tech.query_slot_frame[oldest_slot]))
+					oldest_slot = slot;
+			return oldest_slot;
+		};
+
+		// Evaluate queries of all slots whose results are available, starting with the oldest one (this never waits for the GPU)
+		temp_mem<uint64_t, 17> timestamps(num_queries_per_slot);
+		for (uint32_t slot; (slot = find_oldest_query_slot()) != technique::max_query_ring_depth;)
+		{
+			if (!_device->get_query_heap_results(effect.query_heap, tech.query_base_index + slot * num_queries_per_slot, num_queries_per_slot, timestamps.p, sizeof(uint64_t)))
+				break;
+
+			tech.average_gpu_duration.append((timestamps[num_queries_per_slot - 1] - timestamps[0]) * 1000000000ull / _timestamp_frequency);
+
+			for (size_t i = 0; i < num_timings_per_slot; ++i)
+			{
+				const uint64_t gpu_duration = (timestamps[i + 1] - timestamps[i]) * 1000000000ull / _timestamp_frequency;
+				const uint64_t cpu_duration = tech.query_slot_cpu_durations[slot * num_timings_per_slot + i];
+
+				if (tech.query_per_pass)
+					tech.passes_data[i].average_gpu_duration.append(gpu_duration);
+
+				// Formatting and writing happens on the worker thread of the export file
+				if (_timing_export_file.is_open())
+					_timing_export_file.append({ tech.query_slot_frame[slot] - 1, tech.name, tech.query_per_pass ? static_cast<int32_t>(i) : -1, tech.query_per_pass ? tech.passes[i].name : std::string(), cpu_duration, gpu_duration });
+			}
+
+			tech.query_slot_frame[slot] = 0;
+		}
+
+		// Pick a slot without pending results to write the queries of this frame to
+		for (uint32_t slot = 0; slot < tech.query_ring_depth && query_slot == technique::max_query_ring_depth; ++slot)
+			if (tech.query_slot_frame[slot] == 0)
+				query_slot = slot;
+
+		if (query_slot == technique::max_query_ring_depth)
+		{
+			// All slots are still in flight, so grow the ring, or drop the oldest results if it already has the maximum depth
+			if (tech.query_ring_depth < technique::max_query_ring_depth)
+				query_slot = tech.query_ring_depth++;
+			else
+				query_slot = find_oldest_query_slot();
+		}
+
+		tech.query_slot_frame[query_slot] = _frame_count + 1;
 
-		cmd_list->end_query(effect.query_heap, api::query_type::timestamp, tech.query_base_index + (_frame_count % 4) * 2);
+		cmd_list->end_query(effect.query_heap, api::query_type::timestamp, tech.query_base_index + query_slot * num_queries_per_slot);
 	}
 
 	const std::chrono::high_resolution_clock::time_point time_technique_started = std::chrono::high_resolution_clock::now();
+	std::chrono::high_resolution_clock::time_point time_pass_started = time_technique_started;
+
+	// Count commands recorded for the statistics overlay by recording through a wrapper, which is only done while the overlay is visible
+	command_list_statistics cmd_list_statistics(cmd_list, _effect_command_stats);
+	if (_gather_gpu_statistics)
+		cmd_list = &cmd_list_statistics;
 #endif
 
 #ifndef NDEBUG
 	cmd_list->begin_debug_event(tech.name.c_str());
 #endif
 
+	// Techniques of scaled effects render into a stand-in for the back buffer at the scaled dimensions (see 'create_effect'), which is upsampled into the actual back buffer again at the end
+	const api::resource full_back_buffer_resource = back_buffer_resource;
+	const api::resource_view full_back_buffer_rtv = back_buffer_rtv;
+#if RESHADE_ADDON
+	const api::resource_view full_back_buffer_rtv_srgb = back_buffer_rtv_srgb;
+#endif
+	api::resource effect_color_tex = _effect_color_tex;
+	bool scaled_back_buffer_modified = false;
+
+	if (effect.scaled_back_buffer != 0)
+	{
+		// Go through the effect color texture, since the back buffer itself cannot be sampled
+		const api::resource resources[2] = { back_buffer_resource, _effect_color_tex };
+		const api::resource_usage state_old[2] = { api::resource_usage::render_target, api::resource_usage::shader_resource };
+		const api::resource_usage state_new[2] = { api::resource_usage::copy_source, api::resource_usage::copy_dest };
+
+		cmd_list->barrier(2, resources, state_old, state_new);
+		cmd_list->copy_texture_region(back_buffer_resource, 0, nullptr, _effect_color_tex, 0, nullptr);
+		cmd_list->barrier(2, resources, state_new, state_old);
+
+		resample_effect_texture(cmd_list, _effect_color_tex, _effect_color_srv[0], api::resource_usage::shader_resource, effect.scaled_back_buffer, effect.scaled_back_buffer_rtv[0], effect.width, effect.height);
+
+		back_buffer_resource = effect.scaled_back_buffer;
+		back_buffer_rtv = effect.scaled_back_buffer_rtv[0];
+		back_buffer_rtv_srgb = effect.scaled_back_buffer_rtv[1];
+		effect_color_tex = effect.scaled_color_tex;
+	}
+
 	// Update shader constants
 	if (void *mapped_uniform_data;
 		effect.cb != 0 && _device->map_buffer_region(effect.cb, 0, std::numeric_limits<uint64_t>::max(), api::map_access::write_discard, &mapped_uniform_data))
@@ -4161,49 +5154,65 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 	const bool sampler_with_resource_view = _device->check_capability(api::device_caps::sampler_with_resource_view);
 
 	bool is_effect_stencil_cleared = false;
-	bool needs_implicit_back_buffer_copy = true; // First pass always needs the back buffer updated
+
+	// Descriptor tables that are shared by all passes only need to be bound again after they were invalidated by the call to 'generate_mipmaps' below
+	bool graphics_tables_bound = false;
+	bool compute_tables_bound = false;
+
+	// Back buffer copy of a skipped pass that later passes still rely on
+	bool back_buffer_copy_pending = false;
 
 	for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
 	{
-		if (needs_implicit_back_buffer_copy)
+		const reshadefx::pass_info &pass_info = tech.passes[pass_index];
+		const technique::pass_data &pass_data = tech.passes_data[pass_index];
+
+		// Effects declare that a pass does not change anything while its enable condition is false, so skip drawing it altogether in that case
+		bool skip_pass = pass_data.always_skipped;
+		if (pass_data.enable_uniform_index < effect.uniforms.size())
 		{
-			// Save back buffer of previous pass
-			const api::resource resources[2] = { back_buffer_resource, _effect_color_tex };
-			const api::resource_usage state_old[2] = { api::resource_usage::render_target, api::resource_usage::shader_resource };
-			const api::resource_usage state_new[2] = { api::resource_usage::copy_source, api::resource_usage::copy_dest };
+			bool enabled = true;
+			get_uniform_value(effect.uniforms[pass_data.enable_uniform_index], &enabled);
+			skip_pass = !enabled;
+		}
 
-			cmd_list->barrier(2, resources, state_old, state_new);
-			cmd_list->copy_texture_region(back_buffer_resource, 0, nullptr, _effect_color_tex, 0, nullptr);
-			cmd_list->barrier(2, resources, state_new, state_old);
+		bool copy_back_buffer = pass_data.copy_back_buffer || back_buffer_copy_pending;
+		if (skip_pass)
+		{
+			// Passes that would write to the back buffer cause the next pass sampling it to copy it again anyway, so the copy can be dropped, otherwise it is moved to the next pass that is executed
+			back_buffer_copy_pending = copy_back_buffer && !pass_data.writes_back_buffer;
+			copy_back_buffer = false;
+		}
+		else
+		{
+			back_buffer_copy_pending = false;
 		}
 
-		const reshadefx::pass_info &pass_info = tech.passes[pass_index];
-		const technique::pass_data &pass_data = tech.passes_data[pass_index];
+		// Issue transitions of the previous pass and this pass as a single batch (see 'create_effect')
+		pass_data.record_begin_barriers(cmd_list, copy_back_buffer, back_buffer_resource, effect_color_tex);
 
 #ifndef NDEBUG
 		cmd_list->begin_debug_event((pass_info.name.empty() ? "Pass " + std::to_string(pass_index) : pass_info.name).c_str());
 #endif
 
-		const uint32_t num_barriers = static_cast<uint32_t>(pass_data.modified_resources.size());
-
-		if (!pass_info.cs_entry_point.empty())
+		if (skip_pass)
+		{
+			// Still transition resources back to shader access, so that their state matches what the next pass expects
+			pass_data.record_end_barriers(cmd_list);
+		}
+		else if (!pass_info.cs_entry_point.empty())
 		{
-			// Compute shaders do not write to the back buffer, so no update necessary
-			needs_implicit_back_buffer_copy = false;
-
 			cmd_list->bind_pipeline(api::pipeline_stage::all_compute, pass_data.pipeline);
 
-			temp_mem<api::resource_usage> state_old, state_new;
-			std::fill_n(state_old.p, num_barriers, api::resource_usage::shader_resource);
-			std::fill_n(state_new.p, num_barriers, api::resource_usage::unordered_access);
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_old.p, state_new.p);
-
-			// Reset bindings on every pass (since they get invalidated by the call to 'generate_mipmaps' below)
-			if (effect.cb != 0)
-				cmd_list->bind_descriptor_table(api::shader_stage::all_compute, effect.layout, 0, effect.cb_table);
-			if (effect.sampler_table != 0)
-				assert(!sampler_with_resource_view),
-				cmd_list->bind_descriptor_table(api::shader_stage::all_compute, effect.layout, 1, effect.sampler_table);
+			if (!compute_tables_bound)
+			{
+				if (effect.cb != 0)
+					cmd_list->bind_descriptor_table(api::shader_stage::all_compute, effect.layout, 0, effect.cb_table);
+				if (effect.sampler_table != 0)
+					assert(!sampler_with_resource_view),
+					cmd_list->bind_descriptor_table(api::shader_stage::all_compute, effect.layout, 1, effect.sampler_table);
+				compute_tables_bound = true;
+			}
 			if (pass_data.texture_table != 0)
 				cmd_list->bind_descriptor_table(api::shader_stage::all_compute, effect.layout, sampler_with_resource_view ? 1 : 2, pass_data.texture_table);
 			if (pass_data.storage_table != 0)
@@ -4211,18 +5220,12 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 
 			cmd_list->dispatch(pass_info.viewport_width, pass_info.viewport_height, pass_info.viewport_dispatch_z);
 
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_new.p, state_old.p);
+			pass_data.record_end_barriers(cmd_list);
 		}
 		else
 		{
 			cmd_list->bind_pipeline(api::pipeline_stage::all_graphics, pass_data.pipeline);
 
-			// Transition resource state for render targets
-			temp_mem<api::resource_usage> state_old, state_new;
-			std::fill_n(state_old.p, num_barriers, api::resource_usage::shader_resource);
-			std::fill_n(state_new.p, num_barriers, api::resource_usage::render_target);
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_old.p, state_new.p);
-
 			// Setup render targets
 			uint32_t render_target_count = 0;
 			api::render_pass_depth_stencil_desc depth_stencil = {};
@@ -4230,15 +5233,13 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 
 			if (pass_info.render_target_names[0].empty())
 			{
-				needs_implicit_back_buffer_copy = true;
-
 				render_target[0].view = pass_info.srgb_write_enable ? back_buffer_rtv_srgb : back_buffer_rtv;
 				render_target_count = 1;
+
+				scaled_back_buffer_modified = effect.scaled_back_buffer != 0;
 			}
 			else
 			{
-				needs_implicit_back_buffer_copy = false;
-
 				for (int i = 0; i < 8 && pass_data.render_target_views[i] != 0; ++i, ++render_target_count)
 					render_target[i].view = pass_data.render_target_views[i];
 			}
@@ -4262,12 +5263,15 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 
 			cmd_list->begin_render_pass(render_target_count, render_target, depth_stencil.view != 0 ? &depth_stencil : nullptr);
 
-			// Reset bindings on every pass (since they get invalidated by the call to 'generate_mipmaps' below)
-			if (effect.cb != 0)
-				cmd_list->bind_descriptor_table(api::shader_stage::all_graphics, effect.layout, 0, effect.cb_table);
-			if (effect.sampler_table != 0)
-				assert(!sampler_with_resource_view),
-				cmd_list->bind_descriptor_table(api::shader_stage::all_graphics, effect.layout, 1, effect.sampler_table);
+			if (!graphics_tables_bound)
+			{
+				if (effect.cb != 0)
+					cmd_list->bind_descriptor_table(api::shader_stage::all_graphics, effect.layout, 0, effect.cb_table);
+				if (effect.sampler_table != 0)
+					assert(!sampler_with_resource_view),
+					cmd_list->bind_descriptor_table(api::shader_stage::all_graphics, effect.layout, 1, effect.sampler_table);
+				graphics_tables_bound = true;
+			}
 			// Setup shader resources after binding render targets, to ensure any OM bindings by the application are unset at this point (e.g. a depth buffer that was bound to the OM and is now bound as shader resource)
 			if (pass_data.texture_table != 0)
 				cmd_list->bind_descriptor_table(api::shader_stage::all_graphics, effect.layout, sampler_with_resource_view ? 1 : 2, pass_data.texture_table);
@@ -4289,32 +5293,9 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 
 			if (_renderer_id == 0x9000)
 			{
-				// Set __TEXEL_SIZE__ constant (see effect_codegen_hlsl.cpp)
-				const float texel_size[4] = {
-					-1.0f / pass_info.viewport_width,
-					 1.0f / pass_info.viewport_height
-				};
-				cmd_list->push_constants(api::shader_stage::vertex, effect.layout, 0, 255 * 4, 4, texel_size);
-
-				// Set SEMANTIC_PIXEL_SIZE constants (see 'load_effect' above)
-				uint32_t semantic_index = 0;
-				for (const reshadefx::texture_info &tex : effect.module.textures)
-				{
-					if (tex.semantic.empty() || tex.semantic == "COLOR")
-						continue;
-
-					semantic_index++;
-
-					if (const auto it = _texture_semantic_bindings.find(tex.semantic); it != _texture_semantic_bindings.end())
-					{
-						const float pixel_size[4] = {
-							1.0f / _effect_width,
-							1.0f / _effect_height
-						};
-
-						cmd_list->push_constants(api::shader_stage::vertex | api::shader_stage::pixel, effect.layout, 0, (255 - semantic_index) * 4, 4, pixel_size);
-					}
-				}
+				// Set SEMANTIC_PIXEL_SIZE and __TEXEL_SIZE__ constants, which were prepared in 'create_effect'
+				const uint32_t num_constants = static_cast<uint32_t>(pass_data.d3d9_constants.size());
+				cmd_list->push_constants(api::shader_stage::vertex | api::shader_stage::pixel, effect.layout, 0, 256 * 4 - num_constants, num_constants, pass_data.d3d9_constants.data());
 			}
 
 			// Draw primitives
@@ -4322,19 +5303,46 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 
 			cmd_list->end_render_pass();
 
-			// Transition resource state back to shader access
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_new.p, state_old.p);
+			// Transition resource state back to shader access, unless that was merged into the transitions of the next pass
+			pass_data.record_end_barriers(cmd_list);
+		}
+
+		// Generate mipmaps for modified resources (those of skipped passes were not modified, so still have valid mipmaps)
+		if (!skip_pass && !pass_data.generate_mipmap_views.empty())
+		{
+			for (const api::resource_view modified_texture : pass_data.generate_mipmap_views)
+				cmd_list->generate_mipmaps(modified_texture);
+
+			graphics_tables_bound = false;
+			compute_tables_bound = false;
 		}
 
-		// Generate mipmaps for modified resources
-		for (const api::resource_view modified_texture : pass_data.generate_mipmap_views)
-			cmd_list->generate_mipmaps(modified_texture);
+#if RESHADE_GUI
+		if (query_slot != technique::max_query_ring_depth && (tech.query_per_pass || pass_index == tech.passes.size() - 1))
+		{
+			const size_t timing_index = tech.query_per_pass ? pass_index : 0;
+
+			cmd_list->end_query(effect.query_heap, api::query_type::timestamp, tech.query_base_index + query_slot * num_queries_per_slot + static_cast<uint32_t>(timing_index) + 1);
+
+			// CPU durations are only measured alongside the GPU timestamps
+			const std::chrono::high_resolution_clock::time_point time_pass_finished = std::chrono::high_resolution_clock::now();
+			const uint64_t cpu_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(time_pass_finished - time_pass_started).count();
+			time_pass_started = time_pass_finished;
+
+			if (tech.query_per_pass)
+				tech.passes_data[pass_index].average_cpu_duration.append(cpu_duration);
+			tech.query_slot_cpu_durations[query_slot * num_timings_per_slot + timing_index] = cpu_duration;
+		}
+#endif
 
 #ifndef NDEBUG
 		cmd_list->end_debug_event();
 #endif
 	}
 
+	if (scaled_back_buffer_modified)
+		resample_effect_texture(cmd_list, effect.scaled_back_buffer, effect.scaled_back_buffer_srv, api::resource_usage::render_target, full_back_buffer_resource, full_back_buffer_rtv, _effect_width, _effect_height);
+
 #ifndef NDEBUG
 	cmd_list->end_debug_event();
 #endif
@@ -4343,9 +5351,6 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 	const std::chrono::high_resolution_clock::time_point time_technique_finished = std::chrono::high_resolution_clock::now();
 
 	tech.average_cpu_duration.append(std::chrono::duration_cast<std::chrono::nanoseconds>(time_technique_finished - time_technique_started).count());
-
-	if (_gather_gpu_statistics && _timestamp_frequency != 0 && effect.query_heap != 0)
-		cmd_list->end_query(effect.query_heap, api::query_type::timestamp, tech.query_base_index + (_frame_count % 4) * 2 + 1);
 #endif
 
 #if RESHADE_ADDON
@@ -4353,7 +5358,7 @@ void reshade::runtime::render_technique(technique &tech, api::command_list *cmd_
 		return;
 
 	_is_in_api_call = true;
-	invoke_addon_event<addon_event::reshade_render_technique>(const_cast<runtime *>(this), api::effect_technique { reinterpret_cast<uintptr_t>(&tech) }, cmd_list, back_buffer_rtv, back_buffer_rtv_srgb);
+	invoke_addon_event<addon_event::reshade_render_technique>(const_cast<runtime *>(this), api::effect_technique { reinterpret_cast<uintptr_t>(&tech) }, addon_cmd_list, full_back_buffer_rtv, full_back_buffer_rtv_srgb);
 	_is_in_api_call = false;
 #endif
 }
@@ -4431,62 +5436,8 @@ void reshade::runtime::update_texture(texture &tex, uint32_t width, uint32_t hei
 	uint32_t pixel_size;
 	stbir_datatype data_type;
 	stbir_pixel_layout pixel_layout;
-	switch (tex.format)
-	{
-	case reshadefx::texture_format::r8:
-		pixel_size = 1 * 1;
-		data_type = STBIR_TYPE_UINT8;
-		pixel_layout = STBIR_1CHANNEL;
-		break;
-	case reshadefx::texture_format::r32f:
-		pixel_size = 4 * 1;
-		data_type = STBIR_TYPE_FLOAT;
-		pixel_layout = STBIR_1CHANNEL;
-		break;
-	case reshadefx::texture_format::rg8:
-		pixel_size = 1 * 2;
-		data_type = STBIR_TYPE_UINT8;
-		pixel_layout = STBIR_2CHANNEL;
-		break;
-	case reshadefx::texture_format::rg16:
-		pixel_size = 2 * 2;
-		data_type = STBIR_TYPE_UINT16;
-		pixel_layout = STBIR_2CHANNEL;
-		break;
-	case reshadefx::texture_format::rg16f:
-		pixel_size = 2 * 2;
-		data_type = STBIR_TYPE_HALF_FLOAT;
-		pixel_layout = STBIR_2CHANNEL;
-		break;
-	case reshadefx::texture_format::rg32f:
-		pixel_size = 4 * 2;
-		data_type = STBIR_TYPE_FLOAT;
-		pixel_layout = STBIR_2CHANNEL;
-		break;
-	case reshadefx::texture_format::rgba8:
-	case reshadefx::texture_format::rgb10a2:
-		pixel_size = 1 * 4;
-		data_type = STBIR_TYPE_UINT8;
-		pixel_layout = STBIR_RGBA;
-		break;
-	case reshadefx::texture_format::rgba16:
-		pixel_size = 2 * 4;
-		data_type = STBIR_TYPE_UINT16;
-		pixel_layout = STBIR_RGBA;
-		break;
-	case reshadefx::texture_format::rgba16f:
-		pixel_size = 2 * 4;
-		data_type = STBIR_TYPE_HALF_FLOAT;
-		pixel_layout = STBIR_RGBA;
-		break;
-	case reshadefx::texture_format::rgba32f:
-		pixel_size = 4 * 4;
-		data_type = STBIR_TYPE_FLOAT;
-		pixel_layout = STBIR_RGBA;
-		break;
-	default:
+	if (!get_texture_format_info(tex.format, pixel_size, data_type, pixel_layout))
 		return;
-	}
 
 	void *upload_data = const_cast<void *>(pixels);
 
@@ -4880,26 +5831,24 @@ void reshade::runtime::save_screenshot(const std::string_view postfix)
 
 	_last_screenshot_save_successful = true;
 
-	if (std::vector<uint8_t> pixels(static_cast<size_t>(_width) * static_cast<size_t>(_height) * 4);
-		capture_screenshot(pixels.data()))
-	{
 #if RESHADE_FX
-		const bool include_preset = _screenshot_include_preset && postfix.empty() && ini_file::flush_cache(_current_preset_path);
+	const bool include_preset = _screenshot_include_preset && postfix.empty() && ini_file::flush_cache(_current_preset_path);
 #else
-		const bool include_preset = false;
+	const bool include_preset = false;
 #endif
-		// Play screenshot sound
-		if (!_screenshot_sound_path.empty())
-			utils::play_sound_async(g_reshade_base_path / _screenshot_sound_path);
 
-		_worker_threads.emplace_back([this, screenshot_count, screenshot_path, pixels = std::move(pixels), include_preset]() mutable {
+	// Only a copy is queued here, the pixel data is passed to the callback on a worker thread once it arrived in system memory a few frames later
+	if (!queue_texture_readback(
+			_back_buffer_resolved != 0 ? _back_buffer_resolved : _swapchain->get_current_back_buffer(),
+			_back_buffer_resolved != 0 ? api::resource_usage::render_target : api::resource_usage::present,
+			[this, screenshot_count, screenshot_path, include_preset](std::vector<uint8_t> &pixels, uint32_t width, uint32_t height) {
 			// Remove alpha channel
 			int comp = 4;
 			if (_screenshot_clear_alpha)
 			{
 				comp = 3;
-				for (size_t i = 0; i < static_cast<size_t>(_width) * static_cast<size_t>(_height); ++i)
-					*reinterpret_cast<uint32_t *>(pixels.data() + 3 * i) = *reinterpret_cast<const uint32_t *>(pixels.data() + 4 * i);
+				for (size_t i = 0; i < pixels.size() / 4; ++i)
+					std::memcpy(pixels.data() + 3 * i, pixels.data() + 4 * i, 3);
 			}
 
 			// Create screenshot directory if it does not exist
@@ -4912,7 +5861,11 @@ void reshade::runtime::save_screenshot(const std::string_view postfix)
 			// Default to a save failure unless it is reported to succeed below
 			bool save_success = false;
 
-			if (auto file = std::ofstream(screenshot_path, std::ios::binary | std::ios::trunc))
+			if (pixels.empty())
+			{
+				LOG(ERROR) << "Failed to read back screenshot data!";
+			}
+			else if (auto file = std::ofstream(screenshot_path, std::ios::binary | std::ios::trunc))
 			{
 				const auto write_callback = [](void *context, void *data, int size) {
 					static_cast<std::ofstream *>(context)->write(static_cast<const char *>(data), size);
@@ -4921,21 +5874,21 @@ void reshade::runtime::save_screenshot(const std::string_view postfix)
 				switch (_screenshot_format)
 				{
 				case 0:
-					save_success = stbi_write_bmp_to_func(write_callback, &file, _width, _height, comp, pixels.data()) != 0;
+					save_success = stbi_write_bmp_to_func(write_callback, &file, width, height, comp, pixels.data()) != 0;
 					break;
 				case 1:
 				{
 #if 1
 					std::vector<uint8_t> encoded_data;
-					save_success = fpng::fpng_encode_image_to_memory(pixels.data(), _width, _height, comp, encoded_data);
+					save_success = fpng::fpng_encode_image_to_memory(pixels.data(), width, height, comp, encoded_data);
 					write_callback(&file, encoded_data.data(), static_cast<int>(encoded_data.size()));
 #else
-					save_success = stbi_write_png_to_func(write_callback, &file, _width, _height, comp, pixels.data(), 0) != 0;
+					save_success = stbi_write_png_to_func(write_callback, &file, width, height, comp, pixels.data(), 0) != 0;
 #endif
 					break;
 				}
 				case 2:
-					save_success = stbi_write_jpg_to_func(write_callback, &file, _width, _height, comp, pixels.data(), _screenshot_jpeg_quality) != 0;
+					save_success = stbi_write_jpg_to_func(write_callback, &file, width, height, comp, pixels.data(), _screenshot_jpeg_quality) != 0;
 					break;
 				}
 
@@ -4945,6 +5898,10 @@ void reshade::runtime::save_screenshot(const std::string_view postfix)
 
 			if (save_success)
 			{
+				// Play screenshot sound only once the file was actually written
+				if (!_screenshot_sound_path.empty())
+					utils::play_sound_async(g_reshade_base_path / _screenshot_sound_path);
+
 				execute_screenshot_post_save_command(screenshot_path, screenshot_count);
 
 #if RESHADE_FX
@@ -4974,7 +5931,11 @@ void reshade::runtime::save_screenshot(const std::string_view postfix)
 				_last_screenshot_file = screenshot_path;
 				_last_screenshot_save_successful = save_success;
 			}
-		});
+		}))
+	{
+		_last_screenshot_time = std::chrono::high_resolution_clock::now();
+		_last_screenshot_file = screenshot_path;
+		_last_screenshot_save_successful = false;
 	}
 }
 bool reshade::runtime::execute_screenshot_post_save_command(const std::filesystem::path &screenshot_path, unsigned int screenshot_count)
@@ -5018,14 +5979,7 @@ bool reshade::runtime::get_texture_data(api::resource resource, api::resource_us
 	const api::resource_desc desc = _device->get_resource_desc(resource);
 	const api::format view_format = api::format_to_default_typed(desc.texture.format, 0);
 
-	if (view_format != api::format::r8_unorm &&
-		view_format != api::format::r8g8_unorm &&
-		view_format != api::format::r8g8b8a8_unorm &&
-		view_format != api::format::b8g8r8a8_unorm &&
-		view_format != api::format::r8g8b8x8_unorm &&
-		view_format != api::format::b8g8r8x8_unorm &&
-		view_format != api::format::r10g10b10a2_unorm &&
-		view_format != api::format::b10g10r10a2_unorm)
+	if (!utils::is_rgba8_conversion_supported(view_format))
 	{
 		LOG(ERROR) << "Screenshots are not supported for format " << static_cast<uint32_t>(desc.texture.format) << '!';
 		return false;
@@ -5055,64 +6009,7 @@ bool reshade::runtime::get_texture_data(api::resource resource, api::resource_us
 	api::subresource_data mapped_data = {};
 	if (_device->map_texture_region(intermediate, 0, nullptr, api::map_access::read_only, &mapped_data))
 	{
-		auto mapped_pixels = static_cast<const uint8_t *>(mapped_data.data);
-		const uint32_t pixels_row_pitch = desc.texture.width * 4;
-
-		for (size_t y = 0; y < desc.texture.height; ++y, pixels += pixels_row_pitch, mapped_pixels += mapped_data.row_pitch)
-		{
-			switch (view_format)
-			{
-			case api::format::r8_unorm:
-				for (size_t x = 0; x < desc.texture.width; ++x)
-				{
-					pixels[x * 4 + 0] = mapped_pixels[x];
-					pixels[x * 4 + 1] = 0;
-					pixels[x * 4 + 2] = 0;
-					pixels[x * 4 + 3] = 0xFF;
-				}
-				break;
-			case api::format::r8g8_unorm:
-				for (size_t x = 0; x < desc.texture.width; ++x)
-				{
-					pixels[x * 4 + 0] = mapped_pixels[x * 2 + 0];
-					pixels[x * 4 + 1] = mapped_pixels[x * 2 + 1];
-					pixels[x * 4 + 2] = 0;
-					pixels[x * 4 + 3] = 0xFF;
-				}
-				break;
-			case api::format::r8g8b8a8_unorm:
-			case api::format::r8g8b8x8_unorm:
-				std::memcpy(pixels, mapped_pixels, pixels_row_pitch);
-				if (view_format == api::format::r8g8b8x8_unorm)
-					for (size_t x = 0; x < pixels_row_pitch; x += 4)
-						pixels[x + 3] = 0xFF;
-				break;
-			case api::format::b8g8r8a8_unorm:
-			case api::format::b8g8r8x8_unorm:
-				std::memcpy(pixels, mapped_pixels, pixels_row_pitch);
-				// Format is BGRA, but output should be RGBA, so flip channels
-				for (size_t x = 0; x < pixels_row_pitch; x += 4)
-					std::swap(pixels[x + 0], pixels[x + 2]);
-				if (view_format == api::format::b8g8r8x8_unorm)
-					for (size_t x = 0; x < pixels_row_pitch; x += 4)
-						pixels[x + 3] = 0xFF;
-				break;
-			case api::format::r10g10b10a2_unorm:
-			case api::format::b10g10r10a2_unorm:
-				for (size_t x = 0; x < pixels_row_pitch; x += 4)
-				{
-					const uint32_t rgba = *reinterpret_cast<const uint32_t *>(mapped_pixels + x);
-					// Divide by 4 to get 10-bit range (0-1023) into 8-bit range (0-255)
-					pixels[x + 0] = (( rgba & 0x000003FF)        /  4) & 0xFF;
-					pixels[x + 1] = (((rgba & 0x000FFC00) >> 10) /  4) & 0xFF;
-					pixels[x + 2] = (((rgba & 0x3FF00000) >> 20) /  4) & 0xFF;
-					pixels[x + 3] = (((rgba & 0xC0000000) >> 30) * 85) & 0xFF;
-					if (view_format == api::format::b10g10r10a2_unorm)
-						std::swap(pixels[x + 0], pixels[x + 2]);
-				}
-				break;
-			}
-		}
+		utils::convert_pixels_to_rgba8(view_format, desc.texture.width, desc.texture.height, mapped_data.data, mapped_data.row_pitch, pixels, desc.texture.width * 4);
 
 		_device->unmap_texture_region(intermediate, 0);
 	}
@@ -5121,3 +6018,139 @@ bool reshade::runtime::get_texture_data(api::resource resource, api::resource_us
 
 	return mapped_data.data != nullptr;
 }
+
+bool reshade::runtime::queue_texture_readback(api::resource resource, api::resource_usage state, std::function<void(std::vector<uint8_t> &pixels, uint32_t width, uint32_t height)> &&callback)
+{
+	const api::resource_desc desc = _device->get_resource_desc(resource);
+	const api::format view_format = api::format_to_default_typed(desc.texture.format, 0);
+
+	if (!utils::is_rgba8_conversion_supported(view_format))
+	{
+		LOG(ERROR) << "Screenshots are not supported for format " << static_cast<uint32_t>(desc.texture.format) << '!';
+		return false;
+	}
+
+	texture_readback &readback = _texture_readbacks[_next_texture_readback];
+
+	// All staging textures are in use, so have to wait for the oldest copy to finish before its staging texture can be reused
+	if (readback.callback != nullptr)
+		finish_texture_readback(readback, true);
+
+	// Staging textures are kept around between captures and only recreated when the back buffer dimensions or format changed
+	if (readback.staging == 0 || readback.width != desc.texture.width || readback.height != desc.texture.height || readback.format != view_format)
+	{
+		_device->destroy_resource(readback.staging);
+		readback.staging = {};
+
+		if (!_device->create_resource(api::resource_desc(desc.texture.width, desc.texture.height, 1, 1, view_format, 1, api::memory_heap::gpu_to_cpu, api::resource_usage::copy_dest), nullptr, api::resource_usage::copy_dest, &readback.staging))
+		{
+			LOG(ERROR) << "Failed to create system memory texture for screenshot capture!";
+			return false;
+		}
+
+		_device->set_resource_name(readback.staging, "ReShade screenshot texture");
+
+		readback.format = view_format;
+		readback.width = desc.texture.width;
+		readback.height = desc.texture.height;
+	}
+
+	if (_texture_readback_fence == 0 && !_device->create_fence(0, api::fence_flags::none, &_texture_readback_fence))
+		_texture_readback_fence = {};
+
+	api::command_list *const cmd_list = _graphics_queue->get_immediate_command_list();
+	cmd_list->barrier(resource, state, api::resource_usage::copy_source);
+	cmd_list->copy_texture_region(resource, 0, nullptr, readback.staging, 0, nullptr);
+	cmd_list->barrier(resource, api::resource_usage::copy_source, state);
+
+	readback.callback = std::move(callback);
+	readback.last_used_frame = _frame_count;
+
+	_next_texture_readback = (_next_texture_readback + 1) % std::size(_texture_readbacks);
+
+	if (_texture_readback_fence != 0 && _graphics_queue->signal(_texture_readback_fence, _texture_readback_fence_value + 1))
+	{
+		readback.fence_value = ++_texture_readback_fence_value;
+	}
+	else
+	{
+		// Fall back to waiting for the copy to finish right away if fences are not supported
+		_graphics_queue->wait_idle();
+
+		readback.fence_value = 0;
+		finish_texture_readback(readback, false);
+	}
+
+	return true;
+}
+bool reshade::runtime::finish_texture_readback(texture_readback &readback, bool wait)
+{
+	if (readback.callback == nullptr)
+		return true;
+
+	if (readback.fence_value != 0 && _device->get_completed_fence_value(_texture_readback_fence) < readback.fence_value)
+	{
+		if (!wait)
+			return false;
+
+		if (!_device->wait(_texture_readback_fence, readback.fence_value))
+			_graphics_queue->wait_idle();
+	}
+
+	std::vector<uint8_t> pixels;
+
+	// Copy data from staging texture into output buffer (copy has finished at this point, so mapping does not stall)
+	api::subresource_data mapped_data = {};
+	if (_device->map_texture_region(readback.staging, 0, nullptr, api::map_access::read_only, &mapped_data))
+	{
+		pixels.resize(static_cast<size_t>(readback.width) * static_cast<size_t>(readback.height) * 4);
+		utils::convert_pixels_to_rgba8(readback.format, readback.width, readback.height, mapped_data.data, mapped_data.row_pitch, pixels.data(), readback.width * 4);
+
+		_device->unmap_texture_region(readback.staging, 0);
+	}
+
+	// Encoding and writing the image can take a while, so do that on a separate thread to avoid stalling rendering
+	_worker_threads.emplace_back([callback = std::move(readback.callback), pixels = std::move(pixels), width = readback.width, height = readback.height]() mutable {
+		callback(pixels, width, height);
+	});
+
+	readback.callback = nullptr;
+
+	return true;
+}
+void reshade::runtime::finish_texture_readbacks()
+{
+	// Go through readbacks from oldest to newest, since they were all submitted to the same queue and therefore complete in that order
+	for (size_t i = 0; i < std::size(_texture_readbacks); ++i)
+	{
+		texture_readback &readback = _texture_readbacks[(_next_texture_readback + i) % std::size(_texture_readbacks)];
+
+		if (!finish_texture_readback(readback, false))
+			break;
+
+		// Release staging textures that were not used for a while, so that memory is not held onto forever after a single screenshot
+		if (readback.staging != 0 && (_frame_count - readback.last_used_frame) > 600)
+		{
+			_device->destroy_resource(readback.staging);
+			readback.staging = {};
+		}
+	}
+}
+void reshade::runtime::destroy_texture_readbacks()
+{
+	for (size_t i = 0; i < std::size(_texture_readbacks); ++i)
+	{
+		texture_readback &readback = _texture_readbacks[(_next_texture_readback + i) % std::size(_texture_readbacks)];
+
+		finish_texture_readback(readback, true);
+
+		_device->destroy_resource(readback.staging);
+		readback.staging = {};
+	}
+
+	_next_texture_readback = 0;
+
+	_device->destroy_fence(_texture_readback_fence);
+	_texture_readback_fence = {};
+	_texture_readback_fence_value = 0;
+}
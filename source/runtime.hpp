@@ -7,12 +7,20 @@
 
 #include "reshade_api.hpp"
 #include "state_block.hpp"
+#include "thread_pool.hpp"
+#include "name_index.hpp"
+#include "pipeline_cache_file.hpp"
+#include "timing_export_file.hpp"
+#include "command_list_statistics.hpp"
 #include "imgui_code_editor.hpp"
 #include <chrono>
 #include <memory>
 #include <filesystem>
+#include <deque>
+#include <functional>
 #include <atomic>
 #include <shared_mutex>
+#include <condition_variable>
 
 class ini_file;
 
@@ -183,10 +191,36 @@ namespace reshade
 		bool create_effect(size_t effect_index);
 		bool create_effect_sampler_state(const api::sampler_desc &desc, api::sampler &sampler);
 		void destroy_effect(size_t effect_index);
+		bool is_device_free_threaded() const;
+
+		struct texture_data
+		{
+			std::string unique_name;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t depth = 0;
+			std::shared_ptr<const uint8_t> pixels;
+			size_t pixels_size = 0;
+		};
+		struct texture_load_state
+		{
+			// Set when loading is aborted, so that worker threads stop decoding and exit on their own
+			std::atomic<bool> aborted = false;
+			std::atomic<bool> failed = false;
+			std::atomic<size_t> remaining = 0;
+			std::mutex upload_mutex;
+			std::condition_variable upload_cv;
+			std::deque<texture_data> upload_queue;
+			size_t upload_queue_size = 0;
+		};
 
 		void load_textures();
+		bool upload_textures();
+		void abort_texture_loading();
 		bool create_texture(texture &texture);
 		void destroy_texture(texture &texture);
+		texture *find_texture(const std::string &unique_name);
+		void update_name_lookups();
 
 		void enable_technique(technique &technique);
 		void disable_technique(technique &technique);
@@ -202,9 +236,16 @@ namespace reshade
 		bool save_effect_cache(const std::string &id, const std::string &type, const std::string &data) const;
 		void clear_effect_cache();
 
+		pipeline_cache_file get_pipeline_cache_file() const;
+		void load_pipeline_cache();
+		void save_pipeline_cache();
+
 		bool update_effect_color_and_stencil_tex(uint32_t width, uint32_t height, api::format color_format, api::format stencil_format);
 
 		void update_effects();
+		void update_effect_resolution_scales();
+		bool is_effect_resolution_scalable(size_t effect_index) const;
+		void resample_effect_texture(api::command_list *cmd_list, api::resource source, api::resource_view source_srv, api::resource_usage source_state, api::resource dest, api::resource_view dest_rtv, uint32_t dest_width, uint32_t dest_height);
 		void render_technique(technique &technique, api::command_list *cmd_list, api::resource back_buffer_resource, api::resource_view back_buffer_rtv, api::resource_view back_buffer_rtv_srgb);
 
 		void save_texture(const texture &texture);
@@ -236,6 +277,22 @@ namespace reshade
 
 		bool get_texture_data(api::resource resource, api::resource_usage state, uint8_t *pixels);
 
+		struct texture_readback
+		{
+			api::resource staging = {};
+			api::format format = api::format::unknown;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint64_t fence_value = 0;
+			uint64_t last_used_frame = 0;
+			std::function<void(std::vector<uint8_t> &pixels, uint32_t width, uint32_t height)> callback;
+		};
+
+		bool queue_texture_readback(api::resource resource, api::resource_usage state, std::function<void(std::vector<uint8_t> &pixels, uint32_t width, uint32_t height)> &&callback);
+		bool finish_texture_readback(texture_readback &readback, bool wait);
+		void finish_texture_readbacks();
+		void destroy_texture_readbacks();
+
 		bool execute_screenshot_post_save_command(const std::filesystem::path &screenshot_path, unsigned int screenshot_count);
 
 		api::swapchain *const _swapchain;
@@ -286,6 +343,12 @@ namespace reshade
 		bool _no_reload_on_init = false;
 		bool _performance_mode = false;
 		bool _effect_load_skipping = false;
+		// GPU time budget for all effects in milliseconds, within which the resolution of expensive effects is scaled automatically (zero to disable)
+		float _effect_frame_budget = 0.0f;
+		// CPU time budget in milliseconds for creating effects during a single frame after a reload (at least one effect is always created per frame)
+		float _effect_creation_budget = 16.0f;
+		std::unordered_map<std::string, unsigned int> _effect_resolution_scales;
+		std::chrono::high_resolution_clock::time_point _last_effect_resolution_scale_change;
 		unsigned int _reload_key_data[4] = {};
 		unsigned int _performance_mode_key_data[4] = {};
 
@@ -295,6 +358,8 @@ namespace reshade
 		bool _block_effect_reload_this_frame = false;
 
 		std::filesystem::path _effect_cache_path;
+		// Size of the pipeline cache data when it was last loaded or saved
+		size_t _pipeline_cache_size = 0;
 		std::vector<std::filesystem::path> _effect_search_paths;
 		std::vector<std::filesystem::path> _texture_search_paths;
 
@@ -303,12 +368,19 @@ namespace reshade
 		std::shared_mutex _reload_mutex;
 		std::vector<size_t> _reload_create_queue;
 		std::atomic<size_t> _reload_remaining_effects = std::numeric_limits<size_t>::max();
+		// State shared with the worker threads decoding textures, which only reference it and not the runtime, so that they can be detached when loading is aborted
+		std::shared_ptr<texture_load_state> _texture_load;
+		// Kept alive between reloads, so that creating pipelines does not have to start new threads for every effect
+		thread_pool _pipeline_thread_pool;
 		void *_d3d_compiler_module = nullptr;
 
 		std::vector<effect> _effects;
 		std::vector<texture> _textures;
 		std::vector<technique> _techniques;
 		std::vector<size_t> _technique_sorting;
+		// Indices into the texture and technique lists by name, to avoid linear searches during effect creation and add-on lookups (textures are listed under both their name and unique name)
+		name_index _texture_lookup;
+		name_index _technique_lookup;
 #endif
 		std::vector<std::thread> _worker_threads;
 		std::chrono::high_resolution_clock::time_point _last_reload_time;
@@ -326,8 +398,13 @@ namespace reshade
 		api::format _effect_stencil_format = api::format::unknown;
 		api::resource _effect_stencil_tex = {};
 		api::resource_view _effect_stencil_dsv = {};
+		// Pipeline that resamples between the back buffer and the scaled back buffer of an effect, on APIs that cannot blit
+		api::pipeline _effect_resample_pipeline = {};
+		api::pipeline_layout _effect_resample_pipeline_layout = {};
+		api::sampler _effect_resample_sampler_state = {};
 
 		std::unordered_map<size_t, api::sampler> _effect_sampler_states;
+		std::unordered_map<uint64_t, size_t> _transient_texture_references;
 		std::unordered_map<std::string, std::pair<api::resource_view, api::resource_view>> _texture_semantic_bindings;
 #if RESHADE_ADDON == 1
 		std::unordered_map<std::string, std::pair<api::resource_view, api::resource_view>> _backup_texture_semantic_bindings;
@@ -373,6 +450,11 @@ namespace reshade
 		bool _screenshot_directory_creation_successful = true;
 		std::filesystem::path _last_screenshot_file;
 		std::chrono::high_resolution_clock::time_point _last_screenshot_time;
+
+		texture_readback _texture_readbacks[4];
+		size_t _next_texture_readback = 0;
+		api::fence _texture_readback_fence = {};
+		uint64_t _texture_readback_fence_value = 0;
 		#pragma endregion
 
 		#pragma region Preset Switching
@@ -512,9 +594,16 @@ namespace reshade
 		#pragma region Overlay Statistics
 #if RESHADE_FX
 		bool _gather_gpu_statistics = false;
+		// Timestamps after every pass (rather than only around every technique) are opt-in, since they multiply the number of queries
+		bool _gather_pass_timings = false;
+		// Number of commands recorded while rendering effects, to track the CPU-side cost of effect rendering independent of the GPU
+		command_statistics _effect_command_stats, _last_effect_command_stats;
 		api::resource_view _preview_texture = {};
 		unsigned int _preview_size[3] = { 0, 0, 0xFFFFFFFF };
 		uint64_t _timestamp_frequency = 0;
+		// Timings are written to this file as they are read back, for offline analysis
+		timing_export_file _timing_export_file;
+		int _timing_export_format = 0;
 #endif
 		#pragma endregion
 
@@ -93,11 +93,9 @@ reshade::api::effect_uniform_variable reshade::runtime::find_uniform_variable([[
 		if (effect_name != nullptr && effect.source_file.filename() != effect_name)
 			continue;
 
-		for (const uniform &variable : effect.uniforms)
-		{
-			if (variable.name == variable_name)
-				return { reinterpret_cast<uintptr_t>(&variable) };
-		}
+		if (const size_t uniform_index = effect.uniform_lookup.find(variable_name);
+			uniform_index != name_index::npos)
+			return { reinterpret_cast<uintptr_t>(&effect.uniforms[uniform_index]) };
 
 		if (effect_name != nullptr)
 			break;
@@ -511,20 +509,19 @@ reshade::api::effect_texture_variable reshade::runtime::find_texture_variable([[
 	if (is_loading())
 		return { 0 };
 
-	const std::string_view name(variable_name);
+	const size_t texture_index = _texture_lookup.find(variable_name,
+		[this, effect_name](size_t index) {
+			const texture &variable = _textures[index];
 
-	for (const texture &variable : _textures)
-	{
-		if (effect_name != nullptr &&
-			std::find_if(variable.shared.cbegin(), variable.shared.cend(),
-				[this, effect_name = std::string_view(effect_name)](size_t effect_index) {
-					return _effects[effect_index].source_file.filename() == effect_name;
-				}) == variable.shared.cend())
-			continue;
+			return effect_name == nullptr ||
+				std::find_if(variable.shared.cbegin(), variable.shared.cend(),
+					[this, effect_name = std::string_view(effect_name)](size_t effect_index) {
+						return _effects[effect_index].source_file.filename() == effect_name;
+					}) != variable.shared.cend();
+		});
 
-		if (variable.name == name || variable.unique_name == name)
-			return { reinterpret_cast<uintptr_t>(&variable) };
-	}
+	if (texture_index < _textures.size())
+		return { reinterpret_cast<uintptr_t>(&_textures[texture_index]) };
 #endif
 
 	return { 0 };
@@ -834,14 +831,13 @@ reshade::api::effect_technique reshade::runtime::find_technique([[maybe_unused]]
 	if (is_loading())
 		return { 0 };
 
-	for (const technique &technique : _techniques)
-	{
-		if (effect_name != nullptr && _effects[technique.effect_index].source_file.filename() != effect_name)
-			continue;
+	const size_t technique_index = _technique_lookup.find(technique_name,
+		[this, effect_name](size_t index) {
+			return effect_name == nullptr || _effects[_techniques[index].effect_index].source_file.filename() == effect_name;
+		});
 
-		if (technique.name == technique_name)
-			return { reinterpret_cast<uintptr_t>(&technique) };
-	}
+	if (technique_index < _techniques.size())
+		return { reinterpret_cast<uintptr_t>(&_techniques[technique_index]) };
 #endif
 
 	return { 0 };
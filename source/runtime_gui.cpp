@@ -2116,6 +2116,23 @@ void reshade::runtime::draw_gui_settings()
 			reload_effects(!_effect_load_skipping);
 		}
 
+		if (ImGui::DragFloat(_("Effect frame budget"), &_effect_frame_budget, 0.1f, 0.0f, 100.0f, _effect_frame_budget > 0.0f ? "%.1f ms" : "Off", ImGuiSliderFlags_AlwaysClamp))
+		{
+			modified = true;
+
+			// Restore full resolution of all effects when automatic scaling is disabled
+			if (_effect_frame_budget <= 0.0f && !_effect_resolution_scales.empty())
+			{
+				_effect_resolution_scales.clear();
+				reload_effects();
+			}
+		}
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip(_("When the GPU time of all enabled effects exceeds this budget, the resolution of the most expensive effects is reduced automatically."));
+
+		modified |= ImGui::DragFloat(_("Effect creation budget"), &_effect_creation_budget, 1.0f, 1.0f, 1000.0f, "%.0f ms", ImGuiSliderFlags_AlwaysClamp);
+		ImGui::SetItemTooltip(_("Time spent creating effects per frame after a reload. Higher values load effects in fewer frames, but cause longer stalls."));
+
 		if (ImGui::Button(_("Clear effect cache"), ImVec2(ImGui::CalcItemWidth(), 0)))
 			clear_effect_cache();
 		ImGui::SetItemTooltip(_("Clear effect cache located in \"%s\"."), _effect_cache_path.u8string().c_str());
@@ -2647,12 +2664,94 @@ void reshade::runtime::draw_gui_statistics()
 
 			// GPU timings are not available for all APIs
 			if (_gather_gpu_statistics && tech.average_gpu_duration != 0)
+			{
 				ImGui::Text("%*.3f ms GPU", gpu_digits + 4, tech.average_gpu_duration * 1e-6f);
+
+				if (tech.query_per_pass && ImGui::IsItemHovered())
+				{
+					ImGui::BeginTooltip();
+					for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
+					{
+						const reshadefx::pass_info &pass_info = tech.passes[pass_index];
+						const technique::pass_data &pass_data = tech.passes_data[pass_index];
+
+						if (pass_info.name.empty())
+							ImGui::Text("Pass %zu: %.3f ms CPU | %.3f ms GPU", pass_index, pass_data.average_cpu_duration * 1e-6f, pass_data.average_gpu_duration * 1e-6f);
+						else
+							ImGui::Text("%s: %.3f ms CPU | %.3f ms GPU", pass_info.name.c_str(), pass_data.average_cpu_duration * 1e-6f, pass_data.average_gpu_duration * 1e-6f);
+					}
+					ImGui::EndTooltip();
+				}
+			}
 			else
+			{
 				ImGui::NewLine();
+			}
 		}
 
 		ImGui::EndGroup();
+
+		// Commands recorded for all techniques during the last frame, which make up most of the CPU time of effect rendering
+		const command_statistics &stats = _last_effect_command_stats;
+		ImGui::Spacing();
+		ImGui::Text(_("%u draws/dispatches, %u render passes, %u pipeline binds, %u descriptor table binds"), stats.draws_and_dispatches, stats.render_passes, stats.pipeline_binds, stats.descriptor_table_binds);
+		ImGui::Text(_("%u barriers, %u copies, %u clears, %u push constants, %u mipmap generations"), stats.barriers, stats.copies, stats.clears, stats.push_constants, stats.mipmap_generations);
+
+		// Skipped passes do not record any commands, so evaluate their enable condition the same way as 'render_technique' does instead
+		uint32_t num_skipped_passes = 0;
+		for (const technique &tech : _techniques)
+		{
+			if (!tech.enabled)
+				continue;
+
+			for (const technique::pass_data &pass_data : tech.passes_data)
+			{
+				bool skip_pass = pass_data.always_skipped;
+				if (pass_data.enable_uniform_index < _effects[tech.effect_index].uniforms.size())
+				{
+					bool enabled = true;
+					get_uniform_value(_effects[tech.effect_index].uniforms[pass_data.enable_uniform_index], &enabled);
+					skip_pass = !enabled;
+				}
+
+				num_skipped_passes += skip_pass ? 1 : 0;
+			}
+		}
+		if (num_skipped_passes != 0)
+			ImGui::Text(_("%u passes skipped because their enable condition was false"), num_skipped_passes);
+
+		ImGui::Spacing();
+		// Query heaps are sized for the timestamps of every pass, so they have to be recreated when this changes
+		if (ImGui::Checkbox(_("Measure GPU time of every pass"), &_gather_pass_timings))
+			_should_reload_effect = _effects.size();
+		ImGui::SetItemTooltip(_("Adds a timestamp query after every pass of a technique instead of only around the entire technique.\nChanging this reloads all effects."));
+
+		// Export timings of all techniques (and their passes if measured) as they are read back, so they can be analyzed offline
+		if (!_timing_export_file.is_open())
+		{
+			ImGui::SetNextItemWidth(8.0f * _font_size);
+			ImGui::Combo("##timing_export_format", &_timing_export_format, "CSV\0JSON Lines\0");
+			ImGui::SameLine();
+
+			if (ImGui::Button(_("Start timing export")))
+			{
+				const std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+				struct tm tm; localtime_s(&tm, &t);
+
+				char filename[64];
+				ImFormatString(filename, sizeof(filename), "ReShade_timings_%.4d-%.2d-%.2d_%.2d-%.2d-%.2d.%s",
+					tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, _timing_export_format == 0 ? "csv" : "jsonl");
+
+				const std::filesystem::path export_path = g_reshade_base_path / filename;
+
+				if (!_timing_export_file.open(export_path, _timing_export_format == 0 ? timing_export_file::format::csv : timing_export_file::format::json_lines))
+					LOG(ERROR) << "Failed to open " << export_path << " for timing export!";
+			}
+		}
+		else if (ImGui::Button(_("Stop timing export")))
+		{
+			_timing_export_file.close();
+		}
 	}
 
 	if (ImGui::CollapsingHeader(_("Render Targets & Textures"), ImGuiTreeNodeFlags_DefaultOpen) && !is_loading())
@@ -2676,7 +2775,9 @@ void reshade::runtime::draw_gui_statistics()
 		// Variables used to calculate memory size of textures
 		lldiv_t memory_view;
 		int64_t post_processing_memory_size = 0;
+		int64_t aliased_memory_size = 0;
 		const char *memory_size_unit;
+		std::vector<api::resource> counted_resources;
 
 		for (const texture &tex : _textures)
 		{
@@ -2690,7 +2791,16 @@ void reshade::runtime::draw_gui_statistics()
 			for (uint32_t level = 0, width = tex.width, height = tex.height, depth = tex.depth; level < tex.levels; ++level, width /= 2, height /= 2, depth /= 2)
 				memory_size += static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * pixel_sizes[static_cast<int>(tex.format)];
 
-			post_processing_memory_size += memory_size;
+			// Transient render targets that alias the resource of another texture do not occupy any additional memory
+			if (std::find(counted_resources.cbegin(), counted_resources.cend(), tex.resource) == counted_resources.cend())
+			{
+				post_processing_memory_size += memory_size;
+				counted_resources.push_back(tex.resource);
+			}
+			else
+			{
+				aliased_memory_size += memory_size;
+			}
 
 			if (memory_size >= 1024 * 1024)
 			{
@@ -2704,7 +2814,7 @@ void reshade::runtime::draw_gui_statistics()
 				memory_size_unit = "KiB";
 			}
 
-			ImGui::TextColored(ImVec4(1, 1, 1, 1), "%s%s", tex.unique_name.c_str(), tex.shared.size() > 1 ? " (pooled)" : "");
+			ImGui::TextColored(ImVec4(1, 1, 1, 1), "%s%s", tex.unique_name.c_str(), tex.shared.size() > 1 ? " (pooled)" : tex.transient && _transient_texture_references[tex.resource.handle] > 1 ? " (aliased)" : "");
 			switch (tex.type)
 			{
 			case reshadefx::texture_type::texture_1d:
@@ -2907,6 +3017,23 @@ void reshade::runtime::draw_gui_statistics()
 		}
 
 		ImGui::Text(_("Total memory usage: %lld.%03lld %s"), memory_view.quot, memory_view.rem, memory_size_unit);
+
+		if (aliased_memory_size != 0)
+		{
+			if (aliased_memory_size >= 1024 * 1024)
+			{
+				memory_view = std::lldiv(aliased_memory_size, 1024 * 1024);
+				memory_view.rem /= 1000;
+				memory_size_unit = "MiB";
+			}
+			else
+			{
+				memory_view = std::lldiv(aliased_memory_size, 1024);
+				memory_size_unit = "KiB";
+			}
+
+			ImGui::Text(_("Memory saved by aliasing transient render targets: %lld.%03lld %s"), memory_view.quot, memory_view.rem, memory_size_unit);
+		}
 	}
 #endif
 }
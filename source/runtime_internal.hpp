@@ -6,7 +6,9 @@
 #pragma once
 
 #include "effect_module.hpp"
+#include "effect_pass_barriers.hpp"
 #include "moving_average.hpp"
+#include "name_index.hpp"
 
 namespace reshade
 {
@@ -73,6 +75,8 @@ namespace reshade
 
 		std::vector<size_t> shared;
 		bool loaded = false;
+		// Render target that is cleared before it is read in every technique, so it does not carry data between techniques and may alias the resource of another effect
+		bool transient = false;
 
 		api::resource resource = {};
 		api::resource_view srv[2] = {};
@@ -170,18 +174,33 @@ namespace reshade
 		bool enabled_in_screenshot = true;
 		int64_t time_left = 0;
 
-		struct pass_data
+		struct pass_data : effect_pass_barriers
 		{
 			api::resource_view render_target_views[8] = {};
 			api::pipeline pipeline = {};
 			api::descriptor_table texture_table = {};
 			api::descriptor_table storage_table = {};
-			std::vector<api::resource> modified_resources;
-			std::vector<api::resource_view> generate_mipmap_views;
+			// Index of the uniform variable in the effect that decides whether this pass is executed (see 'EnableIf' pass state), or whether it is never executed because that variable was turned into a specialization constant with a value of zero
+			size_t enable_uniform_index = std::numeric_limits<size_t>::max();
+			bool always_skipped = false;
+			// Constants uploaded in D3D9 before drawing this pass, which are the SEMANTIC_PIXEL_SIZE constants followed by '__TEXEL_SIZE__' in register c255
+			std::vector<float> d3d9_constants;
+
+			moving_average<uint64_t, 60> average_cpu_duration;
+			moving_average<uint64_t, 60> average_gpu_duration;
 		};
 
 		std::vector<pass_data> passes_data;
+
+		// Timestamp queries are written to a ring of slots, each of which holds a timestamp before the first pass and after every pass (or only after the last pass if per-pass timings are disabled) of one frame
+		// The ring grows whenever the GPU is so far behind that no slot has been read back yet, so that results are not dropped on deep-queued GPUs
+		static constexpr uint32_t max_query_ring_depth = 8;
 		uint32_t query_base_index = 0;
+		uint32_t query_ring_depth = 2;
+		bool query_per_pass = false;
+		uint64_t query_slot_frame[max_query_ring_depth] = {}; // One past the frame a slot was written in, or zero if it has no pending results
+		std::vector<uint64_t> query_slot_cpu_durations;
+
 		moving_average<uint64_t, 60> average_cpu_duration;
 		moving_average<uint64_t, 60> average_gpu_duration;
 	};
@@ -203,6 +222,7 @@ namespace reshade
 		std::unordered_map<std::string, std::string> assembly_text;
 
 		std::vector<uniform> uniforms;
+		name_index uniform_lookup;
 		std::vector<uint8_t> uniform_data_storage;
 
 		api::query_heap query_heap = {};
@@ -212,6 +232,17 @@ namespace reshade
 		api::descriptor_table cb_table = {};
 		api::descriptor_table sampler_table = {};
 
+		// Resolution scale in percent and the resulting 'BUFFER_WIDTH' and 'BUFFER_HEIGHT' this effect was compiled with (see 'update_effect_resolution_scales')
+		unsigned int resolution_scale = 100;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		// Scaled stand-ins for the back buffer and the effect color texture, which the technique of a scaled effect renders to and samples from, before the result is upsampled into the back buffer
+		api::resource scaled_back_buffer = {};
+		api::resource_view scaled_back_buffer_rtv[2] = {};
+		api::resource_view scaled_back_buffer_srv = {};
+		api::resource scaled_color_tex = {};
+		api::resource_view scaled_color_srv[2] = {};
+
 		struct binding_data
 		{
 			std::string semantic;
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <mutex>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace reshade
+{
+	/// <summary>
+	/// Set of worker threads that are kept alive between jobs, to avoid the cost of creating threads every time work is spread across them.
+	/// </summary>
+	class thread_pool
+	{
+	public:
+		~thread_pool() { stop(); }
+
+		/// <summary>
+		/// Gets the number of worker threads (not counting the thread calling <see cref="parallel_for"/>, which takes part as well).
+		/// </summary>
+		size_t size() const { return _threads.size(); }
+
+		/// <summary>
+		/// Creates the specified number of worker threads, if the pool does not have any yet.
+		/// </summary>
+		void start(size_t num_threads)
+		{
+			if (!_threads.empty())
+				return;
+
+			_exit = false;
+			for (size_t i = 0; i < num_threads; ++i)
+				_threads.emplace_back(&thread_pool::worker_main, this, _generation);
+		}
+		/// <summary>
+		/// Waits for all worker threads to exit and destroys them.
+		/// </summary>
+		void stop()
+		{
+			if (_threads.empty())
+				return;
+
+			{
+				const std::unique_lock<std::mutex> lock(_mutex);
+				_exit = true;
+			}
+			_condition.notify_all();
+
+			for (std::thread &thread : _threads)
+				thread.join();
+			_threads.clear();
+		}
+
+		/// <summary>
+		/// Calls <paramref name="func"/> for every index in [0, <paramref name="count"/>) on the worker threads and the calling thread, and returns once all calls finished.
+		/// </summary>
+		void parallel_for(size_t count, const std::function<void(size_t)> &func)
+		{
+			if (_threads.empty() || count <= 1)
+			{
+				for (size_t i = 0; i < count; ++i)
+					func(i);
+				return;
+			}
+
+			// Only one job can run at a time
+			const std::unique_lock<std::mutex> job_lock(_job_mutex);
+
+			job new_job;
+			new_job.func = &func;
+			new_job.count = count;
+
+			{
+				const std::unique_lock<std::mutex> lock(_mutex);
+				_job = &new_job;
+				_num_active_threads = _threads.size();
+				_generation++;
+			}
+			_condition.notify_all();
+
+			new_job.run();
+
+			// Every worker thread has to have seen the job before it can be destroyed
+			std::unique_lock<std::mutex> lock(_mutex);
+			_finished_condition.wait(lock, [this]() { return _num_active_threads == 0; });
+			_job = nullptr;
+		}
+
+	private:
+		struct job
+		{
+			const std::function<void(size_t)> *func = nullptr;
+			size_t count = 0;
+			std::atomic<size_t> next_index = 0;
+
+			void run()
+			{
+				for (size_t i; (i = next_index.fetch_add(1, std::memory_order_relaxed)) < count;)
+					(*func)(i);
+			}
+		};
+
+		void worker_main(uint64_t last_generation)
+		{
+			while (true)
+			{
+				job *current_job;
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_condition.wait(lock, [this, last_generation]() { return _exit || _generation != last_generation; });
+					if (_exit)
+						return;
+
+					last_generation = _generation;
+					current_job = _job;
+				}
+
+				current_job->run();
+
+				{
+					const std::unique_lock<std::mutex> lock(_mutex);
+					if (--_num_active_threads == 0)
+						_finished_condition.notify_one();
+				}
+			}
+		}
+
+		std::vector<std::thread> _threads;
+		std::mutex _job_mutex;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		std::condition_variable _finished_condition;
+		job *_job = nullptr;
+		size_t _num_active_threads = 0;
+		uint64_t _generation = 0;
+		bool _exit = false;
+	};
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+#include <condition_variable>
+
+namespace reshade
+{
+	/// <summary>
+	/// File that technique and pass timings are streamed to, for offline analysis.
+	/// Samples are only buffered by the thread adding them, formatting and writing them happens on a worker thread, so that file I/O never stalls rendering.
+	/// </summary>
+	class timing_export_file
+	{
+	public:
+		enum class format
+		{
+			csv,
+			json_lines
+		};
+
+		struct sample
+		{
+			uint64_t frame;
+			std::string technique;
+			// Index of the pass, or negative if this sample covers the entire technique
+			int32_t pass_index;
+			std::string pass_name;
+			uint64_t cpu_duration_ns;
+			uint64_t gpu_duration_ns;
+		};
+
+		~timing_export_file() { close(); }
+
+		bool is_open() const { return _thread.joinable(); }
+
+		/// <summary>
+		/// Creates the file at the specified path and starts the worker thread writing samples to it.
+		/// </summary>
+		bool open(const std::filesystem::path &path, format file_format)
+		{
+			close();
+
+			_file.open(path, std::ios::out | std::ios::trunc);
+			if (!_file)
+				return false;
+
+			_format = file_format;
+			if (_format == format::csv)
+				_file << "frame,technique,pass,pass_name,cpu_ns,gpu_ns\n";
+
+			_exit = false;
+			_thread = std::thread(&timing_export_file::worker_main, this);
+			return true;
+		}
+		/// <summary>
+		/// Writes all remaining samples and closes the file.
+		/// </summary>
+		void close()
+		{
+			if (!_thread.joinable())
+				return;
+
+			{
+				const std::unique_lock<std::mutex> lock(_mutex);
+				_exit = true;
+			}
+			_condition.notify_one();
+
+			_thread.join();
+			_file.close();
+		}
+
+		/// <summary>
+		/// Queues a sample for writing. This only takes a lock that the worker thread holds for the duration of a buffer swap.
+		/// </summary>
+		void append(sample &&sample)
+		{
+			bool notify;
+			{
+				const std::unique_lock<std::mutex> lock(_mutex);
+				_pending.push_back(std::move(sample));
+				notify = _pending.size() == batch_size;
+			}
+			if (notify)
+				_condition.notify_one();
+		}
+
+		static void append_csv_field(std::string &line, std::string_view value)
+		{
+			if (value.find_first_of(",\"\r\n") == std::string_view::npos)
+			{
+				line += value;
+				return;
+			}
+
+			line += '\"';
+			for (const char c : value)
+			{
+				if (c == '\"')
+					line += '\"';
+				line += c;
+			}
+			line += '\"';
+		}
+		static void append_json_string(std::string &line, std::string_view value)
+		{
+			line += '\"';
+			for (const char c : value)
+			{
+				switch (c)
+				{
+				case '\"':
+					line += "\\\"";
+					break;
+				case '\\':
+					line += "\\\\";
+					break;
+				case '\b':
+					line += "\\b";
+					break;
+				case '\f':
+					line += "\\f";
+					break;
+				case '\n':
+					line += "\\n";
+					break;
+				case '\r':
+					line += "\\r";
+					break;
+				case '\t':
+					line += "\\t";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+					{
+						static const char hex_digits[] = "0123456789abcdef";
+						line += "\\u00";
+						line += hex_digits[(c >> 4) & 0xF];
+						line += hex_digits[c & 0xF];
+					}
+					else
+					{
+						line += c;
+					}
+					break;
+				}
+			}
+			line += '\"';
+		}
+
+		static std::string format_sample(const sample &sample, format file_format)
+		{
+			const std::string pass_index = sample.pass_index < 0 ? std::string() : std::to_string(sample.pass_index);
+
+			std::string line;
+			if (file_format == format::csv)
+			{
+				line += std::to_string(sample.frame);
+				line += ',';
+				append_csv_field(line, sample.technique);
+				line += ',';
+				line += pass_index;
+				line += ',';
+				append_csv_field(line, sample.pass_name);
+				line += ',';
+				line += std::to_string(sample.cpu_duration_ns);
+				line += ',';
+				line += std::to_string(sample.gpu_duration_ns);
+			}
+			else
+			{
+				line += "{\"frame\":";
+				line += std::to_string(sample.frame);
+				line += ",\"technique\":";
+				append_json_string(line, sample.technique);
+				line += ",\"pass\":";
+				line += pass_index.empty() ? "null" : pass_index;
+				line += ",\"pass_name\":";
+				append_json_string(line, sample.pass_name);
+				line += ",\"cpu_ns\":";
+				line += std::to_string(sample.cpu_duration_ns);
+				line += ",\"gpu_ns\":";
+				line += std::to_string(sample.gpu_duration_ns);
+				line += '}';
+			}
+			line += '\n';
+			return line;
+		}
+
+	private:
+		static constexpr size_t batch_size = 1024;
+
+		void worker_main()
+		{
+			std::vector<sample> samples;
+			std::string text;
+
+			while (true)
+			{
+				bool exit;
+				{
+					// Wake up regularly even if the batch is not full yet, so that the file follows along while rendering continues
+					std::unique_lock<std::mutex> lock(_mutex);
+					_condition.wait_for(lock, std::chrono::milliseconds(500), [this]() { return _exit || _pending.size() >= batch_size; });
+					exit = _exit;
+					samples.swap(_pending);
+				}
+
+				text.clear();
+				for (const sample &sample : samples)
+					text += format_sample(sample, _format);
+				samples.clear();
+
+				_file.write(text.data(), text.size());
+				_file.flush();
+
+				if (exit)
+					break;
+			}
+		}
+
+		std::ofstream _file;
+		format _format = format::csv;
+		std::thread _thread;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		std::vector<sample> _pending;
+		bool _exit = false;
+	};
+}
@@ -449,6 +449,10 @@ VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, const VkDevi
 	INIT_DISPATCH_PTR(DestroyImageView);
 	INIT_DISPATCH_PTR(CreateShaderModule);
 	INIT_DISPATCH_PTR(DestroyShaderModule);
+	INIT_DISPATCH_PTR(CreatePipelineCache);
+	INIT_DISPATCH_PTR(DestroyPipelineCache);
+	INIT_DISPATCH_PTR(GetPipelineCacheData);
+	INIT_DISPATCH_PTR(MergePipelineCaches);
 	INIT_DISPATCH_PTR(CreateGraphicsPipelines);
 	INIT_DISPATCH_PTR(CreateComputePipelines);
 	INIT_DISPATCH_PTR(DestroyPipeline);
@@ -1744,6 +1748,9 @@ void     VKAPI_CALL vkDestroyImageView(VkDevice device, VkImageView imageView, c
 	device_impl->unregister_object<VK_OBJECT_TYPE_IMAGE_VIEW>(imageView);
 #endif
 
+	// Framebuffers referencing this view become invalid, so remove them from the render pass lookup before the handle can be reused
+	device_impl->destroy_render_passes_with_view(imageView);
+
 	trampoline(device, imageView, pAllocator);
 }
 
@@ -193,17 +193,9 @@ void reshade::vulkan::command_list_impl::begin_render_pass(uint32_t count, const
 		const uint32_t max_attachments = count + 1;
 		VkRenderPassBeginInfo begin_info;
 
-		std::unique_lock<std::shared_mutex> lock(_device_impl->_mutex);
-
-		if (const auto it = _device_impl->_render_pass_lookup.find(hash);
-			it != _device_impl->_render_pass_lookup.end())
-		{
-			begin_info = it->second;
-		}
-		else
+		// Look up existing render pass (only takes a shared lock, so that concurrent recording threads do not block each other)
+		if (!_device_impl->_render_pass_lookup.find(hash, begin_info))
 		{
-			lock.unlock();
-
 			temp_mem<VkImageView, 9> attach_views(max_attachments);
 			temp_mem<VkAttachmentReference, 9> attach_refs(max_attachments);
 			temp_mem<VkAttachmentDescription, 9> attach_descs(max_attachments);
@@ -306,13 +298,16 @@ void reshade::vulkan::command_list_impl::begin_render_pass(uint32_t count, const
 			begin_info.renderArea.extent.width = framebuffer_create_info.width;
 			begin_info.renderArea.extent.height = framebuffer_create_info.height;
 
-			lock.lock();
+			const VkRenderPassBeginInfo created_begin_info = begin_info;
 
-			_device_impl->_render_pass_lookup.emplace(hash, begin_info);
+			if (!_device_impl->_render_pass_lookup.insert(hash, begin_info, attach_views.p, framebuffer_create_info.attachmentCount))
+			{
+				// Another thread created the same render pass in the meantime, so use that one instead (which was stored in 'begin_info')
+				vk.DestroyFramebuffer(_device_impl->_orig, created_begin_info.framebuffer, nullptr);
+				vk.DestroyRenderPass(_device_impl->_orig, created_begin_info.renderPass, nullptr);
+			}
 		}
 
-		lock.unlock();
-
 		temp_mem<VkClearValue, 9> clear_values(max_attachments);
 		for (uint32_t i = 0; i < count; ++i)
 		{
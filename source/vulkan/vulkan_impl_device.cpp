@@ -124,16 +124,26 @@ reshade::vulkan::device_impl::device_impl(
 			LOG(ERROR) << "Failed to create private data slot!";
 		}
 	}
+
+	{	VkPipelineCacheCreateInfo create_info { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+
+		// The cache starts out empty, the runtime seeds it with data from previous runs through 'merge_pipeline_cache_data'
+		if (vk.CreatePipelineCache(_orig, &create_info, nullptr, &_pipeline_cache) != VK_SUCCESS)
+		{
+			LOG(ERROR) << "Failed to create pipeline cache!";
+		}
+	}
 }
 reshade::vulkan::device_impl::~device_impl()
 {
 	assert(_queues.empty()); // All queues should have been unregistered and destroyed at this point
 
-	for (const auto &render_pass_data : _render_pass_lookup)
-	{
-		vk.DestroyRenderPass(_orig, render_pass_data.second.renderPass, nullptr);
-		vk.DestroyFramebuffer(_orig, render_pass_data.second.framebuffer, nullptr);
-	}
+	_render_pass_lookup.clear([this](const VkRenderPassBeginInfo &begin_info) {
+		vk.DestroyRenderPass(_orig, begin_info.renderPass, nullptr);
+		vk.DestroyFramebuffer(_orig, begin_info.framebuffer, nullptr);
+	});
+
+	vk.DestroyPipelineCache(_orig, _pipeline_cache, nullptr);
 
 	vk.DestroyPrivateDataSlot(_orig, _private_data_slot, nullptr);
 
@@ -645,6 +655,9 @@ void reshade::vulkan::device_impl::destroy_resource(api::resource handle)
 
 		if (allocation == VMA_NULL)
 		{
+			if (default_view != VK_NULL_HANDLE)
+				destroy_render_passes_with_view(default_view);
+
 			vk.DestroyImageView(_orig, default_view, nullptr);
 			vk.DestroyImage(_orig, (VkImage)handle.handle, nullptr);
 			vk.FreeMemory(_orig, memory, nullptr);
@@ -822,6 +835,8 @@ void reshade::vulkan::device_impl::destroy_resource_view(api::resource_view hand
 	{
 		unregister_object<VK_OBJECT_TYPE_IMAGE_VIEW>((VkImageView)handle.handle);
 
+		destroy_render_passes_with_view((VkImageView)handle.handle);
+
 		vk.DestroyImageView(_orig, (VkImageView)handle.handle, nullptr);
 	}
 	else if(data->create_info.sType != VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR)
@@ -1449,7 +1464,7 @@ bool reshade::vulkan::device_impl::create_pipeline(api::pipeline_layout layout,
 			create_info.flags |= VK_PIPELINE_CREATE_RAY_TRACING_NO_NULL_INTERSECTION_SHADERS_BIT_KHR;
 
 		if (VkPipeline object = VK_NULL_HANDLE;
-			vk.CreateRayTracingPipelinesKHR(_orig, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &create_info, nullptr, &object) == VK_SUCCESS)
+			vk.CreateRayTracingPipelinesKHR(_orig, VK_NULL_HANDLE, _pipeline_cache, 1, &create_info, nullptr, &object) == VK_SUCCESS)
 		{
 			for (const VkShaderModule shader : shaders)
 				vk.DestroyShaderModule(_orig, shader, nullptr);
@@ -1474,7 +1489,7 @@ bool reshade::vulkan::device_impl::create_pipeline(api::pipeline_layout layout,
 		}
 
 		if (VkPipeline object = VK_NULL_HANDLE;
-			vk.CreateComputePipelines(_orig, VK_NULL_HANDLE, 1, &create_info, nullptr, &object) == VK_SUCCESS)
+			vk.CreateComputePipelines(_orig, _pipeline_cache, 1, &create_info, nullptr, &object) == VK_SUCCESS)
 		{
 			vk.DestroyShaderModule(_orig, create_info.stage.module, nullptr);
 
@@ -1720,7 +1735,7 @@ bool reshade::vulkan::device_impl::create_pipeline(api::pipeline_layout layout,
 		}
 
 		if (VkPipeline object = VK_NULL_HANDLE;
-			vk.CreateGraphicsPipelines(_orig, VK_NULL_HANDLE, 1, &create_info, nullptr, &object) == VK_SUCCESS)
+			vk.CreateGraphicsPipelines(_orig, _pipeline_cache, 1, &create_info, nullptr, &object) == VK_SUCCESS)
 		{
 			if (render_pass != VK_NULL_HANDLE)
 				vk.DestroyRenderPass(_orig, render_pass, nullptr);
@@ -2321,6 +2336,47 @@ bool reshade::vulkan::device_impl::get_pipeline_shader_group_handles(api::pipeli
 	return vk.GetRayTracingShaderGroupHandlesKHR(_orig, (VkPipeline)pipeline.handle, first, count, count * handle_size, groups) == VK_SUCCESS;
 }
 
+bool reshade::vulkan::device_impl::get_pipeline_cache_data(size_t *size, void *data)
+{
+	if (_pipeline_cache == VK_NULL_HANDLE || size == nullptr)
+		return false;
+
+	return vk.GetPipelineCacheData(_orig, _pipeline_cache, size, data) == VK_SUCCESS;
+}
+bool reshade::vulkan::device_impl::merge_pipeline_cache_data(size_t size, const void *data)
+{
+	if (_pipeline_cache == VK_NULL_HANDLE || size == 0 || data == nullptr)
+		return false;
+
+	VkPhysicalDeviceProperties device_props = {};
+	_instance_dispatch_table.GetPhysicalDeviceProperties(_physical_device, &device_props);
+
+	// Some drivers do not validate the cache data properly, so only pass it on if it was created by the same device and driver
+	VkPipelineCacheHeaderVersionOne header = {};
+	if (size >= sizeof(header))
+		std::memcpy(&header, data, sizeof(header));
+	if (header.headerSize < sizeof(header) ||
+		header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+		header.vendorID != device_props.vendorID ||
+		header.deviceID != device_props.deviceID ||
+		std::memcmp(header.pipelineCacheUUID, device_props.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+		return false;
+
+	VkPipelineCacheCreateInfo create_info { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+	create_info.initialDataSize = size;
+	create_info.pInitialData = data;
+
+	VkPipelineCache source_cache = VK_NULL_HANDLE;
+	if (vk.CreatePipelineCache(_orig, &create_info, nullptr, &source_cache) != VK_SUCCESS)
+		return false;
+
+	const bool result = vk.MergePipelineCaches(_orig, _pipeline_cache, 1, &source_cache) == VK_SUCCESS;
+
+	vk.DestroyPipelineCache(_orig, source_cache, nullptr);
+
+	return result;
+}
+
 void reshade::vulkan::device_impl::advance_transient_descriptor_pool()
 {
 	if (_push_descriptor_ext)
@@ -2331,6 +2387,14 @@ void reshade::vulkan::device_impl::advance_transient_descriptor_pool()
 	vk.ResetDescriptorPool(_orig, next_pool, 0);
 }
 
+void reshade::vulkan::device_impl::destroy_render_passes_with_view(VkImageView view)
+{
+	_render_pass_lookup.erase_with_view(view, [this](const VkRenderPassBeginInfo &begin_info) {
+		vk.DestroyFramebuffer(_orig, begin_info.framebuffer, nullptr);
+		vk.DestroyRenderPass(_orig, begin_info.renderPass, nullptr);
+	});
+}
+
 reshade::vulkan::command_list_immediate_impl *reshade::vulkan::device_impl::get_first_immediate_command_list()
 {
 	assert(!_queues.empty());
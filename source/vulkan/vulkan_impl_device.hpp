@@ -12,6 +12,7 @@
 #include <vk_layer_dispatch_table.h>
 
 #include "reshade_api_object_impl.hpp"
+#include "render_pass_cache.hpp"
 #include <shared_mutex>
 #include <unordered_map>
 
@@ -106,8 +107,13 @@ namespace reshade::vulkan
 
 		bool get_pipeline_shader_group_handles(api::pipeline pipeline, uint32_t first, uint32_t count, void *groups) final;
 
+		bool get_pipeline_cache_data(size_t *size, void *data) final;
+		bool merge_pipeline_cache_data(size_t size, const void *data) final;
+
 		void advance_transient_descriptor_pool();
 
+		void destroy_render_passes_with_view(VkImageView view);
+
 		command_list_immediate_impl *get_first_immediate_command_list();
 
 		template <VkObjectType type, typename... Args>
@@ -175,7 +181,11 @@ namespace reshade::vulkan
 
 		VkPrivateDataSlot _private_data_slot = VK_NULL_HANDLE;
 
+		VkPipelineCache _pipeline_cache = VK_NULL_HANDLE;
+
 		std::shared_mutex _mutex;
-		std::unordered_map<size_t, VkRenderPassBeginInfo> _render_pass_lookup;
+
+		// Has its own lock, so that render pass lookups do not contend with descriptor pool allocations
+		render_pass_cache<VkImageView, VkRenderPassBeginInfo, 9> _render_pass_lookup;
 	};
 }
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "addon_event_callbacks.hpp"
+#include <thread>
+
+using namespace reshade;
+
+static volatile uint32_t s_num_calls = 0;
+
+static void trivial_callback(uint32_t value)
+{
+	s_num_calls = s_num_calls + value;
+}
+static bool handling_callback(uint32_t)
+{
+	return true;
+}
+
+static void invoke_event(addon_event_callbacks &callbacks, uint32_t value)
+{
+	callbacks.invoke([value](void *cb) {
+		reinterpret_cast<decltype(&trivial_callback)>(cb)(value);
+		return false;
+	});
+}
+
+int main()
+{
+	// Callbacks are invoked in registration order, stopping at the first one that handled the event
+	{
+		addon_event_callbacks callbacks;
+		CHECK(!callbacks.invoke([](void *) { return true; }));
+
+		callbacks.update(reinterpret_cast<void *>(&trivial_callback), true);
+		callbacks.update(reinterpret_cast<void *>(&handling_callback), true);
+		callbacks.update(reinterpret_cast<void *>(&trivial_callback), true);
+		CHECK(callbacks.count == 3);
+
+		uint32_t num_invoked = 0;
+		CHECK(callbacks.invoke([&num_invoked](void *cb) {
+			num_invoked++;
+			return cb == reinterpret_cast<void *>(&handling_callback);
+		}));
+		CHECK(num_invoked == 2);
+
+		callbacks.update(reinterpret_cast<void *>(&trivial_callback), false);
+		callbacks.update(reinterpret_cast<void *>(&handling_callback), false);
+		CHECK(callbacks.count == 0 && callbacks.list.load() == nullptr);
+	}
+
+	// Replaced callback arrays are kept while the same event is being invoked, but not held back by invocations of other events
+	{
+		addon_event_callbacks callbacks_a, callbacks_b;
+		callbacks_a.update(reinterpret_cast<void *>(&trivial_callback), true);
+		callbacks_b.update(reinterpret_cast<void *>(&trivial_callback), true);
+
+		{
+			const reader_tracker::scope reader(callbacks_a.readers);
+			callbacks_a.update(reinterpret_cast<void *>(&handling_callback), true);
+			callbacks_b.update(reinterpret_cast<void *>(&handling_callback), true);
+			CHECK(callbacks_a.num_retired() == 1);
+			CHECK(callbacks_b.num_retired() == 0);
+		}
+
+		// Reader on another thread, which has a different counter than this one
+		std::atomic<bool> reading = false, done = false;
+		std::thread reader_thread([&]() {
+			const reader_tracker::scope reader(callbacks_b.readers);
+			reading = true;
+			while (!done)
+				std::this_thread::yield();
+		});
+		while (!reading)
+			std::this_thread::yield();
+		callbacks_a.update(reinterpret_cast<void *>(&handling_callback), false);
+		CHECK(callbacks_a.num_retired() == 0);
+		callbacks_b.update(reinterpret_cast<void *>(&handling_callback), false);
+		CHECK(callbacks_b.num_retired() == 1);
+		done = true;
+		reader_thread.join();
+
+		callbacks_b.reclaim();
+		CHECK(callbacks_b.num_retired() == 0);
+
+		{
+			const reader_tracker::scope reader(callbacks_a.readers);
+			callbacks_a.update(reinterpret_cast<void *>(&trivial_callback), false);
+			callbacks_a.reclaim(true);
+			CHECK(callbacks_a.num_retired() == 0);
+		}
+	}
+
+	const unsigned int iterations = 100;
+	constexpr uint32_t num_invocations = 100000;
+
+	// Cost of dispatching an event to the registered callbacks, which happens for every API call the runtime intercepts
+	for (const uint32_t num_listeners : { 0u, 1u, 4u, 16u })
+	{
+		addon_event_callbacks callbacks;
+		for (uint32_t i = 0; i < num_listeners; ++i)
+			callbacks.update(reinterpret_cast<void *>(&trivial_callback), true);
+		CHECK(callbacks.count == num_listeners);
+
+		s_num_calls = 0;
+		char name[64];
+		std::snprintf(name, sizeof(name), "dispatch to %u listeners (x%u)", num_listeners, num_invocations);
+		testing::benchmark(name, iterations, [&callbacks]() {
+			for (uint32_t i = 0; i < num_invocations; ++i)
+				invoke_event(callbacks, 1);
+		});
+		CHECK(s_num_calls % num_invocations == 0 && (num_listeners == 0) == (s_num_calls == 0));
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "cube_lut.hpp"
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <cstring>
+
+static std::string generate_cube_lut(int size)
+{
+	std::string text = "TITLE \"Synthetic\"\n# Generated for benchmarking\nLUT_3D_SIZE " + std::to_string(size) + "\nDOMAIN_MIN 0.0 0.0 0.0\nDOMAIN_MAX 1.0 1.0 1.0\n";
+	text.reserve(text.size() + static_cast<size_t>(size) * size * size * 28);
+
+	char line[64];
+	for (int b = 0; b < size; ++b)
+		for (int g = 0; g < size; ++g)
+			for (int r = 0; r < size; ++r)
+			{
+				// Apply a slight curve, so that values have varying numbers of significant digits like real grading tables do
+				const float x = std::pow(r / float(size - 1), 0.9f), y = std::pow(g / float(size - 1), 1.1f), z = b / float(size - 1);
+				text.append(line, std::snprintf(line, sizeof(line), "%.6f %.6f %.6f\n", x, y, z));
+			}
+	return text;
+}
+
+// Previous implementation, which read the file line by line and parsed each component with 'std::strtod'
+static float *load_cube_lut_reference(const std::string &text, int &width, int &height, int &depth)
+{
+	std::istringstream file(text);
+	float *pixels = nullptr;
+	float domain_min[3] = { 0.0f, 0.0f, 0.0f };
+	float domain_max[3] = { 1.0f, 1.0f, 1.0f };
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#' || line.rfind("TITLE", 0) == 0)
+			continue;
+		char *p = line.data();
+		if (line.rfind("DOMAIN_MIN", 0) == 0 || line.rfind("DOMAIN_MAX", 0) == 0)
+		{
+			float *const domain = line[8] == 'A' ? domain_max : domain_min;
+			p += 10;
+			for (int c = 0; c < 3; ++c)
+				domain[c] = static_cast<float>(std::strtod(p, &p));
+			continue;
+		}
+		if (line.rfind("LUT_3D_SIZE", 0) == 0)
+		{
+			width = height = depth = std::strtol(p + 11, nullptr, 10);
+			pixels = static_cast<float *>(std::malloc(static_cast<size_t>(width) * height * depth * 4 * sizeof(float)));
+			continue;
+		}
+		file.seekg(-static_cast<std::streamoff>(line.size() + 1), std::ios::cur);
+		break;
+	}
+
+	if (pixels != nullptr)
+	{
+		size_t index = 0;
+		while (std::getline(file, line) && (index + 4) <= (static_cast<size_t>(width) * height * depth * 4))
+		{
+			if (line.empty() || line[0] == '#')
+				continue;
+			char *p = line.data();
+			for (int c = 0; c < 3; ++c)
+				pixels[index++] = static_cast<float>(std::strtod(p, &p)) * (domain_max[c] - domain_min[c]) + domain_min[c];
+			pixels[index++] = 1.0f;
+		}
+	}
+
+	return pixels;
+}
+
+int main()
+{
+	for (const int size : { 33, 65 })
+	{
+		const std::string text = generate_cube_lut(size);
+		const size_t num_values = static_cast<size_t>(size) * size * size * 4;
+
+		int width = 0, height = 0, depth = 0;
+
+		// Verify that the new parser produces the same table as the reference implementation
+		float *const reference = load_cube_lut_reference(text, width, height, depth);
+		CHECK(reference != nullptr && width == size && height == size && depth == size);
+
+		void *const pixels_32f = reshade::utils::load_cube_lut(text.data(), text.size(), reshadefx::texture_format::rgba32f, width, height, depth);
+		CHECK(pixels_32f != nullptr && width == size && height == size && depth == size);
+		if (reference != nullptr && pixels_32f != nullptr)
+			CHECK(std::memcmp(reference, pixels_32f, num_values * sizeof(float)) == 0);
+
+		void *const pixels_16f = reshade::utils::load_cube_lut(text.data(), text.size(), reshadefx::texture_format::rgba16f, width, height, depth);
+		CHECK(pixels_16f != nullptr);
+		if (pixels_16f != nullptr)
+		{
+			// Last entry is (1, 1, 1, 1), which is 0x3C00 in half precision
+			const uint16_t *const last = static_cast<const uint16_t *>(pixels_16f) + num_values - 4;
+			CHECK(last[0] == 0x3C00 && last[1] == 0x3C00 && last[2] == 0x3C00 && last[3] == 0x3C00);
+			CHECK(static_cast<const uint16_t *>(pixels_16f)[0] == 0);
+		}
+
+		std::free(reference);
+		std::free(pixels_32f);
+		std::free(pixels_16f);
+
+		const unsigned int iterations = size > 33 ? 10 : 50;
+		const std::string suffix = std::to_string(size) + "^3";
+
+		reshade::testing::benchmark(("getline + strtod (reference) " + suffix).c_str(), iterations, [&]() {
+			std::free(load_cube_lut_reference(text, width, height, depth));
+		});
+		reshade::testing::benchmark(("load_cube_lut rgba32f " + suffix).c_str(), iterations, [&]() {
+			std::free(reshade::utils::load_cube_lut(text.data(), text.size(), reshadefx::texture_format::rgba32f, width, height, depth));
+		});
+		reshade::testing::benchmark(("load_cube_lut rgba16f " + suffix).c_str(), iterations, [&]() {
+			std::free(reshade::utils::load_cube_lut(text.data(), text.size(), reshadefx::texture_format::rgba16f, width, height, depth));
+		});
+	}
+
+	return TEST_RESULT();
+}
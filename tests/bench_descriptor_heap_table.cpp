@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstddef>
+#include "testing.hpp"
+#include "descriptor_heap_table.hpp"
+#include <random>
+#include <thread>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace reshade::api;
+
+// Size of a typical shader-visible D3D12 descriptor heap
+static constexpr uint32_t heap_size = 1000000;
+static constexpr uint32_t num_threads = 4;
+static constexpr uint32_t updates_per_thread = 20000;
+static constexpr uint32_t descriptors_per_update = 8;
+static constexpr uint32_t lookups_per_update = 4;
+
+// Stand-in for the previous implementation, which stored every descriptor as a separate element of a concurrent hash map
+class descriptor_heap_reference
+{
+public:
+	void store(uint32_t offset, descriptor_type type, sampler sampler, resource_view view)
+	{
+		const std::unique_lock<std::shared_mutex> lock(_mutex);
+		_descriptors[offset] = { type, sampler, view };
+	}
+	resource_view load_view(uint32_t offset) const
+	{
+		const std::shared_lock<std::shared_mutex> lock(_mutex);
+		if (const auto it = _descriptors.find(offset); it != _descriptors.end() && it->second.type == descriptor_type::shader_resource_view)
+			return it->second.view;
+		return { 0 };
+	}
+
+private:
+	struct descriptor
+	{
+		descriptor_type type;
+		reshade::api::sampler sampler;
+		resource_view view;
+	};
+
+	mutable std::shared_mutex _mutex;
+	std::unordered_map<uint32_t, descriptor> _descriptors;
+};
+
+template <typename F>
+static void run_churn(F &&func)
+{
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < num_threads; ++t)
+		threads.emplace_back([t, &func]() {
+			std::mt19937 rng(t);
+			for (uint32_t i = 0; i < updates_per_thread; ++i)
+				func(rng);
+		});
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+int main()
+{
+	// Stored descriptors can be found again and runs are valid until the end of a page
+	{
+		descriptor_heap_table table;
+		CHECK(table.find(0) == nullptr);
+
+		for (uint32_t offset = 0; offset < 5000; offset += 7)
+			table.get_or_create(offset)->store(descriptor_type::shader_resource_view, { 0 }, { 0x1000 + offset });
+		table.get_or_create(heap_size - 1)->store(descriptor_type::sampler, { 42 }, { 0 });
+
+		bool all_found = true;
+		for (uint32_t offset = 0; offset < 5000; offset += 7)
+			all_found = all_found && table.find(offset) != nullptr && table.find(offset)->load_type() == descriptor_type::shader_resource_view && table.find(offset)->load_view().handle == 0x1000 + offset;
+		CHECK(all_found);
+		CHECK(table.find(heap_size - 1) != nullptr && table.find(heap_size - 1)->load_sampler().handle == 42);
+		CHECK(table.find(1) != nullptr && table.find(1)->load_view().handle == 0);
+		CHECK(table.find(heap_size - 1 - descriptor_heap_table::page_size) == nullptr);
+
+		const descriptor_heap_table::slot *const run = table.find(descriptor_heap_table::page_size);
+		CHECK(run != nullptr && run[7 - descriptor_heap_table::page_size % 7].load_view().handle == 0x1000 + descriptor_heap_table::page_size + 7 - descriptor_heap_table::page_size % 7);
+	}
+
+	// Concurrent updates and lookups of the same descriptors (run with ThreadSanitizer to check for data races)
+	{
+		descriptor_heap_table table;
+		run_churn([&table](std::mt19937 &rng) {
+			const uint32_t offset = rng() % 4096;
+			table.get_or_create(offset)->store(descriptor_type::shader_resource_view, { 0 }, { offset + 1 });
+			if (const descriptor_heap_table::slot *const descriptor = table.find(rng() % 4096))
+				CHECK(descriptor->load_view().handle == 0 || descriptor->load_view().handle <= 4096);
+		});
+	}
+
+	// Applications that rewrite descriptor tables every frame (e.g. D3D12 games with a ring buffer of descriptors) update and query many descriptors from several threads at once
+	reshade::testing::benchmark("descriptor churn reference (hash map)", 5, []() {
+		descriptor_heap_reference heap;
+		run_churn([&heap](std::mt19937 &rng) {
+			const uint32_t offset = rng() % (heap_size - descriptors_per_update);
+			for (uint32_t j = 0; j < descriptors_per_update; ++j)
+				heap.store(offset + j, descriptor_type::shader_resource_view, { 0 }, { offset + j + 1 });
+			for (uint32_t j = 0; j < lookups_per_update; ++j)
+				heap.load_view(rng() % heap_size);
+		});
+	});
+	reshade::testing::benchmark("descriptor churn paged table", 5, []() {
+		descriptor_heap_table table;
+		run_churn([&table](std::mt19937 &rng) {
+			const uint32_t offset = rng() % (heap_size - descriptors_per_update);
+			for (uint32_t j = 0; j < descriptors_per_update; ++j)
+				table.get_or_create(offset + j)->store(descriptor_type::shader_resource_view, { 0 }, { offset + j + 1 });
+			for (uint32_t j = 0; j < lookups_per_update; ++j)
+				if (const descriptor_heap_table::slot *const descriptor = table.find(rng() % heap_size))
+					descriptor->load_view();
+		});
+	});
+
+	return TEST_RESULT();
+}
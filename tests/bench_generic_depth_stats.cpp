@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstddef>
+#include "testing.hpp"
+#include "generic_depth_stats.hpp"
+#include <random>
+
+using namespace reshade::api;
+
+// Previous implementation, which searched the target list for every source entry
+static void merge_reference(std::vector<std::pair<resource, depth_stencil_frame_stats>> &target, const std::vector<std::pair<resource, depth_stencil_frame_stats>> &source)
+{
+	for (const auto &[depth_stencil_handle, source_counters] : source)
+	{
+		auto it = std::find_if(target.begin(), target.end(), [depth_stencil_handle = depth_stencil_handle](const auto &entry) { return entry.first == depth_stencil_handle; });
+		if (it == target.end())
+			it = target.emplace(target.end(), depth_stencil_handle, depth_stencil_frame_stats {});
+		it->second.merge(source_counters);
+	}
+}
+
+static depth_stencil_frame_stats make_stats(uint32_t seed)
+{
+	depth_stencil_frame_stats stats;
+	stats.total_stats.vertices = seed * 3;
+	stats.total_stats.drawcalls = seed;
+	stats.current_stats.vertices = seed * 2;
+	stats.current_stats.drawcalls = seed / 2;
+	stats.current_stats.drawcalls_indirect = seed % 3;
+	if (seed % 4 == 0)
+		stats.clears.push_back({});
+	stats.copied_during_frame = seed % 5 == 0;
+	return stats;
+}
+
+static bool equals(const depth_stencil_frame_stats &lhs, const depth_stencil_frame_stats &rhs)
+{
+	return
+		lhs.total_stats.vertices == rhs.total_stats.vertices &&
+		lhs.total_stats.drawcalls == rhs.total_stats.drawcalls &&
+		lhs.total_stats.drawcalls_indirect == rhs.total_stats.drawcalls_indirect &&
+		lhs.current_stats.vertices == rhs.current_stats.vertices &&
+		lhs.current_stats.drawcalls == rhs.current_stats.drawcalls &&
+		lhs.current_stats.drawcalls_indirect == rhs.current_stats.drawcalls_indirect &&
+		lhs.clears.size() == rhs.clears.size() &&
+		lhs.copied_during_frame == rhs.copied_during_frame;
+}
+
+int main()
+{
+	std::mt19937 rng(42);
+
+	// Randomized merges produce the same statistics as the previous implementation
+	{
+		depth_stencil_stats_list target;
+		std::vector<std::pair<resource, depth_stencil_frame_stats>> target_reference;
+
+		for (int round = 0; round < 200; ++round)
+		{
+			depth_stencil_stats_list source;
+			std::vector<std::pair<resource, depth_stencil_frame_stats>> source_reference;
+
+			const uint32_t num_entries = rng() % 12;
+			for (uint32_t i = 0; i < num_entries; ++i)
+			{
+				const resource depth_stencil = { 0x1000 + (rng() % 32) * 0x40 };
+				const depth_stencil_frame_stats stats = make_stats(rng() % 1000);
+
+				source[source.find_or_add(depth_stencil)].merge(stats);
+				auto it = std::find_if(source_reference.begin(), source_reference.end(), [depth_stencil](const auto &entry) { return entry.first == depth_stencil; });
+				if (it == source_reference.end())
+					it = source_reference.emplace(source_reference.end(), depth_stencil, depth_stencil_frame_stats {});
+				it->second.merge(stats);
+			}
+
+			target.merge(source);
+			merge_reference(target_reference, source_reference);
+
+			bool all_equal = target.size() == target_reference.size();
+			for (const auto &[depth_stencil, stats] : target_reference)
+				all_equal = all_equal && target.find(depth_stencil) != nullptr && equals(*target.find(depth_stencil), stats);
+			CHECK(all_equal);
+			CHECK(std::is_sorted(target.begin(), target.end(), [](const auto &lhs, const auto &rhs) { return lhs.first.handle < rhs.first.handle; }));
+		}
+
+		CHECK(target.find({ 0x1 }) == nullptr);
+	}
+
+	// Merging command lists that used many depth-stencils into a queue list (e.g. a frame with lots of shadow map cascades and render target atlases)
+	for (const size_t num_depth_stencils : { 8, 64, 512 })
+	{
+		std::vector<resource> handles(num_depth_stencils);
+		for (size_t i = 0; i < num_depth_stencils; ++i)
+			handles[i] = { 0x10000000 + i * 0x80 };
+		std::shuffle(handles.begin(), handles.end(), rng);
+
+		depth_stencil_stats_list source;
+		std::vector<std::pair<resource, depth_stencil_frame_stats>> source_reference;
+		for (size_t i = 0; i < num_depth_stencils; ++i)
+		{
+			source[source.find_or_add(handles[i])] = make_stats(static_cast<uint32_t>(i));
+			source_reference.emplace_back(handles[i], make_stats(static_cast<uint32_t>(i)));
+		}
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "merge reference (%zu depth-stencils)", num_depth_stencils);
+		reshade::testing::benchmark(name, 2000, [&]() {
+			std::vector<std::pair<resource, depth_stencil_frame_stats>> target;
+			target.reserve(16);
+			for (int i = 0; i < 4; ++i)
+				merge_reference(target, source_reference);
+			CHECK(target.size() == num_depth_stencils);
+		});
+		std::snprintf(name, sizeof(name), "merge sorted (%zu depth-stencils)", num_depth_stencils);
+		reshade::testing::benchmark(name, 2000, [&]() {
+			depth_stencil_stats_list target;
+			target.reserve(16);
+			for (int i = 0; i < 4; ++i)
+				target.merge(source);
+			CHECK(target.size() == num_depth_stencils);
+		});
+	}
+
+	return TEST_RESULT();
+}
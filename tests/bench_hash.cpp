@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "crc32_hash.hpp"
+#include "reshade_xxhash64.hpp"
+#include <vector>
+
+using namespace reshade;
+
+// Roughly the size of a large compressed texture or a big shader library
+static constexpr size_t buffer_size = 16 * 1024 * 1024;
+
+// Previous implementation, which processed a single byte per iteration
+static uint32_t compute_crc32_bytewise(const uint8_t *data, size_t size)
+{
+	const auto &table = crc32_internal::tables.table[0];
+
+	uint32_t crc = 0xFFFFFFFF;
+	for (; size != 0; --size, ++data)
+		crc = (crc >> 8) ^ table[(crc ^ (*data)) & 0xFF];
+	return ~crc;
+}
+
+static void print_throughput(double ns_per_iteration)
+{
+	std::printf("%-48s %14.1f MB/s\n", "", (buffer_size / (1024.0 * 1024.0)) / (ns_per_iteration / 1000000000.0));
+}
+
+int main()
+{
+	std::vector<uint8_t> buffer(buffer_size);
+	for (size_t i = 0; i < buffer.size(); ++i)
+		buffer[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+
+	// Slicing-by-8 has to produce the same values as the byte-wise algorithm, so that existing dumps keep matching
+	{
+		const uint8_t check_string[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+		CHECK(compute_crc32(check_string, sizeof(check_string)) == 0xCBF43926);
+
+		bool all_match = true;
+		for (size_t size = 0; size < 64; ++size)
+			all_match = all_match && compute_crc32(buffer.data() + 1, size) == compute_crc32_bytewise(buffer.data() + 1, size);
+		CHECK(all_match);
+		CHECK(compute_crc32(buffer.data(), buffer.size()) == compute_crc32_bytewise(buffer.data(), buffer.size()));
+	}
+
+	const unsigned int iterations = 20;
+	volatile uint64_t sink = 0;
+
+	print_throughput(testing::benchmark("CRC32 byte-wise (16 MiB)", iterations, [&]() {
+		sink = sink + compute_crc32_bytewise(buffer.data(), buffer.size());
+	}));
+	print_throughput(testing::benchmark("CRC32 slicing-by-8 (16 MiB)", iterations, [&]() {
+		sink = sink + compute_crc32(buffer.data(), buffer.size());
+	}));
+	print_throughput(testing::benchmark("XXH64 (16 MiB)", iterations, [&]() {
+		sink = sink + compute_xxhash64(buffer.data(), buffer.size());
+	}));
+
+	return TEST_RESULT();
+}
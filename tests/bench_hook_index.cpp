@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "hook_index.hpp"
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <shared_mutex>
+#include <condition_variable>
+
+using namespace reshade;
+
+// Roughly the number of hooks installed when an OpenGL application is hooked
+static constexpr size_t num_hooks = 3000;
+
+static hook::address make_address(uintptr_t value)
+{
+	return reinterpret_cast<hook::address>(value);
+}
+
+int main()
+{
+	// Mix of function hooks (aligned function addresses) and virtual function table hooks (neighboring table entries)
+	std::vector<hook> hooks(num_hooks);
+	for (size_t i = 0; i < num_hooks; ++i)
+	{
+		hooks[i].target = make_address(i % 2 ? 0x7FF800000000 + i * 16 : 0x10000000 + i * sizeof(void *));
+		hooks[i].trampoline = make_address(0x20000000 + i * 64);
+		hooks[i].replacement = make_address(0x180000000 + i * 32);
+	}
+
+	published_hook_index published;
+
+	// Lookups by target, by replacement and by both return the right hook
+	{
+		published.publish(std::make_unique<hook_index>(hooks));
+		const published_hook_index::read_guard guard = published.read();
+		const hook_index *const index = guard.get();
+		CHECK(index != nullptr && index->size() == num_hooks);
+
+		bool all_found = true;
+		for (const hook &hook : hooks)
+		{
+			all_found = all_found && index->find(nullptr, hook.replacement) != nullptr && index->find(nullptr, hook.replacement)->trampoline == hook.trampoline;
+			all_found = all_found && index->find(hook.target, nullptr) != nullptr && index->find(hook.target, nullptr)->trampoline == hook.trampoline;
+			all_found = all_found && index->find(hook.target, hook.replacement) != nullptr && index->find(hook.target, hook.replacement)->trampoline == hook.trampoline;
+		}
+		CHECK(all_found);
+		CHECK(index->find(nullptr, make_address(0x1234)) == nullptr);
+		CHECK(index->find(hooks[0].target, hooks[1].replacement) == nullptr);
+	}
+
+	// Superseded snapshots are kept alive while a reader may still be using them and destroyed on the next publish once it finished
+	{
+		std::vector<hook> second_hooks(hooks.begin(), hooks.begin() + 10);
+
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool reading = false, done = false;
+		std::thread reader([&]() {
+			const published_hook_index::read_guard guard = published.read();
+			std::unique_lock<std::mutex> lock(mutex);
+			reading = true;
+			cv.notify_all();
+			cv.wait(lock, [&]() { return done; });
+			// The snapshot must still be valid here, even though two newer ones were published in the meantime
+			CHECK(guard.get()->size() == num_hooks && guard.get()->find(nullptr, hooks.back().replacement) != nullptr);
+		});
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [&]() { return reading; });
+		}
+
+		published.publish(std::make_unique<hook_index>(second_hooks));
+		published.publish(std::make_unique<hook_index>(second_hooks));
+		CHECK(published.num_retired() == 2);
+
+		{
+			const std::unique_lock<std::mutex> lock(mutex);
+			done = true;
+		}
+		cv.notify_all();
+		reader.join();
+
+		published.publish(std::make_unique<hook_index>(hooks));
+		CHECK(published.num_retired() == 0);
+	}
+
+	const unsigned int iterations = 200;
+	volatile uintptr_t sink = 0;
+
+	// Previous implementation, which searched the whole hook list under a shared lock
+	std::shared_mutex hooks_mutex;
+	testing::benchmark("linear search under shared lock (x3000)", iterations, [&]() {
+		for (const hook &lookup : hooks)
+		{
+			const std::shared_lock<std::shared_mutex> lock(hooks_mutex);
+			const auto it = std::find_if(hooks.cbegin(), hooks.cend(), [&lookup](const hook &hook) { return hook.replacement == lookup.replacement; });
+			sink = sink + reinterpret_cast<uintptr_t>(it->trampoline);
+		}
+	});
+
+	testing::benchmark("published index by replacement (x3000)", iterations, [&]() {
+		for (const hook &lookup : hooks)
+		{
+			const published_hook_index::read_guard guard = published.read();
+			sink = sink + reinterpret_cast<uintptr_t>(guard.get()->find(nullptr, lookup.replacement)->trampoline);
+		}
+	});
+	testing::benchmark("published index by target (x3000)", iterations, [&]() {
+		for (const hook &lookup : hooks)
+		{
+			const published_hook_index::read_guard guard = published.read();
+			sink = sink + reinterpret_cast<uintptr_t>(guard.get()->find(lookup.target, nullptr)->trampoline);
+		}
+	});
+
+	testing::benchmark("build and publish index", 20, [&]() {
+		published.publish(std::make_unique<hook_index>(hooks));
+	});
+	CHECK(published.num_retired() == 0);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "name_index.hpp"
+#include <vector>
+#include <algorithm>
+
+using namespace reshade;
+
+// Roughly the number of textures and techniques with a large effect collection loaded
+static constexpr size_t num_effects = 200;
+static constexpr size_t num_textures_per_effect = 12;
+static constexpr size_t num_techniques_per_effect = 2;
+
+struct named_item
+{
+	std::string name;
+	std::string unique_name;
+	size_t effect_index;
+};
+
+static size_t linear_find(const std::vector<named_item> &items, const std::string &name, size_t effect_index = name_index::npos)
+{
+	const auto it = std::find_if(items.cbegin(), items.cend(),
+		[&name, effect_index](const named_item &item) {
+			return (item.name == name || item.unique_name == name) && (effect_index == name_index::npos || item.effect_index == effect_index);
+		});
+	return it != items.cend() ? std::distance(items.cbegin(), it) : name_index::npos;
+}
+
+int main()
+{
+	// Textures are declared in a namespace per effect, but most effects also declare a few with common names (like the back buffer reference)
+	std::vector<named_item> textures;
+	for (size_t effect_index = 0; effect_index < num_effects; ++effect_index)
+	{
+		for (size_t i = 0; i < num_textures_per_effect; ++i)
+		{
+			std::string name = i < 2 ? "BackBufferTex" + std::to_string(i) : "Tex" + std::to_string(i);
+			std::string unique_name = "Effect" + std::to_string(effect_index) + "::" + name;
+			textures.push_back({ std::move(name), std::move(unique_name), effect_index });
+		}
+	}
+
+	// Technique names are frequently reused across effects too
+	std::vector<named_item> techniques;
+	for (size_t effect_index = 0; effect_index < num_effects; ++effect_index)
+		for (size_t i = 0; i < num_techniques_per_effect; ++i)
+			techniques.push_back({ "Technique" + std::to_string((effect_index * num_techniques_per_effect + i) % 150), std::string(), effect_index });
+
+	const auto build_texture_index = [&textures](name_index &index) {
+		index.clear();
+		for (size_t texture_index = 0; texture_index < textures.size(); ++texture_index)
+		{
+			index.add(textures[texture_index].unique_name, texture_index);
+			if (textures[texture_index].name != textures[texture_index].unique_name)
+				index.add(textures[texture_index].name, texture_index);
+		}
+	};
+
+	name_index texture_index;
+	build_texture_index(texture_index);
+	name_index technique_index;
+	for (size_t i = 0; i < techniques.size(); ++i)
+		technique_index.add(techniques[i].name, i);
+
+	// Lookups return the same item a linear search through the list does, also with duplicate names and a filter
+	{
+		bool all_match = true;
+		for (const named_item &item : textures)
+		{
+			all_match = all_match && texture_index.find(item.unique_name) == linear_find(textures, item.unique_name);
+			all_match = all_match && texture_index.find(item.name) == linear_find(textures, item.name);
+			all_match = all_match && texture_index.find(item.name, [&textures, &item](size_t i) { return textures[i].effect_index == item.effect_index; }) == linear_find(textures, item.name, item.effect_index);
+		}
+		for (const named_item &item : techniques)
+		{
+			all_match = all_match && technique_index.find(item.name) == linear_find(techniques, item.name);
+			all_match = all_match && technique_index.find(item.name, [&techniques, &item](size_t i) { return techniques[i].effect_index == item.effect_index; }) == linear_find(techniques, item.name, item.effect_index);
+		}
+		CHECK(all_match);
+
+		CHECK(texture_index.find("BackBufferTex0") == 0);
+		CHECK(texture_index.find("Missing") == name_index::npos);
+		CHECK(technique_index.find("Technique0", [](size_t) { return false; }) == name_index::npos);
+
+		name_index empty_index;
+		CHECK(empty_index.empty() && empty_index.find("Tex2") == name_index::npos);
+	}
+
+	const unsigned int iterations = 50;
+	volatile size_t sink = 0;
+
+	// Resolving every texture by unique name, as done for the render targets and samplers of all passes during effect creation
+	testing::benchmark("linear search textures by unique name (x2400)", iterations, [&]() {
+		for (const named_item &item : textures)
+			sink = sink + linear_find(textures, item.unique_name);
+	});
+	testing::benchmark("name index textures by unique name (x2400)", iterations, [&]() {
+		for (const named_item &item : textures)
+			sink = sink + texture_index.find(item.unique_name, [&textures, &item](size_t i) { return textures[i].unique_name == item.unique_name; });
+	});
+
+	// Add-on lookups by variable name restricted to an effect, where many textures share the name
+	testing::benchmark("linear search textures by name in effect (x2400)", iterations, [&]() {
+		for (const named_item &item : textures)
+			sink = sink + linear_find(textures, item.name, item.effect_index);
+	});
+	testing::benchmark("name index textures by name in effect (x2400)", iterations, [&]() {
+		for (const named_item &item : textures)
+			sink = sink + texture_index.find(item.name, [&textures, &item](size_t i) { return textures[i].effect_index == item.effect_index; });
+	});
+
+	testing::benchmark("linear search techniques by name (x400)", iterations, [&]() {
+		for (const named_item &item : techniques)
+			sink = sink + linear_find(techniques, item.name);
+	});
+	testing::benchmark("name index techniques by name (x400)", iterations, [&]() {
+		for (const named_item &item : techniques)
+			sink = sink + technique_index.find(item.name);
+	});
+
+	// Index is rebuilt whenever an effect is destroyed
+	testing::benchmark("rebuild texture index", iterations, [&]() {
+		build_texture_index(texture_index);
+	});
+	CHECK(texture_index.find(textures.back().unique_name) == textures.size() - 1);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "render_pass_cache.hpp"
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace reshade;
+
+static constexpr uint32_t num_threads = 4;
+static constexpr uint32_t passes_per_thread = 50000;
+// Number of distinct render target combinations an application cycles through every frame
+static constexpr uint32_t num_render_passes = 64;
+// One in this many passes uses a transient render target that is destroyed right after
+static constexpr uint32_t transient_pass_interval = 1000;
+
+struct render_pass_objects
+{
+	uint64_t render_pass;
+	uint64_t framebuffer;
+};
+
+using cache_type = render_pass_cache<uint64_t, render_pass_objects, 9>;
+
+// Stand-in for the previous implementation, which took the exclusive device lock for every lookup
+class render_pass_cache_reference
+{
+public:
+	bool find_or_insert(size_t hash, render_pass_objects &value)
+	{
+		const std::unique_lock<std::mutex> lock(_mutex);
+		if (const auto it = _entries.find(hash); it != _entries.end())
+		{
+			value = it->second;
+			return true;
+		}
+		_entries.emplace(hash, value);
+		return false;
+	}
+
+private:
+	std::mutex _mutex;
+	std::unordered_map<size_t, render_pass_objects> _entries;
+};
+
+static size_t hash_attachments(const uint64_t *views, uint32_t num_views)
+{
+	// FNV-1a over the view handles, which does not collide for the small handle values used here
+	uint64_t hash = 0xcbf29ce484222325;
+	for (uint32_t i = 0; i < num_views; ++i)
+		hash = (hash ^ views[i]) * 0x100000001b3;
+	return static_cast<size_t>(hash);
+}
+
+template <typename F>
+static void run_passes(F &&func)
+{
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < num_threads; ++t)
+		threads.emplace_back([t, &func]() {
+			std::mt19937 rng(t);
+			for (uint32_t i = 0; i < passes_per_thread; ++i)
+				func(rng, t, i);
+		});
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+int main()
+{
+	// Entries are evicted together with any of their attachments, but not with unrelated views
+	{
+		cache_type cache;
+		uint32_t num_destroyed = 0;
+		const auto destroy = [&num_destroyed](const render_pass_objects &) { num_destroyed++; };
+
+		const uint64_t views_a[] = { 1, 2, 10 };
+		const uint64_t views_b[] = { 3, 2 };
+		render_pass_objects value = { 100, 200 };
+		CHECK(cache.insert(hash_attachments(views_a, 3), value, views_a, 3));
+		value = { 101, 201 };
+		CHECK(cache.insert(hash_attachments(views_b, 2), value, views_b, 2));
+
+		// Inserting an existing entry again returns the one that was already there
+		value = { 102, 202 };
+		CHECK(!cache.insert(hash_attachments(views_a, 3), value, views_a, 3));
+		CHECK(value.render_pass == 100 && value.framebuffer == 200);
+
+		CHECK(cache.find(hash_attachments(views_b, 2), value) && value.render_pass == 101);
+
+		cache.erase_with_view(42, destroy);
+		CHECK(num_destroyed == 0 && cache.size() == 2);
+
+		cache.erase_with_view(2, destroy);
+		CHECK(num_destroyed == 2 && cache.size() == 0);
+		CHECK(!cache.find(hash_attachments(views_a, 3), value));
+
+		// No stale references to evicted entries are left behind on the other attachments
+		cache.erase_with_view(1, destroy);
+		cache.erase_with_view(10, destroy);
+		CHECK(num_destroyed == 2);
+
+		value = { 103, 203 };
+		CHECK(cache.insert(hash_attachments(views_a, 3), value, views_a, 3));
+		cache.clear(destroy);
+		CHECK(num_destroyed == 3 && cache.size() == 0);
+	}
+
+	// Concurrent lookups, inserts and evictions (run with ThreadSanitizer to check for data races)
+	{
+		cache_type cache;
+		std::atomic<uint32_t> num_created = 0, num_destroyed = 0;
+		run_passes([&](std::mt19937 &rng, uint32_t, uint32_t) {
+			const uint64_t views[2] = { rng() % 32 + 1, rng() % 32 + 33 };
+			const size_t hash = hash_attachments(views, 2);
+			render_pass_objects value = { views[0], views[1] };
+			if (!cache.find(hash, value))
+			{
+				num_created++;
+				if (!cache.insert(hash, value, views, 2))
+					num_destroyed++;
+				CHECK(value.render_pass == views[0] && value.framebuffer == views[1]);
+			}
+			if (rng() % 100 == 0)
+				cache.erase_with_view(views[rng() % 2], [&num_destroyed](const render_pass_objects &) { num_destroyed++; });
+		});
+		cache.clear([&num_destroyed](const render_pass_objects &) { num_destroyed++; });
+		CHECK(num_created == num_destroyed);
+	}
+
+	// Applications without dynamic rendering begin many render passes per frame from several recording threads, which mostly hit the cache
+	testing::benchmark("begin render pass reference (exclusive lock)", 5, []() {
+		render_pass_cache_reference cache;
+		run_passes([&cache](std::mt19937 &rng, uint32_t t, uint32_t i) {
+			uint64_t views[2] = { rng() % num_render_passes + 1, 0 };
+			if (i % transient_pass_interval == 0)
+				views[1] = (uint64_t(t + 1) << 32) | i;
+			render_pass_objects value = { views[0], views[1] };
+			cache.find_or_insert(hash_attachments(views, views[1] != 0 ? 2 : 1), value);
+		});
+	});
+	testing::benchmark("begin render pass cache (shared lock)", 5, []() {
+		cache_type cache;
+		run_passes([&cache](std::mt19937 &rng, uint32_t t, uint32_t i) {
+			uint64_t views[2] = { rng() % num_render_passes + 1, 0 };
+			if (i % transient_pass_interval == 0)
+				views[1] = (uint64_t(t + 1) << 32) | i;
+			const uint32_t num_views = views[1] != 0 ? 2 : 1;
+			const size_t hash = hash_attachments(views, num_views);
+			render_pass_objects value = { views[0], views[1] };
+			if (!cache.find(hash, value))
+				cache.insert(hash, value, views, num_views);
+			// Transient render targets are destroyed right after the pass
+			if (views[1] != 0)
+				cache.erase_with_view(views[1], [](const render_pass_objects &) {});
+		});
+	});
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,14 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Builds the format conversion functions a second time with only the scalar reference implementations, under different names, so that the tests can compare them against the vectorized ones
+
+#define RESHADE_FORMAT_UTILS_SSE2 0
+
+#define is_rgba8_conversion_supported is_rgba8_conversion_supported_reference
+#define convert_pixels_to_rgba8 convert_pixels_to_rgba8_reference
+#define collapse_rgba_components collapse_rgba_components_reference
+
+#include "format_utils.cpp"
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#ifndef _MSC_VER
+// The device API header declares interfaces with MSVC extensions, which are not needed to implement them
+#define __declspec(x)
+#define __uuidof(x) x::uuid
+#endif
+
+#include "reshade_api_device.hpp"
+
+namespace reshade
+{
+	// Command list that does not record anything, so that code recording commands can be run without a graphics API
+	class null_command_list : public api::command_list
+	{
+	public:
+		uint32_t num_calls = 0;
+
+		uint64_t get_native() const override { return 0; }
+		void get_private_data(const uint8_t guid[16], uint64_t *data) const override { *data = 0; }
+		void set_private_data(const uint8_t guid[16], const uint64_t data) override {}
+		api::device *get_device() override { return nullptr; }
+		void barrier(uint32_t count, const api::resource *resources, const api::resource_usage *old_states, const api::resource_usage *new_states) override { num_calls++; }
+		void begin_render_pass(uint32_t count, const api::render_pass_render_target_desc *rts, const api::render_pass_depth_stencil_desc *ds) override { num_calls++; }
+		void end_render_pass() override { num_calls++; }
+		void bind_render_targets_and_depth_stencil(uint32_t count, const api::resource_view *rtvs, api::resource_view dsv) override { num_calls++; }
+		void bind_pipeline(api::pipeline_stage stages, api::pipeline pipeline) override { num_calls++; }
+		void bind_pipeline_states(uint32_t count, const api::dynamic_state *states, const uint32_t *values) override { num_calls++; }
+		void bind_viewports(uint32_t first, uint32_t count, const api::viewport *viewports) override { num_calls++; }
+		void bind_scissor_rects(uint32_t first, uint32_t count, const api::rect *rects) override { num_calls++; }
+		void push_constants(api::shader_stage stages, api::pipeline_layout layout, uint32_t layout_param, uint32_t first, uint32_t count, const void *values) override { num_calls++; }
+		void push_descriptors(api::shader_stage stages, api::pipeline_layout layout, uint32_t layout_param, const api::descriptor_table_update &update) override { num_calls++; }
+		void bind_descriptor_tables(api::shader_stage stages, api::pipeline_layout layout, uint32_t first, uint32_t count, const api::descriptor_table *tables) override { num_calls++; }
+		void bind_index_buffer(api::resource buffer, uint64_t offset, uint32_t index_size) override { num_calls++; }
+		void bind_vertex_buffers(uint32_t first, uint32_t count, const api::resource *buffers, const uint64_t *offsets, const uint32_t *strides) override { num_calls++; }
+		void bind_stream_output_buffers(uint32_t first, uint32_t count, const api::resource *buffers, const uint64_t *offsets, const uint64_t *max_sizes, const api::resource *counter_buffers, const uint64_t *counter_offsets) override { num_calls++; }
+		void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) override { num_calls++; }
+		void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) override { num_calls++; }
+		void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) override { num_calls++; }
+		void dispatch_mesh(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) override { num_calls++; }
+		void dispatch_rays(api::resource raygen, uint64_t raygen_offset, uint64_t raygen_size, api::resource miss, uint64_t miss_offset, uint64_t miss_size, uint64_t miss_stride, api::resource hit_group, uint64_t hit_group_offset, uint64_t hit_group_size, uint64_t hit_group_stride, api::resource callable, uint64_t callable_offset, uint64_t callable_size, uint64_t callable_stride, uint32_t width, uint32_t height, uint32_t depth) override { num_calls++; }
+		void draw_or_dispatch_indirect(api::indirect_command type, api::resource buffer, uint64_t offset, uint32_t draw_count, uint32_t stride) override { num_calls++; }
+		void copy_resource(api::resource source, api::resource dest) override { num_calls++; }
+		void copy_buffer_region(api::resource source, uint64_t source_offset, api::resource dest, uint64_t dest_offset, uint64_t size) override { num_calls++; }
+		void copy_buffer_to_texture(api::resource source, uint64_t source_offset, uint32_t row_length, uint32_t slice_height, api::resource dest, uint32_t dest_subresource, const api::subresource_box *dest_box) override { num_calls++; }
+		void copy_texture_region(api::resource source, uint32_t source_subresource, const api::subresource_box *source_box, api::resource dest, uint32_t dest_subresource, const api::subresource_box *dest_box, api::filter_mode filter) override { num_calls++; }
+		void copy_texture_to_buffer(api::resource source, uint32_t source_subresource, const api::subresource_box *source_box, api::resource dest, uint64_t dest_offset, uint32_t row_length, uint32_t slice_height) override { num_calls++; }
+		void resolve_texture_region(api::resource source, uint32_t source_subresource, const api::subresource_box *source_box, api::resource dest, uint32_t dest_subresource, int32_t dest_x, int32_t dest_y, int32_t dest_z, api::format format) override { num_calls++; }
+		void clear_depth_stencil_view(api::resource_view dsv, const float *depth, const uint8_t *stencil, uint32_t rect_count, const api::rect *rects) override { num_calls++; }
+		void clear_render_target_view(api::resource_view rtv, const float color[4], uint32_t rect_count, const api::rect *rects) override { num_calls++; }
+		void clear_unordered_access_view_uint(api::resource_view uav, const uint32_t values[4], uint32_t rect_count, const api::rect *rects) override { num_calls++; }
+		void clear_unordered_access_view_float(api::resource_view uav, const float values[4], uint32_t rect_count, const api::rect *rects) override { num_calls++; }
+		void generate_mipmaps(api::resource_view srv) override { num_calls++; }
+		void begin_query(api::query_heap heap, api::query_type type, uint32_t index) override { num_calls++; }
+		void end_query(api::query_heap heap, api::query_type type, uint32_t index) override { num_calls++; }
+		void copy_query_heap_results(api::query_heap heap, api::query_type type, uint32_t first, uint32_t count, api::resource dest, uint64_t dest_offset, uint32_t stride) override { num_calls++; }
+		void copy_acceleration_structure(api::resource_view source, api::resource_view dest, api::acceleration_structure_copy_mode mode) override { num_calls++; }
+		void build_acceleration_structure(api::acceleration_structure_type type, api::acceleration_structure_build_flags flags, uint32_t input_count, const api::acceleration_structure_build_input *inputs, api::resource scratch, uint64_t scratch_offset, api::resource_view source, api::resource_view dest, api::acceleration_structure_build_mode mode) override { num_calls++; }
+		void begin_debug_event(const char *label, const float color[4]) override { num_calls++; }
+		void end_debug_event() override { num_calls++; }
+		void insert_debug_marker(const char *label, const float color[4]) override { num_calls++; }
+	};
+}
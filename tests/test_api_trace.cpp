@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "api_trace_recorder.hpp"
+#include <string>
+#include <condition_variable>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+struct handle_value
+{
+	uint64_t handle;
+};
+
+static std::string run_decoder(const char *mode, const std::filesystem::path &path)
+{
+	const std::string command = std::string("\"" API_TRACE_DECODE_PATH "\" ") + mode + " \"" + path.u8string() + "\"";
+
+	std::string output;
+	if (std::FILE *const pipe = popen(command.c_str(), "r"))
+	{
+		char buffer[4096];
+		for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), pipe)) != 0;)
+			output.append(buffer, read);
+		CHECK(pclose(pipe) == 0);
+	}
+	else
+	{
+		CHECK(false);
+	}
+	return output;
+}
+
+int main()
+{
+	const char *const names[] = { nullptr, "draw", "bind_pipeline", "clear" };
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "reshade_test_api_trace.rstrace";
+
+	constexpr uint32_t num_threads = 3;
+	constexpr uint32_t records_per_thread = 2000;
+
+	api_trace::recorder recorder;
+
+	// Threads take turns recording, so that the global order of the records is known, while each thread fills multiple chunks that end up in the file in a different order
+	{
+		CHECK(recorder.open(path, names, 4));
+		CHECK(recorder.is_recording());
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		uint32_t turn = 0;
+
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < num_threads; ++t)
+			threads.emplace_back([&, t]() {
+				for (uint32_t i = 0; i < records_per_thread; ++i)
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.wait(lock, [&]() { return turn % num_threads == t; });
+
+					const uint32_t values[3] = { turn, t, i };
+					recorder.record(1 + t, turn, handle_value { 0x1000 + turn }, api_trace::make_array(values, 3));
+
+					turn++;
+					condition.notify_all();
+				}
+			});
+		for (std::thread &thread : threads)
+			thread.join();
+
+		// Stopping does not wait for the file to be written, the recorder can still be closed afterwards from a different context
+		recorder.stop();
+		CHECK(!recorder.is_recording());
+		recorder.record(1, 0u); // Ignored after stopping
+		recorder.close();
+	}
+
+	// Decoded text lists all records in the order they were recorded in across threads
+	{
+		const std::string output = run_decoder("--text", path);
+
+		uint32_t num_lines = 0;
+		bool all_in_order = true;
+		for (size_t line_begin = 0, line_end; (line_end = output.find('\n', line_begin)) != std::string::npos; line_begin = line_end + 1, ++num_lines)
+		{
+			const uint32_t t = num_lines % num_threads;
+			const std::string expected =
+				std::to_string(num_lines) + " [" + std::to_string(t) + "] " + names[1 + t] + "(" +
+				std::to_string(num_lines) + ", 0x" + [](uint64_t value) { char buffer[17]; std::snprintf(buffer, sizeof(buffer), "%016llX", static_cast<unsigned long long>(value)); return std::string(buffer); }(0x1000 + num_lines) +
+				", { " + std::to_string(num_lines) + ", " + std::to_string(t) + ", " + std::to_string(num_lines / num_threads) + " })";
+
+			if (output.compare(line_begin, line_end - line_begin, expected) != 0)
+			{
+				if (all_in_order)
+					std::fprintf(stderr, "unexpected line %u: %s\n", num_lines, output.substr(line_begin, line_end - line_begin).c_str());
+				all_in_order = false;
+			}
+		}
+		CHECK(all_in_order);
+		CHECK(num_lines == num_threads * records_per_thread);
+	}
+
+	// JSON output contains the sequence number of every record
+	{
+		const std::string output = run_decoder("--json", path);
+
+		CHECK(output.compare(0, 2, "[\n") == 0);
+		CHECK(output.find("{ \"sequence\": 0, \"thread\": 0, \"event\": \"draw\", \"args\": [0, \"0x0000000000001000\", [0, 0, 0]] }") != std::string::npos);
+		CHECK(output.find("{ \"sequence\": 5999, \"thread\": 2, \"event\": \"clear\"") != std::string::npos);
+	}
+
+	// Statistics count records per event
+	{
+		const std::string output = run_decoder("--stats", path);
+
+		CHECK(output.find("6000 records from 3 threads") != std::string::npos);
+	}
+
+	// A recorder can record another trace after the previous one was stopped
+	{
+		CHECK(recorder.open(path, names, 4));
+		recorder.record(3, 42u);
+		recorder.close();
+
+		// Thread indices stay the same for the lifetime of the recorder, so the main thread gets the next free one
+		CHECK(run_decoder("--text", path) == "0 [3] clear(42)\n");
+	}
+
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+
+	return TEST_RESULT();
+}
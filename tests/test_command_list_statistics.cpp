@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstddef>
+#include "testing.hpp"
+
+#include "null_command_list.hpp"
+#include "command_list_statistics.hpp"
+
+using namespace reshade;
+
+int main()
+{
+	null_command_list null_cmd_list;
+	command_statistics stats;
+	command_list_statistics cmd_list(&null_cmd_list, stats);
+
+	const api::resource resources[2] = { { 1 }, { 2 } };
+	const api::resource_usage old_states[2] = { api::resource_usage::shader_resource, api::resource_usage::shader_resource };
+	const api::resource_usage new_states[2] = { api::resource_usage::render_target, api::resource_usage::render_target };
+	const api::descriptor_table tables[3] = { { 1 }, { 2 }, { 3 } };
+
+	// Record the commands of a typical effect pass
+	cmd_list.barrier(2, resources, old_states, new_states);
+	cmd_list.copy_texture_region(resources[0], 0, nullptr, resources[1], 0, nullptr, api::filter_mode::min_mag_mip_point);
+	cmd_list.bind_pipeline(api::pipeline_stage::all_graphics, { 1 });
+	cmd_list.begin_render_pass(0, nullptr, nullptr);
+	cmd_list.bind_descriptor_tables(api::shader_stage::all_graphics, { 1 }, 0, 3, tables);
+	cmd_list.bind_viewports(0, 0, nullptr);
+	cmd_list.push_constants(api::shader_stage::pixel, { 1 }, 0, 0, 0, nullptr);
+	cmd_list.draw(3, 1, 0, 0);
+	cmd_list.end_render_pass();
+	cmd_list.barrier(2, resources, new_states, old_states);
+	cmd_list.generate_mipmaps({ 1 });
+	cmd_list.dispatch(1, 1, 1);
+	cmd_list.draw_or_dispatch_indirect(api::indirect_command::draw, resources[0], 0, 4, 16);
+	cmd_list.clear_render_target_view({ 1 }, nullptr, 0, nullptr);
+
+	CHECK(stats.barriers == 4);
+	CHECK(stats.copies == 1);
+	CHECK(stats.pipeline_binds == 1);
+	CHECK(stats.render_passes == 1);
+	CHECK(stats.descriptor_table_binds == 3);
+	CHECK(stats.push_constants == 1);
+	CHECK(stats.draws_and_dispatches == 1 + 1 + 4);
+	CHECK(stats.mipmap_generations == 1);
+	CHECK(stats.clears == 1);
+
+	// Every command is forwarded, including those that are not counted
+	CHECK(null_cmd_list.num_calls == 14);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "dll_log.hpp"
+#include <thread>
+#include <vector>
+#include <fstream>
+
+static std::vector<std::string> read_lines(const std::filesystem::path &path)
+{
+	std::vector<std::string> lines;
+	std::ifstream file(path, std::ios::binary);
+	for (std::string line; std::getline(file, line);)
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		lines.push_back(std::move(line));
+	}
+	return lines;
+}
+
+static bool contains_line_ending_with(const std::vector<std::string> &lines, const std::string &suffix)
+{
+	for (const std::string &line : lines)
+		if (line.size() >= suffix.size() && line.compare(line.size() - suffix.size(), suffix.size(), suffix) == 0)
+			return true;
+	return false;
+}
+
+int main()
+{
+	const std::filesystem::path log_path = std::filesystem::temp_directory_path() / "reshade_test_dll_log.log";
+
+	std::error_code ec;
+	CHECK(reshade::log::open_log_file(log_path, ec));
+	CHECK(!ec);
+
+	// Wide strings are converted to UTF-8, regardless of whether 'wchar_t' is two or four bytes
+	LOG(INFO) << "Formatting " << 42 << ' ' << L"wide " << std::wstring(L"é€\U0001F600") << ' ' << std::filesystem::path("dir/file.txt");
+
+	// Errors are written synchronously, together with everything that was queued before them
+	LOG(ERROR) << "First error";
+	{
+		const std::vector<std::string> lines = read_lines(log_path);
+		CHECK(lines.size() == 2);
+		CHECK(contains_line_ending_with(lines, "| INFO  | Formatting 42 wide \xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 \"dir/file.txt\""));
+		CHECK(contains_line_ending_with(lines, "| ERROR | First error"));
+	}
+
+	// Log from multiple threads at once, which may overflow the queue and drop some informational messages, but never warnings
+	constexpr int num_threads = 4;
+	constexpr int num_messages_per_thread = 3000;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < num_threads; ++t)
+	{
+		threads.emplace_back([t]() {
+			for (int i = 0; i < num_messages_per_thread; ++i)
+				LOG(INFO) << "Thread " << t << " message " << i;
+			LOG(WARN) << "Thread " << t << " done";
+		});
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+
+	reshade::log::shutdown();
+
+	// Messages are written synchronously after shutdown
+	LOG(INFO) << "After shutdown";
+
+	{
+		const std::vector<std::string> lines = read_lines(log_path);
+
+		int last_message_index[num_threads];
+		std::fill_n(last_message_index, num_threads, -1);
+		size_t num_messages = 0, num_dropped = 0;
+		bool in_order = true;
+
+		for (const std::string &line : lines)
+		{
+			int t = 0, i = 0;
+			size_t dropped = 0;
+			if (const size_t pos = line.find("| Thread "); pos != std::string::npos && std::sscanf(line.c_str() + pos, "| Thread %d message %d", &t, &i) == 2)
+			{
+				in_order = in_order && t >= 0 && t < num_threads && i > last_message_index[t];
+				last_message_index[t] = i;
+				num_messages++;
+			}
+			else if (const size_t pos = line.find("Dropped "); pos != std::string::npos && std::sscanf(line.c_str() + pos, "Dropped %zu", &dropped) == 1)
+			{
+				num_dropped += dropped;
+			}
+		}
+
+		CHECK(in_order);
+		CHECK(num_messages + num_dropped == static_cast<size_t>(num_threads) * num_messages_per_thread);
+		for (int t = 0; t < num_threads; ++t)
+			CHECK(contains_line_ending_with(lines, "| WARN  | Thread " + std::to_string(t) + " done"));
+		CHECK(contains_line_ending_with(lines, "| INFO  | After shutdown"));
+	}
+
+	std::filesystem::remove(log_path, ec);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "effect_parser.hpp"
+#include "effect_codegen.hpp"
+
+// Declarations shared by all test effects, so that each only differs in the pass states
+static const std::string effect_prefix = R"(
+uniform bool Enabled = true;
+uniform float2 Offset = float2(0.0, 0.0);
+texture2D BackBufferTex : COLOR;
+sampler2D BackBuffer { Texture = BackBufferTex; };
+void VS(in uint id : SV_VertexID, out float4 position : SV_Position, out float2 texcoord : TEXCOORD)
+{
+	texcoord.x = (id == 2) ? 2.0 : 0.0;
+	texcoord.y = (id == 1) ? 2.0 : 0.0;
+	position = float4(texcoord * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+float4 PS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	return tex2D(BackBuffer, texcoord + Offset);
+}
+)";
+
+static bool parse_effect(const std::string &pass_states, reshadefx::module &module, std::string &errors, const std::string &declarations = std::string())
+{
+	const std::unique_ptr<reshadefx::codegen> codegen(reshadefx::create_codegen_glsl(false, false, false));
+
+	reshadefx::parser parser;
+	const bool success = parser.parse(effect_prefix + declarations + "technique Test { pass { VertexShader = VS; PixelShader = PS; " + pass_states + " } }\n", codegen.get());
+	errors = parser.errors();
+
+	codegen->write_result(module);
+	return success;
+}
+
+int main()
+{
+	// Scalar bool uniforms are accepted as enable condition and referenced by their unique name
+	{
+		reshadefx::module module;
+		std::string errors;
+		CHECK(parse_effect("EnableIf = Enabled;", module, errors));
+		CHECK(errors.empty());
+		CHECK(module.techniques.size() == 1 && module.techniques[0].passes.size() == 1);
+		CHECK(module.uniforms.size() == 2 && module.uniforms[0].name == "Enabled");
+		CHECK(module.techniques[0].passes[0].enable_uniform_name == module.uniforms[0].unique_name);
+	}
+
+	// Uniforms with the same name in different namespaces are told apart
+	{
+		reshadefx::module module;
+		std::string errors;
+		CHECK(parse_effect("EnableIf = B::Toggle;", module, errors, "namespace A { uniform bool Toggle = true; }\nnamespace B { uniform bool Toggle = false; }\n"));
+		CHECK(errors.empty());
+		CHECK(module.uniforms.size() == 4 && module.uniforms[2].name == "Toggle" && module.uniforms[3].name == "Toggle");
+		CHECK(module.uniforms[2].unique_name != module.uniforms[3].unique_name);
+		CHECK(module.techniques[0].passes[0].enable_uniform_name == module.uniforms[3].unique_name);
+	}
+
+	// Passes without enable condition leave the name empty
+	{
+		reshadefx::module module;
+		std::string errors;
+		CHECK(parse_effect("", module, errors));
+		CHECK(module.techniques.size() == 1 && module.techniques[0].passes.size() == 1);
+		CHECK(module.techniques[0].passes[0].enable_uniform_name.empty());
+	}
+
+	// Vector uniforms cannot be evaluated as a condition
+	{
+		reshadefx::module module;
+		std::string errors;
+		CHECK(!parse_effect("EnableIf = Offset;", module, errors));
+		CHECK(errors.find("error X3020") != std::string::npos);
+	}
+
+	// Names that were never declared are reported as such
+	{
+		reshadefx::module module;
+		std::string errors;
+		CHECK(!parse_effect("EnableIf = Missing;", module, errors));
+		CHECK(errors.find("error X3004") != std::string::npos);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstddef>
+#include "testing.hpp"
+
+#include "null_command_list.hpp"
+#include "command_list_statistics.hpp"
+#include "effect_pass_barriers.hpp"
+#include <unordered_map>
+
+using namespace reshade;
+
+static const api::resource back_buffer = { 1 };
+static const api::resource color_tex = { 2 };
+static const api::resource tex_a = { 3 };
+static const api::resource tex_b = { 4 };
+static const api::resource tex_c = { 5 };
+
+// Command list that tracks the state of every resource and checks that transitions and copies are valid
+class validating_command_list : public null_command_list
+{
+public:
+	validating_command_list()
+	{
+		states[back_buffer.handle] = api::resource_usage::render_target;
+		for (const api::resource resource : { color_tex, tex_a, tex_b, tex_c })
+			states[resource.handle] = api::resource_usage::shader_resource;
+	}
+
+	void barrier(uint32_t count, const api::resource *resources, const api::resource_usage *old_states, const api::resource_usage *new_states) override
+	{
+		null_command_list::barrier(count, resources, old_states, new_states);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			// A resource must not appear twice in a single batch
+			for (uint32_t k = 0; k < i; ++k)
+				CHECK(resources[k] != resources[i]);
+
+			CHECK(states[resources[i].handle] == old_states[i]);
+			states[resources[i].handle] = new_states[i];
+		}
+	}
+
+	void copy_texture_region(api::resource source, uint32_t source_subresource, const api::subresource_box *source_box, api::resource dest, uint32_t dest_subresource, const api::subresource_box *dest_box, api::filter_mode filter) override
+	{
+		null_command_list::copy_texture_region(source, source_subresource, source_box, dest, dest_subresource, dest_box, filter);
+
+		CHECK(source == back_buffer && dest == color_tex);
+		CHECK(states[source.handle] == api::resource_usage::copy_source);
+		CHECK(states[dest.handle] == api::resource_usage::copy_dest);
+
+		color_tex_version = back_buffer_version;
+	}
+
+	// Simulates drawing or dispatching a pass
+	void execute_pass(const effect_pass_barriers &pass)
+	{
+		// Passes sampling the back buffer have to see its latest contents
+		if (pass.samples_back_buffer)
+			CHECK(color_tex_version == back_buffer_version);
+		if (pass.writes_back_buffer)
+		{
+			CHECK(states[back_buffer.handle] == api::resource_usage::render_target);
+			back_buffer_version++;
+		}
+
+		for (const api::resource resource : pass.modified_resources)
+			CHECK(states[resource.handle] == pass.modified_usage);
+	}
+
+	bool all_in_initial_state()
+	{
+		bool result = states[back_buffer.handle] == api::resource_usage::render_target;
+		for (const api::resource resource : { color_tex, tex_a, tex_b, tex_c })
+			result = result && states[resource.handle] == api::resource_usage::shader_resource;
+		return result;
+	}
+
+	std::unordered_map<uint64_t, api::resource_usage> states;
+	uint32_t back_buffer_version = 1;
+	uint32_t color_tex_version = 0;
+};
+
+static effect_pass_barriers make_pass(std::vector<api::resource> modified_resources, bool samples_back_buffer, bool writes_back_buffer, bool compute = false, bool generate_mipmaps = false)
+{
+	effect_pass_barriers pass;
+	pass.modified_resources = std::move(modified_resources);
+	pass.modified_usage = compute ? api::resource_usage::unordered_access : api::resource_usage::render_target;
+	pass.samples_back_buffer = samples_back_buffer;
+	pass.writes_back_buffer = writes_back_buffer;
+	if (generate_mipmaps)
+		pass.generate_mipmap_views.push_back({ pass.modified_resources[0].handle });
+	return pass;
+}
+
+// Records the transitions the way it was done before passes were compiled, which copies the back buffer before the first pass and after every pass writing to it and transitions resources before and after every pass
+static void record_unbatched(api::command_list *cmd_list, validating_command_list &validation, const std::vector<effect_pass_barriers> &passes)
+{
+	bool needs_implicit_back_buffer_copy = true;
+
+	for (const effect_pass_barriers &pass : passes)
+	{
+		if (needs_implicit_back_buffer_copy)
+		{
+			const api::resource resources[2] = { back_buffer, color_tex };
+			const api::resource_usage state_old[2] = { api::resource_usage::render_target, api::resource_usage::shader_resource };
+			const api::resource_usage state_new[2] = { api::resource_usage::copy_source, api::resource_usage::copy_dest };
+
+			cmd_list->barrier(2, resources, state_old, state_new);
+			cmd_list->copy_texture_region(back_buffer, 0, nullptr, color_tex, 0, nullptr);
+			cmd_list->barrier(2, resources, state_new, state_old);
+		}
+
+		needs_implicit_back_buffer_copy = pass.writes_back_buffer;
+
+		const uint32_t num_barriers = static_cast<uint32_t>(pass.modified_resources.size());
+		std::vector<api::resource_usage> state_old(num_barriers, api::resource_usage::shader_resource);
+		std::vector<api::resource_usage> state_new(num_barriers, pass.modified_usage);
+
+		cmd_list->barrier(num_barriers, pass.modified_resources.data(), state_old.data(), state_new.data());
+		validation.execute_pass(pass);
+		cmd_list->barrier(num_barriers, pass.modified_resources.data(), state_new.data(), state_old.data());
+
+		for (const api::resource_view view : pass.generate_mipmap_views)
+			cmd_list->generate_mipmaps(view);
+	}
+}
+
+// Records the transitions the way 'render_technique' does
+static void record_batched(api::command_list *cmd_list, validating_command_list &validation, const std::vector<effect_pass_barriers> &passes)
+{
+	for (const effect_pass_barriers &pass : passes)
+	{
+		pass.record_begin_barriers(cmd_list, pass.copy_back_buffer, back_buffer, color_tex);
+		validation.execute_pass(pass);
+		pass.record_end_barriers(cmd_list);
+
+		for (const api::resource_view view : pass.generate_mipmap_views)
+			cmd_list->generate_mipmaps(view);
+	}
+}
+
+int main()
+{
+	std::vector<effect_pass_barriers> passes;
+	// Draws to the back buffer without sampling it
+	passes.push_back(make_pass({}, false, true));
+	// Samples the back buffer and draws to a texture
+	passes.push_back(make_pass({ tex_a }, true, false));
+	// Draws to another texture that has mipmaps
+	passes.push_back(make_pass({ tex_b }, false, false, false, true));
+	// Writes to a texture in a compute shader, followed by a pass that draws to the same texture
+	passes.push_back(make_pass({ tex_c }, false, false, true));
+	passes.push_back(make_pass({ tex_c }, false, false));
+	// Samples the back buffer, which was not modified since the last copy
+	passes.push_back(make_pass({}, true, true));
+	passes.push_back(make_pass({}, false, true));
+	passes.push_back(make_pass({}, true, true));
+
+	effect_pass_barriers::compile(passes);
+
+	// Back buffer is only copied for passes that sample it, and only when it was modified since the last copy
+	CHECK(!passes[0].copy_back_buffer);
+	CHECK(passes[1].copy_back_buffer);
+	CHECK(!passes[5].copy_back_buffer);
+	CHECK(!passes[6].copy_back_buffer);
+	CHECK(passes[7].copy_back_buffer);
+
+	// Transitions after a pass are merged into the next one, unless mipmaps are generated in between or both passes write the same resource
+	CHECK(passes[1].defer_end_barriers);
+	CHECK(passes[2].num_previous_pass_barriers == 1 && passes[2].barrier_resources.size() == 2);
+	CHECK(!passes[2].defer_end_barriers);
+	CHECK(passes[3].num_previous_pass_barriers == 0);
+	CHECK(!passes[3].defer_end_barriers);
+	CHECK(passes[4].defer_end_barriers);
+	CHECK(passes[5].num_previous_pass_barriers == 1);
+	CHECK(!passes[7].defer_end_barriers);
+
+	command_statistics unbatched_stats;
+	{
+		validating_command_list validation;
+		command_list_statistics cmd_list(&validation, unbatched_stats);
+		record_unbatched(&cmd_list, validation, passes);
+		CHECK(validation.all_in_initial_state());
+	}
+
+	command_statistics batched_stats;
+	uint32_t batched_num_calls = 0;
+	{
+		validating_command_list validation;
+		command_list_statistics cmd_list(&validation, batched_stats);
+		record_batched(&cmd_list, validation, passes);
+		CHECK(validation.all_in_initial_state());
+		batched_num_calls = validation.num_calls;
+	}
+
+	CHECK(unbatched_stats.copies == 4);
+	CHECK(batched_stats.copies == 2);
+
+	// Number of transitions (each copy transitions the back buffer and effect color texture there and back again)
+	CHECK(unbatched_stats.barriers == 4 * 4 + 2 * 4);
+	CHECK(batched_stats.barriers == 5 + 3 + 2 + 1 + 1 + 4);
+
+	// Barrier batches, copies and mipmap generations per pass
+	CHECK(batched_num_calls == 0 + 3 + 3 + 2 + 1 + 1 + 0 + 3);
+
+	CHECK(unbatched_stats.mipmap_generations == 1 && batched_stats.mipmap_generations == 1);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "format_utils.hpp"
+#include <random>
+#include <vector>
+
+namespace reshade::utils
+{
+	// See 'format_utils_reference.cpp'
+	bool convert_pixels_to_rgba8_reference(api::format format, uint32_t width, uint32_t height, const void *src, size_t src_row_pitch, uint8_t *dst, size_t dst_row_pitch);
+}
+
+using namespace reshade;
+
+static const api::format test_formats[] = {
+	api::format::r8_unorm,
+	api::format::r8g8_unorm,
+	api::format::r8g8b8a8_unorm,
+	api::format::r8g8b8x8_unorm,
+	api::format::b8g8r8a8_unorm,
+	api::format::b8g8r8x8_unorm,
+	api::format::r10g10b10a2_unorm,
+	api::format::b10g10r10a2_unorm,
+	api::format::r16g16b16a16_float,
+};
+
+static uint32_t bytes_per_pixel(api::format format)
+{
+	switch (format)
+	{
+	case api::format::r8_unorm:
+		return 1;
+	case api::format::r8g8_unorm:
+		return 2;
+	case api::format::r16g16b16a16_float:
+		return 8;
+	default:
+		return 4;
+	}
+}
+
+static bool compare_conversions(api::format format, uint32_t width, uint32_t height, std::mt19937 &rng)
+{
+	// Add some padding to each row and offset the data by one byte, to catch kernels that assume tightly packed or aligned rows
+	const size_t src_row_pitch = static_cast<size_t>(width) * bytes_per_pixel(format) + 3;
+	std::vector<uint8_t> src(1 + src_row_pitch * height);
+	// Random bits cover all special values as well (e.g. denormal, infinity and NaN for floating-point formats)
+	for (uint8_t &value : src)
+		value = static_cast<uint8_t>(rng());
+
+	const size_t dst_row_pitch = static_cast<size_t>(width) * 4;
+	std::vector<uint8_t> dst(dst_row_pitch * height), dst_reference(dst_row_pitch * height);
+
+	CHECK(utils::convert_pixels_to_rgba8(format, width, height, src.data() + 1, src_row_pitch, dst.data(), dst_row_pitch));
+	CHECK(utils::convert_pixels_to_rgba8_reference(format, width, height, src.data() + 1, src_row_pitch, dst_reference.data(), dst_row_pitch));
+
+	const bool equal = dst == dst_reference;
+
+	if (!equal)
+		std::fprintf(stderr, "Conversion of format %u (%ux%u) does not match the scalar reference implementation\n", static_cast<unsigned int>(format), width, height);
+	return equal;
+}
+
+int main()
+{
+	std::mt19937 rng(1234);
+
+	for (const api::format format : test_formats)
+	{
+		CHECK(utils::is_rgba8_conversion_supported(format));
+
+		// Widths that are not a multiple of the vector width exercise the scalar remainder handling of the kernels
+		for (const uint32_t width : { 1u, 3u, 4u, 15u, 16u, 17u, 63u, 64u, 65u, 257u })
+			CHECK(compare_conversions(format, width, 5, rng));
+
+		// Large enough to be split across worker threads, converted twice to check that the worker threads are reused correctly
+		CHECK(compare_conversions(format, 1921, 1081, rng));
+		CHECK(compare_conversions(format, 1921, 1081, rng));
+	}
+
+	// Known values
+	{
+		const uint8_t bgra[4] = { 0x10, 0x20, 0x30, 0x40 };
+		uint8_t rgba[4] = {};
+		CHECK(utils::convert_pixels_to_rgba8(api::format::b8g8r8x8_unorm, 1, 1, bgra, 4, rgba, 4));
+		CHECK(rgba[0] == 0x30 && rgba[1] == 0x20 && rgba[2] == 0x10 && rgba[3] == 0xFF);
+
+		const uint32_t r10g10b10a2 = 1023u | (512u << 10) | (0u << 20) | (3u << 30);
+		CHECK(utils::convert_pixels_to_rgba8(api::format::r10g10b10a2_unorm, 1, 1, &r10g10b10a2, 4, rgba, 4));
+		CHECK(rgba[0] == 0xFF && rgba[1] == 0x80 && rgba[2] == 0 && rgba[3] == 0xFF);
+	}
+
+	// Collapsing drops trailing components in-place
+	{
+		uint8_t pixels[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+		utils::collapse_rgba_components(pixels, 2, 2, 1);
+		CHECK(pixels[0] == 1 && pixels[1] == 2 && pixels[2] == 5 && pixels[3] == 6);
+	}
+
+	return TEST_RESULT();
+}
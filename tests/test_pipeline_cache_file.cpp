@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "pipeline_cache_file.hpp"
+
+using reshade::pipeline_cache_file;
+
+static std::vector<uint8_t> make_data(size_t size, uint8_t value)
+{
+	return std::vector<uint8_t>(size, value);
+}
+
+int main()
+{
+	const std::filesystem::path cache_path = std::filesystem::temp_directory_path() / "reshade_test_pipeline_cache_file";
+	std::error_code ec;
+	std::filesystem::remove_all(cache_path, ec);
+	std::filesystem::create_directory(cache_path);
+
+	constexpr size_t max_size = 4096;
+
+	// Every application and device gets its own file, even if executables share a name
+	{
+		const pipeline_cache_file a(cache_path, "/games/a/game.exe", 0x20000, 0x10de, 0x2204, max_size);
+		const pipeline_cache_file b(cache_path, "/games/b/game.exe", 0x20000, 0x10de, 0x2204, max_size);
+		const pipeline_cache_file c(cache_path, "/games/a/game.exe", 0x20000, 0x1002, 0x73bf, max_size);
+		const pipeline_cache_file a2(cache_path, "/games/a/game.exe", 0x20000, 0x10de, 0x2204, max_size);
+
+		CHECK(a.path() != b.path());
+		CHECK(a.path() != c.path());
+		CHECK(a.path() == a2.path());
+		CHECK(a.path().parent_path() == cache_path);
+		CHECK(a.path().filename().u8string().compare(0, 13, "reshade-game-") == 0);
+		CHECK(a.path().extension() == ".pso");
+	}
+
+	const pipeline_cache_file file(cache_path, "/games/a/game.exe", 0x20000, 0x10de, 0x2204, max_size);
+
+	// Saved data can be loaded again
+	{
+		std::vector<uint8_t> data;
+		CHECK(!file.load(data));
+
+		CHECK(file.save(make_data(1000, 1).data(), 1000));
+		CHECK(file.load(data) && data == make_data(1000, 1));
+
+		CHECK(file.save(make_data(500, 2).data(), 500));
+		CHECK(file.load(data) && data == make_data(500, 2));
+	}
+
+	// Data beyond the size limit is not saved and removes the existing file, so that the cache starts from scratch again
+	{
+		std::vector<uint8_t> data;
+		CHECK(!file.save(make_data(max_size + 1, 3).data(), max_size + 1));
+		CHECK(!std::filesystem::exists(file.path()));
+		CHECK(!file.load(data));
+
+		// A file that was made too large by something else is ignored
+		std::ofstream(file.path(), std::ios::binary).write(reinterpret_cast<const char *>(make_data(max_size + 1, 4).data()), max_size + 1);
+		CHECK(!file.load(data));
+	}
+
+	// Concurrent saves (e.g. from multiple processes running the same application) always leave one complete file behind and no temporary files
+	{
+		std::vector<std::thread> threads;
+		for (uint8_t t = 0; t < 8; ++t)
+			threads.emplace_back([&file, t]() {
+				const std::vector<uint8_t> data = make_data(1024 + t, t);
+				for (int i = 0; i < 50; ++i)
+					file.save(data.data(), data.size());
+			});
+		for (std::thread &thread : threads)
+			thread.join();
+
+		std::vector<uint8_t> data;
+		CHECK(file.load(data) && data.size() >= 1024 && data == make_data(data.size(), static_cast<uint8_t>(data.size() - 1024)));
+
+		size_t num_files = 0;
+		for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(cache_path))
+		{
+			CHECK(entry.path().extension() == ".pso");
+			num_files++;
+		}
+		CHECK(num_files == 1);
+	}
+
+	std::filesystem::remove_all(cache_path, ec);
+
+	return TEST_RESULT();
+}
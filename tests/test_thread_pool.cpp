@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+
+int main()
+{
+	reshade::thread_pool pool;
+
+	// Without worker threads everything runs on the calling thread
+	{
+		size_t sum = 0;
+		pool.parallel_for(100, [&sum](size_t i) { sum += i; });
+		CHECK(sum == 4950);
+	}
+
+	pool.start(3);
+	CHECK(pool.size() == 3);
+	pool.start(5); // Ignored while the pool has threads
+	CHECK(pool.size() == 3);
+
+	// Every index is processed exactly once, across many consecutive jobs that reuse the same threads
+	{
+		bool all_processed_once = true;
+		for (size_t job = 0; job < 1000; ++job)
+		{
+			const size_t count = 1 + job % 37;
+			std::vector<std::atomic<uint32_t>> calls(count);
+			pool.parallel_for(count, [&calls](size_t i) { calls[i].fetch_add(1, std::memory_order_relaxed); });
+
+			for (const std::atomic<uint32_t> &num_calls : calls)
+				all_processed_once = all_processed_once && num_calls.load() == 1;
+		}
+		CHECK(all_processed_once);
+	}
+
+	// Work is spread across multiple threads
+	{
+		std::mutex mutex;
+		std::vector<std::thread::id> thread_ids;
+		pool.parallel_for(64, [&](size_t) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			const std::unique_lock<std::mutex> lock(mutex);
+			if (std::find(thread_ids.begin(), thread_ids.end(), std::this_thread::get_id()) == thread_ids.end())
+				thread_ids.push_back(std::this_thread::get_id());
+		});
+		CHECK(thread_ids.size() > 1);
+	}
+
+	// The pool can be restarted after it was stopped
+	pool.stop();
+	CHECK(pool.size() == 0);
+	pool.start(2);
+	{
+		std::atomic<size_t> sum = 0;
+		pool.parallel_for(100, [&sum](size_t i) { sum += i; });
+		CHECK(sum == 4950);
+	}
+
+	return TEST_RESULT();
+}
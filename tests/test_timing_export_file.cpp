@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "timing_export_file.hpp"
+#include <sstream>
+
+using reshade::timing_export_file;
+
+static std::string read_file(const std::filesystem::path &path)
+{
+	std::ifstream file(path);
+	std::stringstream stream;
+	stream << file.rdbuf();
+	return stream.str();
+}
+
+int main()
+{
+	// Fields containing separators or quotes are quoted, with quotes doubled
+	{
+		std::string line;
+		timing_export_file::append_csv_field(line, "Plain");
+		CHECK(line == "Plain");
+
+		line.clear();
+		timing_export_file::append_csv_field(line, "a,b");
+		CHECK(line == "\"a,b\"");
+
+		line.clear();
+		timing_export_file::append_csv_field(line, "say \"hi\"\n");
+		CHECK(line == "\"say \"\"hi\"\"\n\"");
+	}
+
+	// Strings are escaped according to JSON, including control characters
+	{
+		std::string line;
+		timing_export_file::append_json_string(line, "a\"b\\c\nd\te\x01");
+		CHECK(line == "\"a\\\"b\\\\c\\nd\\te\\u0001\"");
+	}
+
+	// Samples covering the entire technique leave the pass empty
+	{
+		const timing_export_file::sample pass_sample = { 42, "Tech,nique", 1, "Pass \"B\"", 1000, 2000 };
+		const timing_export_file::sample technique_sample = { 43, "Technique", -1, std::string(), 3000, 4000 };
+
+		CHECK(timing_export_file::format_sample(pass_sample, timing_export_file::format::csv) == "42,\"Tech,nique\",1,\"Pass \"\"B\"\"\",1000,2000\n");
+		CHECK(timing_export_file::format_sample(technique_sample, timing_export_file::format::csv) == "43,Technique,,,3000,4000\n");
+		CHECK(timing_export_file::format_sample(pass_sample, timing_export_file::format::json_lines) == "{\"frame\":42,\"technique\":\"Tech,nique\",\"pass\":1,\"pass_name\":\"Pass \\\"B\\\"\",\"cpu_ns\":1000,\"gpu_ns\":2000}\n");
+		CHECK(timing_export_file::format_sample(technique_sample, timing_export_file::format::json_lines) == "{\"frame\":43,\"technique\":\"Technique\",\"pass\":null,\"pass_name\":\"\",\"cpu_ns\":3000,\"gpu_ns\":4000}\n");
+	}
+
+	// All samples that were appended end up in the file once it is closed, in order
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / "reshade_test_timing_export_file.csv";
+
+		timing_export_file file;
+		CHECK(!file.is_open());
+		CHECK(file.open(path, timing_export_file::format::csv));
+		CHECK(file.is_open());
+
+		std::string expected = "frame,technique,pass,pass_name,cpu_ns,gpu_ns\n";
+		for (uint64_t frame = 0; frame < 5000; ++frame)
+		{
+			timing_export_file::sample sample = { frame, "Technique", 0, "Pass", frame * 2, frame * 3 };
+			expected += timing_export_file::format_sample(sample, timing_export_file::format::csv);
+			file.append(std::move(sample));
+		}
+
+		file.close();
+		CHECK(!file.is_open());
+		CHECK(read_file(path) == expected);
+
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "testing.hpp"
+#include "reshade_xxhash64.hpp"
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+using reshade::compute_xxhash64;
+
+static uint64_t hash_string(std::string_view value, uint64_t seed = 0)
+{
+	return compute_xxhash64(reinterpret_cast<const uint8_t *>(value.data()), value.size(), seed);
+}
+
+int main()
+{
+	// Known answers of the reference implementation for short strings
+	CHECK(hash_string("") == 0xEF46DB3751D8E999ull);
+	CHECK(hash_string("", 1) == 0xD5AFBA1336A3BE4Bull);
+	CHECK(hash_string("a") == 0xD24EC4F1A98C6E5Bull);
+	CHECK(hash_string("abc") == 0x44BC2CF5AD770999ull);
+	CHECK(hash_string("xxhash") == 0x32DD38952C4BC720ull);
+	CHECK(hash_string("xxhash", 20141025) == 0xB559B98D844E0635ull);
+	CHECK(hash_string("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ull);
+
+	// Known answers of the reference implementation for the pseudo-random sanity buffer of its test suite, with lengths around the 32 byte stripe size
+	{
+		constexpr uint64_t prime32 = 2654435761u;
+		constexpr uint64_t prime64 = 11400714785074694797ull;
+
+		std::vector<uint8_t> buffer(2367);
+		uint64_t byte_gen = prime32;
+		for (uint8_t &value : buffer)
+		{
+			value = static_cast<uint8_t>(byte_gen >> 56);
+			byte_gen *= prime64;
+		}
+
+		const struct { size_t size; uint64_t seed; uint64_t hash; } vectors[] = {
+			{ 1, 0, 0xE934A84ADB052768ull },
+			{ 1, prime32, 0x5014607643A9B4C3ull },
+			{ 14, 0, 0x8282DCC4994E35C8ull },
+			{ 14, prime32, 0xC3BD6BF63DEB6DF0ull },
+			{ 31, 0, 0x299B39A290E6D783ull },
+			{ 31, prime32, 0xDA673D5FEB5C1D79ull },
+			{ 32, 0, 0x18B216492BB44B70ull },
+			{ 32, prime32, 0xB3F33BDF93ADE409ull },
+			{ 33, 0, 0x55C8DC3E578F5B59ull },
+			{ 33, prime32, 0xE92C292F64BC3071ull },
+			{ 222, 0, 0xB641AE8CB691C174ull },
+			{ 222, prime32, 0x20CB8AB7AE10C14Aull },
+			{ 2367, 0, 0xA82418DDEC0EA581ull },
+			{ 2367, prime32, 0xA36A93C18052673Aull },
+		};
+
+		for (const auto &vector : vectors)
+			CHECK(compute_xxhash64(buffer.data(), vector.size, vector.seed) == vector.hash);
+	}
+
+	// Result must not depend on the alignment of the input
+	{
+		std::vector<uint8_t> buffer(256 + 8);
+		for (size_t i = 0; i < buffer.size(); ++i)
+			buffer[i] = static_cast<uint8_t>(i * 7);
+
+		std::vector<uint8_t> shifted(buffer.size() + 3);
+		std::copy(buffer.begin(), buffer.end(), shifted.begin() + 3);
+
+		CHECK(compute_xxhash64(buffer.data(), buffer.size()) == compute_xxhash64(shifted.data() + 3, buffer.size()));
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2024 Patrick Mours
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace reshade::testing
+{
+	inline int num_failures = 0;
+
+	/// <summary>
+	/// Returns whether benchmarks should only run a reduced number of iterations (e.g. when run as part of the test suite).
+	/// </summary>
+	inline bool is_quick_run()
+	{
+		const char *const value = std::getenv("RESHADE_BENCHMARK_QUICK");
+		return value != nullptr && *value != '\0' && *value != '0';
+	}
+
+	/// <summary>
+	/// Calls the specified function repeatedly and prints the average time per iteration.
+	/// </summary>
+	/// <returns>Average time per iteration in nanoseconds.</returns>
+	template <typename F>
+	double benchmark(const char *name, unsigned int iterations, F &&func)
+	{
+		if (is_quick_run())
+			iterations = 1;
+
+		func(); // Warm up
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < iterations; ++i)
+			func();
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		const double ns_per_iteration = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+		std::printf("%-48s %14.1f us/iteration (%u iterations)\n", name, ns_per_iteration / 1000.0, iterations);
+		return ns_per_iteration;
+	}
+}
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			reshade::testing::num_failures++; \
+		} \
+	} while (false)
+
+#define TEST_RESULT() \
+	(reshade::testing::num_failures == 0 ? EXIT_SUCCESS : (std::fprintf(stderr, "%d check(s) failed\n", reshade::testing::num_failures), EXIT_FAILURE))